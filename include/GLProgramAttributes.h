@@ -12,6 +12,7 @@ struct GLProgramAttribute
     enum Index
     {
         Position = 0,
+        ObjectTransform = 4, // per-instance matrix, occupies 4 to 7
         TexCoord = 8,
         Tangent = 9,
         Bitangent = 10,
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <functional>
 #include "imodule.h"
 #include <list>
 
@@ -8,6 +9,8 @@
 #include "math/Vector3.h"
 #include "math/AABB.h"
 
+class VolumeTest;
+
 namespace map
 {
 
@@ -76,6 +79,16 @@ public:
 
     virtual std::size_t     getNumAreas() const = 0;
     virtual const Area&     getArea(int areaNum) const = 0;
+
+    // Returns the number of the area containing the given point, or -1 if
+    // the point is outside of all areas
+    virtual int getAreaContainingPoint(const Vector3& point) const = 0;
+
+    // Invokes the given functor for each area whose bounds intersect the given box
+    virtual void forEachAreaIntersecting(const AABB& bounds, const std::function<void(int areaNum)>& functor) const = 0;
+
+    // Invokes the given functor for each area whose bounds are (partially) inside the given volume
+    virtual void forEachVisibleArea(const VolumeTest& volume, const std::function<void(int areaNum)>& functor) const = 0;
 };
 typedef std::shared_ptr<IAasFile> IAasFilePtr;
 
@@ -144,6 +157,11 @@ public:
 
     // Returns a list of AAS files for the given map (absolute) map path
     virtual std::list<AasFileInfo> getAasFilesForMap(const std::string& mapPath) = 0;
+
+    // Loads the AAS file at the given absolute path. The parsed contents are
+    // cached on disk, such that unchanged files can be loaded faster next time.
+    // Returns an empty pointer if the file could not be loaded.
+    virtual IAasFilePtr loadAasFile(const std::string& absolutePath) = 0;
 };
 
 } // namespace
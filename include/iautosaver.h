@@ -29,12 +29,19 @@ public:
     // for the currently loaded map, regardless whether it is due for a save or not.
     // Call the "runAutosaveCheck" method to see if an autosave is overdue.
     virtual void performAutosave() = 0;
+
+    // If background saving is enabled, performAutosave() returns as soon as the
+    // scene has been copied, while the file is written on a worker thread.
+    // This blocks until such a pending save has been written to disk.
+    virtual void waitForPendingSave() = 0;
 };
 
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_ENABLED = "user/ui/map/autoSaveSnapshots";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_FOLDER = "user/ui/map/snapshotFolder";
 constexpr const char* const RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE = "user/ui/map/maxSnapshotFolderSize";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOT_FOLDER_SIZE_HISTORY = "user/ui/map/snapshotFolderSizeHistory";
+constexpr const char* const RKEY_AUTOSAVE_IN_BACKGROUND = "user/ui/map/autoSaveInBackground";
+constexpr const char* const RKEY_AUTOSAVE_JOURNAL_ENABLED = "user/ui/map/autoSaveJournal";
 
 }
 
@@ -83,9 +83,10 @@ public:
 	virtual std::size_t getNumFrames() const = 0;
 
 	/**
-	 * Returns the float values of the given frame index.
+	 * Writes the float values of the given frame index to the given array,
+	 * which is resized to hold one value per animated component.
 	 */
-	virtual const FrameKeys& getFrameKeys(std::size_t index) const = 0;
+	virtual void getFrameKeys(std::size_t index, FrameKeys& keys) const = 0;
 };
 typedef std::shared_ptr<IMD5Anim> IMD5AnimPtr;
 
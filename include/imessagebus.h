@@ -1,7 +1,10 @@
 #pragma once
 
 #include <string>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace radiant
 {
@@ -59,6 +62,7 @@ public:
         GridSnapRequest,
         FocusMaterialRequest,
         TextureToolRequest,
+        AutomaticMapSaveFinished,
 
         UserDefinedMessagesGoHigherThanThis = 999,
     };
@@ -95,6 +99,42 @@ public:
      * a given message type and must have been acquired using getChannelId() beforehand.
      */
     virtual void sendMessage(IMessage& message) = 0;
+
+    /**
+     * Queue the given message for delivery on the main thread. This can be called
+     * from any thread and never blocks, the listeners are invoked the next time
+     * processPostedMessages() is called. Messages are delivered in posting order
+     * (per posting thread).
+     */
+    virtual void postMessage(std::unique_ptr<IMessage> message) = 0;
+
+    /**
+     * Delivers all posted messages to their listeners. Must be called on the main thread.
+     * Returns the number of processed messages.
+     */
+    virtual std::size_t processPostedMessages() = 0;
+
+    /**
+     * Sets the function that is invoked when posted messages are waiting in the queue,
+     * called from the posting thread. The function is supposed to arrange for
+     * processPostedMessages() to be called on the main thread (e.g. through the
+     * UI event loop). Pass an empty function to remove it.
+     */
+    virtual void setPostedMessageNotifier(const std::function<void()>& notifier) = 0;
+
+    struct ChannelStatistics
+    {
+        std::size_t messageType;
+        std::size_t numListeners;
+        std::size_t numDispatches;
+        std::chrono::nanoseconds totalDispatchTime;
+        std::chrono::nanoseconds maxDispatchTime;
+    };
+
+    /**
+     * Returns the dispatch timings of every channel that had listeners at some point.
+     */
+    virtual std::vector<ChannelStatistics> getChannelStatistics() const = 0;
 };
 
 /**
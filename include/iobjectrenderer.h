@@ -4,6 +4,7 @@
 #include <vector>
 #include "igl.h"
 #include "igeometrystore.h"
+#include "math/Matrix4.h"
 
 namespace render
 {
@@ -17,6 +18,18 @@ class IRenderableObject;
 class IObjectRenderer
 {
 public:
+    // Number of draw calls issued since the last resetStatistics() call
+    struct Statistics
+    {
+        std::size_t drawCalls = 0;
+
+        // Draw calls that rendered more than one object at once
+        std::size_t instancedDrawCalls = 0;
+
+        // Number of objects drawn through the instanced calls
+        std::size_t instances = 0;
+    };
+
     virtual ~IObjectRenderer() {}
 
     // Sets up the renderer. Must be called before submitting any geometry
@@ -25,6 +38,11 @@ public:
     // Draws the given object, sets up transform and submits geometry
     virtual void submitObject(IRenderableObject& object) = 0;
 
+    // Draws the geometry of the given slot once per transform, in a single call if the
+    // hardware supports it. Only valid in passes without GLSL program and without lighting,
+    // textured defines whether the bound texture of unit 0 is applied.
+    virtual void submitInstancedObjects(IGeometryStore::Slot slot, const std::vector<const Matrix4*>& transforms, bool textured) = 0;
+
     // Draws the geometry of the given slot in the given primitive mode, no transforms
     virtual void submitGeometry(IGeometryStore::Slot slot, GLenum primitiveMode) = 0;
 
@@ -43,6 +61,9 @@ public:
     // Draws the geometry with a custom set of indices
     virtual void submitGeometryWithCustomIndices(IGeometryStore::Slot slot, GLenum primitiveMode,
         const std::vector<unsigned int>& indices) = 0;
+
+    virtual const Statistics& getStatistics() const = 0;
+    virtual void resetStatistics() = 0;
 };
 
 }
@@ -8,6 +8,7 @@ class BasicVector3;
 typedef BasicVector3<double> Vector3;
 
 constexpr const char* const RKEY_HIGHER_ENTITY_PRIORITY = "user/ui/xyview/higherEntitySelectionPriority";
+constexpr const char* const RKEY_PARALLEL_SELECTION_TESTS = "user/ui/xyview/parallelSelectionTests";
 
 // Possible orientations of the orthogonal view window
 enum class OrthoOrientation
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "iradiant.h"
+
+namespace profiling
+{
+
+/**
+ * Central recorder of profiling spans. A span is a named interval of time
+ * on a single thread, spans started within another span's scope on the same
+ * thread are nested below it.
+ *
+ * Recording is disabled by default (it can be enabled at startup using the
+ * --profile command line switch), in which case spans cost no more than a
+ * check of the enabled flag. Use the ScopedSpan class in profiling/ScopedSpan.h
+ * to instrument code. All methods are safe to call from any thread.
+ */
+class IProfiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~IProfiler() {}
+
+    // Returns true if spans are being recorded right now
+    virtual bool isEnabled() const = 0;
+
+    // Starts or stops recording spans. Spans recorded so far are kept.
+    virtual void setEnabled(bool enabled) = 0;
+
+    // Stores a finished span of the calling thread
+    virtual void recordSpan(std::string_view name, Clock::time_point start, Clock::time_point end) = 0;
+
+    // Discards all recorded spans
+    virtual void clear() = 0;
+
+    // Returns the number of spans recorded since the last clear()
+    virtual std::size_t getNumRecordedSpans() const = 0;
+
+    // Writes the recorded spans in the Chrome trace event format (JSON),
+    // which can be opened in chrome://tracing or ui.perfetto.dev
+    virtual void writeChromeTrace(std::ostream& stream) const = 0;
+};
+
+}
+
+// Shortcut to the profiler owned by the radiant core
+inline profiling::IProfiler& GlobalProfiler()
+{
+    return GlobalRadiantCore().getProfiler();
+}
@@ -9,6 +9,7 @@ const char* const MODULE_RADIANT_CORE("RadiantCore");
 
 namespace applog { class ILogWriter;  }
 namespace language { class ILanguageManager; } // see "i18n.h"
+namespace profiling { class IProfiler; } // see "iprofiler.h"
 
 namespace radiant
 {
@@ -52,6 +53,12 @@ public:
      */
     virtual language::ILanguageManager& getLanguageManager() = 0;
 
+    /**
+     * Get a reference to the profiler recording the spans
+     * of all threads and modules.
+     */
+    virtual profiling::IProfiler& getProfiler() = 0;
+
     /**
      * Loads and initialises all modules, starting up the 
      * application. Might throw a StartupFailure exception
@@ -5,6 +5,7 @@
 #include "iwindingrenderer.h"
 #include "igeometryrenderer.h"
 #include "isurfacerenderer.h"
+#include <array>
 #include <functional>
 
 #include "math/Vector3.h"
@@ -534,9 +535,82 @@ public:
     virtual ~IRenderResult() {}
 
     virtual std::string toString() = 0;
+
+    // The number of GL draw calls issued for this frame
+    virtual std::size_t getDrawCalls() { return 0; }
+
+    // The number of draw calls that rendered several instances of the same geometry
+    virtual std::size_t getInstancedDrawCalls() { return 0; }
+};
+
+// The phases of a rendered frame, used to break down the time spent per frame
+enum class RenderPass
+{
+    FrontEnd = 0,       // Renderable collection, from startFrame() until the back end is invoked
+    ShaderPreparation,  // Shaders submitting their geometry to the store
+    GeometryUpload,     // Synchronisation of the geometry store with the buffer objects
+    LightCollection,    // Lighting mode: surfaces touched by each visible light
+    ShadowMap,          // Lighting mode: shadow map rendering
+    DepthFill,          // Lighting mode: depth fill pass
+    Interaction,        // Lighting mode: light/surface interactions
+    NonInteraction,     // Lighting mode: non-interaction stages like skyboxes or blend stages
+    BlendLight,         // Lighting mode: blend lights
+    FullBright,         // Fullbright mode: all sorted shader passes
+    Text,               // Text renderers
+    NumPasses,
+};
+
+inline const char* getRenderPassName(RenderPass pass)
+{
+    switch (pass)
+    {
+    case RenderPass::FrontEnd: return "Front end";
+    case RenderPass::ShaderPreparation: return "Shader preparation";
+    case RenderPass::GeometryUpload: return "Geometry upload";
+    case RenderPass::LightCollection: return "Light collection";
+    case RenderPass::ShadowMap: return "Shadow map";
+    case RenderPass::DepthFill: return "Depth fill";
+    case RenderPass::Interaction: return "Interaction";
+    case RenderPass::NonInteraction: return "Non-interaction";
+    case RenderPass::BlendLight: return "Blend light";
+    case RenderPass::FullBright: return "Fullbright";
+    case RenderPass::Text: return "Text";
+    default: return "";
+    }
+}
+
+/**
+ * Time spent in each pass of the most recently rendered frame, in milliseconds.
+ * Passes not executed in that frame are reported as negative values.
+ *
+ * GPU times are measured using timer queries, their results are collected
+ * without stalling the pipeline and therefore stem from a frame rendered
+ * slightly earlier. They are negative if timer queries are not supported.
+ */
+struct RenderPassTimings
+{
+    std::array<double, static_cast<std::size_t>(RenderPass::NumPasses)> cpu;
+    std::array<double, static_cast<std::size_t>(RenderPass::NumPasses)> gpu;
+
+    RenderPassTimings()
+    {
+        cpu.fill(-1);
+        gpu.fill(-1);
+    }
+
+    double getCpuTime(RenderPass pass) const
+    {
+        return cpu[static_cast<std::size_t>(pass)];
+    }
+
+    double getGpuTime(RenderPass pass) const
+    {
+        return gpu[static_cast<std::size_t>(pass)];
+    }
 };
 
 constexpr const char* const RKEY_ENABLE_SHADOW_MAPPING = "user/ui/renderSystem/enableShadowMapping";
+constexpr const char* const RKEY_PERSISTENT_GEOMETRY_BUFFERS = "user/ui/renderSystem/persistentGeometryBuffers";
 
 /**
  * \brief
@@ -689,6 +763,14 @@ public:
 
 	// Subscription to get notified as soon as the openGL extensions have been initialised
 	virtual sigc::signal<void> signal_extensionsInitialised() = 0;
+
+    // Enables or disables the measurement of the time spent in each render pass.
+    // Disabled by default, it can be toggled using the ToggleRenderPassTimings command.
+    virtual void setPassTimingsEnabled(bool enabled) = 0;
+    virtual bool getPassTimingsEnabled() const = 0;
+
+    // Returns the pass timings of the most recent frame rendered for the given view type
+    virtual RenderPassTimings getPassTimings(RenderViewType viewType) const = 0;
 };
 typedef std::shared_ptr<RenderSystem> RenderSystemPtr;
 typedef std::weak_ptr<RenderSystem> RenderSystemWeakPtr;
@@ -16,6 +16,35 @@ struct ExecutionResult
 };
 typedef std::shared_ptr<ExecutionResult> ExecutionResultPtr;
 
+/**
+ * A script running on a worker thread, started by
+ * IScriptingSystem::executeStringAsync().
+ */
+class IAsyncScriptExecution
+{
+public:
+	using Ptr = std::shared_ptr<IAsyncScriptExecution>;
+
+	virtual ~IAsyncScriptExecution() {}
+
+	// The progress fraction [0..1] and text as last reported by the script
+	virtual float getProgress() const = 0;
+	virtual std::string getProgressText() const = 0;
+
+	virtual bool isFinished() const = 0;
+
+	// Requests the script to stop, by raising a KeyboardInterrupt in it
+	virtual void cancel() = 0;
+
+	// Runs the commands the script queued for execution so far, as one undoable
+	// operation. Must be called from the main thread, periodically while the script is running.
+	virtual void processPendingCommands() = 0;
+
+	// Blocks until the script has finished, processing its pending commands in the meantime.
+	// Must be called from the main thread.
+	virtual ExecutionResultPtr waitForResult() = 0;
+};
+
 // Declared in iscriptinterface.h
 class IScriptInterface;
 typedef std::shared_ptr<IScriptInterface> IScriptInterfacePtr;
@@ -59,6 +88,19 @@ public:
 	 */
 	virtual script::ExecutionResultPtr executeString(const std::string& scriptString) = 0;
 
+	/**
+	 * Runs the given python script string on a worker thread, without blocking the caller.
+	 *
+	 * The script cannot access the live scene, it is provided with a read-only
+	 * snapshot of the scene as taken at the time of this call ("Snapshot").
+	 * Apart from that, only the math types (Vector2, Vector3, Vector4, AABB) are available.
+	 * Progress is reported through "AsyncScript.reportProgress(fraction, text)",
+	 * cancellation can be checked using "AsyncScript.isCancelled()". Commands passed to
+	 * "AsyncScript.executeCommand(statement)" are queued and executed on the main thread
+	 * when the returned object's processPendingCommands() is called.
+	 */
+	virtual IAsyncScriptExecution::Ptr executeStringAsync(const std::string& scriptString) = 0;
+
 	/**
 	 * Iterate over all available script commands, invoking the given functor.
 	 */
@@ -234,6 +234,9 @@ public:
   virtual void TestTriangles(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) = 0;
   virtual void TestQuads(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) = 0;
   virtual void TestQuadStrip(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) = 0;
+
+  // Returns an independent copy of this test, to be used on a different thread
+  virtual std::shared_ptr<SelectionTest> clone() const = 0;
 };
 typedef std::shared_ptr<SelectionTest> SelectionTestPtr;
 
@@ -0,0 +1,13 @@
+#version 130
+
+// Sampler bound to texture unit 0
+uniform sampler2D u_Diffuse;
+
+// Whether the current shader pass has texturing enabled
+uniform bool u_UseTexture;
+
+void main()
+{
+    // Modulate the texture with the pass colour, like GL_MODULATE does
+    gl_FragColor = u_UseTexture ? texture(u_Diffuse, gl_TexCoord[0].st) * gl_Color : gl_Color;
+}
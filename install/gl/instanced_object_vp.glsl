@@ -0,0 +1,15 @@
+#version 130
+
+in mat4 attr_ObjectTransform; // per-instance object transform, bound to attributes 4 to 7 in source
+
+void main()
+{
+    // Same as the fixed-function pipeline, with the object transform taken from the instance data
+    gl_Position = gl_ModelViewProjectionMatrix * attr_ObjectTransform * gl_Vertex;
+
+    // Apply the fixed-function texture matrix of unit 0
+    gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;
+
+    // Surfaces don't use vertex colours, this is the colour of the shader pass
+    gl_FrontColor = gl_Color;
+}
@@ -477,3 +477,27 @@ print(GlobalLayerManager.layerIsVisible(1))
 
 GlobalLayerManager.setSelected(0, True)
 GlobalLayerManager.moveSelectionToLayer(1)
+
+# Bulk scene access, all data is returned as numpy arrays
+entities = GlobalBulkScene.getEntityKeyValues()
+print('Entities: {0}, spawnargs: {1}'.format(len(entities['nodes']), len(entities['keys'])))
+
+brushes = GlobalBulkScene.getBrushFaces()
+print('Brushes: {0}, faces: {1}, shaders: {2}'.format(len(brushes['nodes']), brushes['planes'].shape[0], len(brushes['shaderNames'])))
+
+# Replace all caulk faces facing upwards with a different material in one undoable step
+if 'textures/common/caulk' in brushes['shaderNames']:
+    caulk = brushes['shaderNames'].index('textures/common/caulk')
+    brushes['shaderNames'].append('textures/common/nodraw')
+    facingUp = brushes['planes'][:, 2] > 0.99
+    brushes['shaderIndices'][facingUp & (brushes['shaderIndices'] == caulk)] = len(brushes['shaderNames']) - 1
+    GlobalBulkScene.setBrushFaceShaders(brushes['nodes'], brushes['shaderIndices'], brushes['shaderNames'])
+
+# Lift all patches by 8 units
+patches = GlobalBulkScene.getPatchControlNets()
+patches['vertices'][:, 2] += 8
+GlobalBulkScene.setPatchControlNets(patches['nodes'], patches['vertices'])
+
+# Tag all lights
+lights = [node for node, classname in zip(entities['nodes'], entities['classnames']) if classname == 'light']
+GlobalBulkScene.setEntityKeyValues(lights, ['bulk_test'] * len(lights), ['1'] * len(lights))
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "imessagebus.h"
+
+namespace map
+{
+
+/**
+ * Posted by the auto saver after a background save has been written,
+ * delivered on the main thread.
+ */
+class AutomaticMapSaveFinished :
+    public radiant::IMessage
+{
+private:
+    std::string _filename;
+    std::string _errorMessage;
+
+public:
+    AutomaticMapSaveFinished(const std::string& filename, const std::string& errorMessage) :
+        _filename(filename),
+        _errorMessage(errorMessage)
+    {}
+
+    std::size_t getId() const override
+    {
+        return Type::AutomaticMapSaveFinished;
+    }
+
+    const std::string& getFilename() const
+    {
+        return _filename;
+    }
+
+    // TRUE if the file has been written without errors
+    bool isSuccessful() const
+    {
+        return _errorMessage.empty();
+    }
+
+    const std::string& getErrorMessage() const
+    {
+        return _errorMessage;
+    }
+};
+
+}
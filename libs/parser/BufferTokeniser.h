@@ -0,0 +1,217 @@
+#pragma once
+
+#include <charconv>
+#include <istream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "DefTokeniser.h"
+#include "string/convert.h"
+
+namespace parser
+{
+
+/**
+ * DefTokeniser reading the whole input into a contiguous buffer first.
+ * Tokens can be retrieved as views into that buffer and numbers are
+ * converted in place using std::from_chars, without constructing any
+ * intermediate strings. Meant for large, mostly numeric files like
+ * md5 meshes and anims or AAS files.
+ *
+ * The tokens are split the same way as the BasicDefTokeniser does by
+ * default: on whitespace, with the braces and parentheses returned as
+ * separate tokens, quoted content being preserved and C/C++ style comments
+ * being ignored. Escape sequences and string continuations in quoted
+ * content are not processed.
+ */
+class BufferTokeniser :
+    public DefTokeniser
+{
+private:
+    std::string _buffer;
+
+    // Always pointing at the start of the next token (or at the end)
+    const char* _pos;
+    const char* _end;
+
+public:
+    // Reads the remaining contents of the given stream
+    explicit BufferTokeniser(std::istream& stream) :
+        BufferTokeniser(std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()))
+    {}
+
+    explicit BufferTokeniser(std::string buffer) :
+        _buffer(std::move(buffer)),
+        _pos(_buffer.data()),
+        _end(_buffer.data() + _buffer.size())
+    {
+        skipWhitespaceAndComments();
+    }
+
+    bool hasMoreTokens() const override
+    {
+        return _pos != _end;
+    }
+
+    std::string nextToken() override
+    {
+        return std::string(nextTokenView());
+    }
+
+    void assertNextToken(const std::string& val) override
+    {
+        assertNextToken(val.c_str());
+    }
+
+    // Non-allocating variant for string literals
+    void assertNextToken(const char* val)
+    {
+        auto token = nextTokenView();
+
+        if (token != val)
+        {
+            throw ParseException("BufferTokeniser: Assertion failed: Required \"" +
+                std::string(val) + "\", found \"" + std::string(token) + "\"");
+        }
+    }
+
+    void skipTokens(unsigned int n) override
+    {
+        for (unsigned int i = 0; i < n; ++i)
+        {
+            nextTokenView();
+        }
+    }
+
+    std::string peek() const override
+    {
+        if (!hasMoreTokens())
+        {
+            throw ParseException("BufferTokeniser: no more tokens");
+        }
+
+        auto pos = _pos;
+        return std::string(readToken(pos));
+    }
+
+    // Returns the next token as view into the buffer, valid as long as this tokeniser exists
+    std::string_view nextTokenView()
+    {
+        if (!hasMoreTokens())
+        {
+            throw ParseException("BufferTokeniser: no more tokens");
+        }
+
+        auto token = readToken(_pos);
+        skipWhitespaceAndComments();
+
+        return token;
+    }
+
+    // Converts the next token to the given arithmetic type. Tokens which
+    // are not a number are converted to 0, like string::convert would do.
+    template<typename T>
+    T nextNumber()
+    {
+        auto token = nextTokenView();
+
+        T value = 0;
+        auto result = std::from_chars(token.data(), token.data() + token.size(), value);
+
+        if (result.ec == std::errc() && result.ptr == token.data() + token.size())
+        {
+            return value;
+        }
+
+        // Fall back to the stream-based conversion for anything
+        // from_chars doesn't accept (like a leading + sign)
+        return string::convert<T>(std::string(token));
+    }
+
+private:
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\r';
+    }
+
+    static bool isKeptDelimiter(char c)
+    {
+        return c == '{' || c == '}' || c == '(' || c == ')';
+    }
+
+    bool isCommentStart(const char* pos) const
+    {
+        return *pos == '/' && pos + 1 != _end && (pos[1] == '/' || pos[1] == '*');
+    }
+
+    std::string_view readToken(const char*& pos) const
+    {
+        auto start = pos;
+
+        if (isKeptDelimiter(*pos))
+        {
+            return std::string_view(start, ++pos - start);
+        }
+
+        if (*pos == '"')
+        {
+            ++start;
+
+            for (++pos; pos != _end && *pos != '"'; ++pos) {}
+
+            std::string_view token(start, pos - start);
+
+            if (pos != _end)
+            {
+                ++pos; // skip the closing quote
+            }
+
+            return token;
+        }
+
+        while (pos != _end && !isWhitespace(*pos) && !isKeptDelimiter(*pos) &&
+               *pos != '"' && !isCommentStart(pos))
+        {
+            ++pos;
+        }
+
+        return std::string_view(start, pos - start);
+    }
+
+    void skipWhitespaceAndComments()
+    {
+        while (_pos != _end)
+        {
+            if (isWhitespace(*_pos))
+            {
+                ++_pos;
+            }
+            else if (isCommentStart(_pos))
+            {
+                if (_pos[1] == '/')
+                {
+                    // Line comment, skip to the end of the line
+                    for (_pos += 2; _pos != _end && *_pos != '\n'; ++_pos) {}
+                }
+                else
+                {
+                    // Delimited comment, skip past the closing */
+                    for (_pos += 2; _pos != _end; ++_pos)
+                    {
+                        if (*_pos == '*' && _pos + 1 != _end && _pos[1] == '/')
+                        {
+                            _pos += 2;
+                            break;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                return;
+            }
+        }
+    }
+};
+
+}
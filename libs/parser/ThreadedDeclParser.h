@@ -4,6 +4,7 @@
 #include "itextstream.h"
 #include "idecltypes.h"
 #include "debugging/ScopedDebugTimer.h"
+#include "profiling/ScopedSpan.h"
 #include "parser/ParseException.h"
 #include "parser/ThreadedDefLoader.h"
 
@@ -76,6 +77,7 @@ protected:
     void processFiles()
     {
         ScopedDebugTimer timer("[DeclParser] Parsed " + decl::getTypeName(_declType) + " declarations");
+        profiling::ScopedSpan span("Parse " + decl::getTypeName(_declType) + " declarations");
 
         // Accumulate all the files and sort them before calling the protected parse() method
         std::vector<vfs::FileInfo> _incomingFiles;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <optional>
+#include "iprofiler.h"
+
+namespace profiling
+{
+
+/**
+ * Records a profiling span covering the lifetime of this object, e.g.
+ *
+ *   profiling::ScopedSpan span("MapResource::load");
+ *
+ * If the profiler is disabled when the span is constructed, nothing is recorded
+ * and the name is not copied.
+ */
+class ScopedSpan
+{
+private:
+    IProfiler& _profiler;
+
+    std::optional<std::string> _name;
+    IProfiler::Clock::time_point _start;
+
+public:
+    ScopedSpan(std::string_view name) :
+        ScopedSpan(GlobalProfiler(), name)
+    {}
+
+    // Overload to use within the core, before the module registry is available
+    ScopedSpan(IProfiler& profiler, std::string_view name) :
+        _profiler(profiler)
+    {
+        if (_profiler.isEnabled())
+        {
+            _name = name;
+            _start = IProfiler::Clock::now();
+        }
+    }
+
+    ScopedSpan(const ScopedSpan& other) = delete;
+    ScopedSpan& operator=(const ScopedSpan& other) = delete;
+
+    ~ScopedSpan()
+    {
+        if (_name)
+        {
+            _profiler.recordSpan(*_name, _start, IProfiler::Clock::now());
+        }
+    }
+};
+
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <stack>
 #include <limits>
 #include <vector>
@@ -30,6 +32,10 @@ struct BufferTransaction
  *
  * Use the allocate/deallocate methods to acquire or release a chunk of
  * a certain size. The chunk size is fixed and cannot be changed.
+ *
+ * Deallocated chunks leave gaps which are re-used by later allocations.
+ * The compact() method can be used to move the allocated chunks together,
+ * the handles stay valid, only the chunk offsets change.
  */
 template<typename ElementType>
 class ContinuousBuffer
@@ -86,19 +92,45 @@ private:
 
     std::size_t _allocatedElements;
 
+    // Compaction never shrinks the buffer below this size
+    std::size_t _initialSize;
+
+    // Number of elements deallocated since the last completed compaction
+    std::size_t _releasedElements;
+
 public:
+    // Memory usage, all sizes in number of elements
+    struct MemoryStatistics
+    {
+        std::size_t bufferSize = 0;
+        std::size_t allocatedElements = 0;  // reserved by the occupied slots
+        std::size_t usedElements = 0;       // actually filled with data
+        std::size_t freeElements = 0;
+        std::size_t numFreeBlocks = 0;
+        std::size_t largestFreeBlock = 0;
+
+        // 0 if all free space is available in a single block, approaching 1 for scattered gaps
+        double getFragmentation() const
+        {
+            return freeElements > 0 ? 1.0 - static_cast<double>(largestFreeBlock) / freeElements : 0.0;
+        }
+    };
+
     ContinuousBuffer(std::size_t initialSize = DefaultInitialSize) :
         _lastSyncedBufferSize(0),
-        _allocatedElements(0)
+        _allocatedElements(0),
+        _releasedElements(0)
     {
         // Pre-allocate some memory, but don't go all the way down to zero
         _buffer.resize(initialSize == 0 ? 16 : initialSize);
+        _initialSize = _buffer.size();
 
         // The initial slot info which is going to be cut into pieces
         createSlotInfo(0, _buffer.size());
     }
 
-    ContinuousBuffer(const ContinuousBuffer& other)
+    ContinuousBuffer(const ContinuousBuffer& other) :
+        _lastSyncedBufferSize(0)
     {
         *this = other;
     }
@@ -115,6 +147,8 @@ public:
         _emptySlots = other._emptySlots;
         _unsyncedModifications = other._unsyncedModifications;
         _allocatedElements = other._allocatedElements;
+        _initialSize = other._initialSize;
+        _releasedElements = other._releasedElements;
 
         return *this;
     }
@@ -172,6 +206,159 @@ public:
         return total;
     }
 
+    MemoryStatistics getMemoryStatistics() const
+    {
+        MemoryStatistics stats;
+
+        stats.bufferSize = _buffer.size();
+        stats.allocatedElements = _allocatedElements;
+
+        for (const auto& slot : _slots)
+        {
+            if (slot.Occupied)
+            {
+                stats.usedElements += slot.Used;
+            }
+            else if (slot.Size > 0)
+            {
+                stats.freeElements += slot.Size;
+                stats.largestFreeBlock = std::max(stats.largestFreeBlock, slot.Size);
+                ++stats.numFreeBlocks;
+            }
+        }
+
+        return stats;
+    }
+
+    // The number of elements released since the last completed compact() run
+    std::size_t getNumReleasedElements() const
+    {
+        return _releasedElements;
+    }
+
+    /**
+     * Moves the occupied slots towards the start of the buffer, merging all gaps
+     * into a single free block at the end. Once everything is in place, the buffer
+     * is shrunk if the data occupies less than a quarter of it.
+     *
+     * To spread the work over several calls, this stops after moving approximately
+     * maxElementsToMove elements (at least one slot is always moved). The next call
+     * continues with the remaining gaps. The given callback is invoked for every
+     * slot that has been moved, along with its number of used elements.
+     *
+     * Returns true when the buffer is fully compacted.
+     */
+    bool compact(std::size_t maxElementsToMove, const std::function<void(Handle, std::size_t)>& onSlotMoved = {})
+    {
+        // Visit all slots with a non-zero size in the order of their offset
+        // (zero-sized occupied slots are recycled handles)
+        std::vector<Handle> slotsByOffset;
+        slotsByOffset.reserve(_slots.size());
+
+        for (Handle handle = 0; handle < _slots.size(); ++handle)
+        {
+            const auto& slot = _slots[handle];
+
+            if (slot.Size > 0 || !slot.Occupied)
+            {
+                slotsByOffset.push_back(handle);
+            }
+        }
+
+        std::sort(slotsByOffset.begin(), slotsByOffset.end(), [&](Handle a, Handle b)
+        {
+            return _slots[a].Offset < _slots[b].Offset;
+        });
+
+        std::vector<Handle> freeSlots;
+        std::size_t writeOffset = 0;
+        std::size_t movedElements = 0;
+        auto gapEnd = _buffer.size();
+        auto finished = true;
+
+        for (auto handle : slotsByOffset)
+        {
+            auto& slot = _slots[handle];
+
+            if (!slot.Occupied)
+            {
+                freeSlots.push_back(handle);
+                continue;
+            }
+
+            if (slot.Offset != writeOffset)
+            {
+                if (movedElements > 0 && movedElements + slot.Used > maxElementsToMove)
+                {
+                    // Out of budget, leave the rest for the next call
+                    gapEnd = slot.Offset;
+                    finished = false;
+                    break;
+                }
+
+                // Moving to the left, the ranges are allowed to overlap
+                std::move(_buffer.begin() + slot.Offset, _buffer.begin() + slot.Offset + slot.Used,
+                    _buffer.begin() + writeOffset);
+
+                slot.Offset = writeOffset;
+                movedElements += slot.Used;
+
+                _unsyncedModifications.emplace_back(ModifiedMemoryChunk{ handle, 0, slot.Used });
+
+                if (onSlotMoved)
+                {
+                    onSlotMoved(handle, slot.Used);
+                }
+            }
+
+            writeOffset += slot.Size;
+        }
+
+        if (finished)
+        {
+            _releasedElements = 0;
+
+            // Give memory back if most of the buffer is unused
+            if (writeOffset < _buffer.size() / 4 && _buffer.size() > _initialSize)
+            {
+                auto newSize = std::max(_initialSize, writeOffset * 2);
+
+                std::vector<ElementType> shrunkBuffer(_buffer.begin(), _buffer.begin() + newSize);
+                _buffer.swap(shrunkBuffer);
+
+                gapEnd = newSize;
+            }
+        }
+
+        // All free slots passed so far are replaced by a single one filling the gap
+        for (auto handle : freeSlots)
+        {
+            auto& slot = _slots[handle];
+            slot.Size = 0;
+            slot.Used = 0;
+
+            if (gapEnd > writeOffset)
+            {
+                slot.Offset = writeOffset;
+                slot.Size = gapEnd - writeOffset;
+                gapEnd = writeOffset; // don't assign the gap twice
+                continue;
+            }
+
+            // The handle goes to recycling, block it against future use
+            slot.Occupied = true;
+            _emptySlots.push(handle);
+        }
+
+        if (gapEnd > writeOffset)
+        {
+            // There was no free slot to re-use
+            createSlotInfo(writeOffset, gapEnd - writeOffset);
+        }
+
+        return finished;
+    }
+
     void setData(Handle handle, const std::vector<ElementType>& elements)
     {
         auto& slot = _slots[handle];
@@ -228,6 +415,7 @@ public:
         releasedSlot.Used = 0;
 
         _allocatedElements -= releasedSlot.Size;
+        _releasedElements += releasedSlot.Size;
 
         // Check if the slot can merge with an adjacent one
         Handle slotIndexToMerge = std::numeric_limits<Handle>::max();
@@ -276,10 +464,10 @@ public:
             return;
         }
 
-        // Ensure the buffer is at least the same size
+        // Ensure the buffer has the same size (it might have been shrunk by compaction)
         auto otherSize = other._buffer.size();
 
-        if (otherSize > _buffer.size())
+        if (otherSize != _buffer.size())
         {
             _buffer.resize(otherSize);
         }
@@ -303,6 +491,7 @@ public:
         memcpy(_slots.data(), other._slots.data(), other._slots.size() * sizeof(SlotInfo));
 
         _allocatedElements = other._allocatedElements;
+        _releasedElements = other._releasedElements;
         _emptySlots = other._emptySlots;
     }
 
@@ -24,7 +24,8 @@ private:
         IndexRemap = 1,
     };
 
-    static constexpr auto NumFrameBuffers = 1;
+    // Number of elements moved per frame when compacting the buffers
+    static constexpr std::size_t CompactionElementsPerFrame = 32768;
 
     // Represents the storage for a single frame
     struct FrameBuffer
@@ -53,6 +54,27 @@ private:
             indices.syncModificationsToBufferObject(indexBufferObject);
         }
 
+        // Moves a portion of the data to close the gaps left by deallocations,
+        // the moved slots are logged to be replicated to the other frame buffers.
+        void compact()
+        {
+            if (NeedsCompaction(vertices))
+            {
+                vertices.compact(CompactionElementsPerFrame, [this](std::uint32_t handle, std::size_t numElements)
+                {
+                    recordVertexTransaction(GetSlot(SlotType::Regular, handle, 0), 0, numElements);
+                });
+            }
+
+            if (NeedsCompaction(indices))
+            {
+                indices.compact(CompactionElementsPerFrame, [this](std::uint32_t handle, std::size_t numElements)
+                {
+                    recordIndexTransaction(GetSlot(SlotType::Regular, 0, handle), 0, numElements);
+                });
+            }
+        }
+
         void recordVertexTransaction(Slot slot, std::size_t offset, std::size_t numChangedElements)
         {
             vertexTransactionLog.emplace_back(detail::BufferTransaction
@@ -70,18 +92,21 @@ private:
         }
     };
 
-    // We keep a fixed number of frame buffers
+    // We keep a fixed number of frame buffers, one per frame in flight
     std::vector<FrameBuffer> _frameBuffers;
     unsigned int _currentBuffer;
 
     ISyncObjectProvider& _syncObjectProvider;
+    IBufferObjectProvider& _bufferObjectProvider;
 
 public:
-    GeometryStore(ISyncObjectProvider& syncObjectProvider, IBufferObjectProvider& bufferObjectProvider) :
+    GeometryStore(ISyncObjectProvider& syncObjectProvider, IBufferObjectProvider& bufferObjectProvider,
+                  std::size_t numFrameBuffers = 1) :
         _currentBuffer(0),
-        _syncObjectProvider(syncObjectProvider)
+        _syncObjectProvider(syncObjectProvider),
+        _bufferObjectProvider(bufferObjectProvider)
     {
-        _frameBuffers.resize(NumFrameBuffers);
+        _frameBuffers.resize(numFrameBuffers);
 
         // Assign (empty) buffer objects to the frames
         for (auto& frameBuffer : _frameBuffers)
@@ -91,10 +116,54 @@ public:
         }
     }
 
+    std::size_t getNumFrameBuffers() const
+    {
+        return _frameBuffers.size();
+    }
+
+    /**
+     * Changes the number of frame buffers, keeping the stored data. All frames start
+     * out with new buffer objects acquired from the buffer object provider. Using more
+     * than one frame buffer allows for writing data while the GPU is still reading
+     * the previous frames, as required by persistently mapped buffer objects.
+     * Must not be called between onFrameStart() and onFrameFinished().
+     */
+    void setNumFrameBuffers(std::size_t numFrameBuffers)
+    {
+        assert(numFrameBuffers > 0);
+
+        // Wait for all pending frames, their buffer objects are about to be released
+        for (auto& frameBuffer : _frameBuffers)
+        {
+            if (frameBuffer.syncObject)
+            {
+                frameBuffer.syncObject->wait();
+            }
+        }
+
+        // The current buffer has seen all modifications, it serves as template for all frames
+        FrameBuffer& current = getCurrentBuffer();
+
+        std::vector<FrameBuffer> frameBuffers(numFrameBuffers);
+
+        for (auto& frameBuffer : frameBuffers)
+        {
+            frameBuffer.vertices = current.vertices;
+            frameBuffer.indices = current.indices;
+            frameBuffer.vertexBufferObject = _bufferObjectProvider.createBufferObject(IBufferObject::Type::Vertex);
+            frameBuffer.indexBufferObject = _bufferObjectProvider.createBufferObject(IBufferObject::Type::Index);
+        }
+
+        _frameBuffers.swap(frameBuffers);
+        _currentBuffer = 0;
+    }
+
     // Marks the beginning of a frame, switches to the next writing buffers
     void onFrameStart()
     {
-        _currentBuffer = (_currentBuffer + 1) % NumFrameBuffers;
+        auto numFrameBuffers = static_cast<unsigned int>(_frameBuffers.size());
+
+        _currentBuffer = (_currentBuffer + 1) % numFrameBuffers;
         auto& current = getCurrentBuffer();
 
         // Wait for this buffer to become available
@@ -106,9 +175,9 @@ public:
 
         // Replay any modifications of all other buffers onto this one,
         // in the order they are switched through
-        for (auto bufferIndex = (_currentBuffer + 1) % NumFrameBuffers;
+        for (auto bufferIndex = (_currentBuffer + 1) % numFrameBuffers;
              bufferIndex != _currentBuffer;
-             bufferIndex = (bufferIndex + 1) % NumFrameBuffers)
+             bufferIndex = (bufferIndex + 1) % numFrameBuffers)
         {
             current.applyTransactions(_frameBuffers[bufferIndex]);
         }
@@ -116,6 +185,9 @@ public:
         // This buffer is in sync now, we can clear its log
         current.vertexTransactionLog.clear();
         current.indexTransactionLog.clear();
+
+        // Defragment the storage a bit each frame
+        current.compact();
     }
 
     std::pair<IBufferObject::Ptr, IBufferObject::Ptr> getBufferObjects() override
@@ -283,7 +355,7 @@ public:
 
         AABB bounds;
 
-        for (auto i = 0; i < numIndices; ++i, ++indexPointer)
+        for (std::size_t i = 0; i < numIndices; ++i, ++indexPointer)
         {
             const auto& v = vertex[*indexPointer].vertex;
             bounds.includePoint({ v.x(), v.y(), v.z() });
@@ -292,16 +364,25 @@ public:
         return bounds;
     }
 
+    // Memory usage of the vertex and index storage of the current frame buffer
+    std::pair<ContinuousBuffer<RenderVertex>::MemoryStatistics, ContinuousBuffer<unsigned int>::MemoryStatistics> getMemoryStatistics()
+    {
+        auto& current = getCurrentBuffer();
+        return { current.vertices.getMemoryStatistics(), current.indices.getMemoryStatistics() };
+    }
+
     void printMemoryStats()
     {
         rMessage() << "-- Geometry Store Memory --" << std::endl;
-        rMessage() << "Number of Frame Buffers: " << NumFrameBuffers << std::endl;
+        rMessage() << "Number of Frame Buffers: " << _frameBuffers.size() << std::endl;
 
-        for (auto i = 0; i < NumFrameBuffers; ++i)
+        for (std::size_t i = 0; i < _frameBuffers.size(); ++i)
         {
             rMessage() << "Frame Buffer " << i << std::endl;
             rMessage() << "  Vertices: " << string::getFormattedByteSize(_frameBuffers[i].vertices.getBufferSizeInBytes()) << std::endl;
+            PrintBufferUsage(_frameBuffers[i].vertices);
             rMessage() << "  Indices: " << string::getFormattedByteSize(_frameBuffers[i].indices.getBufferSizeInBytes()) << std::endl;
+            PrintBufferUsage(_frameBuffers[i].indices);
 
             auto logSize = _frameBuffers[i].vertexTransactionLog.capacity() + _frameBuffers[i].indexTransactionLog.capacity();
             rMessage() << "  Transaction Logs: " << string::getFormattedByteSize(logSize * sizeof(detail::BufferTransaction)) << std::endl;
@@ -309,6 +390,27 @@ public:
     }
 
 private:
+    template<typename ElementType>
+    static bool NeedsCompaction(const ContinuousBuffer<ElementType>& buffer)
+    {
+        // Wait until a reasonable amount of memory has been released
+        return buffer.getNumReleasedElements() > ContinuousBuffer<ElementType>::DefaultInitialSize / 4;
+    }
+
+    template<typename ElementType>
+    static void PrintBufferUsage(const ContinuousBuffer<ElementType>& buffer)
+    {
+        auto stats = buffer.getMemoryStatistics();
+
+        rMessage() << "    Live: " << string::getFormattedByteSize(stats.usedElements * sizeof(ElementType))
+            << ", Allocated: " << string::getFormattedByteSize(stats.allocatedElements * sizeof(ElementType))
+            << ", Buffer: " << string::getFormattedByteSize(stats.bufferSize * sizeof(ElementType)) << std::endl;
+
+        rMessage() << "    Free: " << string::getFormattedByteSize(stats.freeElements * sizeof(ElementType))
+            << " in " << stats.numFreeBlocks << " blocks, Fragmentation: "
+            << static_cast<int>(stats.getFragmentation() * 100) << "%" << std::endl;
+    }
+
     FrameBuffer& getCurrentBuffer()
     {
         return _frameBuffers[_currentBuffer];
@@ -30,13 +30,16 @@ private:
     // The render entity the adapter is attached to
     IRenderEntity* _renderEntity;
 
-    // When attached to an entity, this is the backend storage handle
-    IGeometryStore::Slot _storageLocation;
+    // When attached to an entity, this is the shader slot providing the storage handle.
+    // The handle is not cached, since surfaces can be moved to shared storage on update.
+    Shader* _storageShader;
+    ISurfaceRenderer::Slot _storageSlot;
 
 protected:
     RenderableSurface() :
         _renderEntity(nullptr),
-        _storageLocation(std::numeric_limits<IGeometryStore::Slot>::max())
+        _storageShader(nullptr),
+        _storageSlot(ISurfaceRenderer::InvalidSlot)
     {}
 
 public:
@@ -107,7 +110,8 @@ public:
 
         _renderEntity = entity;
         _renderEntity->addRenderable(shared_from_this(), shader.get());
-        _storageLocation = shader->getSurfaceStorageLocation(_shaders[shader]);
+        _storageShader = shader.get();
+        _storageSlot = _shaders[shader];
     }
 
     // Renders the surface stored in our single slot
@@ -126,8 +130,8 @@ public:
 
     IGeometryStore::Slot getStorageLocation() override
     {
-        assert(_storageLocation != std::numeric_limits<IGeometryStore::Slot>::max());
-        return _storageLocation;
+        assert(_storageShader != nullptr);
+        return _storageShader->getSurfaceStorageLocation(_storageSlot);
     }
 
 private:
@@ -139,7 +143,8 @@ private:
             _renderEntity = nullptr;
         }
 
-        _storageLocation = std::numeric_limits<IGeometryStore::Slot>::max();
+        _storageShader = nullptr;
+        _storageSlot = ISurfaceRenderer::InvalidSlot;
     }
 
     void detachFromShader(const ShaderMapping::iterator& iter)
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <charconv>
+#include <cstring>
+#include <istream>
+#include <vector>
 #include "math/Vector3.h"
 
 namespace map
@@ -16,21 +20,130 @@ private:
     // List of point positions
     Points _points;
 
+    // Size of the blocks read from the stream while parsing
+    static constexpr std::size_t ChunkSize = 1 << 16;
+
+    // Sine of the largest angle between two segments still considered collinear
+    static constexpr double CollinearEpsilon = 1e-5;
+
 public:
 
-    /// Construct a PointTrace to read point data from the given stream
-    explicit PointTrace(std::istream& stream)
+    /// Construct a PointTrace to read point data from the given stream.
+    /// If simplify is true, points in the middle of straight runs are dropped.
+    explicit PointTrace(std::istream& stream, bool simplify = false)
     {
-        // Point file consists of one point per line, with three components
-        double x, y, z;
-        while (stream >> x >> y >> z)
+        parse(stream);
+
+        if (simplify)
         {
-            _points.push_back(Vector3(x, y, z));
+            removeCollinearPoints();
         }
     }
 
     /// Return points parsed
     const Points& points() const { return _points; }
+
+    /// Move the parsed points out of this trace, leaving it empty
+    Points takePoints() { return std::move(_points); }
+
+private:
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Point file consists of one point per line, with three components.
+    // The stream is read in chunks and the numbers are converted in place,
+    // parsing stops at the first token that is not a number.
+    void parse(std::istream& stream)
+    {
+        std::vector<char> buffer(ChunkSize);
+        std::size_t filled = 0;
+
+        double coords[3];
+        std::size_t numCoords = 0;
+
+        while (true)
+        {
+            stream.read(buffer.data() + filled, static_cast<std::streamsize>(buffer.size() - filled));
+            filled += static_cast<std::size_t>(stream.gcount());
+
+            bool endOfStream = !stream;
+
+            const char* pos = buffer.data();
+            const char* end = pos + filled;
+
+            while (true)
+            {
+                while (pos != end && isWhitespace(*pos)) ++pos;
+
+                if (pos == end) break;
+
+                auto tokenEnd = pos;
+                while (tokenEnd != end && !isWhitespace(*tokenEnd)) ++tokenEnd;
+
+                // A token touching the end of the buffer might continue in the next chunk
+                if (tokenEnd == end && !endOfStream) break;
+
+                // from_chars doesn't accept a leading plus sign, unlike operator>>
+                auto numberStart = *pos == '+' ? pos + 1 : pos;
+                auto result = std::from_chars(numberStart, tokenEnd, coords[numCoords]);
+
+                if (result.ec != std::errc() || result.ptr != tokenEnd)
+                {
+                    return;
+                }
+
+                if (++numCoords == 3)
+                {
+                    _points.emplace_back(coords[0], coords[1], coords[2]);
+                    numCoords = 0;
+                }
+
+                pos = tokenEnd;
+            }
+
+            if (endOfStream) return;
+
+            // Keep the incomplete token at the front of the buffer
+            filled = static_cast<std::size_t>(end - pos);
+            std::memmove(buffer.data(), pos, filled);
+
+            if (filled == buffer.size())
+            {
+                buffer.resize(buffer.size() * 2);
+            }
+        }
+    }
+
+    // Drops all points lying on the straight line between their neighbours,
+    // the first and last point are always kept
+    void removeCollinearPoints()
+    {
+        if (_points.size() < 3) return;
+
+        std::size_t kept = 1;
+
+        for (std::size_t i = 1; i + 1 < _points.size(); ++i)
+        {
+            auto incoming = _points[i] - _points[kept - 1];
+            auto outgoing = _points[i + 1] - _points[i];
+
+            auto lengths = incoming.getLength() * outgoing.getLength();
+
+            // Duplicate points and points continuing in the same direction can go
+            bool redundant = lengths == 0 || (incoming.dot(outgoing) > 0 &&
+                incoming.cross(outgoing).getLength() <= CollinearEpsilon * lengths);
+
+            if (!redundant)
+            {
+                _points[kept++] = _points[i];
+            }
+        }
+
+        _points[kept++] = _points.back();
+        _points.resize(kept);
+    }
 };
 
-}
\ No newline at end of file
+}
@@ -133,6 +133,11 @@ public:
                       clipped, best, _cull);
         }
     }
+
+    std::shared_ptr<SelectionTest> clone() const override
+    {
+        return std::make_shared<SelectionVolume>(*this);
+    }
 };
 
 // --------------------------------------------------------------------------------
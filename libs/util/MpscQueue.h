@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace util
+{
+
+/**
+ * Unbounded lock-free queue accepting items from any number of threads,
+ * which are taken out by a single consumer thread (D. Vyukov's intrusive
+ * MPSC node queue). Pushing never blocks and never waits for the consumer.
+ *
+ * A push that is still in progress can briefly hide the items pushed after
+ * it from the consumer, tryPop() reports an empty queue in that case.
+ */
+template<typename T>
+class MpscQueue
+{
+private:
+    struct Node
+    {
+        std::atomic<Node*> next;
+        T value;
+
+        Node() : next(nullptr) {}
+        explicit Node(T&& v) : next(nullptr), value(std::move(v)) {}
+    };
+
+    // Producers append after the head, the consumer removes at the tail
+    std::atomic<Node*> _head;
+    Node* _tail;
+
+    // Placeholder node keeping the list non-empty
+    Node _stub;
+
+public:
+    MpscQueue() :
+        _head(&_stub),
+        _tail(&_stub)
+    {}
+
+    MpscQueue(const MpscQueue& other) = delete;
+    MpscQueue& operator=(const MpscQueue& other) = delete;
+
+    ~MpscQueue()
+    {
+        T discarded;
+        while (tryPop(discarded)) {}
+    }
+
+    // Can be called from any thread
+    void push(T value)
+    {
+        pushNode(new Node(std::move(value)));
+    }
+
+    // Consumer thread only. Returns false if there is nothing to take.
+    bool tryPop(T& value)
+    {
+        auto tail = _tail;
+        auto next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &_stub)
+        {
+            if (next == nullptr) return false;
+
+            // Skip the stub
+            _tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next == nullptr)
+        {
+            // The tail is the last node, unless a producer is about to link a new one
+            if (tail != _head.load(std::memory_order_acquire)) return false;
+
+            // Re-insert the stub so that the tail can be taken out
+            pushNode(&_stub);
+            next = tail->next.load(std::memory_order_acquire);
+
+            if (next == nullptr) return false;
+        }
+
+        _tail = next;
+        value = std::move(tail->value);
+        delete tail;
+
+        return true;
+    }
+
+    // Consumer thread only. Unlike tryPop() this also reports items
+    // whose push has not completed yet.
+    bool empty() const
+    {
+        return _tail == &_stub && _head.load(std::memory_order_acquire) == &_stub;
+    }
+
+private:
+    void pushNode(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        auto previous = _head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+};
+
+}
@@ -62,6 +62,7 @@ Node Document::addTopLevelNode(const std::string& name)
     _xmlDoc.remove_children();
     createDeclNode(); // remove_children also removes the decl
     auto node = _xmlDoc.append_child(name.c_str());
+    ++_changeCount;
 
     return Node(this, node);
 }
@@ -90,6 +91,7 @@ void Document::importDocument(Document& other, Node& importNode)
     for (pugi::xml_node child: other._xmlDoc.children()) {
         targetNode.append_copy(child);
     }
+    ++_changeCount;
 }
 
 void Document::copyNodes(const NodeList& nodeList)
@@ -104,6 +106,7 @@ void Document::copyNodes(const NodeList& nodeList)
     for (auto node: nodeList) {
         _xmlDoc.document_element().append_copy(node.getNodePtr());
     }
+    ++_changeCount;
 }
 
 bool Document::isValid() const
@@ -150,6 +153,11 @@ std::string Document::saveToString() const
     return stream.str();
 }
 
+std::size_t Document::getChangeCount() const
+{
+    return _changeCount;
+}
+
 std::mutex& Document::getLock() const
 {
     return _lock;
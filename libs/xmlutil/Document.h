@@ -3,6 +3,7 @@
 #include "Node.h"
 #include "pugixml/pugixml.hpp"
 
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <optional>
@@ -29,6 +30,9 @@ class Document
 
     mutable std::mutex _lock;
 
+    // Incremented by every modification, including the ones made through Nodes
+    mutable std::atomic<std::size_t> _changeCount = 0;
+
 public:
     /// Construct an empty document
     Document();
@@ -77,6 +81,10 @@ public:
     // Saves the document to a std::string and returns it
     std::string saveToString() const;
 
+    // Returns a counter which changes whenever this document is modified,
+    // either through this Document or through any of its Nodes
+    std::size_t getChangeCount() const;
+
 private:
     friend class Node;
 
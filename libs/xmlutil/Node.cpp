@@ -40,6 +40,7 @@ Node Node::createChild(const std::string& name)
 
     // Create a new child under the contained node
     auto newChild = _xmlNode.append_child(name.c_str());
+    ++_owner->_changeCount;
 
     // Create a new xml::Node out of this pointer and return it
     return Node(_owner, newChild);
@@ -71,6 +72,7 @@ void Node::setAttributeValue(const std::string& key, const std::string& value)
         attr = _xmlNode.append_attribute(key.c_str());
 
     attr.set_value(value.c_str());
+    ++_owner->_changeCount;
 }
 
 void Node::removeAttribute(const std::string& key)
@@ -78,6 +80,7 @@ void Node::removeAttribute(const std::string& key)
     std::lock_guard lock(_owner->getLock());
 
     _xmlNode.remove_attribute(key.c_str());
+    ++_owner->_changeCount;
 }
 
 std::string Node::getAttributeValue(const std::string& key) const
@@ -103,6 +106,7 @@ void Node::setContent(const std::string& content)
     std::lock_guard lock(_owner->getLock());
 
     _xmlNode.text() = content.c_str();
+    ++_owner->_changeCount;
 }
 
 void Node::addText(const std::string& text)
@@ -112,6 +116,7 @@ void Node::addText(const std::string& text)
     // Add a PCDATA node as a sibling following this node
     auto textNode = _xmlNode.parent().insert_child_after(pugi::node_pcdata, _xmlNode);
     textNode.set_value(text.c_str());
+    ++_owner->_changeCount;
 }
 
 void Node::erase()
@@ -119,6 +124,7 @@ void Node::erase()
     std::lock_guard lock(_owner->getLock());
 
     _xmlNode.parent().remove_child(_xmlNode);
+    ++_owner->_changeCount;
 }
 
 pugi::xml_node Node::getNodePtr() const
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cassert>
+#include <cstdlib>
 #include <map>
 
 namespace gameconn
@@ -2,6 +2,7 @@
 #include "DiffStatus.h"
 #include "DiffDoom3MapWriter.h"
 #include "AutomationEngine.h"
+#include "MapUpdateSender.h"
 
 #include "i18n.h"
 #include "igame.h"
@@ -43,6 +44,8 @@ namespace
     constexpr int TAG_CAMERA = 6;
     //multistep procedure for TDM game start/restart
     constexpr int TAG_RESTART = 7;
+    //"update map" diffs, executed asynchronously and pipelined
+    constexpr int TAG_UPDATEMAP = 8;
 
     inline std::string messagePreamble(const std::string& type) {
         return fmt::format("message \"{}\"\n", type);
@@ -60,6 +63,7 @@ namespace
 GameConnection::GameConnection()
 {
     _engine.reset(new AutomationEngine());
+    _mapUpdateSender.reset(new MapUpdateSender(*_engine, _mapObserver, TAG_UPDATEMAP, &GameConnection::composeMapUpdateRequest));
 }
 
 std::string GameConnection::executeGenericRequest(const std::string& request)
@@ -70,14 +74,20 @@ std::string GameConnection::executeGenericRequest(const std::string& request)
 
 bool GameConnection::sendAnyPendingAsync()
 {
-    if (_mapObserver.getChanges().size() && _updateMapAlways) {
-        //note: this is blocking
-        doUpdateMap();
+    if (sendPendingMapUpdate())
         return true;
-    }
     return sendPendingCameraUpdate();
 }
 
+bool GameConnection::sendPendingMapUpdate()
+{
+    if (!_updateMapAlways || _mapObserver.getChanges().empty())
+        return false;
+    if (!_mapUpdateSender->canSendMore())
+        return false;   //wait for game to catch up, changes coalesce meanwhile
+    return sendMapUpdateAsync();
+}
+
 void GameConnection::think()
 {
     if (_engine->hasLostConnection()) {
@@ -99,6 +109,11 @@ void GameConnection::think()
         //think now, don't delay to next frame
         _engine->think();
     }
+    else if (!_engine->areTagsInProgress(~(1 << TAG_UPDATEMAP))) {
+        //only map updates are in flight: pipeline next one without waiting
+        if (sendPendingMapUpdate())
+            _engine->think();
+    }
 }
 
 void GameConnection::onTimerEvent(wxTimerEvent& ev)
@@ -152,6 +167,12 @@ bool GameConnection::connect()
 
 void GameConnection::disconnect(bool force)
 {
+    if (force) {
+        //the diffs in flight are dropped without response:
+        //put their changes back before the observer is reset below
+        _mapUpdateSender->restoreInFlight();
+    }
+
     _autoReloadMap = false;
     setAlwaysUpdateMapEnabled(false);
     setUpdateMapObserverEnabled(false);
@@ -159,6 +180,7 @@ void GameConnection::disconnect(bool force)
 
     _engine->disconnect(force);
     assert(!_engine->isAlive() && !_engine->hasLostConnection());
+    assert(_mapUpdateSender->getNumInFlight() == 0);
 
     setThinkLoop(false);
     _mapEventListener.disconnect();
@@ -775,27 +797,30 @@ std::string saveMapDiff(const DiffEntityStatuses& entityStatuses)
     return outStream.str();
 }
 
+std::string GameConnection::composeMapUpdateRequest(const DiffEntityStatuses& entityChanges)
+{
+    std::string diff = saveMapDiff(entityChanges);
+    if (diff.empty())
+        return "";
+    return actionPreamble("reloadmap-diff") + "content:\n" + diff;
+}
+
 void GameConnection::doUpdateMap()
+{
+    sendMapUpdateAsync();
+}
+
+bool GameConnection::sendMapUpdateAsync()
 {
     try {
         if (!_engine->isAlive())
-            return; //no connection, don't even try
+            return false;   //no connection, don't even try
 
-        // Get map diff
-        std::string diff = saveMapDiff(_mapObserver.getChanges());
-        if (diff.empty()) {
-            return; //TODO: fail
-        }
-
-        std::string response = executeGenericRequest(actionPreamble("reloadmap-diff") + "content:\n" + diff);
-        if (response.find("HotReload: SUCCESS") != std::string::npos) {
-            //success: clear current diff, so that we don't reapply it next time
-            _mapObserver.clear();
-        }
+        return _mapUpdateSender->send();
     }
     catch (const DisconnectException&) {
         //disconnected: will be handled during next think
-        return;
+        return false;
     }
 }
 
@@ -14,6 +14,7 @@ namespace gameconn
 
 class MessageTcp;
 class AutomationEngine;
+class MapUpdateSender;
 
 /**
  * stgatilov: This is TheDarkMod-only system for connecting to game process via socket.
@@ -71,6 +72,8 @@ public:
     // All changes a) since last successful call of this method,
     // or b) since the observer was enabled; are sent as a diff.
     // The game applies the diff on top of its current map state and hot reloads entities.
+    // Note: the diff is sent asynchronously, this method does not wait for the game.
+    // If the game fails to apply it, the changes are put back to be sent again next time.
     void doUpdateMap();
     // Enable/disable mode: doUpdateMap after every entity change.
     // Note: the update is postponed to next think, so that mass changes go as one diff.
@@ -122,6 +125,8 @@ private:
     bool _autoReloadMap = false;
     // True when "setAlwaysUpdateMapEnabled" is enabled.
     bool _updateMapAlways = false;
+    // Sends "update map" diffs to game and keeps track of the ones in flight.
+    std::unique_ptr<MapUpdateSender> _mapUpdateSender;
 
     // True when restartGame procedure is executed.
     bool _restartInProgress = false;
@@ -145,6 +150,16 @@ private:
     // If there are any pending async commands (e.g. camera update), send one now.
     // Returns true iff anything was sent to game.
     bool sendAnyPendingAsync();
+    // If "update map" mode is on and there are pending entity changes, send them as diff.
+    // Several diffs can be in flight at once: the game applies them in order.
+    // Returns true iff anything was sent to game.
+    bool sendPendingMapUpdate();
+    // Takes all pending entity changes from observer and sends them to game asynchronously.
+    // Returns true iff anything was sent to game.
+    bool sendMapUpdateAsync();
+
+    // Given pending entity changes, returns full text of the "update map" request (empty on failure).
+    static std::string composeMapUpdateRequest(const DiffEntityStatuses& entityChanges);
 
     // Given a command to be executed in game console (no EOLs), returns its full request text.
     // The result is ready to be sent over to AutomationEngine, which will prepend seqno automatically.
@@ -164,4 +164,23 @@ const DiffEntityStatuses& MapObserver::getChanges() const {
     return _entityChanges;
 }
 
+DiffEntityStatuses MapObserver::takeChanges() {
+    DiffEntityStatuses result;
+    result.swap(_entityChanges);
+    return result;
+}
+
+void MapObserver::restoreChanges(const DiffEntityStatuses& earlierChanges) {
+    if (!isEnabled())
+        return;     //observer was disabled meanwhile: nothing to restore into
+
+    for (const auto& pNS : earlierChanges) {
+        auto found = _entityChanges.find(pNS.first);
+        if (found == _entityChanges.end())
+            _entityChanges.insert(pNS);
+        else
+            found->second = pNS.second.combine(found->second);
+    }
+}
+
 }
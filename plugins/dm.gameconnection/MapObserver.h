@@ -31,6 +31,14 @@ public:
     //returns pending entity change since last clear (or since enabled)
     const DiffEntityStatuses& getChanges() const;
 
+    //returns pending entity changes and clears them
+    //(e.g. when they are sent to game, subsequent changes accumulate anew)
+    DiffEntityStatuses takeChanges();
+
+    //puts back previously taken changes (e.g. when game failed to apply them)
+    //they are considered to happen before all the changes pending now
+    void restoreChanges(const DiffEntityStatuses& earlierChanges);
+
 private:
     //receives events about entity changes
     void entityUpdated(const std::string& name, const DiffStatus& diff);
@@ -0,0 +1,75 @@
+#include "MapUpdateSender.h"
+#include "AutomationEngine.h"
+#include "MapObserver.h"
+
+#include "itextstream.h"
+
+namespace gameconn
+{
+
+MapUpdateSender::MapUpdateSender(AutomationEngine& engine, MapObserver& observer, int tag, const RequestComposer& composeRequest) :
+    _engine(engine),
+    _observer(observer),
+    _tag(tag),
+    _composeRequest(composeRequest)
+{}
+
+int MapUpdateSender::getNumInFlight() const
+{
+    return static_cast<int>(_inFlight.size());
+}
+
+bool MapUpdateSender::canSendMore() const
+{
+    return getNumInFlight() < MAX_IN_FLIGHT;
+}
+
+bool MapUpdateSender::send()
+{
+    if (_observer.getChanges().empty())
+        return false;   //nothing to send
+
+    // Compose the diff, everything changed from now on goes to the next one
+    std::string request = _composeRequest(_observer.getChanges());
+    if (request.empty())
+    {
+        rError() << "MapUpdateSender: failed to compose update request for "
+            << _observer.getChanges().size() << " changed entities" << std::endl;
+        return false;
+    }
+
+    int seqno = _engine.executeRequestAsync(_tag, request, [this](int seqno) {
+        onResponse(seqno);
+    });
+    _inFlight[seqno] = _observer.takeChanges();
+
+    return true;
+}
+
+void MapUpdateSender::onResponse(int seqno)
+{
+    auto found = _inFlight.find(seqno);
+    if (found == _inFlight.end())
+        return;     //already restored
+
+    DiffEntityStatuses sentChanges;
+    sentChanges.swap(found->second);
+    _inFlight.erase(found);
+
+    std::string response = _engine.getResponse(seqno);
+    if (response.find("HotReload: SUCCESS") == std::string::npos) {
+        //failure: these changes must be sent again next time
+        _observer.restoreChanges(sentChanges);
+    }
+}
+
+void MapUpdateSender::restoreInFlight()
+{
+    //each restore goes in front of the pending changes, so start with the latest diff
+    for (auto it = _inFlight.rbegin(); it != _inFlight.rend(); ++it) {
+        _observer.restoreChanges(it->second);
+    }
+    _inFlight.clear();
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <string>
+#include "DiffStatus.h"
+
+namespace gameconn
+{
+
+class AutomationEngine;
+class MapObserver;
+
+/**
+ * Private for GameConnection class: do not use directly!
+ * Sends the changes collected by MapObserver to game as map diffs ("update map").
+ * Diffs are sent asynchronously, several of them can be in flight at once:
+ * the game applies them in order of arrival.
+ * Changes of a diff which the game fails to apply are put back into the observer.
+ */
+class MapUpdateSender
+{
+public:
+    //how many diffs can be sent without waiting for response
+    static constexpr int MAX_IN_FLIGHT = 3;
+
+    //returns full text of the request applying the given changes in game
+    //(AutomationEngine prepends seqno automatically), or empty string on failure
+    using RequestComposer = std::function<std::string(const DiffEntityStatuses&)>;
+
+    MapUpdateSender(AutomationEngine& engine, MapObserver& observer, int tag, const RequestComposer& composeRequest);
+
+    //returns number of diffs sent to game, for which response has not arrived yet
+    int getNumInFlight() const;
+    //returns true iff one more diff can be sent without waiting for responses
+    bool canSendMore() const;
+
+    //takes all pending changes from observer and sends them to game asynchronously
+    //returns true iff anything was sent to game
+    //throws DisconnectException if connection is missing
+    bool send();
+
+    //must be called when the pending requests are dropped without response (e.g. on disconnect)
+    //puts the changes of all diffs in flight back into the observer, in the order they were made
+    void restoreInFlight();
+
+private:
+    //callback for finished request with given seqno
+    void onResponse(int seqno);
+
+    AutomationEngine& _engine;
+    MapObserver& _observer;
+    int _tag;
+    RequestComposer _composeRequest;
+
+    //changes sent to game, by seqno of the request (i.e. in order of sending)
+    std::map<int, DiffEntityStatuses> _inFlight;
+};
+
+}
@@ -0,0 +1,203 @@
+#include "AsyncScriptExecution.h"
+
+#include <chrono>
+#include <pybind11/eval.h>
+
+#include "icommandsystem.h"
+#include "itextstream.h"
+#include "iundo.h"
+
+namespace script
+{
+
+AsyncScriptExecution::AsyncScriptExecution(const std::string& moduleName, const std::string& scriptString, const SceneSnapshot::Ptr& snapshot) :
+    _snapshot(snapshot),
+    _pythonThreadId(0),
+    _cancelled(false),
+    _finished(false),
+    _progress(0),
+    _outputWriter(false, _outputBuffer),
+    _errorWriter(true, _errorBuffer),
+    _errorOccurred(false)
+{
+    _worker = std::thread(&AsyncScriptExecution::run, this, moduleName, scriptString);
+}
+
+AsyncScriptExecution::~AsyncScriptExecution()
+{
+    cancel();
+
+    if (_worker.joinable())
+    {
+        _worker.join();
+    }
+}
+
+float AsyncScriptExecution::getProgress() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _progress;
+}
+
+std::string AsyncScriptExecution::getProgressText() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _progressText;
+}
+
+bool AsyncScriptExecution::isFinished() const
+{
+    return _finished;
+}
+
+void AsyncScriptExecution::cancel()
+{
+    if (_finished || _cancelled.exchange(true)) return;
+
+    py::gil_scoped_acquire gil;
+
+    // The thread id is only set while the script is running, which cannot
+    // change as long as we're holding the interpreter lock
+    if (_pythonThreadId != 0)
+    {
+        PyThreadState_SetAsyncExc(_pythonThreadId, PyExc_KeyboardInterrupt);
+    }
+}
+
+void AsyncScriptExecution::processPendingCommands()
+{
+    std::vector<std::string> commands;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        commands.swap(_pendingCommands);
+    }
+
+    if (commands.empty()) return;
+
+    UndoableCommand cmd("runScriptAsync");
+
+    for (const auto& statement : commands)
+    {
+        GlobalCommandSystem().execute(statement);
+    }
+}
+
+ExecutionResultPtr AsyncScriptExecution::waitForResult()
+{
+    while (!_finished)
+    {
+        processPendingCommands();
+
+        std::unique_lock<std::mutex> lock(_lock);
+        _stateChanged.wait_for(lock, std::chrono::milliseconds(50), [this]
+        {
+            return _finished || !_pendingCommands.empty();
+        });
+    }
+
+    if (_worker.joinable())
+    {
+        _worker.join();
+    }
+
+    // Run anything queued right before the script finished
+    processPendingCommands();
+
+    auto result = std::make_shared<ExecutionResult>();
+
+    result->errorOccurred = _errorOccurred;
+    result->output = _outputBuffer + "\n" + _errorBuffer + "\n";
+
+    return result;
+}
+
+void AsyncScriptExecution::reportProgress(float fraction, const std::string& text)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _progress = fraction;
+    _progressText = text;
+}
+
+bool AsyncScriptExecution::isCancelled() const
+{
+    return _cancelled;
+}
+
+void AsyncScriptExecution::queueCommand(const std::string& statement)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _pendingCommands.push_back(statement);
+    }
+
+    _stateChanged.notify_all();
+}
+
+void AsyncScriptExecution::run(const std::string& moduleName, const std::string& scriptString)
+{
+    {
+        py::gil_scoped_acquire gil;
+
+        _pythonThreadId = PyThread_get_thread_ident();
+
+        try
+        {
+            // A separate dictionary, the globals of the main module are referencing the live scene
+            py::dict globals;
+
+            globals["__builtins__"] = py::module::import("builtins");
+            globals["__output__"] = py::cast(&_outputWriter, py::return_value_policy::reference);
+
+            // Of the DarkRadiant module only the plain value types are made available,
+            // the rest of its classes are wrapping nodes and interfaces of the live scene
+            auto module = py::module::import(moduleName.c_str());
+
+            for (auto name : { "Vector2", "Vector3", "Vector4", "AABB" })
+            {
+                globals[name] = module.attr(name);
+            }
+
+            // sys.stdout belongs to the main thread, print to our own buffer instead
+            py::exec("import functools as __functools\n"
+                "print = __functools.partial(print, file=__output__)\n", globals);
+
+            globals["Snapshot"] = py::cast(_snapshot);
+            globals["AsyncScript"] = py::cast(this, py::return_value_policy::reference);
+
+            if (!_cancelled)
+            {
+                py::exec(scriptString, globals);
+            }
+        }
+        catch (py::error_already_set& ex)
+        {
+            if (ex.matches(PyExc_KeyboardInterrupt))
+            {
+                _outputWriter.write("Script cancelled\n");
+            }
+            else
+            {
+                _errorOccurred = true;
+                _errorWriter.write(std::string("Error executing script: ") + ex.what() + "\n");
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            _errorOccurred = true;
+            _errorWriter.write(std::string("Error executing script: ") + ex.what() + "\n");
+        }
+
+        _pythonThreadId = 0;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _finished = true;
+    }
+
+    _stateChanged.notify_all();
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "iscript.h"
+#include "PythonConsoleWriter.h"
+#include "SceneSnapshot.h"
+
+namespace script
+{
+
+/**
+ * Runs a script string on its own worker thread, which is started right
+ * away. The script gets its own global dictionary, holding the scene
+ * snapshot, this object (exposed as "AsyncScript") and the math value types
+ * instead of the regular interfaces to the live scene, so it can't do any
+ * harm to data used by the main thread.
+ *
+ * The interpreter lock must not be held by the thread constructing
+ * or destroying this object.
+ */
+class AsyncScriptExecution final :
+    public IAsyncScriptExecution
+{
+private:
+    SceneSnapshot::Ptr _snapshot;
+
+    std::thread _worker;
+
+    // Identifier of the python thread, only non-zero while the script is
+    // running and only accessed with the interpreter lock held
+    unsigned long _pythonThreadId;
+
+    std::atomic<bool> _cancelled;
+    std::atomic<bool> _finished;
+
+    mutable std::mutex _lock;
+    std::condition_variable _stateChanged;
+
+    // Guarded by _lock
+    float _progress;
+    std::string _progressText;
+    std::vector<std::string> _pendingCommands;
+
+    // Written by the worker, only read after it finished
+    std::string _outputBuffer;
+    std::string _errorBuffer;
+    PythonConsoleWriter _outputWriter;
+    PythonConsoleWriter _errorWriter;
+    bool _errorOccurred;
+
+public:
+    AsyncScriptExecution(const std::string& moduleName, const std::string& scriptString, const SceneSnapshot::Ptr& snapshot);
+
+    // Cancels the script if it is still running, waits for the worker to finish
+    ~AsyncScriptExecution() override;
+
+    float getProgress() const override;
+    std::string getProgressText() const override;
+    bool isFinished() const override;
+    void cancel() override;
+    void processPendingCommands() override;
+    ExecutionResultPtr waitForResult() override;
+
+    // Methods exposed to the script through the "AsyncScript" object
+    void reportProgress(float fraction, const std::string& text);
+    bool isCancelled() const;
+    void queueCommand(const std::string& statement);
+
+private:
+    void run(const std::string& moduleName, const std::string& scriptString);
+};
+
+}
@@ -14,6 +14,9 @@
 #include "os/file.h"
 #include "os/path.h"
 
+#include "AsyncScriptExecution.h"
+#include "SceneSnapshot.h"
+
 namespace script
 {
 
@@ -32,6 +35,9 @@ PythonModule::PythonModule() :
 
 PythonModule::~PythonModule()
 {
+    // Take back the interpreter lock for the cleanup
+    _mainThreadRelease.reset();
+
     _namedInterfaces.clear();
 
     // Release the references to trigger the internal cleanup before Py_Finalize
@@ -80,6 +86,9 @@ void PythonModule::initialise()
 
     // Not needed anymore
     _instance = nullptr;
+
+    // Release the interpreter lock, it's acquired again whenever we execute something
+    _mainThreadRelease = std::make_unique<py::gil_scoped_release>();
 }
 
 void PythonModule::registerModule()
@@ -100,6 +109,8 @@ void PythonModule::registerModule()
 
 ExecutionResultPtr PythonModule::executeString(const std::string& scriptString)
 {
+    py::gil_scoped_acquire gil;
+
     ExecutionResultPtr result = std::make_shared<ExecutionResult>();
 
     result->errorOccurred = false;
@@ -134,8 +145,16 @@ ExecutionResultPtr PythonModule::executeString(const std::string& scriptString)
     return result;
 }
 
+IAsyncScriptExecution::Ptr PythonModule::executeStringAsync(const std::string& scriptString)
+{
+    // The snapshot is taken here, on the main thread
+    return std::make_shared<AsyncScriptExecution>(ModuleName, scriptString, SceneSnapshot::CaptureFromScene());
+}
+
 void PythonModule::executeScriptFile(const std::string& scriptBasePath, const std::string& relativeScriptPath, bool setExecuteCommandAttr)
 {
+    py::gil_scoped_acquire gil;
+
     try
     {
         auto fullPath = scriptBasePath + relativeScriptPath;
@@ -255,6 +274,7 @@ void PythonModule::addInterface(const NamedInterface& iface)
     // Initialise the interface at once, if the module is already alive
     if (_interpreterInitialised)
     {
+        py::gil_scoped_acquire gil;
         iface.second->registerInterface(_module, getGlobals());
     }
 }
@@ -275,6 +295,8 @@ bool PythonModule::interfaceExists(const std::string& name)
 
 ScriptCommand::Ptr PythonModule::createScriptCommand(const std::string& scriptBasePath, const std::string& relativeScriptPath)
 {
+    py::gil_scoped_acquire gil;
+
     try
     {
         auto fullPath = scriptBasePath + relativeScriptPath;
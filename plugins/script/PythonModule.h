@@ -42,6 +42,10 @@ private:
 
     bool _interpreterInitialised;
 
+    // The main thread only holds the interpreter lock while it is
+    // executing scripts, so that asynchronous scripts can run in between
+    std::unique_ptr<py::gil_scoped_release> _mainThreadRelease;
+
 public:
     PythonModule();
     ~PythonModule();
@@ -51,6 +55,9 @@ public:
 
     ExecutionResultPtr executeString(const std::string& scriptString);
 
+    // Starts executing the given script on a worker thread, see IScriptingSystem::executeStringAsync
+    IAsyncScriptExecution::Ptr executeStringAsync(const std::string& scriptString);
+
     // Execute the given script file
     void executeScriptFile(const std::string& scriptBasePath, const std::string& relativeScriptPath, bool setExecuteCommandAttr);
 
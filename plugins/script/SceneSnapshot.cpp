@@ -0,0 +1,184 @@
+#include "SceneSnapshot.h"
+
+#include <map>
+#include <stdexcept>
+
+#include "ientity.h"
+#include "ibrush.h"
+#include "iscenegraph.h"
+
+namespace script
+{
+
+SceneSnapshot::Ptr SceneSnapshot::CaptureFromScene()
+{
+    auto snapshot = std::make_shared<SceneSnapshot>();
+
+    auto root = GlobalSceneGraph().root();
+
+    if (!root) return snapshot;
+
+    // Nodes are visited before their children, so the parent entity is always known
+    std::map<const scene::INode*, std::size_t> entityIndices;
+
+    auto getParentEntity = [&](const scene::INodePtr& node)
+    {
+        auto parent = node->getParent();
+        auto found = entityIndices.find(parent.get());
+
+        return found != entityIndices.end() ? found->second : snapshot->_entities.size();
+    };
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity != nullptr)
+        {
+            entityIndices.emplace(node.get(), snapshot->_entities.size());
+
+            auto& copy = snapshot->_entities.emplace_back();
+
+            entity->forEachKeyValue([&](const std::string& key, const std::string& value)
+            {
+                copy.keyValues.emplace_back(key, value);
+            });
+        }
+        else if (auto brush = Node_getIBrush(node); brush != nullptr)
+        {
+            auto& copy = snapshot->_brushes.emplace_back();
+
+            copy.entity = getParentEntity(node);
+            copy.faces.reserve(brush->getNumFaces());
+
+            for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+            {
+                const auto& face = brush->getFace(i);
+                copy.faces.push_back(Face{ face.getPlane3(), face.getShader() });
+            }
+        }
+        else if (auto patch = Node_getIPatch(node); patch != nullptr)
+        {
+            auto& copy = snapshot->_patches.emplace_back();
+
+            copy.entity = getParentEntity(node);
+            copy.shader = patch->getShader();
+            copy.width = patch->getWidth();
+            copy.height = patch->getHeight();
+            copy.controls.reserve(copy.width * copy.height);
+
+            for (std::size_t row = 0; row < copy.height; ++row)
+            {
+                for (std::size_t col = 0; col < copy.width; ++col)
+                {
+                    copy.controls.push_back(patch->ctrlAt(row, col));
+                }
+            }
+        }
+
+        return true;
+    });
+
+    return snapshot;
+}
+
+std::size_t SceneSnapshot::getEntityCount() const
+{
+    return _entities.size();
+}
+
+std::string SceneSnapshot::getEntityKeyValue(std::size_t index, const std::string& key) const
+{
+    for (const auto& [k, value] : entity(index).keyValues)
+    {
+        if (k == key) return value;
+    }
+
+    return {};
+}
+
+const std::vector<std::pair<std::string, std::string>>& SceneSnapshot::getEntityKeyValues(std::size_t index) const
+{
+    return entity(index).keyValues;
+}
+
+std::size_t SceneSnapshot::getBrushCount() const
+{
+    return _brushes.size();
+}
+
+std::size_t SceneSnapshot::getBrushEntity(std::size_t index) const
+{
+    return brush(index).entity;
+}
+
+std::size_t SceneSnapshot::getBrushFaceCount(std::size_t index) const
+{
+    return brush(index).faces.size();
+}
+
+const std::string& SceneSnapshot::getBrushFaceShader(std::size_t index, std::size_t face) const
+{
+    return brush(index).faces.at(face).shader;
+}
+
+Vector4 SceneSnapshot::getBrushFacePlane(std::size_t index, std::size_t face) const
+{
+    const auto& plane = brush(index).faces.at(face).plane;
+    return Vector4(plane.normal(), plane.dist());
+}
+
+std::size_t SceneSnapshot::getPatchCount() const
+{
+    return _patches.size();
+}
+
+std::size_t SceneSnapshot::getPatchEntity(std::size_t index) const
+{
+    return patch(index).entity;
+}
+
+const std::string& SceneSnapshot::getPatchShader(std::size_t index) const
+{
+    return patch(index).shader;
+}
+
+std::size_t SceneSnapshot::getPatchWidth(std::size_t index) const
+{
+    return patch(index).width;
+}
+
+std::size_t SceneSnapshot::getPatchHeight(std::size_t index) const
+{
+    return patch(index).height;
+}
+
+const PatchControl& SceneSnapshot::getPatchControl(std::size_t index, std::size_t row, std::size_t col) const
+{
+    const auto& p = patch(index);
+
+    if (row >= p.height || col >= p.width)
+    {
+        throw std::out_of_range("Patch control index out of range");
+    }
+
+    return p.controls[row * p.width + col];
+}
+
+const SceneSnapshot::Entity& SceneSnapshot::entity(std::size_t index) const
+{
+    if (index >= _entities.size()) throw std::out_of_range("Entity index out of range");
+    return _entities[index];
+}
+
+const SceneSnapshot::Brush& SceneSnapshot::brush(std::size_t index) const
+{
+    if (index >= _brushes.size()) throw std::out_of_range("Brush index out of range");
+    return _brushes[index];
+}
+
+const SceneSnapshot::Patch& SceneSnapshot::patch(std::size_t index) const
+{
+    if (index >= _patches.size()) throw std::out_of_range("Patch index out of range");
+    return _patches[index];
+}
+
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ipatch.h"
+#include "math/Plane3.h"
+#include "math/Vector4.h"
+
+namespace script
+{
+
+/**
+ * Immutable copy of the entities, brushes and patches of the scene,
+ * taken on the main thread before an asynchronous script is started.
+ * Scripts running on a worker thread can only read the scene through
+ * this copy, the live scene is never touched from outside the main thread.
+ */
+class SceneSnapshot
+{
+public:
+    using Ptr = std::shared_ptr<SceneSnapshot>;
+
+    struct Entity
+    {
+        std::vector<std::pair<std::string, std::string>> keyValues;
+    };
+
+    struct Face
+    {
+        Plane3 plane;
+        std::string shader;
+    };
+
+    struct Brush
+    {
+        std::size_t entity; // index of the parent entity
+        std::vector<Face> faces;
+    };
+
+    struct Patch
+    {
+        std::size_t entity; // index of the parent entity
+        std::string shader;
+        std::size_t width;
+        std::size_t height;
+        std::vector<PatchControl> controls; // row-major
+    };
+
+private:
+    std::vector<Entity> _entities;
+    std::vector<Brush> _brushes;
+    std::vector<Patch> _patches;
+
+public:
+    // Copies the current scene contents, must be called from the main thread
+    static Ptr CaptureFromScene();
+
+    std::size_t getEntityCount() const;
+    std::string getEntityKeyValue(std::size_t entity, const std::string& key) const;
+    const std::vector<std::pair<std::string, std::string>>& getEntityKeyValues(std::size_t entity) const;
+
+    std::size_t getBrushCount() const;
+    std::size_t getBrushEntity(std::size_t brush) const;
+    std::size_t getBrushFaceCount(std::size_t brush) const;
+    const std::string& getBrushFaceShader(std::size_t brush, std::size_t face) const;
+    Vector4 getBrushFacePlane(std::size_t brush, std::size_t face) const;
+
+    std::size_t getPatchCount() const;
+    std::size_t getPatchEntity(std::size_t patch) const;
+    const std::string& getPatchShader(std::size_t patch) const;
+    std::size_t getPatchWidth(std::size_t patch) const;
+    std::size_t getPatchHeight(std::size_t patch) const;
+    const PatchControl& getPatchControl(std::size_t patch, std::size_t row, std::size_t col) const;
+
+private:
+    const Entity& entity(std::size_t index) const;
+    const Brush& brush(std::size_t index) const;
+    const Patch& patch(std::size_t index) const;
+};
+
+}
@@ -28,6 +28,8 @@
 #include "interfaces/LayerInterface.h"
 #include "interfaces/DeclarationManagerInterface.h"
 #include "interfaces/FxManagerInterface.h"
+#include "interfaces/BulkSceneInterface.h"
+#include "interfaces/AsyncScriptInterface.h"
 
 #include "PythonModule.h"
 
@@ -35,7 +37,10 @@
 
 #include "os/fs.h"
 #include "os/path.h"
+#include <algorithm>
+#include <chrono>
 #include <functional>
+#include <thread>
 #include "string/case_conv.h"
 
 namespace script 
@@ -74,6 +79,39 @@ ExecutionResultPtr ScriptingSystem::executeString(const std::string& scriptStrin
     return _pythonModule->executeString(scriptString);
 }
 
+IAsyncScriptExecution::Ptr ScriptingSystem::executeStringAsync(const std::string& scriptString)
+{
+    // Forget about the scripts that have been released already
+    _asyncExecutions.erase(std::remove_if(_asyncExecutions.begin(), _asyncExecutions.end(),
+        [](const std::weak_ptr<IAsyncScriptExecution>& execution) { return execution.expired(); }),
+        _asyncExecutions.end());
+
+    auto execution = _pythonModule->executeStringAsync(scriptString);
+    _asyncExecutions.push_back(execution);
+
+    return execution;
+}
+
+void ScriptingSystem::cancelAsyncExecutions()
+{
+    for (const auto& weakExecution : _asyncExecutions)
+    {
+        auto execution = weakExecution.lock();
+
+        if (!execution) continue;
+
+        execution->cancel();
+
+        // Wait for the script to leave the interpreter before it is shut down
+        while (!execution->isFinished())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    _asyncExecutions.clear();
+}
+
 void ScriptingSystem::foreachScriptCommand(const std::function<void(const IScriptCommand&)>& functor)
 {
 	for (const auto& pair : _commands)
@@ -266,6 +304,8 @@ void ScriptingSystem::initialiseModule(const IApplicationContext& ctx)
 	addInterface("LayerInterface", std::make_shared<LayerInterface>());
 	addInterface("DeclarationManager", std::make_shared<DeclarationManagerInterface>());
 	addInterface("FxManager", std::make_shared<FxManagerInterface>());
+	addInterface("BulkScene", std::make_shared<BulkSceneInterface>());
+	addInterface("AsyncScript", std::make_shared<AsyncScriptInterface>());
 
 	GlobalCommandSystem().addCommand(
 		"RunScript",
@@ -302,6 +342,8 @@ void ScriptingSystem::shutdownModule()
 
 	_scriptPath.clear();
 
+    cancelAsyncExecutions();
+
     _pythonModule.reset();
 }
 
@@ -33,6 +33,9 @@ private:
 
 	sigc::signal<void> _sigScriptsReloaded;
 
+	// Scripts started by executeStringAsync, to stop them on shutdown
+	std::vector<std::weak_ptr<IAsyncScriptExecution>> _asyncExecutions;
+
 public:
 	ScriptingSystem();
 
@@ -63,6 +66,8 @@ public:
 	// Execute the given python script string
 	ExecutionResultPtr executeString(const std::string& scriptString) override;
 
+	IAsyncScriptExecution::Ptr executeStringAsync(const std::string& scriptString) override;
+
 	void foreachScriptCommand(const std::function<void(const IScriptCommand&)>& functor) override;
 
 	sigc::signal<void>& signal_onScriptsReloaded() override;
@@ -79,6 +84,8 @@ public:
 private:
 	void executeScriptFile(const std::string& filename, bool setExecuteCommandAttr);
 
+	void cancelAsyncExecutions();
+
 	void reloadScripts();
 
 	void loadCommandScript(const std::string& scriptFilename);
@@ -0,0 +1,45 @@
+#include "AsyncScriptInterface.h"
+
+#include "../AsyncScriptExecution.h"
+#include "../SceneSnapshot.h"
+
+namespace script
+{
+
+void AsyncScriptInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	py::class_<SceneSnapshot, SceneSnapshot::Ptr> snapshot(scope, "SceneSnapshot");
+
+	snapshot.def("getEntityCount", &SceneSnapshot::getEntityCount);
+	snapshot.def("getEntityKeyValue", &SceneSnapshot::getEntityKeyValue);
+	snapshot.def("getEntityKeyValues", [](const SceneSnapshot& self, std::size_t entity)
+	{
+		py::dict keyValues;
+
+		for (const auto& [key, value] : self.getEntityKeyValues(entity))
+		{
+			keyValues[py::str(key)] = value;
+		}
+
+		return keyValues;
+	});
+	snapshot.def("getBrushCount", &SceneSnapshot::getBrushCount);
+	snapshot.def("getBrushEntity", &SceneSnapshot::getBrushEntity);
+	snapshot.def("getBrushFaceCount", &SceneSnapshot::getBrushFaceCount);
+	snapshot.def("getBrushFaceShader", &SceneSnapshot::getBrushFaceShader, py::return_value_policy::copy);
+	snapshot.def("getBrushFacePlane", &SceneSnapshot::getBrushFacePlane);
+	snapshot.def("getPatchCount", &SceneSnapshot::getPatchCount);
+	snapshot.def("getPatchEntity", &SceneSnapshot::getPatchEntity);
+	snapshot.def("getPatchShader", &SceneSnapshot::getPatchShader, py::return_value_policy::copy);
+	snapshot.def("getPatchWidth", &SceneSnapshot::getPatchWidth);
+	snapshot.def("getPatchHeight", &SceneSnapshot::getPatchHeight);
+	snapshot.def("getPatchControl", &SceneSnapshot::getPatchControl, py::return_value_policy::copy);
+
+	py::class_<AsyncScriptExecution> asyncScript(scope, "AsyncScriptContext");
+
+	asyncScript.def("reportProgress", &AsyncScriptExecution::reportProgress, py::arg("fraction"), py::arg("text") = "");
+	asyncScript.def("isCancelled", &AsyncScriptExecution::isCancelled);
+	asyncScript.def("executeCommand", &AsyncScriptExecution::queueCommand);
+}
+
+} // namespace script
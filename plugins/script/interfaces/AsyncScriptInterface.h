@@ -0,0 +1,23 @@
+#pragma once
+
+#include "iscript.h"
+#include "iscriptinterface.h"
+
+namespace script
+{
+
+/**
+ * Declares the types available to scripts running asynchronously:
+ * the read-only SceneSnapshot and the AsyncScript object used to report
+ * progress, check for cancellation and queue commands for the main thread.
+ * The instances are set up per execution, no globals are defined here.
+ */
+class AsyncScriptInterface :
+	public IScriptInterface
+{
+public:
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+};
+
+} // namespace script
@@ -0,0 +1,436 @@
+#include "BulkSceneInterface.h"
+
+#include <map>
+#include <stdexcept>
+
+#include "ientity.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "iscenegraph.h"
+#include "iselection.h"
+#include "iundo.h"
+#include "string/convert.h"
+
+#include "SceneGraphInterface.h"
+
+namespace script
+{
+
+namespace
+{
+
+// Converts the list of script nodes to scene nodes, checking them with the given predicate
+template<typename Predicate>
+std::vector<scene::INodePtr> getNodesFromList(const py::list& nodes, const Predicate& isValidNode, const char* nodeType)
+{
+	std::vector<scene::INodePtr> result;
+	result.reserve(nodes.size());
+
+	for (const auto& item : nodes)
+	{
+		scene::INodePtr node = item.cast<const ScriptSceneNode&>();
+
+		if (!node || !isValidNode(node))
+		{
+			throw std::invalid_argument(std::string("Node ") + std::to_string(result.size()) + " is not a " + nodeType);
+		}
+
+		result.push_back(node);
+	}
+
+	return result;
+}
+
+template<typename T>
+py::array_t<T> createArray(std::size_t rows, std::size_t columns)
+{
+	return py::array_t<T>({ rows, columns });
+}
+
+}
+
+void BulkSceneInterface::forEachNode(bool selectedOnly, const std::function<void(const scene::INodePtr&)>& functor)
+{
+	if (selectedOnly)
+	{
+		GlobalSelectionSystem().foreachSelected(functor);
+		return;
+	}
+
+	auto root = GlobalSceneGraph().root();
+
+	if (!root) return;
+
+	root->foreachNode([&](const scene::INodePtr& node)
+	{
+		functor(node);
+		return true;
+	});
+}
+
+py::dict BulkSceneInterface::getEntityKeyValues(bool selectedOnly)
+{
+	std::vector<scene::INodePtr> entityNodes;
+
+	forEachNode(selectedOnly, [&](const scene::INodePtr& node)
+	{
+		if (Node_isEntity(node))
+		{
+			entityNodes.push_back(node);
+		}
+	});
+
+	py::list nodes;
+	py::list classnames;
+	py::list keys;
+	py::list values;
+
+	auto origins = createArray<double>(entityNodes.size(), 3);
+	py::array_t<std::int64_t> offsets(entityNodes.size() + 1);
+
+	auto origin = origins.mutable_unchecked<2>();
+	auto offset = offsets.mutable_unchecked<1>();
+	std::int64_t numKeyValues = 0;
+
+	for (std::size_t i = 0; i < entityNodes.size(); ++i)
+	{
+		auto entity = Node_getEntity(entityNodes[i]);
+
+		nodes.append(ScriptSceneNode(entityNodes[i]));
+		classnames.append(entity->getKeyValue("classname"));
+
+		auto position = string::convert<Vector3>(entity->getKeyValue("origin"));
+		origin(i, 0) = position.x();
+		origin(i, 1) = position.y();
+		origin(i, 2) = position.z();
+
+		offset(i) = numKeyValues;
+
+		entity->forEachKeyValue([&](const std::string& key, const std::string& value)
+		{
+			keys.append(key);
+			values.append(value);
+			++numKeyValues;
+		});
+	}
+
+	offset(entityNodes.size()) = numKeyValues;
+
+	py::dict result;
+	result["nodes"] = nodes;
+	result["classnames"] = classnames;
+	result["origins"] = origins;
+	result["keys"] = keys;
+	result["values"] = values;
+	result["keyValueOffsets"] = offsets;
+
+	return result;
+}
+
+py::dict BulkSceneInterface::getBrushFaces(bool selectedOnly)
+{
+	std::vector<scene::INodePtr> brushNodes;
+	std::size_t numFaces = 0;
+
+	forEachNode(selectedOnly, [&](const scene::INodePtr& node)
+	{
+		if (auto brush = Node_getIBrush(node); brush != nullptr)
+		{
+			brushNodes.push_back(node);
+			numFaces += brush->getNumFaces();
+		}
+	});
+
+	py::list nodes;
+	py::list shaderNames;
+	std::map<std::string, int> shaderIndexByName;
+
+	auto planes = createArray<double>(numFaces, 4);
+	py::array_t<int> shaderIndices(numFaces);
+	py::array_t<std::int64_t> offsets(brushNodes.size() + 1);
+
+	auto plane = planes.mutable_unchecked<2>();
+	auto shaderIndex = shaderIndices.mutable_unchecked<1>();
+	auto offset = offsets.mutable_unchecked<1>();
+	std::size_t faceIndex = 0;
+
+	for (std::size_t i = 0; i < brushNodes.size(); ++i)
+	{
+		const auto& brush = *Node_getIBrush(brushNodes[i]);
+
+		nodes.append(ScriptSceneNode(brushNodes[i]));
+		offset(i) = static_cast<std::int64_t>(faceIndex);
+
+		for (std::size_t f = 0; f < brush.getNumFaces(); ++f, ++faceIndex)
+		{
+			const auto& face = brush.getFace(f);
+			const auto& facePlane = face.getPlane3();
+
+			plane(faceIndex, 0) = facePlane.normal().x();
+			plane(faceIndex, 1) = facePlane.normal().y();
+			plane(faceIndex, 2) = facePlane.normal().z();
+			plane(faceIndex, 3) = facePlane.dist();
+
+			auto [existing, inserted] = shaderIndexByName.emplace(face.getShader(), static_cast<int>(shaderIndexByName.size()));
+
+			if (inserted)
+			{
+				shaderNames.append(face.getShader());
+			}
+
+			shaderIndex(faceIndex) = existing->second;
+		}
+	}
+
+	offset(brushNodes.size()) = static_cast<std::int64_t>(faceIndex);
+
+	py::dict result;
+	result["nodes"] = nodes;
+	result["planes"] = planes;
+	result["shaderIndices"] = shaderIndices;
+	result["shaderNames"] = shaderNames;
+	result["faceOffsets"] = offsets;
+
+	return result;
+}
+
+py::dict BulkSceneInterface::getPatchControlNets(bool selectedOnly)
+{
+	std::vector<scene::INodePtr> patchNodes;
+	std::size_t numControls = 0;
+
+	forEachNode(selectedOnly, [&](const scene::INodePtr& node)
+	{
+		if (auto patch = Node_getIPatch(node); patch != nullptr)
+		{
+			patchNodes.push_back(node);
+			numControls += patch->getWidth() * patch->getHeight();
+		}
+	});
+
+	py::list nodes;
+	py::list shaders;
+
+	auto dimensions = createArray<std::int64_t>(patchNodes.size(), 2);
+	auto vertices = createArray<double>(numControls, 3);
+	auto texcoords = createArray<double>(numControls, 2);
+	py::array_t<std::int64_t> offsets(patchNodes.size() + 1);
+
+	auto dimension = dimensions.mutable_unchecked<2>();
+	auto vertex = vertices.mutable_unchecked<2>();
+	auto texcoord = texcoords.mutable_unchecked<2>();
+	auto offset = offsets.mutable_unchecked<1>();
+	std::size_t controlIndex = 0;
+
+	for (std::size_t i = 0; i < patchNodes.size(); ++i)
+	{
+		const auto& patch = *Node_getIPatch(patchNodes[i]);
+
+		nodes.append(ScriptSceneNode(patchNodes[i]));
+		shaders.append(patch.getShader());
+
+		dimension(i, 0) = static_cast<std::int64_t>(patch.getWidth());
+		dimension(i, 1) = static_cast<std::int64_t>(patch.getHeight());
+		offset(i) = static_cast<std::int64_t>(controlIndex);
+
+		for (std::size_t row = 0; row < patch.getHeight(); ++row)
+		{
+			for (std::size_t col = 0; col < patch.getWidth(); ++col, ++controlIndex)
+			{
+				const auto& ctrl = patch.ctrlAt(row, col);
+
+				vertex(controlIndex, 0) = ctrl.vertex.x();
+				vertex(controlIndex, 1) = ctrl.vertex.y();
+				vertex(controlIndex, 2) = ctrl.vertex.z();
+				texcoord(controlIndex, 0) = ctrl.texcoord.x();
+				texcoord(controlIndex, 1) = ctrl.texcoord.y();
+			}
+		}
+	}
+
+	offset(patchNodes.size()) = static_cast<std::int64_t>(controlIndex);
+
+	py::dict result;
+	result["nodes"] = nodes;
+	result["shaders"] = shaders;
+	result["dimensions"] = dimensions;
+	result["vertices"] = vertices;
+	result["texcoords"] = texcoords;
+	result["controlOffsets"] = offsets;
+
+	return result;
+}
+
+void BulkSceneInterface::setEntityKeyValues(const py::list& nodes, const py::list& keys, const py::list& values)
+{
+	if (keys.size() != nodes.size() || values.size() != nodes.size())
+	{
+		throw std::invalid_argument("The node, key and value lists must have the same length");
+	}
+
+	auto entityNodes = getNodesFromList(nodes, Node_isEntity, "entity");
+
+	// Convert all arguments up front, a bad one must not leave a half-applied undo step behind
+	std::vector<std::pair<std::string, std::string>> keyValues;
+	keyValues.reserve(entityNodes.size());
+
+	for (std::size_t i = 0; i < entityNodes.size(); ++i)
+	{
+		if (!py::isinstance<py::str>(keys[i]) || !py::isinstance<py::str>(values[i]))
+		{
+			throw std::invalid_argument("Key and value " + std::to_string(i) + " must be strings");
+		}
+
+		auto key = keys[i].cast<std::string>();
+
+		if (key.empty())
+		{
+			throw std::invalid_argument("Key " + std::to_string(i) + " is empty");
+		}
+
+		keyValues.emplace_back(std::move(key), values[i].cast<std::string>());
+	}
+
+	UndoableCommand cmd("setEntityKeyValues");
+
+	for (std::size_t i = 0; i < entityNodes.size(); ++i)
+	{
+		Node_getEntity(entityNodes[i])->setKeyValue(keyValues[i].first, keyValues[i].second);
+	}
+}
+
+void BulkSceneInterface::setBrushFaceShaders(const py::list& nodes, const py::array_t<int>& shaderIndices, const py::list& shaderNames)
+{
+	auto brushNodes = getNodesFromList(nodes, Node_isBrush, "brush");
+
+	std::size_t numFaces = 0;
+
+	for (const auto& node : brushNodes)
+	{
+		numFaces += Node_getIBrush(node)->getNumFaces();
+	}
+
+	if (shaderIndices.ndim() != 1 || static_cast<std::size_t>(shaderIndices.shape(0)) != numFaces)
+	{
+		throw std::invalid_argument("Expected " + std::to_string(numFaces) + " shader indices");
+	}
+
+	std::vector<std::string> shaders;
+	shaders.reserve(shaderNames.size());
+
+	for (const auto& name : shaderNames)
+	{
+		shaders.emplace_back(name.cast<std::string>());
+	}
+
+	auto shaderIndex = shaderIndices.unchecked<1>();
+
+	for (std::size_t i = 0; i < numFaces; ++i)
+	{
+		if (shaderIndex(i) < 0 || static_cast<std::size_t>(shaderIndex(i)) >= shaders.size())
+		{
+			throw std::invalid_argument("Shader index out of range at face " + std::to_string(i));
+		}
+	}
+
+	UndoableCommand cmd("setBrushFaceShaders");
+
+	std::size_t faceIndex = 0;
+
+	for (const auto& node : brushNodes)
+	{
+		auto& brush = *Node_getIBrush(node);
+
+		for (std::size_t f = 0; f < brush.getNumFaces(); ++f, ++faceIndex)
+		{
+			auto& face = brush.getFace(f);
+			const auto& shader = shaders[shaderIndex(faceIndex)];
+
+			if (face.getShader() != shader)
+			{
+				face.setShader(shader);
+			}
+		}
+	}
+}
+
+void BulkSceneInterface::setPatchControlNets(const py::list& nodes, const py::array_t<double>& vertices, const py::object& texcoords)
+{
+	auto patchNodes = getNodesFromList(nodes, Node_isPatch, "patch");
+
+	std::size_t numControls = 0;
+
+	for (const auto& node : patchNodes)
+	{
+		auto patch = Node_getIPatch(node);
+		numControls += patch->getWidth() * patch->getHeight();
+	}
+
+	if (vertices.ndim() != 2 || static_cast<std::size_t>(vertices.shape(0)) != numControls || vertices.shape(1) != 3)
+	{
+		throw std::invalid_argument("Expected " + std::to_string(numControls) + " x 3 vertex coordinates");
+	}
+
+	py::array_t<double> texcoordArray;
+	bool setTexcoords = !texcoords.is_none();
+
+	if (setTexcoords)
+	{
+		texcoordArray = texcoords.cast<py::array_t<double>>();
+
+		if (texcoordArray.ndim() != 2 || static_cast<std::size_t>(texcoordArray.shape(0)) != numControls || texcoordArray.shape(1) != 2)
+		{
+			throw std::invalid_argument("Expected " + std::to_string(numControls) + " x 2 texture coordinates");
+		}
+	}
+
+	auto vertex = vertices.unchecked<2>();
+
+	UndoableCommand cmd("setPatchControlNets");
+
+	std::size_t controlIndex = 0;
+
+	for (const auto& node : patchNodes)
+	{
+		auto& patch = *Node_getIPatch(node);
+
+		patch.undoSave();
+
+		for (std::size_t row = 0; row < patch.getHeight(); ++row)
+		{
+			for (std::size_t col = 0; col < patch.getWidth(); ++col, ++controlIndex)
+			{
+				auto& ctrl = patch.ctrlAt(row, col);
+
+				ctrl.vertex.set(vertex(controlIndex, 0), vertex(controlIndex, 1), vertex(controlIndex, 2));
+
+				if (setTexcoords)
+				{
+					auto texcoord = texcoordArray.unchecked<2>();
+					ctrl.texcoord = Vector2(texcoord(controlIndex, 0), texcoord(controlIndex, 1));
+				}
+			}
+		}
+
+		patch.controlPointsChanged();
+	}
+}
+
+void BulkSceneInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	// Add the module declaration to the given python namespace
+	py::class_<BulkSceneInterface> bulkScene(scope, "BulkScene");
+
+	bulkScene.def("getEntityKeyValues", &BulkSceneInterface::getEntityKeyValues, py::arg("selectedOnly") = false);
+	bulkScene.def("getBrushFaces", &BulkSceneInterface::getBrushFaces, py::arg("selectedOnly") = false);
+	bulkScene.def("getPatchControlNets", &BulkSceneInterface::getPatchControlNets, py::arg("selectedOnly") = false);
+	bulkScene.def("setEntityKeyValues", &BulkSceneInterface::setEntityKeyValues);
+	bulkScene.def("setBrushFaceShaders", &BulkSceneInterface::setBrushFaceShaders);
+	bulkScene.def("setPatchControlNets", &BulkSceneInterface::setPatchControlNets,
+		py::arg("nodes"), py::arg("vertices"), py::arg("texcoords") = py::none());
+
+	// Now point the Python variable "GlobalBulkScene" to this instance
+	globals["GlobalBulkScene"] = this;
+}
+
+} // namespace script
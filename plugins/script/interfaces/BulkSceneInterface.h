@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include "iscript.h"
+#include "iscriptinterface.h"
+#include "inode.h"
+
+namespace script
+{
+
+/**
+ * Bulk access to the scene, for scripts processing all the entities,
+ * brushes or patches of a map. Instead of calling back into Python once
+ * per node, the data of all nodes (or just the selected ones) is gathered
+ * into flat numpy arrays in a single call. Changes are written back in a
+ * single call as well, forming one undoable operation.
+ *
+ * Variable-length data (spawnargs, brush faces, patch control points) is
+ * stored back to back, the offsets array holds the start index of each
+ * node's range plus the total count as last element.
+ */
+class BulkSceneInterface :
+	public IScriptInterface
+{
+public:
+	// Returns a dict with the entity "nodes", their "classnames", "origins" (n x 3),
+	// and their spawnargs in "keys", "values" and "keyValueOffsets" (n + 1)
+	py::dict getEntityKeyValues(bool selectedOnly);
+
+	// Returns a dict with the brush "nodes", their face "planes" (f x 4: normal and distance),
+	// the "shaderIndices" (f) pointing into the "shaderNames" list and the "faceOffsets" (n + 1)
+	py::dict getBrushFaces(bool selectedOnly);
+
+	// Returns a dict with the patch "nodes", their "shaders", "dimensions" (n x 2: width, height),
+	// the control point "vertices" (c x 3) and "texcoords" (c x 2) in row-major order,
+	// and the "controlOffsets" (n + 1)
+	py::dict getPatchControlNets(bool selectedOnly);
+
+	// Sets the spawnarg keys[i] to values[i] on the entity nodes[i], an empty value removes the key
+	void setEntityKeyValues(const py::list& nodes, const py::list& keys, const py::list& values);
+
+	// Assigns the shaders to all brush faces, the shader indices are laid out
+	// like the ones returned by getBrushFaces. Faces keeping their shader are left alone.
+	void setBrushFaceShaders(const py::list& nodes, const py::array_t<int>& shaderIndices, const py::list& shaderNames);
+
+	// Replaces the control points of the given patches, which are keeping their dimensions.
+	// The vertices are laid out like the ones returned by getPatchControlNets,
+	// texcoords can be None to leave the texture coordinates untouched.
+	void setPatchControlNets(const py::list& nodes, const py::array_t<double>& vertices, const py::object& texcoords);
+
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+
+private:
+	void forEachNode(bool selectedOnly, const std::function<void(const scene::INodePtr&)>& functor);
+};
+
+} // namespace script
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <cstdint>
+#include <cstring>
 
 #ifdef __APPLE__
 #include <OpenAL/al.h>
@@ -23,7 +25,8 @@ namespace sound
  */
 class OggFileLoader
 {
-private:
+public:
+    // Decoder state of an OGG file, the compressed file data is copied into memory
     class FileWrapper
     {
     private:
@@ -63,16 +66,51 @@ private:
             ov_clear(&_oggFile);
         }
     };
-public:
+
     /**
      * greebo: Determines the OGG file length in seconds.
+     *
+     * The length is taken from the sample rate in the first page and the
+     * granule position (the number of samples) of the last page, without
+     * decoding anything. Only the file tail is kept in memory while reading.
+     *
      * @throws: std::runtime_error if an error occurs.
      */
     static float GetDuration(ArchiveFile& vfsFile)
     {
-        FileWrapper file(vfsFile);
+        constexpr std::size_t HeaderSize = 4096;
+        constexpr std::size_t TailSize = 65536;
 
-        return static_cast<float>(ov_time_total(file.getHandle(), -1));
+        auto& stream = vfsFile.getInputStream();
+
+        std::vector<unsigned char> header(HeaderSize);
+        header.resize(stream.read(header.data(), header.size()));
+
+        // The last page is found within the tail of the file
+        std::vector<unsigned char> tail(header);
+        std::vector<unsigned char> chunk(TailSize);
+
+        for (auto bytesRead = stream.read(chunk.data(), chunk.size()); bytesRead > 0;
+             bytesRead = stream.read(chunk.data(), chunk.size()))
+        {
+            tail.insert(tail.end(), chunk.begin(), chunk.begin() + bytesRead);
+
+            if (tail.size() > 2 * TailSize)
+            {
+                tail.erase(tail.begin(), tail.end() - TailSize);
+            }
+        }
+
+        std::uint32_t serial = 0;
+        auto sampleRate = ParseSampleRate(header, serial);
+        auto numSamples = FindLastGranulePosition(tail, serial);
+
+        if (sampleRate == 0 || numSamples < 0)
+        {
+            throw std::runtime_error("Invalid OGG page structure");
+        }
+
+        return static_cast<float>(static_cast<double>(numSamples) / sampleRate);
     }
 
     /**
@@ -135,6 +173,70 @@ public:
 
         return bufferNum;
     }
+
+private:
+    // Size of an OGG page header without the segment table
+    static constexpr std::size_t PageHeaderSize = 27;
+
+    template<typename T>
+    static T ReadLittleEndian(const unsigned char* data)
+    {
+        T value = 0;
+
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            value |= static_cast<T>(data[i]) << (8 * i);
+        }
+
+        return value;
+    }
+
+    static bool IsPageStart(const std::vector<unsigned char>& data, std::size_t offset)
+    {
+        return offset + PageHeaderSize <= data.size() &&
+            std::memcmp(data.data() + offset, "OggS", 4) == 0 && data[offset + 4] == 0;
+    }
+
+    // Reads the sample rate from the vorbis identification header in the first page
+    static std::uint32_t ParseSampleRate(const std::vector<unsigned char>& header, std::uint32_t& serial)
+    {
+        if (!IsPageStart(header, 0)) return 0;
+
+        serial = ReadLittleEndian<std::uint32_t>(header.data() + 14);
+
+        // The packet follows the segment table: type 1, "vorbis", version, channels, rate
+        auto packetStart = PageHeaderSize + header[26];
+
+        if (packetStart + 16 > header.size() || header[packetStart] != 1 ||
+            std::memcmp(header.data() + packetStart + 1, "vorbis", 6) != 0)
+        {
+            return 0;
+        }
+
+        return ReadLittleEndian<std::uint32_t>(header.data() + packetStart + 12);
+    }
+
+    // Returns the granule position of the last page of the given stream, or -1
+    static std::int64_t FindLastGranulePosition(const std::vector<unsigned char>& tail, std::uint32_t serial)
+    {
+        for (auto offset = tail.size() >= PageHeaderSize ? tail.size() - PageHeaderSize + 1 : 0; offset-- > 0;)
+        {
+            if (!IsPageStart(tail, offset) || ReadLittleEndian<std::uint32_t>(tail.data() + offset + 14) != serial)
+            {
+                continue;
+            }
+
+            auto granule = static_cast<std::int64_t>(ReadLittleEndian<std::uint64_t>(tail.data() + offset + 6));
+
+            // Pages without a finished packet carry a granule position of -1
+            if (granule >= 0)
+            {
+                return granule;
+            }
+        }
+
+        return -1;
+    }
 };
 
 }
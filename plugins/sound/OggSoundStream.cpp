@@ -0,0 +1,160 @@
+#include "OggSoundStream.h"
+
+#include <chrono>
+#include "itextstream.h"
+
+namespace sound
+{
+
+OggSoundStream::OggSoundStream(ArchiveFile& file, ALuint source, bool loop) :
+    _file(std::make_unique<OggFileLoader::FileWrapper>(file)),
+    _source(source),
+    _buffers{},
+    _loop(loop),
+    _stopRequested(false),
+    _finished(false)
+{
+    // Get some information about the OGG file, this throws if the file is invalid
+    vorbis_info* vorbisInfo = ov_info(_file->getHandle(), -1);
+
+    _format = (vorbisInfo->channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    _frequency = static_cast<ALsizei>(vorbisInfo->rate);
+
+    alGenBuffers(static_cast<ALsizei>(_buffers.size()), _buffers.data());
+}
+
+OggSoundStream::~OggSoundStream()
+{
+    _stopRequested = true;
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    // Release the buffers still queued on the source before deleting them
+    alSourceStop(_source);
+    alSourcei(_source, AL_BUFFER, 0);
+
+    alDeleteBuffers(static_cast<ALsizei>(_buffers.size()), _buffers.data());
+}
+
+void OggSoundStream::start()
+{
+    _thread = std::thread(&OggSoundStream::run, this);
+}
+
+bool OggSoundStream::isFinished() const
+{
+    return _finished;
+}
+
+void OggSoundStream::run()
+{
+    std::vector<char> data(BufferSize);
+
+    // Fill the queue before starting the source
+    std::size_t numQueued = 0;
+
+    for (auto buffer : _buffers)
+    {
+        if (!fillBuffer(buffer, data)) break;
+
+        alSourceQueueBuffers(_source, 1, &buffer);
+        ++numQueued;
+    }
+
+    if (numQueued > 0)
+    {
+        alSourcePlay(_source);
+    }
+
+    auto endOfFile = false;
+
+    while (numQueued > 0 && !_stopRequested)
+    {
+        ALint numProcessed = 0;
+        alGetSourcei(_source, AL_BUFFERS_PROCESSED, &numProcessed);
+
+        // Refill the buffers the source is done with and put them back in the queue
+        for (; numProcessed > 0; --numProcessed)
+        {
+            ALuint buffer = 0;
+            alSourceUnqueueBuffers(_source, 1, &buffer);
+            --numQueued;
+
+            if (!endOfFile && fillBuffer(buffer, data))
+            {
+                alSourceQueueBuffers(_source, 1, &buffer);
+                ++numQueued;
+            }
+            else
+            {
+                endOfFile = true;
+            }
+        }
+
+        ALint state = 0;
+        alGetSourcei(_source, AL_SOURCE_STATE, &state);
+
+        if (state != AL_PLAYING && numQueued > 0)
+        {
+            // The source ran dry before we could refill it, resume playback
+            alSourcePlay(_source);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    _finished = true;
+}
+
+bool OggSoundStream::fillBuffer(ALuint buffer, std::vector<char>& data)
+{
+    std::size_t size = 0;
+    auto rewound = false;
+
+    while (size < data.size())
+    {
+        int bitStream;
+        auto bytes = ov_read(_file->getHandle(), data.data() + size, static_cast<int>(data.size() - size), 0, 2, 1, &bitStream);
+
+        if (bytes > 0)
+        {
+            size += bytes;
+            rewound = false;
+            continue;
+        }
+
+        if (bytes == OV_HOLE)
+        {
+            // Interruption in the data, continue with the next chunk
+            rError() << "Error decoding OGG: OV_HOLE.\n";
+            continue;
+        }
+
+        if (bytes < 0)
+        {
+            rError() << "Error decoding OGG: " << bytes << "\n";
+        }
+        else if (_loop && !rewound)
+        {
+            // End of file, start over (but don't spin on files without any samples)
+            rewound = true;
+
+            if (ov_raw_seek(_file->getHandle(), 0) == 0) continue;
+        }
+
+        break;
+    }
+
+    if (size == 0)
+    {
+        return false;
+    }
+
+    alBufferData(buffer, _format, data.data(), static_cast<ALsizei>(size), _frequency);
+    return true;
+}
+
+}
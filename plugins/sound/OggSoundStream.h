@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "OggFileLoader.h"
+
+namespace sound
+{
+
+/**
+ * Plays an OGG file through a queue of small AL buffers, which are decoded
+ * and refilled on a worker thread while the source is playing. Playback
+ * starts right away, regardless of the length of the file.
+ *
+ * The stream takes over the given AL source until it is destroyed. Looping
+ * is handled by the stream, the source's AL_LOOPING flag must not be set.
+ */
+class OggSoundStream
+{
+private:
+    static constexpr std::size_t NumBuffers = 4;
+
+    // Roughly 0.37 seconds of 16 bit stereo sound at 44.1 kHz
+    static constexpr std::size_t BufferSize = 65536;
+
+    std::unique_ptr<OggFileLoader::FileWrapper> _file;
+
+    ALuint _source;
+    std::array<ALuint, NumBuffers> _buffers;
+
+    ALenum _format;
+    ALsizei _frequency;
+    bool _loop;
+
+    std::atomic<bool> _stopRequested;
+    std::atomic<bool> _finished;
+
+    std::thread _thread;
+
+public:
+    // Copies the file data, throws std::runtime_error if the file cannot be opened
+    OggSoundStream(ArchiveFile& file, ALuint source, bool loop);
+
+    OggSoundStream(const OggSoundStream& other) = delete;
+    OggSoundStream& operator=(const OggSoundStream& other) = delete;
+
+    // Stops the playback and waits for the worker thread
+    ~OggSoundStream();
+
+    // Begins decoding and playing the file on the worker thread
+    void start();
+
+    // True when the end of the file has been played, or after an error
+    bool isFinished() const;
+
+private:
+    void run();
+
+    // Decodes the next chunk into the given buffer, returns false at the end of the file
+    bool fillBuffer(ALuint buffer, std::vector<char>& data);
+};
+
+}
@@ -48,6 +48,25 @@ ArchiveFilePtr openSoundFile(const std::string& fileName)
     return GlobalFileSystem().openFile(os::replaceExtension(fileName, ".wav"));
 }
 
+// Returns the path of the archive (or physical file) containing the given VFS file
+// along with its modification time, which is used to detect file changes
+std::pair<std::string, fs::file_time_type> getFileTimestamp(const std::string& vfsPath)
+{
+    auto info = GlobalFileSystem().getFileInfo(vfsPath);
+
+    if (info.isEmpty())
+    {
+        return {};
+    }
+
+    auto path = info.getIsPhysicalFile() ? info.getArchivePath() + info.fullPath() : info.getArchivePath();
+
+    std::error_code errorCode;
+    auto timestamp = fs::last_write_time(path, errorCode);
+
+    return { path, errorCode ? fs::file_time_type() : timestamp };
+}
+
 }
 
 SoundManager::SoundManager()
@@ -148,6 +167,25 @@ void SoundManager::initialiseModule(const IApplicationContext& ctx)
 
 float SoundManager::getSoundFileDuration(const std::string& vfsPath)
 {
+    {
+        std::lock_guard<std::mutex> lock(_durationCacheLock);
+
+        auto cached = _durationCache.find(vfsPath);
+
+        if (cached != _durationCache.end())
+        {
+            // The cached value is good as long as the file resolves to the same unmodified archive
+            auto [archivePath, timestamp] = getFileTimestamp(cached->second.resolvedPath);
+
+            if (archivePath == cached->second.archivePath && timestamp == cached->second.timestamp)
+            {
+                return cached->second.duration;
+            }
+
+            _durationCache.erase(cached);
+        }
+    }
+
     auto file = openSoundFile(vfsPath);
 
     if (!file)
@@ -155,17 +193,31 @@ float SoundManager::getSoundFileDuration(const std::string& vfsPath)
         throw std::out_of_range("Could not resolve sound file " + vfsPath);
     }
 
-    auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+    auto duration = determineSoundFileDuration(*file);
+    auto [archivePath, timestamp] = getFileTimestamp(file->getName());
+
+    if (!archivePath.empty())
+    {
+        std::lock_guard<std::mutex> lock(_durationCacheLock);
+        _durationCache[vfsPath] = CachedDuration{ file->getName(), archivePath, timestamp, duration };
+    }
+
+    return duration;
+}
+
+float SoundManager::determineSoundFileDuration(ArchiveFile& file)
+{
+    auto extension = string::to_lower_copy(os::getExtension(file.getName()));
 
     try
     {
         if (extension == "wav")
         {
-            return WavFileLoader::GetDuration(file->getInputStream());
+            return WavFileLoader::GetDuration(file.getInputStream());
         }
         else if (extension == "ogg")
         {
-            return OggFileLoader::GetDuration(*file);
+            return OggFileLoader::GetDuration(file);
         }
     }
     catch (const std::runtime_error& ex)
@@ -3,8 +3,11 @@
 #include "SoundShader.h"
 #include "SoundPlayer.h"
 
+#include <map>
+#include <mutex>
 #include "isound.h"
 #include "icommandsystem.h"
+#include "os/fs.h"
 
 namespace sound
 {
@@ -21,6 +24,18 @@ private:
 
     sigc::signal<void> _sigSoundShadersReloaded;
 
+    // Durations of the sound files queried so far, validated against the
+    // modification time of the file or the archive containing it
+    struct CachedDuration
+    {
+        std::string resolvedPath; // the file found by trying different extensions
+        std::string archivePath;
+        fs::file_time_type timestamp;
+        float duration;
+    };
+    std::map<std::string, CachedDuration> _durationCache;
+    std::mutex _durationCacheLock;
+
 public:
 	SoundManager();
 
@@ -37,6 +52,9 @@ public:
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+
+private:
+    float determineSoundFileDuration(ArchiveFile& file);
 };
 
 }
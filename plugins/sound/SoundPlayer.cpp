@@ -18,7 +18,7 @@
 #endif
 
 #include "WavFileLoader.h"
-#include "OggFileLoader.h"
+#include "OggSoundStream.h"
 
 namespace sound
 {
@@ -93,6 +93,13 @@ SoundPlayer::~SoundPlayer() {
 
 void SoundPlayer::onTimerIntervalReached(wxTimerEvent& ev)
 {
+	// Streams stop on their own, we just need to clean up
+	if (_stream && _stream->isFinished())
+	{
+		clearBuffer();
+		return;
+	}
+
 	// Check for active source and buffer
 	if (_source != 0 && _buffer != 0)
 	{
@@ -115,6 +122,9 @@ void SoundPlayer::clearBuffer()
 {
 	// Check if there is an active buffer
 	if (_source != 0) {
+		// The stream releases its buffers, the source is still needed for that
+		_stream.reset();
+
 		// Stop playing
 		alSourceStop(_source);
 		alDeleteSources(1, &_source);
@@ -151,13 +161,13 @@ void SoundPlayer::play(ArchiveFile& file, bool loopSound)
 
 	if (string::to_lower_copy(ext) == "ogg")
 	{
-		createBufferDataFromOgg(file);
-	}
-	else 
-	{
-		createBufferDataFromWav(file);
+		// OGG files are decoded on the fly, no need to wait for the whole file
+		startOggStream(file, loopSound);
+		return;
 	}
 
+	createBufferDataFromWav(file);
+
 	if (_buffer != 0) 
 	{
 		alGenSources(1, &_source);
@@ -195,18 +205,22 @@ void SoundPlayer::createBufferDataFromWav(ArchiveFile& file)
 	}
 }
 
-void SoundPlayer::createBufferDataFromOgg(ArchiveFile& file)
+void SoundPlayer::startOggStream(ArchiveFile& file, bool loopSound)
 {
-    // Must be an OGG file
+    alGenSources(1, &_source);
+
     try
     {
-        // Create an AL sound buffer directly from the buffer in memory
-        _buffer = OggFileLoader::LoadFromFile(file);
+        _stream = std::make_unique<OggSoundStream>(file, _source, loopSound);
+        _stream->start();
+
+        // Enable the periodic check, this cleans up after the stream is done
+        _timer.Start(200);
     }
     catch (std::runtime_error & e)
     {
         rError() << "SoundPlayer: Error opening OGG file: " << e.what() << std::endl;
-        _buffer = 0;
+        clearBuffer();
     }
 }
 
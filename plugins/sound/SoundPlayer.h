@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <memory>
 
 #ifdef __APPLE__
 #include <OpenAL/al.h>
@@ -16,6 +17,8 @@ class ArchiveFile;
 
 namespace sound {
 
+class OggSoundStream;
+
 class SoundPlayer :
 	public wxEvtHandler
 {
@@ -31,6 +34,9 @@ protected:
 	// The source playing the buffer
 	ALuint _source;
 
+	// OGG files are streamed into the source instead of using a single buffer
+	std::unique_ptr<OggSoundStream> _stream;
+
 	// The timer object to check whether the sound is done playing
 	// to destroy the buffer afterwards
 	wxTimer _timer;
@@ -63,7 +69,7 @@ protected:
 	// This is called periodically to check whether the buffer can be cleared
 	void onTimerIntervalReached(wxTimerEvent& ev);
 
-	void createBufferDataFromOgg(ArchiveFile& file);
+	void startOggStream(ArchiveFile& file, bool loopSound);
 	void createBufferDataFromWav(ArchiveFile& file);
 };
 
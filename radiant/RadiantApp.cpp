@@ -232,6 +232,7 @@ void RadiantApp::OnInitCmdLine(wxCmdLineParser& parser)
 	parser.SetSwitchChars("-");
 
 	parser.AddLongSwitch("disable-sound", _("Disable sound for this session."));
+	parser.AddLongSwitch("profile", _("Record profiling spans from startup on."));
 	parser.AddLongOption("verbose", _("Verbose logging."));
 
 	parser.AddParam("Map file", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
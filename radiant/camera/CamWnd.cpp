@@ -854,6 +854,8 @@ void CamWnd::Cam_Draw()
             result = GlobalRenderSystem().renderFullBrightScene(RenderViewType::Camera, allowedRenderFlags, _view);
         }
 
+        _renderStats.setDrawCalls(result->getDrawCalls(), result->getInstancedDrawCalls());
+
         _renderer->cleanup();
 
         GlobalRenderSystem().endFrame();
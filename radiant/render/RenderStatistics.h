@@ -15,6 +15,10 @@ class RenderStatistics
     // Time for the render front-end only
     long _feTime = 0;
 
+    // Draw calls issued by the back-end
+    std::size_t _drawCalls = 0;
+    std::size_t _instancedDrawCalls = 0;
+
 public:
 
     /// Return the constructed string for display
@@ -27,7 +31,16 @@ public:
         return " | f/e: " + std::to_string(_feTime) + " ms"
              + " | b/e: " + std::to_string(beTime) + " ms"
              + " | tot: " + std::to_string(totTime) + " ms"
-             + " | fps: " + (totTime > 0 ? std::to_string(1000 / totTime) : "-");
+             + " | fps: " + (totTime > 0 ? std::to_string(1000 / totTime) : "-")
+             + " | draws: " + std::to_string(_drawCalls)
+             + " (instanced: " + std::to_string(_instancedDrawCalls) + ")";
+    }
+
+    /// Store the draw call counts reported by the back-end
+    void setDrawCalls(std::size_t drawCalls, std::size_t instancedDrawCalls)
+    {
+        _drawCalls = drawCalls;
+        _instancedDrawCalls = instancedDrawCalls;
     }
 
     /// Mark the front-end render stage as completed, storing the time internally
@@ -40,6 +53,8 @@ public:
     void resetStats()
     {
         _feTime = 0;
+        _drawCalls = 0;
+        _instancedDrawCalls = 0;
         _timer.Start();
     }
 };
@@ -219,6 +219,12 @@ void UserInterfaceModule::initialiseModule(const IApplicationContext& ctx)
 		radiant::IMessage::Type::Notification,
         radiant::TypeListener<radiant::NotificationMessage>(UserInterfaceModule::HandleNotificationMessage));
 
+    // Messages posted by worker threads are delivered through the event loop
+    GlobalRadiantCore().getMessageBus().setPostedMessageNotifier([this]()
+    {
+        dispatch([]() { GlobalRadiantCore().getMessageBus().processPostedMessages(); });
+    });
+
 	SelectionSetToolmenu::Init();
 
 	_mruMenu.reset(new MRUMenu);
@@ -294,6 +300,7 @@ void UserInterfaceModule::shutdownModule()
 
 	GlobalRadiantCore().getMessageBus().removeListener(_execFailedListener);
 	GlobalRadiantCore().getMessageBus().removeListener(_notificationListener);
+    GlobalRadiantCore().getMessageBus().setPostedMessageNotifier({});
 
     _reloadMaterialsConn.disconnect();
 	_coloursUpdatedConn.disconnect();
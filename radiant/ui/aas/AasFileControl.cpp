@@ -1,9 +1,7 @@
 #include "AasFileControl.h"
 
 #include "i18n.h"
-#include "iarchive.h"
 #include "ui/imainframe.h"
-#include "ifilesystem.h"
 
 #include <wx/event.h>
 #include <wx/button.h>
@@ -68,22 +66,12 @@ void AasFileControl::ensureAasFileLoaded()
 {
     if (_aasFile) return;
 
-    ArchiveTextFilePtr file = GlobalFileSystem().openTextFileInAbsolutePath(_info.absolutePath);
+    _aasFile = GlobalAasFileManager().loadAasFile(_info.absolutePath);
 
-    if (file)
+    if (_aasFile)
     {
-        std::istream stream(&file->getInputStream());
-        map::IAasFileLoaderPtr loader = GlobalAasFileManager().getLoaderForStream(stream);
-
-        if (loader && loader->canLoad(stream))
-        {
-            stream.seekg(0, std::ios_base::beg);
-
-            _aasFile = loader->loadFromStream(stream);
-
-            // Construct a renderable to attach to the rendersystem
-            _renderable.setAasFile(_aasFile);
-        }
+        // Construct a renderable to attach to the rendersystem
+        _renderable.setAasFile(_aasFile);
     }
 }
 
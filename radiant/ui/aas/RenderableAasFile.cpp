@@ -4,6 +4,7 @@
 #include "iregistry.h"
 #include "ui/imainframe.h"
 #include "ivolumetest.h"
+#include <algorithm>
 
 #include "registry/registry.h"
 
@@ -14,6 +15,7 @@ RenderableAasFile::RenderableAasFile() :
 	_renderNumbers(registry::getValue<bool>(RKEY_SHOW_AAS_AREA_NUMBERS)),
 	_hideDistantAreas(registry::getValue<bool>(RKEY_HIDE_DISTANT_AAS_AREAS)),
 	_hideDistanceSquared(registry::getValue<float>(RKEY_AAS_AREA_HIDE_DISTANCE)),
+    _visibilityChanged(true),
     _renderableAreas(_visibleAreas, { 1,1,1,1 })
 {
 	_hideDistanceSquared *= _hideDistanceSquared;
@@ -28,6 +30,7 @@ RenderableAasFile::RenderableAasFile() :
 void RenderableAasFile::onShowAreaNumbersChanged()
 {
     _renderNumbers = registry::getValue<bool>(RKEY_SHOW_AAS_AREA_NUMBERS);
+    _visibilityChanged = true;
     GlobalMainFrame().updateAllWindows();
 }
 
@@ -37,12 +40,7 @@ void RenderableAasFile::onHideDistantAreasChanged()
     _hideDistanceSquared = registry::getValue<float>(RKEY_AAS_AREA_HIDE_DISTANCE);
     _hideDistanceSquared *= _hideDistanceSquared;
 
-    if (!_hideDistantAreas)
-    {
-        _visibleAreas = _areas;
-    }
-
-    _renderableAreas.queueUpdate();
+    _visibilityChanged = true;
     GlobalMainFrame().updateAllWindows();
 }
 
@@ -67,43 +65,60 @@ void RenderableAasFile::onPreRender(const VolumeTest& volume)
         _textRenderer = renderSystem->captureTextRenderer(IGLFont::Style::Sans, 14);
     }
 
-    if (_hideDistantAreas)
-    {
-        // Get the camera position for distance clipping
-        auto invModelView = volume.GetModelview().getFullInverse();
-        auto viewPos = invModelView.tCol().getProjected();
+    updateVisibleAreas(volume);
 
-        _visibleAreas.clear();
+    _renderableAreas.update(_normalShader);
+}
 
-        for (const auto& area : _areas)
-        {
-            if ((area.getOrigin() - viewPos).getLengthSquared() > _hideDistanceSquared)
-            {
-                continue;
-            }
+void RenderableAasFile::updateVisibleAreas(const VolumeTest& volume)
+{
+    // Get the camera position for distance clipping
+    auto invModelView = volume.GetModelview().getFullInverse();
+    auto viewPos = invModelView.tCol().getProjected();
 
-            _visibleAreas.push_back(area);
-        }
+    std::vector<int> visibleAreaNums;
 
-        for (auto& [areaNum, text] : _renderableNumbers)
+    // Only the areas in the view frustum are considered, looked up through the AAS file's area tree
+    _aasFile->forEachVisibleArea(volume, [&](int areaNum)
+    {
+        if (_hideDistantAreas &&
+            (_aasFile->getArea(areaNum).bounds.getOrigin() - viewPos).getLengthSquared() > _hideDistanceSquared)
         {
-            text.setVisible(_renderNumbers && 
-                (_aasFile->getArea(areaNum).center - viewPos).getLengthSquared() <= _hideDistanceSquared);
-            text.update(_textRenderer);
+            return;
         }
 
-        _renderableAreas.queueUpdate();
+        visibleAreaNums.push_back(areaNum);
+    });
+
+    std::sort(visibleAreaNums.begin(), visibleAreaNums.end());
+
+    if (!_visibilityChanged && visibleAreaNums == _visibleAreaNums)
+    {
+        return;
+    }
+
+    _visibilityChanged = false;
+
+    // Hide the numbers of the previously visible areas, then show the current ones
+    for (auto areaNum : _visibleAreaNums)
+    {
+        _renderableNumbers.at(areaNum).setVisible(false);
     }
-    else
+
+    _visibleAreaNums.swap(visibleAreaNums);
+    _visibleAreas.clear();
+    _visibleAreas.reserve(_visibleAreaNums.size());
+
+    for (auto areaNum : _visibleAreaNums)
     {
-        for (auto& [_, text] : _renderableNumbers)
-        {
-            text.setVisible(_renderNumbers);
-            text.update(_textRenderer);
-        }
+        _visibleAreas.push_back(_aasFile->getArea(areaNum).bounds);
+
+        auto& text = _renderableNumbers.at(areaNum);
+        text.setVisible(_renderNumbers);
+        text.update(_textRenderer);
     }
 
-    _renderableAreas.update(_normalShader);
+    _renderableAreas.queueUpdate();
 }
 
 std::size_t RenderableAasFile::getHighlightFlags()
@@ -133,24 +148,21 @@ void RenderableAasFile::prepare()
 
 void RenderableAasFile::constructRenderables()
 {
-    _areas.clear();
     _renderableNumbers.clear();
+    _visibleAreas.clear();
+    _visibleAreaNums.clear();
 
 	for (std::size_t areaNum = 0; areaNum < _aasFile->getNumAreas(); ++areaNum)
 	{
 		const IAasFile::Area& area = _aasFile->getArea(static_cast<int>(areaNum));
 
-		_areas.push_back(area.bounds);
-
-        // Allocate a new RenderableNumber for each area
-        _renderableNumbers.try_emplace(areaNum, string::to_string(areaNum), area.center, Vector4(1, 1, 1, 1));
+        // Allocate a new RenderableNumber for each area, it is shown once the area is visible
+        auto text = _renderableNumbers.try_emplace(static_cast<int>(areaNum),
+            string::to_string(areaNum), area.center, Vector4(1, 1, 1, 1));
+        text.first->second.setVisible(false);
 	}
 
-    if (!_hideDistantAreas)
-    {
-        _visibleAreas = _areas;
-    }
-
+    _visibilityChanged = true;
     _renderableAreas.queueUpdate();
 }
 
@@ -158,8 +170,8 @@ void RenderableAasFile::clear()
 {
     _aasFile.reset();
     _renderableAreas.clear();
-    _areas.clear();
     _visibleAreas.clear();
+    _visibleAreaNums.clear();
     _renderableNumbers.clear();
     _normalShader.reset();
     _textRenderer.reset();
@@ -29,15 +29,19 @@ private:
 	ShaderPtr _normalShader;
     ITextRenderer::Ptr _textRenderer;
 
-    std::vector<AABB> _areas;
+    // The bounds of the areas visible in the last rendered view
     std::vector<AABB> _visibleAreas;
 
+    // The (sorted) numbers of the areas visible in the last rendered view
+    std::vector<int> _visibleAreaNums;
+    bool _visibilityChanged;
+
 	bool _renderNumbers;
 	bool _hideDistantAreas;
 	float _hideDistanceSquared;
 
     render::RenderableBoundingBoxes _renderableAreas;
-    std::map<std::size_t, render::StaticRenderableText> _renderableNumbers;
+    std::map<int, render::StaticRenderableText> _renderableNumbers;
 
 public:
 	RenderableAasFile();
@@ -56,6 +60,7 @@ public:
 private:
 	void prepare();
 	void constructRenderables();
+    void updateVisibleAreas(const VolumeTest& volume);
     void onHideDistantAreasChanged();
     void onShowAreaNumbersChanged();
 };
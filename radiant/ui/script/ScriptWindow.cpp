@@ -24,7 +24,8 @@ namespace
 
 ScriptWindow::ScriptWindow(wxWindow* parent) :
     DockablePanel(parent),
-	_outView(new wxutil::ConsoleView(this))
+	_outView(new wxutil::ConsoleView(this)),
+	_asyncTimer(this)
 {
 	SetSizer(new wxBoxSizer(wxVERTICAL));
 
@@ -39,13 +40,25 @@ ScriptWindow::ScriptWindow(wxWindow* parent) :
 
 	auto editLabel = new wxStaticText(editPanel, wxID_ANY, _("Python Script Input"));
 
-    auto buttonPanel = new wxFlexGridSizer(1, 2, 6, 6);
-    buttonPanel->AddGrowableCol(1);
+    auto buttonPanel = new wxFlexGridSizer(1, 4, 6, 6);
+    buttonPanel->AddGrowableCol(2);
 
 	auto runButton = new wxButton(editPanel, wxID_ANY, _("Run Script"));
 	runButton->Bind(wxEVT_BUTTON, &ScriptWindow::onRunScript, this);
     buttonPanel->Add(runButton, 0, wxALIGN_LEFT);
 
+	// Background scripts only get to see a snapshot of the scene
+	_runAsyncButton = new wxButton(editPanel, wxID_ANY, _("Run in Background"));
+	_runAsyncButton->SetToolTip(_("Runs the script without blocking the editor. The script can read the scene "
+		"through the Snapshot object and report its progress through AsyncScript."));
+	_runAsyncButton->Bind(wxEVT_BUTTON, &ScriptWindow::onRunScriptAsync, this);
+    buttonPanel->Add(_runAsyncButton, 0, wxALIGN_LEFT);
+
+	_progressLabel = new wxStaticText(editPanel, wxID_ANY, "");
+    buttonPanel->Add(_progressLabel, 0, wxALIGN_CENTER_VERTICAL | wxEXPAND);
+
+	Bind(wxEVT_TIMER, &ScriptWindow::onAsyncTimer, this);
+
     auto scriptReferenceUrl = registry::getValue<std::string>(RKEY_SCRIPT_REFERENCE_URL);
 
     if (!scriptReferenceUrl.empty())
@@ -79,27 +92,91 @@ ScriptWindow::ScriptWindow(wxWindow* parent) :
 
 ScriptWindow::~ScriptWindow()
 {
+    _asyncTimer.Stop();
+
+    // Releasing a running script will cancel it
+    _asyncExecution.reset();
+
     _panedPosition.saveToPath(RKEY_WINDOW_STATE);
 }
 
+std::string ScriptWindow::getScriptString()
+{
+	// Extract the script from the input window
+	std::string scriptString = _view->GetValue().ToStdString();
+
+	// wxWidgets on Windows might produce \r\n, these confuse the python interpreter
+	string::replace_all(scriptString, "\r\n", "\n");
+
+	return scriptString;
+}
+
 void ScriptWindow::onRunScript(wxCommandEvent& ev)
 {
 	// Clear the output window before running
 	_outView->Clear();
 
-	// Extract the script from the input window
-	std::string scriptString = _view->GetValue().ToStdString();
+	std::string scriptString = getScriptString();
 
 	if (scriptString.empty()) return;
 
 	UndoableCommand cmd("runScript");
 
-	// wxWidgets on Windows might produce \r\n, these confuse the python interpreter
-	string::replace_all(scriptString, "\r\n", "\n");
-
 	// Run the script
-	script::ExecutionResultPtr result = GlobalScriptingSystem().executeString(scriptString);
+	displayResult(GlobalScriptingSystem().executeString(scriptString));
+}
 
+void ScriptWindow::onRunScriptAsync(wxCommandEvent& ev)
+{
+	// The button doubles as cancel button while a script is running
+	if (_asyncExecution)
+	{
+		_asyncExecution->cancel();
+		return;
+	}
+
+	_outView->Clear();
+
+	std::string scriptString = getScriptString();
+
+	if (scriptString.empty()) return;
+
+	_asyncExecution = GlobalScriptingSystem().executeStringAsync(scriptString);
+
+	_runAsyncButton->SetLabel(_("Cancel"));
+	_progressLabel->SetLabel(_("Running..."));
+	_asyncTimer.Start(100);
+}
+
+void ScriptWindow::onAsyncTimer(wxTimerEvent& ev)
+{
+	if (!_asyncExecution) return;
+
+	// Run any commands the script queued for the main thread
+	_asyncExecution->processPendingCommands();
+
+	if (!_asyncExecution->isFinished())
+	{
+		auto text = _asyncExecution->getProgressText();
+		auto percentage = static_cast<int>(_asyncExecution->getProgress() * 100);
+
+		_progressLabel->SetLabel(text.empty() ? fmt::format("{0}%", percentage) : fmt::format("{0}% {1}", percentage, text));
+		return;
+	}
+
+	_asyncTimer.Stop();
+
+	auto result = _asyncExecution->waitForResult();
+	_asyncExecution.reset();
+
+	_runAsyncButton->SetLabel(_("Run in Background"));
+	_progressLabel->SetLabel("");
+
+	displayResult(result);
+}
+
+void ScriptWindow::displayResult(const script::ExecutionResultPtr& result)
+{
 	// Check if the output only consists of whitespace
 	std::string output = string::replace_all_copy(result->output, "\n", "");
 	string::replace_all(output, "\t", "");
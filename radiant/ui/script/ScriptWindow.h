@@ -1,10 +1,14 @@
 #pragma once
 
+#include "iscript.h"
+#include <wx/timer.h>
 #include "wxutil/ConsoleView.h"
 #include "wxutil/DockablePanel.h"
 #include "wxutil/PanedPosition.h"
 
 class wxCommandEvent;
+class wxButton;
+class wxStaticText;
 namespace wxutil { class PythonSourceViewCtrl; }
 
 class wxSplitterWindow;
@@ -24,6 +28,12 @@ private:
 
     wxutil::PanedPosition _panedPosition;
 
+    // Script running in the background, if any
+    script::IAsyncScriptExecution::Ptr _asyncExecution;
+    wxButton* _runAsyncButton;
+    wxStaticText* _progressLabel;
+    wxTimer _asyncTimer;
+
 public:
 	ScriptWindow(wxWindow* parent);
     ~ScriptWindow() override;
@@ -33,6 +43,10 @@ public:
 
 private:
 	void onRunScript(wxCommandEvent& ev);
+	void onRunScriptAsync(wxCommandEvent& ev);
+	void onAsyncTimer(wxTimerEvent& ev);
+	void displayResult(const script::ExecutionResultPtr& result);
+	std::string getScriptString();
     void restoreSettings();
 };
 
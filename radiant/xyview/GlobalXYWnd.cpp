@@ -150,6 +150,7 @@ void XYWndManager::constructPreferences()
 	page.appendCheckBox(_("Show Workzone"), RKEY_SHOW_WORKZONE);
 	page.appendCheckBox(_("Translate Manipulator always constrained to Axis"), RKEY_TRANSLATE_CONSTRAINED);
 	page.appendCheckBox(_("Higher Selection Priority for Entities"), RKEY_HIGHER_ENTITY_PRIORITY);
+	page.appendCheckBox(_("Use multiple Threads for Area Selection"), RKEY_PARALLEL_SELECTION_TESTS);
     page.appendSpinner(_("Maximum Zoom Factor"), RKEY_MAX_ZOOM_FACTOR, 1, 65536, 0);
 	page.appendCheckBox(_("Zoom centers on Mouse Cursor"), RKEY_CURSOR_CENTERED_ZOOM);
     page.appendCombo(_("Font Style"), RKEY_FONT_STYLE, { "Sans", "Mono" }, true);
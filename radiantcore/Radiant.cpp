@@ -1,6 +1,7 @@
 #include "Radiant.h"
 
 #include <iomanip>
+#include <algorithm>
 #include "version.h"
 
 #include "string/convert.h"
@@ -13,6 +14,7 @@
 #include "module/StaticModule.h"
 #include "messagebus/MessageBus.h"
 #include "settings/LanguageManager.h"
+#include "profiling/Profiler.h"
 
 namespace radiant
 {
@@ -36,6 +38,15 @@ Radiant::Radiant(IApplicationContext& context) :
 	// Attach the logfile to the logwriter
 	createLogFile();
 
+	// Record spans right from the start, such that the module initialisation is covered
+	const auto& args = _context.getCmdLineArgs();
+
+	if (std::find(args.begin(), args.end(), "--profile") != args.end())
+	{
+		rMessage() << "Profiling enabled through the command line" << std::endl;
+		getProfiler().setEnabled(true);
+	}
+
 #ifdef POSIX
     applog::SegFaultHandler::Install();
 #endif
@@ -80,6 +91,11 @@ language::ILanguageManager& Radiant::getLanguageManager()
 	return *_languageManager;
 }
 
+profiling::IProfiler& Radiant::getProfiler()
+{
+	return profiling::Profiler::Instance();
+}
+
 void Radiant::startup()
 {
 	try
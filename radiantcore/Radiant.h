@@ -38,6 +38,7 @@ public:
 	module::ModuleRegistry& getModuleRegistry() override;
 	radiant::IMessageBus& getMessageBus() override;
 	language::ILanguageManager& getLanguageManager() override;
+	profiling::IProfiler& getProfiler() override;
 	void startup() override;
 
 	static std::shared_ptr<Radiant>& InstancePtr();
@@ -29,6 +29,7 @@ EntityClass::EntityClass(const std::string& name)
 EntityClass::~EntityClass()
 {
     _parentChangedConnection.disconnect();
+    _parentAttributesChangedConnection.disconnect();
 }
 
 IEntityClass* EntityClass::getParent()
@@ -247,6 +248,19 @@ void EntityClass::forEachAttribute(AttributeVisitor visitor,
 {
     ensureParsed();
 
+    // Use the flattened table if available, it's already free of duplicates
+    if (_resolvedAttributesEnabled)
+    {
+        for (const auto& resolved : _resolvedAttributes)
+        {
+            if (editorKeys || !resolved.isEditorKey)
+            {
+                visitor(*resolved.attribute, resolved.inherited);
+            }
+        }
+        return;
+    }
+
     // First compile a map of all attributes we need to pass to the visitor,
     // ensuring that there is only one attribute per name (i.e. we don't want to
     // visit the same-named attribute on both a child and one of its ancestors)
@@ -270,6 +284,73 @@ void EntityClass::forEachAttribute(AttributeVisitor visitor,
     }
 }
 
+void EntityClass::buildResolvedAttributes()
+{
+    // The table refers to the attributes of all ancestors, make sure they're available.
+    // Parsing a parent might rebuild this table through the signal, which is harmless.
+    for (auto* eclass = _parent; eclass != nullptr; eclass = eclass->_parent)
+    {
+        eclass->ensureParsed();
+    }
+
+    _resolvedAttributes.clear();
+    _resolvedAttributeIndex.clear();
+
+    // Parents are visited first, more derived attributes replace them in the map
+    std::map<std::string, const EntityClassAttribute*> attrsByName;
+
+    forEachAttributeInternal([&](const EntityClassAttribute& a)
+    {
+        attrsByName[a.getName()] = &a;
+    }, true);
+
+    _resolvedAttributes.reserve(attrsByName.size());
+
+    for (const auto& [name, attribute] : attrsByName)
+    {
+        _resolvedAttributes.push_back(ResolvedAttribute{
+            attribute, _attributes.count(name) == 0, string::istarts_with(name, "editor_")
+        });
+    }
+
+    // The hashed index ignores key case, like the attribute maps do. Walk up the
+    // inheritance chain such that the most derived attribute is found first.
+    for (auto* eclass = this; eclass != nullptr; eclass = eclass->_parent)
+    {
+        for (const auto& [name, attribute] : eclass->_attributes)
+        {
+            _resolvedAttributeIndex.try_emplace(name, &attribute);
+        }
+    }
+
+    _resolvedAttributesEnabled = true;
+    _resolvedAttributesChangedSignal.emit();
+}
+
+void EntityClass::clearResolvedAttributes()
+{
+    _resolvedAttributesEnabled = false;
+    _resolvedAttributes.clear();
+    _resolvedAttributeIndex.clear();
+
+    // Subclasses must not refer to our attributes any longer
+    _resolvedAttributesChangedSignal.emit();
+}
+
+void EntityClass::onParentAttributesChanged()
+{
+    // Follow the parent as long as both of us are parsed, otherwise drop the table
+    // until this class has finished parsing again
+    if (_inheritanceResolved && _parent && _parent->_resolvedAttributesEnabled)
+    {
+        buildResolvedAttributes();
+    }
+    else
+    {
+        clearResolvedAttributes();
+    }
+}
+
 // Resolve inheritance for this class
 void EntityClass::resolveInheritance()
 {
@@ -332,6 +413,11 @@ void EntityClass::resolveInheritance()
         _parentChangedConnection = _parent->changedSignal().connect(
             sigc::mem_fun(this, &EntityClass::resetColour)
         );
+
+        _parentAttributesChangedConnection.disconnect();
+        _parentAttributesChangedConnection = _parent->_resolvedAttributesChangedSignal.connect(
+            sigc::mem_fun(this, &EntityClass::onParentAttributesChanged)
+        );
     }
 }
 
@@ -357,6 +443,15 @@ EntityClassAttribute* EntityClass::getAttribute(const std::string& name, bool in
 {
     ensureParsed();
 
+    // Use the hashed lookup in the flattened table if available
+    if (includeInherited && _resolvedAttributesEnabled)
+    {
+        auto found = _resolvedAttributeIndex.find(name);
+
+        return found != _resolvedAttributeIndex.end() ?
+            const_cast<EntityClassAttribute*>(found->second) : nullptr;
+    }
+
     // First look up the attribute on this class; if found, we can simply return it
     auto f = _attributes.find(name);
     if (f != _attributes.end())
@@ -435,6 +530,8 @@ void EntityClass::clear()
 
     _attributes.clear();
     _inheritanceResolved = false;
+
+    clearResolvedAttributes();
 }
 
 void EntityClass::parseEditorSpawnarg(const std::string& key, const std::string& value)
@@ -536,6 +633,9 @@ void EntityClass::onParsingFinished()
 {
     resolveInheritance();
 
+    // Inheritance is known now, flatten the attributes for fast lookups
+    buildResolvedAttributes();
+
     // Reset the determined visibility, it might have changed
     _visibility = Lazy<vfs::Visibility>([this] { return determineVisibilityFromValues(); });
 
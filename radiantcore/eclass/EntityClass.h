@@ -14,6 +14,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <optional>
 
@@ -62,6 +63,28 @@ private:
     // after recursively instructing the parent to resolve its own inheritance.
     bool _inheritanceResolved = false;
 
+    // Flattened view on all attributes of this class including the inherited
+    // ones, sorted by name. The most derived attribute wins.
+    struct ResolvedAttribute
+    {
+        const EntityClassAttribute* attribute;
+        bool inherited;
+        bool isEditorKey;
+    };
+    std::vector<ResolvedAttribute> _resolvedAttributes;
+
+    // Hashed attribute lookup including inherited attributes, ignoring key case
+    std::unordered_map<std::string, const EntityClassAttribute*, string::IHash, string::IEqual> _resolvedAttributeIndex;
+
+    // The resolved attributes are built once parsing has finished, and rebuilt
+    // whenever the parent's table changes. Lookups never modify them.
+    bool _resolvedAttributesEnabled = false;
+
+    // Emitted when the resolved attributes have been rebuilt or cleared, subclasses
+    // referring to our attributes need to follow
+    sigc::signal<void> _resolvedAttributesChangedSignal;
+    sigc::connection _parentAttributesChangedConnection;
+
     // Emitted when contents are reloaded
     sigc::signal<void> _changedSignal;
     bool _blockChangeSignal = false;
@@ -85,6 +108,11 @@ private:
     // Return attribute if found, possibly checking parents
     EntityClassAttribute* getAttribute(const std::string&, bool includeInherited = true);
 
+    // Builds the flattened attribute table, parsing all ancestors first
+    void buildResolvedAttributes();
+    void clearResolvedAttributes();
+    void onParentAttributesChanged();
+
 public:
 
     /// Construct a named EntityClass
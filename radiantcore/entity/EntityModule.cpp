@@ -11,8 +11,10 @@
 #include "selectionlib.h"
 
 #include "string/replace.h"
+#include "string/format.h"
 
 #include "SpawnArgs.h"
+#include "KeyAtomTable.h"
 
 #include "light/LightNode.h"
 #include "doom3group/StaticGeometryNode.h"
@@ -286,6 +288,9 @@ void Doom3EntityModule::initialiseModule(const IApplicationContext& ctx)
     GlobalCommandSystem().addCommand("CreateSpeaker", std::bind(&algorithm::CreateSpeaker, std::placeholders::_1),
         { cmd::ARGTYPE_STRING, cmd::ARGTYPE_VECTOR3 });
 
+    GlobalCommandSystem().addCommand("ShowEntityMemoryStats",
+        sigc::mem_fun(*this, &Doom3EntityModule::showMemoryStats));
+
     _settingsListener = EntitySettings::InstancePtr()->signal_settingsChanged().connect(
         sigc::mem_fun(this, &Doom3EntityModule::onEntitySettingsChanged));
 }
@@ -318,6 +323,39 @@ void Doom3EntityModule::onEntitySettingsChanged()
     });
 }
 
+void Doom3EntityModule::showMemoryStats(const cmd::ArgumentList& args)
+{
+    SpawnArgs::MemoryStats stats;
+    std::size_t numEntities = 0;
+
+    if (auto root = GlobalMapModule().getRoot(); root)
+    {
+        root->foreachNode([&](const scene::INodePtr& node)
+        {
+            if (auto entityNode = std::dynamic_pointer_cast<EntityNode>(node); entityNode)
+            {
+                if (auto spawnArgs = dynamic_cast<SpawnArgs*>(&entityNode->getEntity()); spawnArgs)
+                {
+                    spawnArgs->collectMemoryStats(stats);
+                    ++numEntities;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    const auto& keyTable = KeyAtomTable::Instance();
+
+    rMessage() << "-- Entity Spawnarg Memory --" << std::endl;
+    rMessage() << "Entities: " << numEntities << std::endl;
+    rMessage() << "Spawnargs: " << stats.numKeyValues << " (" << stats.numObservedKeyValues
+        << " with observers or undo state)" << std::endl;
+    rMessage() << "  Spawnarg Storage: " << string::getFormattedByteSize(stats.bytes) << std::endl;
+    rMessage() << "Interned Keys: " << keyTable.getNumAtoms() << std::endl;
+    rMessage() << "  Key Table: " << string::getFormattedByteSize(keyTable.getMemoryUsage()) << std::endl;
+}
+
 // Static module instance
 module::StaticModuleRegistration<Doom3EntityModule> entityModule;
 
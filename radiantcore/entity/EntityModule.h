@@ -2,6 +2,7 @@
 
 #include "ientity.h"
 #include "ieclass.h"
+#include "icommandsystem.h"
 #include <sigc++/connection.h>
 
 namespace entity
@@ -36,6 +37,7 @@ public:
 
 private:
     void onEntitySettingsChanged();
+    void showMemoryStats(const cmd::ArgumentList& args);
 };
 
 } // namespace entity
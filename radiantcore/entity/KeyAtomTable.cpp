@@ -0,0 +1,69 @@
+#include "KeyAtomTable.h"
+
+#include <mutex>
+
+namespace entity
+{
+
+const KeyAtom* KeyAtomTable::intern(const std::string& key)
+{
+    {
+        std::shared_lock<std::shared_mutex> readLock(_lock);
+
+        auto existing = _atoms.find(key);
+
+        if (existing != _atoms.end())
+        {
+            return existing->second.get();
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> writeLock(_lock);
+
+    // Another thread might have interned the same key in the meantime
+    auto& atom = _atoms[key];
+
+    if (!atom)
+    {
+        atom = std::make_unique<KeyAtom>(key);
+    }
+
+    return atom.get();
+}
+
+std::size_t KeyAtomTable::getNumAtoms() const
+{
+    std::shared_lock<std::shared_mutex> readLock(_lock);
+    return _atoms.size();
+}
+
+std::size_t KeyAtomTable::getMemoryUsage() const
+{
+    std::shared_lock<std::shared_mutex> readLock(_lock);
+
+    // Rough estimate: one hash node per map entry plus the atoms and their heap strings
+    constexpr std::size_t NodeOverhead = 2 * sizeof(void*) + sizeof(std::size_t);
+
+    std::size_t size = _atoms.bucket_count() * sizeof(void*);
+
+    for (const auto& [key, atom] : _atoms)
+    {
+        size += NodeOverhead + sizeof(std::string) + sizeof(std::unique_ptr<KeyAtom>) + sizeof(KeyAtom);
+
+        // Short strings are stored inline, don't count their capacity
+        if (key.capacity() > 15)
+        {
+            size += 2 * (key.capacity() + 1);
+        }
+    }
+
+    return size;
+}
+
+KeyAtomTable& KeyAtomTable::Instance()
+{
+    static KeyAtomTable _instance;
+    return _instance;
+}
+
+}
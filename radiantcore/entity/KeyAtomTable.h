@@ -0,0 +1,55 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace entity
+{
+
+/**
+ * An interned spawnarg key. Every distinct key spelling used by any
+ * entity is stored exactly once in the KeyAtomTable, the SpawnArgs
+ * only hold pointers to these atoms.
+ */
+struct KeyAtom
+{
+    // The key as it has been spelled when it was interned
+    const std::string name;
+
+    KeyAtom(const std::string& name_) :
+        name(name_)
+    {}
+};
+
+/**
+ * Global table of interned spawnarg keys, shared by all entities.
+ * Atoms are never released during the lifetime of the application,
+ * the number of distinct keys used in a map is small.
+ */
+class KeyAtomTable
+{
+private:
+    // All atoms, one per distinct spelling (owning)
+    std::unordered_map<std::string, std::unique_ptr<KeyAtom>> _atoms;
+
+    mutable std::shared_mutex _lock;
+
+public:
+    // Returns the atom for the given key, it is created if not present yet.
+    // This is only needed when adding a key to an entity, lookups compare
+    // against the keys of the entity instead.
+    const KeyAtom* intern(const std::string& key);
+
+    // The number of distinct key spellings in this table
+    std::size_t getNumAtoms() const;
+
+    // Approximate number of bytes allocated by this table
+    std::size_t getMemoryUsage() const;
+
+    // The table shared by all SpawnArgs
+    static KeyAtomTable& Instance();
+};
+
+}
@@ -10,30 +10,45 @@ KeyValue::KeyValue(const std::string& value, const std::string& empty,
                    const std::function<void(const std::string&)>& valueChanged) :
     _value(value),
     _emptyValue(empty),
-    _undo(_value, std::bind(&KeyValue::importState, this, std::placeholders::_1),
-        std::bind(&KeyValue::onUndoRedoOperationFinished, this), "KeyValue"),
+    _undoSystem(nullptr),
     _valueChanged(valueChanged)
 {}
 
 KeyValue::~KeyValue()
 {
-	assert(_observers.empty());
+	assert(!_observers || _observers->empty());
 }
 
 void KeyValue::connectUndoSystem(IUndoSystem& undoSystem)
 {
-    _undo.connectUndoSystem(undoSystem);
+    _undoSystem = &undoSystem;
+
+    // Re-register with the undo system if we've been changed before
+    if (_undo)
+    {
+        _undo->connectUndoSystem(undoSystem);
+    }
 }
 
 void KeyValue::disconnectUndoSystem(IUndoSystem& undoSystem)
 {
-    _undo.disconnectUndoSystem(undoSystem);
+    if (_undo && _undo->isConnected())
+    {
+        _undo->disconnectUndoSystem(undoSystem);
+    }
+
+    _undoSystem = nullptr;
 }
 
 void KeyValue::attach(KeyObserver& observer)
 {
 	// Store the observer
-	_observers.push_back(&observer);
+    if (!_observers)
+    {
+        _observers = std::make_unique<KeyObservers>();
+    }
+
+	_observers->push_back(&observer);
 
 	// Notify the newly inserted observer with the existing value
 	observer.onKeyValueChanged(get());
@@ -45,10 +60,12 @@ void KeyValue::detach(KeyObserver& observer, bool sendEmptyValue)
     if (sendEmptyValue)
         observer.onKeyValueChanged(_emptyValue);
 
+    if (!_observers) return;
+
     // Remove the observer if present
-	auto found = std::find(_observers.begin(), _observers.end(), &observer);
-	if (found != _observers.end())
-		_observers.erase(found);
+	auto found = std::find(_observers->begin(), _observers->end(), &observer);
+	if (found != _observers->end())
+		_observers->erase(found);
 }
 
 const std::string& KeyValue::get() const
@@ -61,7 +78,7 @@ void KeyValue::assign(const std::string& other)
 {
 	if (_value != other)
     {
-		_undo.save();
+		saveUndoState();
 		_value = other;
 		notify();
 	}
@@ -75,7 +92,9 @@ void KeyValue::notify()
     // Notify the owning SpawnArgs instance
     _valueChanged(value);
 
-	for (auto i = _observers.rbegin(); i != _observers.rend(); ++i)
+    if (!_observers) return;
+
+	for (auto i = _observers->rbegin(); i != _observers->rend(); ++i)
     {
 		(*i)->onKeyValueChanged(value);
 	}
@@ -87,6 +106,49 @@ void KeyValue::importState(const std::string& string)
 	_value = string;
 }
 
+std::size_t KeyValue::getMemoryUsage() const
+{
+    std::size_t size = sizeof(KeyValue);
+
+    // Short strings are stored inline, only count heap-allocated ones
+    if (_value.capacity() > 15) size += _value.capacity() + 1;
+    if (_emptyValue.capacity() > 15) size += _emptyValue.capacity() + 1;
+
+    if (_observers)
+    {
+        size += sizeof(KeyObservers) + _observers->capacity() * sizeof(KeyObserver*);
+    }
+
+    if (_undo)
+    {
+        size += sizeof(undo::ObservedUndoable<std::string>);
+    }
+
+    return size;
+}
+
+bool KeyValue::hasObserverState() const
+{
+    return _observers || _undo;
+}
+
+void KeyValue::saveUndoState()
+{
+    // Not connected to any undo system, nothing to do
+    if (!_undoSystem) return;
+
+    // Register the undoable with the undo system on the first change
+    if (!_undo)
+    {
+        _undo = std::make_unique<undo::ObservedUndoable<std::string>>(_value,
+            std::bind(&KeyValue::importState, this, std::placeholders::_1),
+            std::bind(&KeyValue::onUndoRedoOperationFinished, this), "KeyValue");
+        _undo->connectUndoSystem(*_undoSystem);
+    }
+
+    _undo->save();
+}
+
 void KeyValue::onUndoRedoOperationFinished()
 {
 	notify();
@@ -4,6 +4,7 @@
 #include "ObservedUndoable.h"
 #include "string/string.h"
 #include <vector>
+#include <memory>
 
 namespace entity
 {
@@ -15,15 +16,22 @@ class SpawnArgs;
 ///
 /// - Notifies observers when value changes - value changes to "" on destruction.
 /// - Provides undo support through the map's undo system.
+///
+/// Most keyvalues of a loaded map are never observed or changed, so the
+/// observer list and the undo state are allocated on first use only.
 class KeyValue final: public EntityKeyValue
 {
 private:
 	typedef std::vector<KeyObserver*> KeyObservers;
-	KeyObservers _observers;
+	std::unique_ptr<KeyObservers> _observers;
 
 	std::string _value;
 	std::string _emptyValue;
-	undo::ObservedUndoable<std::string> _undo;
+
+    // The undo system this keyvalue is connected to (if any), the undoable
+    // itself is registered with it on the first change only
+    IUndoSystem* _undoSystem;
+	std::unique_ptr<undo::ObservedUndoable<std::string>> _undo;
 
     // This is a specialised callback pointing to the owning SpawnArgs
     std::function<void(const std::string&)> _valueChanged;
@@ -49,10 +57,19 @@ public:
 
 	void importState(const std::string& string);
 
+    // Returns the approximate number of bytes allocated by this keyvalue
+    std::size_t getMemoryUsage() const;
+
+    // Returns true if observers are attached or undo state has been allocated
+    bool hasObserverState() const;
+
 	// NameObserver implementation
 	void onNameChange(const std::string& oldName, const std::string& newName) override;
 
 private:
+    // Saves the current value to the undo stack, allocating the undo state if necessary
+    void saveUndoState();
+
     // Gets called after a undo/redo operation is fully completed.
     // This triggers a keyobserver refresh, to allow for reconnection to Namespaces and such.
     void onUndoRedoOperationFinished();
@@ -4,6 +4,7 @@
 #include "debugging/debugging.h"
 #include "string/predicate.h"
 #include <functional>
+#include <algorithm>
 
 namespace entity
 {
@@ -29,10 +30,11 @@ SpawnArgs::SpawnArgs(const SpawnArgs& other) :
 	_isContainer(other._isContainer),
 	_attachments(other._attachments)
 {
-    // Copy keyvalue strings, not actual KeyValue pointers
+    // Copy keyvalue strings, not actual KeyValue pointers.
+    // The keys are unique already, the interned keys can be reused as they are.
     for (const KeyValuePair& p : other._keyValues)
     {
-        insert(p.first, p.second->get());
+        emplace(p.first, p.second->get());
     }
 }
 
@@ -87,7 +89,7 @@ void SpawnArgs::attachObserver(Observer* observer)
 	// Now notify the observer about all the existing keys
 	for(KeyValues::const_iterator i = _keyValues.begin(); i != _keyValues.end(); ++i)
     {
-		observer->onKeyInsert(i->first, *i->second);
+		observer->onKeyInsert(i->first->name, *i->second);
 	}
 }
 
@@ -110,7 +112,7 @@ void SpawnArgs::detachObserver(Observer* observer)
 	// Call onKeyErase() for every spawnarg, so that the observer gets cleanly shut down
 	for(KeyValues::const_iterator i = _keyValues.begin(); i != _keyValues.end(); ++i)
     {
-		observer->onKeyErase(i->first, *i->second);
+		observer->onKeyErase(i->first->name, *i->second);
 	}
 }
 
@@ -145,7 +147,7 @@ void SpawnArgs::forEachKeyValue(KeyValueVisitFunc func,
     // Visit explicit spawnargs
     for (const KeyValuePair& pair : _keyValues)
 	{
-		func(pair.first, pair.second->get());
+		func(pair.first->name, pair.second->get());
 	}
 
     // If requested, visit inherited spawnargs from the entitydef
@@ -161,7 +163,7 @@ void SpawnArgs::forEachEntityKeyValue(const EntityKeyValueVisitFunctor& func)
 {
     for (const KeyValuePair& pair : _keyValues)
     {
-        func(pair.first, *pair.second);
+        func(pair.first->name, *pair.second);
     }
 }
 
@@ -217,6 +219,24 @@ EntityKeyValuePtr SpawnArgs::getEntityKeyValue(const std::string& key)
 	return (found != _keyValues.end()) ? found->second : EntityKeyValuePtr();
 }
 
+void SpawnArgs::collectMemoryStats(MemoryStats& stats) const
+{
+    stats.bytes += sizeof(SpawnArgs) + _keyValues.capacity() * sizeof(KeyValuePair);
+
+    for (const auto& pair : _keyValues)
+    {
+        ++stats.numKeyValues;
+
+        if (pair.second->hasObserverState())
+        {
+            ++stats.numObservedKeyValues;
+        }
+
+        // Add the shared_ptr control block, allocated together with the KeyValue
+        stats.bytes += pair.second->getMemoryUsage() + 2 * sizeof(long);
+    }
+}
+
 bool SpawnArgs::isWorldspawn() const
 {
 	return getKeyValue("classname") == "worldspawn";
@@ -273,13 +293,13 @@ void SpawnArgs::notifyErase(const std::string& key, KeyValue& value)
 	_observerMutex = false;
 }
 
-void SpawnArgs::insert(const std::string& key, const KeyValuePtr& keyValue)
+void SpawnArgs::insert(const KeyAtom* key, const KeyValuePtr& keyValue)
 {
 	// Insert the new key at the end of the list
 	auto& pair = _keyValues.emplace_back(key, keyValue);
 
 	// Dereference the iterator to get a KeyValue& reference and notify the observers
-	notifyInsert(key, *pair.second);
+	notifyInsert(key->name, *pair.second);
 
 	if (_undo.isConnected())
 	{
@@ -304,13 +324,18 @@ void SpawnArgs::insert(const std::string& key, const std::string& value)
 		// No key with that name found, create a new one
 		_undo.save();
 
-		// Allocate a new KeyValue object and insert it into the map
-        // Capture the key by value in the lambda
-		insert(key, std::make_shared<KeyValue>(value, _eclass->getAttributeValue(key),
-            [key, this](const std::string& value) { notifyChange(key, value); }));
+		emplace(KeyAtomTable::Instance().intern(key), value);
 	}
 }
 
+void SpawnArgs::emplace(const KeyAtom* key, const std::string& value)
+{
+	// Allocate a new KeyValue object and insert it into the map
+	// Capturing the interned key keeps the lambda small enough to not allocate
+	insert(key, std::make_shared<KeyValue>(value, _eclass->getAttributeValue(key->name),
+		[key, this](const std::string& value) { notifyChange(key->name, value); }));
+}
+
 void SpawnArgs::erase(const KeyValues::iterator& i)
 {
 	if (_undo.isConnected())
@@ -319,7 +344,7 @@ void SpawnArgs::erase(const KeyValues::iterator& i)
 	}
 
 	// Retrieve the key and value from the vector before deletion
-	std::string key(i->first);
+	const std::string& key = i->first->name;
 	KeyValuePtr value(i->second);
 
 	// Actually delete the object from the list
@@ -346,34 +371,16 @@ void SpawnArgs::erase(const std::string& key)
 
 SpawnArgs::KeyValues::const_iterator SpawnArgs::find(const std::string& key) const
 {
-	for (KeyValues::const_iterator i = _keyValues.begin();
-		 i != _keyValues.end();
-		 ++i)
-	{
-		if (string::iequals(i->first, key))
-		{
-			return i;
-		}
-	}
-
-	// Not found
-	return _keyValues.end();
+    // Lookups don't touch the shared key table, comparing the few keys
+    // of this entity is cheaper than taking its lock and hashing the key
+    return std::find_if(_keyValues.begin(), _keyValues.end(),
+        [&](const KeyValuePair& pair) { return string::iequals(pair.first->name, key); });
 }
 
 SpawnArgs::KeyValues::iterator SpawnArgs::find(const std::string& key)
 {
-	for (KeyValues::iterator i = _keyValues.begin();
-		 i != _keyValues.end();
-		 ++i)
-	{
-		if (string::iequals(i->first, key))
-		{
-			return i;
-		}
-	}
-
-	// Not found
-	return _keyValues.end();
+    return std::find_if(_keyValues.begin(), _keyValues.end(),
+        [&](const KeyValuePair& pair) { return string::iequals(pair.first->name, key); });
 }
 
 } // namespace entity
@@ -4,6 +4,7 @@
 
 #include <vector>
 #include "KeyValue.h"
+#include "KeyAtomTable.h"
 #include <memory>
 
 class IUndoSystem;
@@ -26,8 +27,8 @@ class SpawnArgs: public Entity
 
 	typedef std::shared_ptr<KeyValue> KeyValuePtr;
 
-	// A key value pair using a dynamically allocated value
-	typedef std::pair<std::string, KeyValuePtr> KeyValuePair;
+	// A key value pair using an interned key and a dynamically allocated value
+	typedef std::pair<const KeyAtom*, KeyValuePtr> KeyValuePair;
 
 	// The unsorted list of KeyValue pairs
 	typedef std::vector<KeyValuePair> KeyValues;
@@ -81,6 +82,21 @@ public:
 
 	bool isOfType(const std::string& className) override;
 
+    // Memory consumed by the spawnargs of one or more entities
+    struct MemoryStats
+    {
+        std::size_t numKeyValues = 0;
+
+        // Number of keyvalues which have observers or undo state allocated
+        std::size_t numObservedKeyValues = 0;
+
+        // Approximate number of bytes, not including the shared key table
+        std::size_t bytes = 0;
+    };
+
+    // Adds the memory consumed by this instance to the given stats
+    void collectMemoryStats(MemoryStats& stats) const;
+
 private:
 
     // Parse attachment information from def_attach and related keys (which are
@@ -92,9 +108,12 @@ private:
     void notifyChange(const std::string& k, const std::string& v);
 	void notifyErase(const std::string& key, KeyValue& value);
 
-	void insert(const std::string& key, const KeyValuePtr& keyValue);
+	void insert(const KeyAtom* key, const KeyValuePtr& keyValue);
 	void insert(const std::string& key, const std::string& value);
 
+	// Creates the KeyValue for the given key, which must not be present yet
+	void emplace(const KeyAtom* key, const std::string& value);
+
 	void erase(const KeyValues::iterator& i);
 	void erase(const std::string& key);
 
@@ -38,6 +38,7 @@
 #include "map/algorithm/Export.h"
 #include "scene/Traverse.h"
 #include "map/algorithm/MapExporter.h"
+#include "map/algorithm/SyntheticMap.h"
 #include "model/export/ModelExporter.h"
 #include "model/export/ModelScalePreserver.h"
 #include "messages/ScopedLongRunningOperation.h"
@@ -1020,6 +1021,9 @@ void Map::registerCommands()
     GlobalCommandSystem().addCommand("SaveAutomaticBackup", std::bind(&Map::saveAutomaticMapBackup, this, std::placeholders::_1), { cmd::ARGTYPE_STRING });
     GlobalCommandSystem().addCommand("ExportMap", std::bind(&Map::exportMap, this, std::placeholders::_1));
     GlobalCommandSystem().addCommand("SaveSelected", Map::exportSelection);
+    GlobalCommandSystem().addCommand("GenerateSyntheticMap", Map::generateSyntheticMapCmd,
+        { cmd::ARGTYPE_INT, cmd::ARGTYPE_INT, cmd::ARGTYPE_INT, cmd::ARGTYPE_INT, cmd::ARGTYPE_INT,
+          cmd::ARGTYPE_INT | cmd::ARGTYPE_OPTIONAL });
     GlobalCommandSystem().addCommand("FocusViews", std::bind(&Map::focusViewCmd, this, std::placeholders::_1), { cmd::ARGTYPE_VECTOR3, cmd::ARGTYPE_VECTOR3 });
     GlobalCommandSystem().addCommand("FocusCameraViewOnSelection", std::bind(&Map::focusCameraOnSelectionCmd, this, std::placeholders::_1));
     // ExportSelectedAsModel <Path> <ExportFormat> [<ExportOrigin>] [<OriginEntityName>] [<CustomOrigin>] [<SkipCaulk>] [<ReplaceSelectionWithModel>] [<ExportLightsAsObjects>]
@@ -1072,6 +1076,53 @@ void Map::newMap(const cmd::ArgumentList& args)
     }
 }
 
+void Map::generateSyntheticMapCmd(const cmd::ArgumentList& args)
+{
+    for (const auto& arg : args)
+    {
+        if (arg.getInt() < 0)
+        {
+            throw cmd::ExecutionFailure(_("The number of generated objects cannot be negative"));
+        }
+    }
+
+    algorithm::SyntheticMapParameters parameters;
+    parameters.numBrushes = static_cast<std::size_t>(args[0].getInt());
+    parameters.numPatches = static_cast<std::size_t>(args[1].getInt());
+    parameters.numEntities = static_cast<std::size_t>(args[2].getInt());
+    parameters.numLights = static_cast<std::size_t>(args[3].getInt());
+    parameters.numModels = static_cast<std::size_t>(args[4].getInt());
+    parameters.seed = args.size() > 5 ? static_cast<unsigned int>(args[5].getInt()) : 0;
+
+    if (!GlobalMap().askForSave(_("Generate Synthetic Map"))) return;
+
+    GlobalMap().freeMap();
+    GlobalMap().createNewMap();
+
+    try
+    {
+        util::ScopeTimer timer("Synthetic map generation");
+
+        auto bounds = algorithm::generateSyntheticMap(GlobalMap().findOrInsertWorldspawn(), parameters);
+
+        rMessage() << "Generated a synthetic map with " << parameters.numBrushes << " brushes, " <<
+            parameters.numPatches << " patches, " << parameters.numEntities << " entities, " <<
+            parameters.numLights << " lights and " << parameters.numModels << " models" << std::endl;
+
+        GlobalMap().setModified(true);
+
+        if (bounds.isValid())
+        {
+            auto originAndAngles = scene::getOriginAndAnglesToLookAtBounds(bounds);
+            GlobalMap().focusViews(originAndAngles.first, originAndAngles.second);
+        }
+    }
+    catch (const std::runtime_error& ex)
+    {
+        throw cmd::ExecutionFailure(ex.what());
+    }
+}
+
 void Map::openMapCmd(const cmd::ArgumentList& args)
 {
     if (!askForSave(_("Open Map"))) return;
@@ -242,6 +242,10 @@ public:
 	 */
 	static void saveSelectedAsPrefab(const cmd::ArgumentList& args);
 
+    // Replaces the current map with a generated one, used to test and measure large maps
+    // GenerateSyntheticMap <Brushes> <Patches> <Entities> <Lights> <Models> [<Seed>]
+    static void generateSyntheticMapCmd(const cmd::ArgumentList& args);
+
 private:
 	/**
 	 * greebo: Asks the user if the current changes should be saved.
@@ -21,6 +21,7 @@
 #include "os/fs.h"
 #include "scene/Traverse.h"
 #include "scenelib.h"
+#include "profiling/ScopedSpan.h"
 
 #include <functional>
 #include <fmt/format.h>
@@ -100,6 +101,8 @@ std::string MapResource::getAbsoluteResourcePath()
 
 bool MapResource::load()
 {
+	profiling::ScopedSpan span("MapResource::load");
+
 	if (!_mapRoot)
     {
 		// Map not loaded yet, acquire map root node from loader
@@ -405,6 +408,8 @@ void MapResource::throwIfNotWriteable(const fs::path& path)
 void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
 						   const GraphTraversalFunc& traverse, const std::string& filename)
 {
+	profiling::ScopedSpan span("MapResource::saveFile");
+
 	// Actual output file paths
 	fs::path outFile = filename;
 	fs::path auxFile = outFile;
@@ -29,7 +29,7 @@ namespace
 // Constructor
 PointFile::PointFile() :
 	_curPos(0),
-    _renderable(_points)
+    _renderable(_points, RED)
 {
     GlobalCommandSystem().addCommand(
         "NextLeakSpot", sigc::mem_fun(*this, &PointFile::nextLeakSpot)
@@ -96,12 +96,13 @@ void PointFile::parse(const fs::path& pointfile)
         );
     }
 
-    // Construct vertices from parsed point data
-    PointTrace trace(inFile);
-    for (auto pos: trace.points())
-    {
-        _points.emplace_back(pos, RED);
-    }
+    // Parse the trace, dropping the points in the middle of straight runs,
+    // they don't add anything to the rendered line or the leak spot stepping
+    PointTrace trace(inFile, true);
+    _points = trace.takePoints();
+
+    rMessage() << "Loaded pointfile " << pointfile.filename().string() << " with "
+        << _points.size() << " points" << std::endl;
 }
 
 // advance camera to previous point
@@ -137,15 +138,15 @@ void PointFile::advance(bool forward)
 	{
 		auto& cam = GlobalCameraManager().getActiveView();
 
-		cam.setCameraOrigin(_points[_curPos].vertex);
+		cam.setCameraOrigin(_points[_curPos]);
 
 		if (module::GlobalModuleRegistry().moduleExists(MODULE_ORTHOVIEWMANAGER))
 		{
-			GlobalOrthoViewManager().setOrigin(_points[_curPos].vertex);
+			GlobalOrthoViewManager().setOrigin(_points[_curPos]);
 		}
 
 		{
-			Vector3 dir((_points[_curPos + 1].vertex - cam.getCameraOrigin()).getNormalised());
+			Vector3 dir((_points[_curPos + 1] - cam.getCameraOrigin()).getNormalised());
 			Vector3 angles(cam.getCameraAngles());
 
 			angles[camera::CAMERA_YAW] = radians_to_degrees(atan2(dir[1], dir[0]));
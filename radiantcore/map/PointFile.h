@@ -5,7 +5,6 @@
 #include "imap.h"
 #include "icommandsystem.h"
 #include "math/Vector3.h"
-#include "render/VertexCb.h"
 #include "RenderablePointFile.h"
 
 namespace map
@@ -15,7 +14,7 @@ namespace map
 class PointFile
 {
 	// Vector of point coordinates
-	std::vector<VertexCb> _points;
+	std::vector<Vector3> _points;
 
 	// Holds the current position in the point file chain
 	std::size_t _curPos;
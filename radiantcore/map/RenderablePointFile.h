@@ -1,7 +1,6 @@
 #pragma once
 
 #include "render/RenderableGeometry.h"
-#include "render/VertexCb.h"
 #include "render/Colour4b.h"
 
 namespace map
@@ -27,24 +26,30 @@ class RenderablePointFile :
     public render::RenderableGeometry
 {
 private:
-    const std::vector<VertexCb>& _points;
+    const std::vector<Vector3>& _points;
+    Vector4 _colour;
 
 public:
-    RenderablePointFile(const std::vector<VertexCb>& points) :
-        _points(points)
+    RenderablePointFile(const std::vector<Vector3>& points, const Colour4b& colour) :
+        _points(points),
+        _colour(detail::toVector4(colour))
     {}
 
 protected:
+    // The whole trace is uploaded in one go, this is only called when a pointfile is shown
     void updateGeometry() override
     {
+        if (_points.size() < 2) return;
+
         std::vector<render::RenderVertex> vertices;
         std::vector<unsigned int> indices;
 
-        if (_points.size() < 2) return;
+        vertices.reserve(_points.size());
+        indices.reserve((_points.size() - 1) * 2);
 
         for (unsigned int i = 0; i < _points.size(); ++i)
         {
-            vertices.push_back(render::RenderVertex(_points[i].vertex, { 0, 0, 0 }, { 0, 0 }, detail::toVector4(_points[i].colour)));
+            vertices.emplace_back(_points[i], Vector3(0, 0, 0), Vector2(0, 0), _colour);
 
             if (i > 0)
             {
@@ -0,0 +1,188 @@
+#include "AasAreaTree.h"
+
+#include <algorithm>
+#include "ivolumetest.h"
+
+namespace map
+{
+
+namespace
+{
+    // Leaves are not split any further below this number of areas
+    constexpr std::size_t MaxAreasPerLeaf = 4;
+}
+
+void AasAreaTree::build(const std::vector<IAasFile::Area>& areas)
+{
+    clear();
+
+    for (std::size_t i = 0; i < areas.size(); ++i)
+    {
+        if (areas[i].bounds.isValid())
+        {
+            _areaNums.push_back(static_cast<int>(i));
+        }
+    }
+
+    if (_areaNums.empty()) return;
+
+    // A binary tree with at least one area per leaf has less than 2n nodes
+    _nodes.reserve(_areaNums.size() * 2);
+    buildNode(areas, 0, _areaNums.size());
+
+    _areaBounds.reserve(_areaNums.size());
+
+    for (auto areaNum : _areaNums)
+    {
+        _areaBounds.push_back(areas[areaNum].bounds);
+    }
+}
+
+void AasAreaTree::clear()
+{
+    _nodes.clear();
+    _areaNums.clear();
+    _areaBounds.clear();
+}
+
+std::uint32_t AasAreaTree::buildNode(const std::vector<IAasFile::Area>& areas, std::size_t begin, std::size_t end)
+{
+    auto nodeIndex = static_cast<std::uint32_t>(_nodes.size());
+    _nodes.emplace_back();
+
+    AABB bounds;
+    AABB centroidBounds;
+
+    for (auto i = begin; i < end; ++i)
+    {
+        const auto& areaBounds = areas[_areaNums[i]].bounds;
+
+        bounds.includeAABB(areaBounds);
+        centroidBounds.includePoint(areaBounds.getOrigin());
+    }
+
+    _nodes[nodeIndex].bounds = bounds;
+
+    if (end - begin <= MaxAreasPerLeaf)
+    {
+        _nodes[nodeIndex].first = static_cast<std::uint32_t>(begin);
+        _nodes[nodeIndex].count = static_cast<std::uint32_t>(end - begin);
+        return nodeIndex;
+    }
+
+    // Split at the median along the axis the area centres are spread the most
+    const auto& extents = centroidBounds.getExtents();
+    auto axis = extents.x() > extents.y() ? (extents.x() > extents.z() ? 0 : 2) : (extents.y() > extents.z() ? 1 : 2);
+    auto middle = begin + (end - begin) / 2;
+
+    std::nth_element(_areaNums.begin() + begin, _areaNums.begin() + middle, _areaNums.begin() + end,
+        [&](int a, int b)
+    {
+        return areas[a].bounds.getOrigin()[axis] < areas[b].bounds.getOrigin()[axis];
+    });
+
+    buildNode(areas, begin, middle);
+    auto rightChild = buildNode(areas, middle, end);
+
+    _nodes[nodeIndex].first = rightChild;
+    _nodes[nodeIndex].count = 0;
+
+    return nodeIndex;
+}
+
+template<typename NodeTest>
+void AasAreaTree::traverse(const NodeTest& test, const AreaVisitor& visitor) const
+{
+    if (_nodes.empty()) return;
+
+    std::vector<std::uint32_t> stack;
+    stack.push_back(0);
+
+    while (!stack.empty())
+    {
+        auto nodeIndex = stack.back();
+        stack.pop_back();
+
+        const auto& node = _nodes[nodeIndex];
+        auto result = test(node.bounds);
+
+        if (result == VOLUME_OUTSIDE)
+        {
+            continue;
+        }
+
+        if (result == VOLUME_INSIDE)
+        {
+            // Everything below this node passes the test
+            visitLeaves(nodeIndex, visitor);
+            continue;
+        }
+
+        if (node.count > 0)
+        {
+            for (auto i = node.first; i < node.first + node.count; ++i)
+            {
+                if (test(_areaBounds[i]) != VOLUME_OUTSIDE)
+                {
+                    visitor(_areaNums[i]);
+                }
+            }
+
+            continue;
+        }
+
+        stack.push_back(node.first);
+        stack.push_back(nodeIndex + 1);
+    }
+}
+
+void AasAreaTree::visitLeaves(std::uint32_t nodeIndex, const AreaVisitor& visitor) const
+{
+    // The leaves of a subtree reference a contiguous range of areas,
+    // from its leftmost leaf (following the left children, stored right
+    // after their parent) to its rightmost leaf (following the right children)
+    auto leftmost = nodeIndex;
+
+    while (_nodes[leftmost].count == 0)
+    {
+        ++leftmost;
+    }
+
+    auto rightmost = nodeIndex;
+
+    while (_nodes[rightmost].count == 0)
+    {
+        rightmost = _nodes[rightmost].first;
+    }
+
+    for (auto i = _nodes[leftmost].first; i < _nodes[rightmost].first + _nodes[rightmost].count; ++i)
+    {
+        visitor(_areaNums[i]);
+    }
+}
+
+void AasAreaTree::forEachAreaContaining(const Vector3& point, const AreaVisitor& visitor) const
+{
+    traverse([&](const AABB& bounds)
+    {
+        return bounds.intersects(point) ? VOLUME_PARTIAL : VOLUME_OUTSIDE;
+    }, visitor);
+}
+
+void AasAreaTree::forEachAreaIntersecting(const AABB& box, const AreaVisitor& visitor) const
+{
+    traverse([&](const AABB& bounds)
+    {
+        return box.intersects(bounds) ? VOLUME_PARTIAL : VOLUME_OUTSIDE;
+    }, visitor);
+}
+
+void AasAreaTree::forEachVisibleArea(const VolumeTest& volume, const AreaVisitor& visitor) const
+{
+    traverse([&](const AABB& bounds)
+    {
+        return volume.TestAABB(bounds);
+    }, visitor);
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "iaasfile.h"
+
+class VolumeTest;
+
+namespace map
+{
+
+/**
+ * Bounding volume hierarchy over the area bounds of an AAS file, used to
+ * find the areas near a point, intersecting a box or visible in a view
+ * without testing every single area.
+ *
+ * The nodes are stored depth-first in a flat array, the left child of an
+ * inner node is the node right after it.
+ */
+class AasAreaTree
+{
+private:
+    struct Node
+    {
+        AABB bounds;
+
+        // Leaf nodes: range of area numbers in _areaNums
+        // Inner nodes: count is 0, first is the index of the right child node
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<int> _areaNums;
+
+    // The bounds of each area in _areaNums
+    std::vector<AABB> _areaBounds;
+
+public:
+    using AreaVisitor = std::function<void(int areaNum)>;
+
+    // Rebuilds the tree, areas with invalid bounds are left out
+    void build(const std::vector<IAasFile::Area>& areas);
+
+    void clear();
+
+    // Visits all areas whose bounds contain the given point
+    void forEachAreaContaining(const Vector3& point, const AreaVisitor& visitor) const;
+
+    // Visits all areas whose bounds intersect the given box
+    void forEachAreaIntersecting(const AABB& bounds, const AreaVisitor& visitor) const;
+
+    // Visits all areas whose bounds are (partially) inside the given volume
+    void forEachVisibleArea(const VolumeTest& volume, const AreaVisitor& visitor) const;
+
+private:
+    std::uint32_t buildNode(const std::vector<IAasFile::Area>& areas, std::size_t begin, std::size_t end);
+    void visitLeaves(std::uint32_t nodeIndex, const AreaVisitor& visitor) const;
+
+    template<typename NodeTest>
+    void traverse(const NodeTest& test, const AreaVisitor& visitor) const;
+};
+
+}
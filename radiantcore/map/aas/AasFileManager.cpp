@@ -7,7 +7,12 @@
 #include "ifilesystem.h"
 #include "eclass.h"
 
+#include <fstream>
+#include <cstring>
+#include <fmt/format.h>
+#include "os/fs.h"
 #include "module/StaticModule.h"
+#include "Doom3AasFile.h"
 
 namespace map
 {
@@ -15,6 +20,31 @@ namespace map
 namespace
 {
     const char* const AAS_TYPES_ENTITYDEF = "aas_types";
+
+    // Header of the binary cache files, increase the version when changing the format
+    const char BINARY_CACHE_MAGIC[8] = { 'D', 'R', 'A', 'A', 'S', 'B', 'I', 'N' };
+    constexpr std::uint32_t BINARY_CACHE_VERSION = 1;
+
+    // The size and modification time of the source file, to detect outdated cache files
+    struct SourceFileStamp
+    {
+        std::uint64_t size;
+        std::int64_t modificationTime;
+
+        bool operator==(const SourceFileStamp& other) const
+        {
+            return size == other.size && modificationTime == other.modificationTime;
+        }
+    };
+
+    inline SourceFileStamp getSourceFileStamp(const std::string& path)
+    {
+        return SourceFileStamp
+        {
+            static_cast<std::uint64_t>(fs::file_size(path)),
+            static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count())
+        };
+    }
 }
 
 AasFileManager::AasFileManager() :
@@ -155,8 +185,135 @@ const StringSet& AasFileManager::getDependencies() const
 	return _dependencies;
 }
 
+IAasFilePtr AasFileManager::loadAasFile(const std::string& absolutePath)
+{
+    if (auto cached = loadFromBinaryCache(absolutePath); cached)
+    {
+        return cached;
+    }
+
+    ArchiveTextFilePtr file = GlobalFileSystem().openTextFileInAbsolutePath(absolutePath);
+
+    if (!file)
+    {
+        return IAasFilePtr();
+    }
+
+    std::istream stream(&file->getInputStream());
+    auto loader = getLoaderForStream(stream);
+
+    if (!loader || !loader->canLoad(stream))
+    {
+        return IAasFilePtr();
+    }
+
+    stream.seekg(0, std::ios_base::beg);
+
+    auto aasFile = loader->loadFromStream(stream);
+
+    if (aasFile)
+    {
+        writeBinaryCache(absolutePath, aasFile);
+    }
+
+    return aasFile;
+}
+
+std::string AasFileManager::getBinaryCacheFile(const std::string& absolutePath) const
+{
+    return _binaryCachePath + fmt::format("{0:016x}.bin", std::hash<std::string>()(absolutePath));
+}
+
+IAasFilePtr AasFileManager::loadFromBinaryCache(const std::string& absolutePath)
+{
+    if (_binaryCachePath.empty()) return IAasFilePtr();
+
+    try
+    {
+        std::ifstream stream(getBinaryCacheFile(absolutePath), std::ios::binary);
+
+        if (!stream) return IAasFilePtr();
+
+        char magic[sizeof(BINARY_CACHE_MAGIC)];
+        std::uint32_t version = 0;
+        SourceFileStamp stamp{ 0, 0 };
+        std::uint64_t pathLength = 0;
+
+        stream.read(magic, sizeof(magic));
+        stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+        stream.read(reinterpret_cast<char*>(&stamp), sizeof(stamp));
+        stream.read(reinterpret_cast<char*>(&pathLength), sizeof(pathLength));
+
+        if (!stream || std::memcmp(magic, BINARY_CACHE_MAGIC, sizeof(magic)) != 0 ||
+            version != BINARY_CACHE_VERSION || pathLength != absolutePath.size() ||
+            !(stamp == getSourceFileStamp(absolutePath)))
+        {
+            return IAasFilePtr();
+        }
+
+        // Different paths might end up in the same cache file
+        std::string path(pathLength, '\0');
+        stream.read(path.data(), pathLength);
+
+        if (path != absolutePath)
+        {
+            return IAasFilePtr();
+        }
+
+        auto aasFile = std::make_shared<Doom3AasFile>();
+        aasFile->readBinary(stream);
+
+        return aasFile;
+    }
+    catch (const std::exception& ex)
+    {
+        rWarning() << "Could not read the cached AAS data of " << absolutePath << ": " << ex.what() << std::endl;
+        return IAasFilePtr();
+    }
+}
+
+void AasFileManager::writeBinaryCache(const std::string& absolutePath, const IAasFilePtr& aasFile)
+{
+    auto doom3AasFile = std::dynamic_pointer_cast<Doom3AasFile>(aasFile);
+
+    if (_binaryCachePath.empty() || !doom3AasFile) return;
+
+    auto cacheFile = getBinaryCacheFile(absolutePath);
+
+    try
+    {
+        fs::create_directories(_binaryCachePath);
+
+        auto stamp = getSourceFileStamp(absolutePath);
+        auto pathLength = static_cast<std::uint64_t>(absolutePath.size());
+
+        std::ofstream stream(cacheFile, std::ios::binary | std::ios::trunc);
+
+        stream.write(BINARY_CACHE_MAGIC, sizeof(BINARY_CACHE_MAGIC));
+        stream.write(reinterpret_cast<const char*>(&BINARY_CACHE_VERSION), sizeof(BINARY_CACHE_VERSION));
+        stream.write(reinterpret_cast<const char*>(&stamp), sizeof(stamp));
+        stream.write(reinterpret_cast<const char*>(&pathLength), sizeof(pathLength));
+        stream.write(absolutePath.data(), absolutePath.size());
+
+        doom3AasFile->writeBinary(stream);
+
+        if (!stream)
+        {
+            throw std::runtime_error("Write error");
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        rWarning() << "Could not write the AAS cache file " << cacheFile << ": " << ex.what() << std::endl;
+
+        std::error_code ec;
+        fs::remove(cacheFile, ec);
+    }
+}
+
 void AasFileManager::initialiseModule(const IApplicationContext& ctx)
 {
+    _binaryCachePath = ctx.getCacheDataPath() + "aas/";
 }
 
 // Define the static AasFileManager module
@@ -18,6 +18,9 @@ private:
     AasTypeList _typeList;
     bool _typesLoaded;
 
+    // The folder the binary representations of parsed AAS files are stored in
+    std::string _binaryCachePath;
+
 public:
     AasFileManager();
 
@@ -28,6 +31,7 @@ public:
     AasTypeList getAasTypes() override;
     AasType getAasTypeByName(const std::string& typeName) override;
     std::list<AasFileInfo> getAasFilesForMap(const std::string& mapPath) override;
+    IAasFilePtr loadAasFile(const std::string& absolutePath) override;
 
     // RegisterableModule implementation
 	const std::string& getName() const override;
@@ -36,6 +40,10 @@ public:
 
 private:
     void ensureAasTypesLoaded();
+
+    std::string getBinaryCacheFile(const std::string& absolutePath) const;
+    IAasFilePtr loadFromBinaryCache(const std::string& absolutePath);
+    void writeBinaryCache(const std::string& absolutePath, const IAasFilePtr& aasFile);
 };
 
 } // namespace
@@ -1,12 +1,112 @@
 #include "Doom3AasFile.h"
 
 #include "itextstream.h"
-#include "string/convert.h"
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
 #include "Util.h"
 
 namespace map
 {
 
+namespace
+{
+    // Upper limit for the number of elements in a binary array, anything above is considered corrupt
+    constexpr std::uint64_t MaxBinaryArraySize = 1 << 28;
+
+    // Distance tolerance used when testing points against the area boundaries
+    constexpr double PointInAreaEpsilon = 0.1;
+
+    template<typename T>
+    void writeValue(std::ostream& stream, const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written");
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template<typename T>
+    T readValue(std::istream& stream)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read");
+
+        T value;
+
+        if (!stream.read(reinterpret_cast<char*>(&value), sizeof(T)))
+        {
+            throw std::runtime_error("Unexpected end of AAS binary data");
+        }
+
+        return value;
+    }
+
+    inline void writeVector3(std::ostream& stream, const Vector3& vector)
+    {
+        writeValue(stream, vector.x());
+        writeValue(stream, vector.y());
+        writeValue(stream, vector.z());
+    }
+
+    inline Vector3 readVector3(std::istream& stream)
+    {
+        auto x = readValue<Vector3::ElementType>(stream);
+        auto y = readValue<Vector3::ElementType>(stream);
+        auto z = readValue<Vector3::ElementType>(stream);
+
+        return Vector3(x, y, z);
+    }
+
+    template<typename T>
+    void writeArray(std::ostream& stream, const std::vector<T>& elements)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be written");
+
+        writeValue(stream, static_cast<std::uint64_t>(elements.size()));
+        stream.write(reinterpret_cast<const char*>(elements.data()), elements.size() * sizeof(T));
+    }
+
+    inline std::size_t readArraySize(std::istream& stream)
+    {
+        auto size = readValue<std::uint64_t>(stream);
+
+        if (size > MaxBinaryArraySize)
+        {
+            throw std::runtime_error("Invalid array size in AAS binary data");
+        }
+
+        return static_cast<std::size_t>(size);
+    }
+
+    inline bool isValidIndex(std::int64_t index, std::size_t count)
+    {
+        return index >= 0 && static_cast<std::uint64_t>(index) < count;
+    }
+
+    // Edge and face indices are signed, the sign encodes the orientation
+    inline bool isValidSignedIndex(std::int64_t index, std::size_t count)
+    {
+        return isValidIndex(index < 0 ? -index : index, count);
+    }
+
+    // Checks that the given number of elements starting at first are within range
+    inline bool isValidRange(std::int64_t first, std::int64_t num, std::size_t count)
+    {
+        return first >= 0 && num >= 0 && static_cast<std::uint64_t>(first + num) <= count;
+    }
+
+    template<typename T>
+    void readArray(std::istream& stream, std::vector<T>& elements)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable types can be read");
+
+        elements.resize(readArraySize(stream));
+
+        if (!stream.read(reinterpret_cast<char*>(elements.data()), elements.size() * sizeof(T)))
+        {
+            throw std::runtime_error("Unexpected end of AAS binary data");
+        }
+    }
+}
+
 // area flags
 #define AREA_FLOOR					(1 << 0)		// AI can stand on the floor in this area
 #define AREA_GAP					(1 << 1)		// area has a gap
@@ -95,11 +195,11 @@ const IAasFile::Area& Doom3AasFile::getArea(int areaNum) const
     return _areas[areaNum];
 }
 
-void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
+void Doom3AasFile::parseFromTokens(parser::BufferTokeniser& tok)
 {
     while (tok.hasMoreTokens())
     {
-        std::string token = tok.nextToken();
+        auto token = tok.nextTokenView();
 
         if (token == "settings")
         {
@@ -107,7 +207,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "planes")
         {
-            std::size_t planesCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t planesCount = tok.nextNumber<std::size_t>();
 
             _planes.reserve(planesCount);
 
@@ -116,15 +216,15 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( a b c dist )
             for (std::size_t i = 0; i < planesCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // plane index
+                tok.skipTokens(1); // plane index
 
                 tok.assertNextToken("(");
 
                 Plane3 plane;
-                plane.normal().x() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().y() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().z() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.dist() = string::convert<Vector3::ElementType>(tok.nextToken());
+                plane.normal().x() = tok.nextNumber<Vector3::ElementType>();
+                plane.normal().y() = tok.nextNumber<Vector3::ElementType>();
+                plane.normal().z() = tok.nextNumber<Vector3::ElementType>();
+                plane.dist() = tok.nextNumber<Vector3::ElementType>();
 
                 _planes.push_back(plane);
 
@@ -135,7 +235,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "vertices")
         {
-            std::size_t vertCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t vertCount = tok.nextNumber<std::size_t>();
 
             _vertices.reserve(vertCount);
 
@@ -144,7 +244,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( x y z )
             for (std::size_t i = 0; i < vertCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
+                tok.skipTokens(1); // index
                 _vertices.push_back(parseVector3(tok)); // components
             }
 
@@ -152,7 +252,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "edges")
         {
-            std::size_t edgeCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t edgeCount = tok.nextNumber<std::size_t>();
 
             _edges.reserve(edgeCount);
 
@@ -161,13 +261,13 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( vertIdx1 vertIdx2 )
             for (std::size_t i = 0; i < edgeCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
+                tok.skipTokens(1); // index
 
                 tok.assertNextToken("(");
 
                 Edge edge;
-                edge.vertexNumber[0] = string::convert<int>(tok.nextToken());
-                edge.vertexNumber[1] = string::convert<int>(tok.nextToken());
+                edge.vertexNumber[0] = tok.nextNumber<int>();
+                edge.vertexNumber[1] = tok.nextNumber<int>();
 
                 tok.assertNextToken(")");
 
@@ -182,7 +282,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "faces")
         {
-            std::size_t faceCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t faceCount = tok.nextNumber<std::size_t>();
 
             _faces.reserve(faceCount);
 
@@ -191,18 +291,18 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( planeNum flags areas[0] areas[1] firstEdge numEdges )
             for (std::size_t i = 0; i < faceCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.skipTokens(1); // number
 
                 tok.assertNextToken("(");
 
                 Face face;
 
-                face.planeNum = string::convert<int>(tok.nextToken());
-                face.flags = string::convert<unsigned short>(tok.nextToken());
-                face.areas[0] = string::convert<short>(tok.nextToken());
-                face.areas[1] = string::convert<short>(tok.nextToken());
-                face.firstEdge = string::convert<int>(tok.nextToken());
-                face.numEdges = string::convert<int>(tok.nextToken());
+                face.planeNum = tok.nextNumber<int>();
+                face.flags = tok.nextNumber<unsigned short>();
+                face.areas[0] = tok.nextNumber<short>();
+                face.areas[1] = tok.nextNumber<short>();
+                face.firstEdge = tok.nextNumber<int>();
+                face.numEdges = tok.nextNumber<int>();
 
                 _faces.push_back(face);
 
@@ -217,7 +317,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "areas")
         {
-            std::size_t areaCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t areaCount = tok.nextNumber<std::size_t>();
 
             _areas.reserve(areaCount);
 
@@ -226,28 +326,29 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( flags contents firstFace numFaces cluster clusterAreaNum ) reachabilityCount { reachabilities }
             for (std::size_t i = 0; i < areaCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.skipTokens(1); // number
 
                 tok.assertNextToken("(");
 
                 Area area;
+                area.travelFlags = 0;
 
-                area.flags = string::convert<unsigned short>(tok.nextToken());
-                area.contents = string::convert<unsigned short>(tok.nextToken());
-                area.firstFace = string::convert<int>(tok.nextToken());
-                area.numFaces = string::convert<int>(tok.nextToken());
-                area.cluster = string::convert<short>(tok.nextToken());
-                area.clusterAreaNum = string::convert<short>(tok.nextToken());
+                area.flags = tok.nextNumber<unsigned short>();
+                area.contents = tok.nextNumber<unsigned short>();
+                area.firstFace = tok.nextNumber<int>();
+                area.numFaces = tok.nextNumber<int>();
+                area.cluster = tok.nextNumber<short>();
+                area.clusterAreaNum = tok.nextNumber<short>();
 
                 _areas.push_back(area);
 
                 tok.assertNextToken(")");
 
                 // Skip over reachabilities for the moment being
-                /*std::size_t reachCount = */string::convert<std::size_t>(tok.nextToken());
+                tok.skipTokens(1); // reachability count
                 tok.assertNextToken("{");
 
-                while (tok.nextToken() != "}")
+                while (tok.nextTokenView() != "}")
                 {
                     // do nothing
                 }
@@ -259,17 +360,17 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "nodes" || token == "portals" || token == "portalIndex" || token == "clusters")
         {
-            tok.nextToken(); // integer
+            tok.skipTokens(1); // integer
             tok.assertNextToken("{");
 
-            while (tok.nextToken() != "}")
+            while (tok.nextTokenView() != "}")
             {
                 // do nothing
             }
         }
         else
         {
-            throw parser::ParseException("Unknown token: " + token);
+            throw parser::ParseException("Unknown token: " + std::string(token));
         }
     }
 
@@ -283,6 +384,8 @@ void Doom3AasFile::finishAreas()
         area.center = calcReachableGoalForArea(area);
 		area.bounds = calcAreaBounds(area);
     }
+
+    _areaTree.build(_areas);
 }
 
 #define INTSIGNBITSET(i)		(((const unsigned int)(i)) >> 31)
@@ -389,9 +492,9 @@ Vector3 Doom3AasFile::calcReachableGoalForArea(const IAasFile::Area& area) const
     return center;
 }
 
-void Doom3AasFile::parseIndex(parser::DefTokeniser& tok, Index& index)
+void Doom3AasFile::parseIndex(parser::BufferTokeniser& tok, Index& index)
 {
-    std::size_t idxCount = string::convert<std::size_t>(tok.nextToken());
+    std::size_t idxCount = tok.nextNumber<std::size_t>();
 
     index.reserve(idxCount);
 
@@ -400,14 +503,192 @@ void Doom3AasFile::parseIndex(parser::DefTokeniser& tok, Index& index)
     // num ( idx )
     for (std::size_t i = 0; i < idxCount; ++i)
     {
-        string::convert<int>(tok.nextToken()); // number
+        tok.skipTokens(1); // number
 
         tok.assertNextToken("(");
-        index.push_back(string::convert<int>(tok.nextToken()));
+        index.push_back(tok.nextNumber<int>());
         tok.assertNextToken(")");
     }
 
     tok.assertNextToken("}");
 }
 
+int Doom3AasFile::getAreaContainingPoint(const Vector3& point) const
+{
+    int result = -1;
+
+    _areaTree.forEachAreaContaining(point, [&](int areaNum)
+    {
+        if (result == -1 && pointIsInsideArea(point, areaNum))
+        {
+            result = areaNum;
+        }
+    });
+
+    return result;
+}
+
+bool Doom3AasFile::pointIsInsideArea(const Vector3& point, int areaNum) const
+{
+    const auto& area = _areas[areaNum];
+
+    // The area is at the front side of the face planes listing it as areas[0],
+    // and at the back side of those listing it as areas[1]
+    for (int i = 0; i < area.numFaces; i++)
+    {
+        const auto& face = _faces[abs(_faceIndex[area.firstFace + i])];
+        auto distance = _planes[face.planeNum].distanceToPoint(point);
+
+        if ((face.areas[0] == areaNum && distance < -PointInAreaEpsilon) ||
+            (face.areas[1] == areaNum && distance > PointInAreaEpsilon))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Doom3AasFile::forEachAreaIntersecting(const AABB& bounds, const std::function<void(int areaNum)>& functor) const
+{
+    _areaTree.forEachAreaIntersecting(bounds, functor);
+}
+
+void Doom3AasFile::forEachVisibleArea(const VolumeTest& volume, const std::function<void(int areaNum)>& functor) const
+{
+    _areaTree.forEachVisibleArea(volume, functor);
+}
+
+void Doom3AasFile::writeBinary(std::ostream& stream) const
+{
+    writeValue(stream, static_cast<std::uint64_t>(_planes.size()));
+
+    for (const auto& plane : _planes)
+    {
+        writeVector3(stream, plane.normal());
+        writeValue(stream, plane.dist());
+    }
+
+    writeValue(stream, static_cast<std::uint64_t>(_vertices.size()));
+
+    for (const auto& vertex : _vertices)
+    {
+        writeVector3(stream, vertex);
+    }
+
+    writeArray(stream, _edges);
+    writeArray(stream, _edgeIndex);
+    writeArray(stream, _faces);
+    writeArray(stream, _faceIndex);
+
+    writeValue(stream, static_cast<std::uint64_t>(_areas.size()));
+
+    for (const auto& area : _areas)
+    {
+        writeValue(stream, area.numFaces);
+        writeValue(stream, area.firstFace);
+        writeVector3(stream, area.bounds.origin);
+        writeVector3(stream, area.bounds.extents);
+        writeVector3(stream, area.center);
+        writeValue(stream, area.flags);
+        writeValue(stream, area.contents);
+        writeValue(stream, area.cluster);
+        writeValue(stream, area.clusterAreaNum);
+        writeValue(stream, area.travelFlags);
+    }
+}
+
+void Doom3AasFile::readBinary(std::istream& stream)
+{
+    _planes.resize(readArraySize(stream));
+
+    for (auto& plane : _planes)
+    {
+        plane.normal() = readVector3(stream);
+        plane.dist() = readValue<double>(stream);
+    }
+
+    _vertices.resize(readArraySize(stream));
+
+    for (auto& vertex : _vertices)
+    {
+        vertex = readVector3(stream);
+    }
+
+    readArray(stream, _edges);
+    readArray(stream, _edgeIndex);
+    readArray(stream, _faces);
+    readArray(stream, _faceIndex);
+
+    _areas.resize(readArraySize(stream));
+
+    for (auto& area : _areas)
+    {
+        area.numFaces = readValue<int>(stream);
+        area.firstFace = readValue<int>(stream);
+        area.bounds.origin = readVector3(stream);
+        area.bounds.extents = readVector3(stream);
+        area.center = readVector3(stream);
+        area.flags = readValue<unsigned short>(stream);
+        area.contents = readValue<unsigned short>(stream);
+        area.cluster = readValue<short>(stream);
+        area.clusterAreaNum = readValue<short>(stream);
+        area.travelFlags = readValue<int>(stream);
+    }
+
+    if (stream.peek() != std::char_traits<char>::eof())
+    {
+        throw std::runtime_error("Unexpected trailing data in AAS binary data");
+    }
+
+    validateReferences();
+
+    _areaTree.build(_areas);
+}
+
+void Doom3AasFile::validateReferences() const
+{
+    for (const auto& edge : _edges)
+    {
+        if (!isValidIndex(edge.vertexNumber[0], _vertices.size()) || !isValidIndex(edge.vertexNumber[1], _vertices.size()))
+        {
+            throw std::runtime_error("Invalid vertex number in AAS edge");
+        }
+    }
+
+    for (auto edgeNum : _edgeIndex)
+    {
+        if (!isValidSignedIndex(edgeNum, _edges.size()))
+        {
+            throw std::runtime_error("Invalid edge number in AAS edge index");
+        }
+    }
+
+    for (const auto& face : _faces)
+    {
+        if (!isValidIndex(face.planeNum, _planes.size()) ||
+            !isValidRange(face.firstEdge, face.numEdges, _edgeIndex.size()) ||
+            !isValidIndex(face.areas[0], _areas.size()) || !isValidIndex(face.areas[1], _areas.size()))
+        {
+            throw std::runtime_error("Invalid reference in AAS face");
+        }
+    }
+
+    for (auto faceNum : _faceIndex)
+    {
+        if (!isValidSignedIndex(faceNum, _faces.size()))
+        {
+            throw std::runtime_error("Invalid face number in AAS face index");
+        }
+    }
+
+    for (const auto& area : _areas)
+    {
+        if (!isValidRange(area.firstFace, area.numFaces, _faceIndex.size()))
+        {
+            throw std::runtime_error("Invalid face range in AAS area");
+        }
+    }
+}
+
 }
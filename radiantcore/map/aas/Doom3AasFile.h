@@ -1,9 +1,12 @@
 #pragma once
 
 #include "iaasfile.h"
-#include "parser/DefTokeniser.h"
+#include "parser/BufferTokeniser.h"
 #include "Doom3AasFileSettings.h"
+#include "AasAreaTree.h"
 #include <vector>
+#include <istream>
+#include <ostream>
 #include "math/Plane3.h"
 #include "math/AABB.h"
 
@@ -28,6 +31,9 @@ private:
 
     std::vector<Area> _areas;
 
+    // Spatial index over the area bounds
+    AasAreaTree _areaTree;
+
 public:
     virtual std::size_t     getNumPlanes() const override;
     virtual const Plane3&   getPlane(std::size_t planeNum) const override;
@@ -49,11 +55,24 @@ public:
     virtual std::size_t     getNumAreas() const override;
     virtual const Area&     getArea(int areaNum) const override;
 
-    void parseFromTokens(parser::DefTokeniser& tok);
+    int getAreaContainingPoint(const Vector3& point) const override;
+    void forEachAreaIntersecting(const AABB& bounds, const std::function<void(int areaNum)>& functor) const override;
+    void forEachVisibleArea(const VolumeTest& volume, const std::function<void(int areaNum)>& functor) const override;
+
+    void parseFromTokens(parser::BufferTokeniser& tok);
+
+    // Binary representation of the parsed data (excluding the settings block)
+    // in the native byte order, used by the AasFileManager's disk cache.
+    // Reading throws std::runtime_error if the data is incomplete or
+    // contains counts or indices which are out of range.
+    void writeBinary(std::ostream& stream) const;
+    void readBinary(std::istream& stream);
 
 private:
-    void parseIndex(parser::DefTokeniser& tok, Index& index);
+    void parseIndex(parser::BufferTokeniser& tok, Index& index);
+    void validateReferences() const;
     void finishAreas();
+    bool pointIsInsideArea(const Vector3& point, int areaNum) const;
     Vector3 calcReachableGoalForArea(const IAasFile::Area& area) const;
     Vector3 calcFaceCenter(int faceNum) const;
     Vector3 calcAreaCenter(const IAasFile::Area& area) const;
@@ -3,6 +3,7 @@
 #include "itextstream.h"
 
 #include "parser/DefTokeniser.h"
+#include "parser/BufferTokeniser.h"
 #include "string/convert.h"
 #include "Doom3AasFile.h"
 #include "module/StaticModule.h"
@@ -54,8 +55,8 @@ IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
 
     // We assume that the stream is rewound to the beginning
 
-    // Instantiate a tokeniser to read the version tag
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+    // Read the whole file into memory, the numbers are converted in place
+	parser::BufferTokeniser tok(stream);
 
     try
 	{
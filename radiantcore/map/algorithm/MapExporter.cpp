@@ -260,6 +260,11 @@ void MapExporter::disableProgressMessages()
     _sendProgressMessages = false;
 }
 
+void MapExporter::finishInfoFile()
+{
+    _infoFileExporter.reset();
+}
+
 void MapExporter::prepareScene()
 {
 	// stgatilov: Hack to disable recalculateBrushWindings for hot-reload diffs
@@ -80,6 +80,10 @@ public:
     // Don't send any progress messages through the MessageBus while exporting
     void disableProgressMessages();
 
+    // Writes the info file blocks and releases the info file stream. This is
+    // otherwise done on destruction, which also restores the exported scene.
+    void finishInfoFile();
+
 private:
 	// Common code shared by the constructors
 	void construct();
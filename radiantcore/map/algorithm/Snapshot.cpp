@@ -0,0 +1,153 @@
+#include "Snapshot.h"
+
+#include <map>
+#include <vector>
+#include "ilayer.h"
+#include "iselectiongroup.h"
+#include "iselectionset.h"
+
+#include "scene/Clone.h"
+#include "map/RootNode.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+namespace
+{
+
+void copyLayers(scene::ILayerManager& source, scene::ILayerManager& target)
+{
+    std::vector<int> hiddenLayerIds;
+    std::vector<std::pair<int, int>> layerParentIds;
+
+    source.foreachLayer([&](int layerId, const std::string& layerName)
+    {
+        // The default layer already exists in the target
+        target.createLayer(layerName, layerId);
+
+        if (!source.layerIsVisible(layerId))
+        {
+            hiddenLayerIds.push_back(layerId);
+        }
+
+        auto parentLayerId = source.getParentLayer(layerId);
+
+        if (parentLayerId != -1)
+        {
+            layerParentIds.emplace_back(layerId, parentLayerId);
+        }
+    });
+
+    // Same order as the layer info file import: active layer, visibility, hierarchy
+    target.setActiveLayer(source.getActiveLayer());
+
+    for (auto layerId : hiddenLayerIds)
+    {
+        target.setLayerVisibility(layerId, false);
+    }
+
+    for (const auto& [childLayerId, parentLayerId] : layerParentIds)
+    {
+        target.setParentLayer(childLayerId, parentLayerId);
+    }
+}
+
+// Clones the direct children of the visited node including their descendants
+class TopLevelNodeCloner :
+    public scene::NodeVisitor
+{
+private:
+    scene::INode& _target;
+    scene::PostCloneCallback _postCloneCallback;
+
+public:
+    TopLevelNodeCloner(scene::INode& target, const scene::PostCloneCallback& callback) :
+        _target(target),
+        _postCloneCallback(callback)
+    {}
+
+    bool pre(const scene::INodePtr& node) override
+    {
+        auto clone = scene::cloneNodeIncludingDescendants(node, _postCloneCallback);
+
+        if (clone)
+        {
+            _target.addChildNode(clone);
+        }
+
+        return false; // the children have been cloned along with their parent
+    }
+};
+
+}
+
+scene::IMapRootNodePtr createSnapshot(const scene::IMapRootNodePtr& root)
+{
+    auto snapshot = std::make_shared<RootNode>(root->name());
+
+    root->foreachProperty([&](const std::string& key, const std::string& value)
+    {
+        snapshot->setProperty(key, value);
+    });
+
+    copyLayers(root->getLayerManager(), snapshot->getLayerManager());
+
+    auto& groupManager = snapshot->getSelectionGroupManager();
+
+    // Selection sets refer to the source nodes, collect the sets each node is a member of
+    // and create all sets up front such that empty ones are preserved too
+    std::map<scene::INode*, std::vector<selection::ISelectionSetPtr>> setMemberships;
+
+    root->getSelectionSetManager().foreachSelectionSet([&](const selection::ISelectionSetPtr& set)
+    {
+        auto clonedSet = snapshot->getSelectionSetManager().createSelectionSet(set->getName());
+
+        for (const auto& node : set->getNodes())
+        {
+            setMemberships[node.get()].push_back(clonedSet);
+        }
+    });
+
+    // Cloned nodes don't inherit the group or set memberships, re-add them in the original order
+    auto assignGroupsAndSets = [&](const scene::INodePtr& sourceNode, const scene::INodePtr& clonedNode)
+    {
+        if (auto sets = setMemberships.find(sourceNode.get()); sets != setMemberships.end())
+        {
+            for (const auto& set : sets->second)
+            {
+                set->addNode(clonedNode);
+            }
+        }
+
+        auto selectable = std::dynamic_pointer_cast<IGroupSelectable>(sourceNode);
+
+        if (!selectable) return;
+
+        for (auto groupId : selectable->getGroupIds())
+        {
+            groupManager.findOrCreateSelectionGroup(groupId)->addNode(clonedNode);
+        }
+    };
+
+    TopLevelNodeCloner cloner(*snapshot, assignGroupsAndSets);
+    root->traverseChildren(cloner);
+
+    root->getSelectionGroupManager().foreachSelectionGroup([&](selection::ISelectionGroup& group)
+    {
+        auto clonedGroup = groupManager.getSelectionGroup(group.getId());
+
+        if (clonedGroup)
+        {
+            clonedGroup->setName(group.getName());
+        }
+    });
+
+    return snapshot;
+}
+
+}
+
+}
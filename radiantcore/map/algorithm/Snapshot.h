@@ -0,0 +1,24 @@
+#pragma once
+
+#include "imap.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+/**
+ * Clones all entities and primitives of the given map into a new root node
+ * which is not connected to the scene graph. Layers, selection groups,
+ * selection sets and map properties are copied along, so the snapshot can be exported in place
+ * of the original and yields the same map and info file.
+ *
+ * Must be called from the main thread, the returned root is not shared with
+ * anything else and can be handed over to a worker thread afterwards.
+ */
+scene::IMapRootNodePtr createSnapshot(const scene::IMapRootNodePtr& root);
+
+}
+
+}
@@ -0,0 +1,298 @@
+#include "SyntheticMap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+#include "i18n.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ieclass.h"
+#include "ientity.h"
+#include "ishaders.h"
+#include "imodel.h"
+#include "ifilesystem.h"
+
+#include "math/pi.h"
+#include "scenelib.h"
+#include "shaderlib.h"
+#include "os/path.h"
+#include "string/case_conv.h"
+#include "string/predicate.h"
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace algorithm
+{
+
+namespace
+{
+    // Distance between the centers of two neighbouring grid cells
+    constexpr double GridSpacing = 256;
+
+    enum class ObjectType
+    {
+        Brush,
+        Patch,
+        Light,
+        Model,
+    };
+
+    // Picks pseudo-random values. The raw output of std::mt19937 is specified
+    // by the standard, unlike the std distributions, so the same seed
+    // yields the same map on every platform.
+    class RandomGenerator
+    {
+    private:
+        std::mt19937 _engine;
+
+    public:
+        RandomGenerator(unsigned int seed) :
+            _engine(seed)
+        {}
+
+        // Returns a value in the range [0..count)
+        std::size_t index(std::size_t count)
+        {
+            return static_cast<std::size_t>(_engine() % count);
+        }
+
+        // Returns a value in the range [min..max]
+        int range(int min, int max)
+        {
+            return min + static_cast<int>(index(static_cast<std::size_t>(max - min + 1)));
+        }
+    };
+
+    std::vector<std::string> collectMaterialNames()
+    {
+        std::vector<std::string> names;
+
+        GlobalMaterialManager().foreachShaderName([&](const std::string& name)
+        {
+            if (string::starts_with(name, "textures/"))
+            {
+                names.push_back(name);
+            }
+        });
+
+        // Don't rely on the order of the material manager
+        std::sort(names.begin(), names.end());
+
+        if (names.empty())
+        {
+            names.push_back(texdef_name_default());
+        }
+
+        return names;
+    }
+
+    std::vector<std::string> collectModelPaths()
+    {
+        std::set<std::string> extensions;
+
+        GlobalModelFormatManager().foreachImporter([&](const model::IModelImporterPtr& importer)
+        {
+            extensions.insert(string::to_lower_copy(importer->getExtension()));
+        });
+
+        std::vector<std::string> paths;
+
+        GlobalFileSystem().forEachFile("models/", "*", [&](const vfs::FileInfo& fileInfo)
+        {
+            if (extensions.count(string::to_lower_copy(os::getExtension(fileInfo.name))) > 0)
+            {
+                paths.push_back(fileInfo.fullPath());
+            }
+        }, 0);
+
+        std::sort(paths.begin(), paths.end());
+
+        return paths;
+    }
+
+    scene::INodePtr createEntity(const scene::INodePtr& root, const std::string& className)
+    {
+        auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findOrInsert(className, false));
+        root->addChildNode(entity);
+
+        return entity;
+    }
+
+    scene::INodePtr createBrush(const scene::INodePtr& parent, const Vector3& origin, RandomGenerator& random,
+        const std::vector<std::string>& materials)
+    {
+        auto brushNode = GlobalBrushCreator().createBrush();
+        parent->addChildNode(brushNode);
+
+        auto& brush = *Node_getIBrush(brushNode);
+
+        auto numSides = random.range(4, 8);
+        auto radius = random.range(32, 96);
+        auto height = random.range(16, 128);
+        auto translation = Matrix4::getTranslation(origin + Vector3(0, 0, height));
+
+        for (int i = 0; i < numSides; ++i)
+        {
+            auto angle = 2 * math::PI * i / numSides;
+            brush.addFace(Plane3(cos(angle), sin(angle), 0, radius).transform(translation));
+        }
+
+        brush.addFace(Plane3(0, 0, +1, height).transform(translation));
+        brush.addFace(Plane3(0, 0, -1, height).transform(translation));
+
+        brush.setShader(materials[random.index(materials.size())]);
+        brush.evaluateBRep();
+
+        return brushNode;
+    }
+
+    scene::INodePtr createPatch(const scene::INodePtr& parent, const Vector3& origin, RandomGenerator& random,
+        const std::vector<std::string>& materials)
+    {
+        auto patchNode = GlobalPatchModule().createPatch(patch::PatchDefType::Def2);
+        parent->addChildNode(patchNode);
+
+        auto& patch = *Node_getIPatch(patchNode);
+        patch.setDims(3, 3);
+        patch.setShader(materials[random.index(materials.size())]);
+
+        // A curved surface, its center row is raised by a random amount
+        auto extents = random.range(32, 96);
+        auto bulge = random.range(0, 64);
+
+        for (std::size_t row = 0; row < 3; ++row)
+        {
+            for (std::size_t col = 0; col < 3; ++col)
+            {
+                patch.ctrlAt(row, col).vertex = origin + Vector3(
+                    (static_cast<double>(col) - 1) * extents,
+                    (static_cast<double>(row) - 1) * extents,
+                    row == 1 ? bulge : 0);
+            }
+        }
+
+        patch.controlPointsChanged();
+        patch.fitTexture(1, 1);
+
+        return patchNode;
+    }
+
+    scene::INodePtr createLight(const scene::INodePtr& root, const Vector3& origin, RandomGenerator& random)
+    {
+        auto node = createEntity(root, "light");
+        auto& entity = *Node_getEntity(node);
+
+        // Draw the values one by one, the evaluation order of function arguments is unspecified
+        auto radius = random.range(64, 512);
+        auto red = random.range(20, 100) / 100.0;
+        auto green = random.range(20, 100) / 100.0;
+        auto blue = random.range(20, 100) / 100.0;
+
+        entity.setKeyValue("origin", fmt::format("{0} {1} {2}", origin.x(), origin.y(), origin.z() + 128));
+        entity.setKeyValue("light_radius", fmt::format("{0} {0} {0}", radius));
+        entity.setKeyValue("_color", fmt::format("{0:.2f} {1:.2f} {2:.2f}", red, green, blue));
+
+        return node;
+    }
+
+    scene::INodePtr createModel(const scene::INodePtr& root, const Vector3& origin, RandomGenerator& random,
+        const std::vector<std::string>& modelPaths)
+    {
+        auto node = createEntity(root, "func_static");
+        auto& entity = *Node_getEntity(node);
+
+        entity.setKeyValue("origin", fmt::format("{0} {1} {2}", origin.x(), origin.y(), origin.z()));
+        entity.setKeyValue("angle", std::to_string(random.range(0, 23) * 15));
+        entity.setKeyValue("model", modelPaths[random.index(modelPaths.size())]);
+
+        return node;
+    }
+}
+
+AABB generateSyntheticMap(const scene::INodePtr& worldspawn, const SyntheticMapParameters& parameters)
+{
+    auto root = worldspawn->getParent();
+
+    if (!root)
+    {
+        throw std::runtime_error(_("The worldspawn is not part of a map"));
+    }
+
+    RandomGenerator random(parameters.seed);
+
+    auto materials = collectMaterialNames();
+    std::vector<std::string> modelPaths;
+
+    if (parameters.numModels > 0)
+    {
+        modelPaths = collectModelPaths();
+
+        if (modelPaths.empty())
+        {
+            throw std::runtime_error(_("Cannot generate model references, no model files found in the VFS"));
+        }
+    }
+
+    // The containers the primitives are distributed to, worldspawn comes first
+    std::vector<scene::INodePtr> containers{ worldspawn };
+
+    for (std::size_t i = 0; i < parameters.numEntities; ++i)
+    {
+        auto entity = createEntity(root, "func_static");
+        Node_getEntity(entity)->setKeyValue("origin", "0 0 0");
+
+        containers.push_back(entity);
+    }
+
+    // Shuffle the objects, to not have all objects of the same kind next to each other
+    std::vector<ObjectType> objects;
+    objects.insert(objects.end(), parameters.numBrushes, ObjectType::Brush);
+    objects.insert(objects.end(), parameters.numPatches, ObjectType::Patch);
+    objects.insert(objects.end(), parameters.numLights, ObjectType::Light);
+    objects.insert(objects.end(), parameters.numModels, ObjectType::Model);
+
+    for (std::size_t i = objects.size(); i > 1; --i)
+    {
+        std::swap(objects[i - 1], objects[random.index(i)]);
+    }
+
+    auto gridSize = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(objects.size()))));
+    std::size_t numPrimitives = 0;
+    AABB bounds;
+
+    for (std::size_t i = 0; i < objects.size(); ++i)
+    {
+        Vector3 origin((i % gridSize) * GridSpacing, (i / gridSize) * GridSpacing, 0);
+        scene::INodePtr node;
+
+        switch (objects[i])
+        {
+        case ObjectType::Brush:
+            node = createBrush(containers[numPrimitives++ % containers.size()], origin, random, materials);
+            break;
+        case ObjectType::Patch:
+            node = createPatch(containers[numPrimitives++ % containers.size()], origin, random, materials);
+            break;
+        case ObjectType::Light:
+            node = createLight(root, origin, random);
+            break;
+        case ObjectType::Model:
+            node = createModel(root, origin, random, modelPaths);
+            break;
+        }
+
+        bounds.includeAABB(node->worldAABB());
+    }
+
+    return bounds;
+}
+
+}
+
+}
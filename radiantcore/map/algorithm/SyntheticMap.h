@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include "inode.h"
+#include "math/AABB.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+/**
+ * Describes the contents of a generated synthetic map.
+ * The same parameters will always produce the same map, as long
+ * as the set of materials and model files in the VFS stays the same.
+ */
+struct SyntheticMapParameters
+{
+    // Number of brushes (prisms with 4 to 8 sides)
+    std::size_t numBrushes = 0;
+
+    // Number of flat 3x3 patches
+    std::size_t numPatches = 0;
+
+    // Number of brush-based func_static entities. The brushes and patches
+    // are distributed evenly across these entities and the worldspawn.
+    std::size_t numEntities = 0;
+
+    // Number of light entities
+    std::size_t numLights = 0;
+
+    // Number of func_static entities referencing a model file from the VFS
+    std::size_t numModels = 0;
+
+    // Seed of the random generator choosing the materials, models and shapes
+    unsigned int seed = 0;
+};
+
+/**
+ * Populates the map of the given worldspawn with the objects described by the given
+ * parameters. Entities are added next to the worldspawn below the map root.
+ * All objects are laid out on a square grid on the XY plane, the brushes and
+ * patches are using materials below textures/ as declared in the current VFS.
+ * No undo information is recorded. Returns the bounds of the generated objects.
+ *
+ * Throws std::runtime_error if model references have been requested but
+ * there are no loadable model files in the VFS.
+ */
+AABB generateSyntheticMap(const scene::INodePtr& worldspawn, const SyntheticMapParameters& parameters);
+
+}
+
+}
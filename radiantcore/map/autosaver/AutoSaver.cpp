@@ -11,6 +11,7 @@
 #include "igame.h"
 #include "ipreferencesystem.h"
 #include "icommandsystem.h"
+#include "command/ExecutionFailure.h"
 
 #include "registry/registry.h"
 
@@ -26,6 +27,8 @@
 #include "module/StaticModule.h"
 #include "messages/NotificationMessage.h"
 #include "messages/AutomaticMapSaveRequest.h"
+#include "messages/AutomaticMapSaveFinished.h"
+#include "imapresource.h"
 #include "map/Map.h"
 
 #include <fmt/format.h>
@@ -57,12 +60,17 @@ namespace
 
 AutoMapSaver::AutoMapSaver() :
 	_snapshotsEnabled(false),
-    _savedChangeCount(0)
+	_backgroundSaveEnabled(false),
+	_journalEnabled(false),
+    _savedChangeCount(0),
+    _saveFinishedListener(0)
 {}
 
 void AutoMapSaver::registryKeyChanged()
 {
 	_snapshotsEnabled = registry::getValue<bool>(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
+	_backgroundSaveEnabled = registry::getValue<bool>(RKEY_AUTOSAVE_IN_BACKGROUND);
+	_journalEnabled = registry::getValue<bool>(RKEY_AUTOSAVE_JOURNAL_ENABLED);
 }
 
 void AutoMapSaver::clearChanges()
@@ -99,6 +107,12 @@ void AutoMapSaver::saveSnapshot()
 	// Check if the folder exists and create it if necessary
 	if (os::fileOrDirExists(snapshotPath.string()) || os::makeDirectory(snapshotPath.string()))
 	{
+		if (_journalEnabled)
+		{
+			saveJournalEntry(snapshotPath, mapName);
+			return;
+		}
+
         // Map existing snapshots (snapshot num => path)
         std::map<int, std::string> existingSnapshots;
 
@@ -111,7 +125,7 @@ void AutoMapSaver::saveSnapshot()
 		rMessage() << "Autosaving snapshot to " << filename << std::endl;
 
 		// Dump to map to the next available filename
-        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+        saveMap(filename);
 
 		handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
 	}
@@ -121,6 +135,40 @@ void AutoMapSaver::saveSnapshot()
 	}
 }
 
+void AutoMapSaver::saveJournalEntry(const fs::path& snapshotPath, const std::string& mapName)
+{
+	auto journalPath = snapshotPath / (mapName + ".journal");
+
+	if (!os::fileOrDirExists(journalPath.string()) && !os::makeDirectory(journalPath.string()))
+	{
+		rError() << "Journal save failed, unable to create directory " << journalPath << std::endl;
+		return;
+	}
+
+	// A different map or a changed snapshot folder starts a new journal
+	if (!_journal || _journal->getFolder() != journalPath)
+	{
+		waitForPendingSave();
+		_journal = std::make_unique<AutosaveJournal>(journalPath, os::getExtension(mapName));
+	}
+
+	rMessage() << "Autosaving changes to journal " << journalPath << std::endl;
+
+	// The journal needs the previous entry to be committed before it can diff the next one
+	waitForPendingSave();
+
+	try
+	{
+		auto format = GlobalMap().getMapFormatForFilenameSafe(mapName);
+
+		startSave(_journal->createSave(GlobalMapModule().getRoot(), *format, _savedChangeCount));
+	}
+	catch (const IMapResource::OperationException& ex)
+	{
+		radiant::NotificationMessage::SendError(ex.what());
+	}
+}
+
 void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots,
 	const fs::path& snapshotPath, const std::string& mapName)
 {
@@ -206,6 +254,12 @@ bool AutoMapSaver::runAutosaveCheck()
         return false;
     }
 
+    if (_pendingSave && !_pendingSave->isFinished())
+    {
+        rMessage() << "Auto save skipped: the previous save is still being written" << std::endl;
+        return false;
+    }
+
     AutomaticMapSaveRequest request;
     GlobalRadiantCore().getMessageBus().sendMessage(request);
 
@@ -252,7 +306,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving unnamed map to " << autoSaveFilename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", autoSaveFilename);
+            saveMap(autoSaveFilename);
         }
         else
         {
@@ -268,17 +322,101 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving map to " << filename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+            saveMap(filename);
         }
     }
 }
 
+void AutoMapSaver::saveMap(const std::string& filename)
+{
+    if (!_backgroundSaveEnabled)
+    {
+        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+        return;
+    }
+
+    // Only one background save at a time, the previous one is most likely done anyway
+    waitForPendingSave();
+
+    try
+    {
+        auto format = GlobalMap().getMapFormatForFilenameSafe(filename);
+
+        startSave(std::make_unique<BackgroundMapSave>(GlobalMapModule().getRoot(), *format, filename));
+    }
+    catch (const IMapResource::OperationException& ex)
+    {
+        radiant::NotificationMessage::SendError(ex.what());
+    }
+}
+
+void AutoMapSaver::startSave(std::unique_ptr<BackgroundMapSave> save)
+{
+    waitForPendingSave();
+
+    _pendingSave = std::move(save);
+    _pendingSave->start();
+
+    if (!_backgroundSaveEnabled)
+    {
+        waitForPendingSave();
+    }
+}
+
+void AutoMapSaver::waitForPendingSave()
+{
+    if (!_pendingSave) return;
+
+    _pendingSave->wait();
+    _pendingSave.reset();
+}
+
+void AutoMapSaver::onBackgroundSaveFinished(AutomaticMapSaveFinished& message)
+{
+    // The message might belong to an earlier save that has been cleaned up already
+    if (_pendingSave && _pendingSave->isFinished())
+    {
+        waitForPendingSave();
+    }
+
+    if (!message.isSuccessful())
+    {
+        radiant::NotificationMessage::SendError(
+            fmt::format(_("Autosave to {0} failed:\n{1}"), message.getFilename(), message.getErrorMessage()));
+    }
+}
+
+void AutoMapSaver::recoverJournalCmd(const cmd::ArgumentList& args)
+{
+    auto journalPath = args[0].getString();
+    auto targetFile = args[1].getString();
+
+    if (!os::fileOrDirExists(journalPath))
+    {
+        throw cmd::ExecutionFailure(fmt::format(_("File doesn't exist: {0}"), journalPath));
+    }
+
+    // Make sure the journal is not being written to right now
+    waitForPendingSave();
+
+    try
+    {
+        AutosaveJournal::Recover(journalPath, targetFile);
+    }
+    catch (const IMapResource::OperationException& ex)
+    {
+        throw cmd::ExecutionFailure(ex.what());
+    }
+}
+
 void AutoMapSaver::constructPreferences()
 {
 	// Add a page to the given group
 	IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Autosave"));
 
 	page.appendCheckBox(_("Save Snapshots"), RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
+	page.appendCheckBox(_("Save in the Background"), RKEY_AUTOSAVE_IN_BACKGROUND);
+	page.appendCheckBox(_("Save Snapshots as Change Journal"), RKEY_AUTOSAVE_JOURNAL_ENABLED);
 	page.appendEntry(_("Snapshot Folder (absolute, or relative to Map Folder)"), RKEY_AUTOSAVE_SNAPSHOTS_FOLDER);
 	page.appendEntry(_("Max total Snapshot size per Map (MB)"), RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE);
 }
@@ -294,6 +432,9 @@ void AutoMapSaver::onMapEvent(IMap::MapEvent ev)
 	case IMap::MapUnloading:
 	case IMap::MapUnloaded:
 		clearChanges();
+		// The journal describes the map that has been loaded before
+		waitForPendingSave();
+		_journal.reset();
 		break;
     default:
         break;
@@ -315,6 +456,7 @@ const StringSet& AutoMapSaver::getDependencies() const
 		_dependencies.insert(MODULE_MAP);
 		_dependencies.insert(MODULE_PREFERENCESYSTEM);
 		_dependencies.insert(MODULE_XMLREGISTRY);
+		_dependencies.insert(MODULE_COMMANDSYSTEM);
 	}
 
 	return _dependencies;
@@ -325,6 +467,23 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED).connect(
 		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
 	));
+	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_IN_BACKGROUND).connect(
+		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
+	));
+	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_JOURNAL_ENABLED).connect(
+		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
+	));
+
+	// RecoverAutosaveJournal <JournalFolder> <TargetMapFile>
+	GlobalCommandSystem().addCommand("RecoverAutosaveJournal",
+		std::bind(&AutoMapSaver::recoverJournalCmd, this, std::placeholders::_1),
+		{ cmd::ARGTYPE_STRING, cmd::ARGTYPE_STRING });
+
+	// Background saves report back through the message bus
+	_saveFinishedListener = GlobalRadiantCore().getMessageBus().addListener(
+		radiant::IMessage::Type::AutomaticMapSaveFinished,
+		radiant::TypeListener<AutomaticMapSaveFinished>(
+			sigc::mem_fun(this, &AutoMapSaver::onBackgroundSaveFinished)));
 
 	// Get notified when the map is loaded afresh
 	_signalConnections.push_back(GlobalMapModule().signal_mapEvent().connect(
@@ -343,6 +502,11 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 
 void AutoMapSaver::shutdownModule()
 {
+	waitForPendingSave();
+	_journal.reset();
+
+	GlobalRadiantCore().getMessageBus().removeListener(_saveFinishedListener);
+
 	// Unsubscribe from all connections
 	for (sigc::connection& connection : _signalConnections)
 	{
@@ -6,12 +6,18 @@
 #include "iautosaver.h"
 
 #include <vector>
+#include <memory>
 #include <sigc++/connection.h>
 #include "os/fs.h"
+#include "icommandsystem.h"
+#include "BackgroundMapSave.h"
+#include "AutosaveJournal.h"
 
 namespace map
 {
 
+class AutomaticMapSaveFinished;
+
 /**
  * greebo: The AutoMapSaver class lets itself being called in distinct intervals
  * and saves the map files either to snapshots or to a single yyyy.autosave.map file.
@@ -23,10 +29,24 @@ private:
 	// TRUE, if the autosaver generates snapshots
 	bool _snapshotsEnabled;
 
+	// TRUE, if the map is written on a worker thread
+	bool _backgroundSaveEnabled;
+
+	// TRUE, if snapshots are written as change journal instead of full copies
+	bool _journalEnabled;
+
 	std::size_t _savedChangeCount;
 
 	std::vector<sigc::connection> _signalConnections;
 
+	// The background save currently being written (if any)
+	std::unique_ptr<BackgroundMapSave> _pendingSave;
+
+	std::size_t _saveFinishedListener;
+
+	// The change journal of the current map, created on first use
+	std::unique_ptr<AutosaveJournal> _journal;
+
 public:
 	// Constructor
 	AutoMapSaver();
@@ -46,6 +66,8 @@ public:
 
     void performAutosave() override;
 
+    void waitForPendingSave() override;
+
 private:
 	void constructPreferences();
 
@@ -53,6 +75,19 @@ private:
 
 	void onMapEvent(IMap::MapEvent ev);
 
+	void onBackgroundSaveFinished(AutomaticMapSaveFinished& message);
+
+	// Writes the current map to the given file, either right away or on a worker thread
+	void saveMap(const std::string& filename);
+
+	// Starts the given save, blocks until it's done unless background saving is enabled
+	void startSave(std::unique_ptr<BackgroundMapSave> save);
+
+	// Appends the changes since the last autosave to the journal of the current map
+	void saveJournalEntry(const fs::path& snapshotPath, const std::string& mapName);
+
+	void recoverJournalCmd(const cmd::ArgumentList& args);
+
 	// Saves a snapshot of the currently active map (only named maps)
 	void saveSnapshot();
 
@@ -0,0 +1,862 @@
+#include "AutosaveJournal.h"
+
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+#include "i18n.h"
+#include "itextstream.h"
+#include "ientity.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ilayer.h"
+#include "iselectiongroup.h"
+#include "iselectionset.h"
+#include "imapresource.h"
+
+#include "scenelib.h"
+#include "gamelib.h"
+#include "os/path.h"
+#include "math/Hash.h"
+#include "scene/ChildPrimitives.h"
+#include "scene/Traverse.h"
+#include "map/MapResource.h"
+#include "map/format/primitivewriters/BrushDef3Exporter.h"
+#include "map/format/primitivewriters/PatchDefExporter.h"
+
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace
+{
+    constexpr const char* const INDEX_FILENAME = "journal.txt";
+
+    // Index file keywords
+    constexpr const char* const BASE = "base";
+    constexpr const char* const ENTRY = "entry";
+    constexpr const char* const ADD = "add";
+    constexpr const char* const UPDATE = "update";
+    constexpr const char* const REMOVE = "remove";
+    constexpr const char* const END = "end";
+
+    // Collects the direct children of a node passing the given predicate
+    class ChildCollector :
+        public scene::NodeVisitor
+    {
+    private:
+        std::function<bool(const scene::INodePtr&)> _predicate;
+
+    public:
+        std::vector<scene::INodePtr> children;
+
+        ChildCollector(const std::function<bool(const scene::INodePtr&)>& predicate) :
+            _predicate(predicate)
+        {}
+
+        bool pre(const scene::INodePtr& node) override
+        {
+            if (_predicate(node))
+            {
+                children.push_back(node);
+            }
+
+            return false;
+        }
+    };
+
+    std::vector<scene::INodePtr> getChildren(const scene::INodePtr& parent,
+        const std::function<bool(const scene::INodePtr&)>& predicate)
+    {
+        ChildCollector collector(predicate);
+        parent->traverseChildren(collector);
+
+        return std::move(collector.children);
+    }
+
+    // The primitives the MapExporter is going to write
+    bool isExportedPrimitive(const scene::INodePtr& node)
+    {
+        if (Node_isPatch(node)) return true;
+
+        auto* brush = Node_getIBrush(node);
+
+        return brush != nullptr && brush->hasContributingFaces();
+    }
+
+    std::vector<scene::INodePtr> getEntities(const scene::INodePtr& root)
+    {
+        return getChildren(root, [](const scene::INodePtr& node) { return Node_isEntity(node); });
+    }
+
+    std::vector<scene::INodePtr> getPrimitives(const scene::INodePtr& entity)
+    {
+        return getChildren(entity, isExportedPrimitive);
+    }
+
+    // The names of the selection sets each node is a member of
+    using SelectionSetMemberships = std::map<scene::INode*, std::vector<std::string>>;
+
+    SelectionSetMemberships getSelectionSetMemberships(const scene::INodePtr& root)
+    {
+        SelectionSetMemberships memberships;
+
+        if (auto mapRoot = std::dynamic_pointer_cast<scene::IMapRootNode>(root); mapRoot)
+        {
+            mapRoot->getSelectionSetManager().foreachSelectionSet([&](const selection::ISelectionSetPtr& set)
+            {
+                for (const auto& node : set->getNodes())
+                {
+                    memberships[node.get()].push_back(set->getName());
+                }
+            });
+        }
+
+        return memberships;
+    }
+
+    // Layer, group and set memberships are written to the info file, changing them changes the node
+    void combineMembershipHashes(std::size_t& hash, const scene::INodePtr& node,
+        const SelectionSetMemberships& setMemberships)
+    {
+        for (auto layerId : node->getLayers())
+        {
+            math::combineHash(hash, std::hash<int>()(layerId));
+        }
+
+        auto selectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
+
+        if (selectable)
+        {
+            for (auto groupId : selectable->getGroupIds())
+            {
+                math::combineHash(hash, std::hash<std::size_t>()(groupId));
+            }
+        }
+
+        if (auto sets = setMemberships.find(node.get()); sets != setMemberships.end())
+        {
+            for (const auto& name : sets->second)
+            {
+                math::combineHash(hash, std::hash<std::string>()(name));
+            }
+        }
+    }
+
+    std::size_t hashPrimitive(const scene::INodePtr& node, const SelectionSetMemberships& setMemberships)
+    {
+        // The Doom 3 syntax covers every property of brushes and patches, regardless of the map format
+        std::ostringstream stream;
+        stream.precision(16);
+
+        if (auto brush = std::dynamic_pointer_cast<IBrushNode>(node); brush)
+        {
+            BrushDef3Exporter::exportBrush(stream, brush);
+        }
+        else if (auto patch = std::dynamic_pointer_cast<IPatchNode>(node); patch)
+        {
+            PatchDefExporter::exportPatch(stream, patch);
+        }
+
+        auto hash = std::hash<std::string>()(stream.str());
+        combineMembershipHashes(hash, node, setMemberships);
+
+        return hash;
+    }
+
+    std::size_t hashEntity(const scene::INodePtr& node, const Entity& entity,
+        const SelectionSetMemberships& setMemberships)
+    {
+        std::size_t hash = 0;
+
+        entity.forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            math::combineHash(hash, std::hash<std::string>()(key));
+            math::combineHash(hash, std::hash<std::string>()(value));
+        });
+
+        combineMembershipHashes(hash, node, setMemberships);
+
+        return hash;
+    }
+
+    // Entities are keyed by name. Unnamed entities are keyed by their contents instead of
+    // their position, such that adding or removing one doesn't change the key of the others.
+    // Changing an unnamed entity changes its key, it is recorded as removal and addition.
+    std::string getEntityKey(const Entity& entity, std::size_t keyValueHash,
+        const std::vector<std::size_t>& primitiveHashes)
+    {
+        if (entity.isWorldspawn()) return "worldspawn";
+
+        auto name = entity.getKeyValue("name");
+
+        if (!name.empty()) return name;
+
+        auto contentHash = keyValueHash;
+
+        for (auto hash : primitiveHashes)
+        {
+            math::combineHash(contentHash, hash);
+        }
+
+        return fmt::format("{0}@{1:x}", entity.getKeyValue("classname"), contentHash);
+    }
+
+    void exportEntity(scene::NodeVisitor& visitor, const scene::INodePtr& entity,
+        const std::vector<scene::INodePtr>& primitives)
+    {
+        visitor.pre(entity);
+
+        for (const auto& primitive : primitives)
+        {
+            visitor.pre(primitive);
+            visitor.post(primitive);
+        }
+
+        visitor.post(entity);
+    }
+
+    std::uintmax_t getFileSize(const fs::path& path)
+    {
+        std::error_code ec;
+        auto size = fs::file_size(path, ec);
+
+        return ec ? 0 : size;
+    }
+
+    // Group and set memberships of a loaded journal file, detached from its own root
+    class SelectionMembershipTransfer
+    {
+    private:
+        std::map<scene::INodePtr, IGroupSelectable::GroupIds> _memberships;
+        std::map<std::size_t, std::string> _names;
+        std::map<scene::INodePtr, std::vector<std::string>> _setMemberships;
+
+    public:
+        SelectionMembershipTransfer(const scene::IMapRootNodePtr& source)
+        {
+            source->foreachNode([&](const scene::INodePtr& node)
+            {
+                auto selectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
+
+                if (selectable && selectable->isGroupMember())
+                {
+                    _memberships.emplace(node, selectable->getGroupIds());
+                }
+
+                return true;
+            });
+
+            source->getSelectionGroupManager().foreachSelectionGroup([&](selection::ISelectionGroup& group)
+            {
+                _names.emplace(group.getId(), group.getName());
+            });
+
+            source->getSelectionSetManager().foreachSelectionSet([&](const selection::ISelectionSetPtr& set)
+            {
+                for (const auto& node : set->getNodes())
+                {
+                    _setMemberships[node].push_back(set->getName());
+                }
+            });
+
+            // The source root is going to be destroyed, don't let it take the memberships along
+            source->getSelectionGroupManager().deleteAllSelectionGroups();
+            source->getSelectionSetManager().deleteAllSelectionSets();
+        }
+
+        void applyTo(const scene::IMapRootNodePtr& target, const scene::INodePtr& node)
+        {
+            applyTo(target, node, node);
+        }
+
+        // Assigns the memberships of the loaded node to the target node
+        void applyTo(const scene::IMapRootNodePtr& target, const scene::INodePtr& loadedNode,
+            const scene::INodePtr& targetNode)
+        {
+            if (auto sets = _setMemberships.find(loadedNode); sets != _setMemberships.end())
+            {
+                for (const auto& name : sets->second)
+                {
+                    target->getSelectionSetManager().createSelectionSet(name)->addNode(targetNode);
+                }
+            }
+
+            auto memberships = _memberships.find(loadedNode);
+
+            if (memberships == _memberships.end()) return;
+
+            auto& groupManager = target->getSelectionGroupManager();
+
+            for (auto groupId : memberships->second)
+            {
+                auto group = groupManager.findOrCreateSelectionGroup(groupId);
+                group->addNode(targetNode);
+
+                auto name = _names.find(groupId);
+
+                if (name != _names.end())
+                {
+                    group->setName(name->second);
+                }
+            }
+        }
+    };
+
+    // Selection sets have no way to remove a single member, rebuild the ones containing the node
+    void removeFromSelectionSets(const scene::IMapRootNodePtr& root, const scene::INodePtr& node)
+    {
+        root->getSelectionSetManager().foreachSelectionSet([&](const selection::ISelectionSetPtr& set)
+        {
+            auto members = set->getNodes();
+
+            if (members.erase(node) == 0) return;
+
+            set->clear();
+
+            for (const auto& member : members)
+            {
+                set->addNode(member);
+            }
+        });
+    }
+
+    // Makes the target entity look like the source, except for the classname
+    void assignKeyValues(Entity& target, const Entity& source)
+    {
+        std::vector<std::string> keysToRemove;
+
+        target.forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            if (source.getKeyValue(key).empty())
+            {
+                keysToRemove.push_back(key);
+            }
+        });
+
+        for (const auto& key : keysToRemove)
+        {
+            target.setKeyValue(key, "");
+        }
+
+        source.forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            if (key != "classname")
+            {
+                target.setKeyValue(key, value);
+            }
+        });
+    }
+
+    void copyMissingLayers(scene::ILayerManager& source, scene::ILayerManager& target)
+    {
+        source.foreachLayer([&](int layerId, const std::string& layerName)
+        {
+            if (!target.layerExists(layerId))
+            {
+                target.createLayer(layerName, layerId);
+            }
+        });
+    }
+
+    scene::IMapRootNodePtr loadJournalFile(const fs::path& path, std::vector<IMapResourcePtr>& resources)
+    {
+        auto resource = GlobalMapResourceManager().createFromPath(path.string());
+
+        if (!resource->load())
+        {
+            throw IMapResource::OperationException(fmt::format(_("Failed to load {0}"), path.string()));
+        }
+
+        resources.push_back(resource);
+
+        // Match the state of the journal's bookkeeping, which happened during export
+        scene::removeOriginFromChildPrimitives(resource->getRootNode());
+
+        return resource->getRootNode();
+    }
+
+    struct JournalOperation
+    {
+        std::string type;
+        std::string key;
+        std::vector<std::size_t> removedPrimitives;
+    };
+
+    struct RecoveredEntity
+    {
+        scene::INodePtr node;
+        std::vector<scene::INodePtr> primitives;
+    };
+}
+
+AutosaveJournal::AutosaveJournal(const fs::path& folder, const std::string& mapExtension) :
+    _folder(folder),
+    _mapExtension(mapExtension),
+    _numEntries(0),
+    _needsBase(true),
+    _baseNumber(0),
+    _baseSize(0),
+    _entriesSize(0),
+    _pendingIsBase(false)
+{}
+
+const fs::path& AutosaveJournal::getFolder() const
+{
+    return _folder;
+}
+
+std::size_t AutosaveJournal::getNumEntries() const
+{
+    return _numEntries;
+}
+
+bool AutosaveJournal::compactionIsDue() const
+{
+    return _needsBase || _numEntries >= MaxEntries || _entriesSize > _baseSize;
+}
+
+std::unique_ptr<BackgroundMapSave> AutosaveJournal::createSave(const scene::IMapRootNodePtr& root,
+    const MapFormat& format, std::size_t changeCount)
+{
+    _pendingIsBase = compactionIsDue();
+    _pendingFilename = _pendingIsBase ?
+        fmt::format("base.{0}.{1}", _baseNumber + 1, _mapExtension) :
+        fmt::format("{0}.{1}", _numEntries + 1, _mapExtension);
+
+    std::ostringstream header;
+    header << (_pendingIsBase ? BASE : ENTRY) << " " << changeCount << " " << std::quoted(_pendingFilename) << std::endl;
+    _pendingRecord = header.str();
+
+    auto save = std::make_unique<BackgroundMapSave>(root, format, (_folder / _pendingFilename).string(),
+        [this](const scene::INodePtr& node, scene::NodeVisitor& visitor) { traverseChanges(node, visitor); });
+
+    save->setWrittenCallback([this]() { commit(); });
+
+    return save;
+}
+
+void AutosaveJournal::traverseChanges(const scene::INodePtr& root, scene::NodeVisitor& visitor)
+{
+    std::ostringstream record;
+    _pendingEntities.clear();
+
+    auto setMemberships = getSelectionSetMemberships(root);
+
+    for (const auto& entityNode : getEntities(root))
+    {
+        auto* entity = Node_getEntity(entityNode);
+
+        EntityState state;
+        state.keyValueHash = hashEntity(entityNode, *entity, setMemberships);
+
+        auto primitives = getPrimitives(entityNode);
+
+        std::vector<std::size_t> primitiveHashes;
+        primitiveHashes.reserve(primitives.size());
+
+        for (const auto& primitive : primitives)
+        {
+            primitiveHashes.push_back(hashPrimitive(primitive, setMemberships));
+        }
+
+        auto key = getEntityKey(*entity, state.keyValueHash, primitiveHashes);
+
+        // Only entities with identical contents end up with the same key,
+        // which of them gets which suffix doesn't make a difference
+        auto uniqueKey = key;
+
+        for (std::size_t n = 2; _pendingEntities.count(uniqueKey) > 0; ++n)
+        {
+            uniqueKey = fmt::format("{0}#{1}", key, n);
+        }
+
+        key = std::move(uniqueKey);
+
+        auto existing = _pendingIsBase ? _entities.end() : _entities.find(key);
+
+        if (existing == _entities.end())
+        {
+            record << ADD << " " << std::quoted(key) << std::endl;
+            exportEntity(visitor, entityNode, primitives);
+
+            state.primitiveHashes = std::move(primitiveHashes);
+            _pendingEntities.emplace(key, std::move(state));
+            continue;
+        }
+
+        // Primitives with a hash present in both states are kept, in their previous order
+        std::unordered_map<std::size_t, std::size_t> availableHashes;
+
+        for (auto hash : primitiveHashes)
+        {
+            ++availableHashes[hash];
+        }
+
+        std::vector<std::size_t> removedIndices;
+        const auto& previousHashes = existing->second.primitiveHashes;
+
+        for (std::size_t i = 0; i < previousHashes.size(); ++i)
+        {
+            auto available = availableHashes.find(previousHashes[i]);
+
+            if (available != availableHashes.end() && available->second > 0)
+            {
+                --available->second;
+                state.primitiveHashes.push_back(previousHashes[i]);
+            }
+            else
+            {
+                removedIndices.push_back(i);
+            }
+        }
+
+        // Whatever is left over is new, and is appended to the retained ones
+        std::vector<scene::INodePtr> addedPrimitives;
+
+        for (std::size_t i = 0; i < primitiveHashes.size(); ++i)
+        {
+            auto& available = availableHashes[primitiveHashes[i]];
+
+            if (available > 0)
+            {
+                --available;
+                addedPrimitives.push_back(primitives[i]);
+                state.primitiveHashes.push_back(primitiveHashes[i]);
+            }
+        }
+
+        if (!removedIndices.empty() || !addedPrimitives.empty() ||
+            state.keyValueHash != existing->second.keyValueHash)
+        {
+            record << UPDATE << " " << std::quoted(key) << " " << removedIndices.size();
+
+            for (auto index : removedIndices)
+            {
+                record << " " << index;
+            }
+
+            record << std::endl;
+
+            exportEntity(visitor, entityNode, addedPrimitives);
+        }
+
+        _pendingEntities.emplace(key, std::move(state));
+    }
+
+    if (!_pendingIsBase)
+    {
+        for (const auto& [key, state] : _entities)
+        {
+            if (_pendingEntities.count(key) == 0)
+            {
+                record << REMOVE << " " << std::quoted(key) << std::endl;
+            }
+        }
+    }
+
+    _pendingRecord += record.str();
+    _pendingRecord += END;
+    _pendingRecord += "\n";
+}
+
+void AutosaveJournal::commit()
+{
+    auto indexPath = _folder / INDEX_FILENAME;
+    auto mapFile = _folder / _pendingFilename;
+
+    auto fileSize = getFileSize(mapFile) +
+        getFileSize(os::replaceExtension(mapFile.string(), game::current::getInfoFileExtension()));
+
+    // A new base starts a new index, all previous entries are superseded
+    std::ofstream index(indexPath.string(), _pendingIsBase ? std::ios::trunc : std::ios::app);
+    index << _pendingRecord;
+    index.close();
+
+    if (index.fail())
+    {
+        throw IMapResource::OperationException(fmt::format(_("Failure writing to file {0}"), indexPath.string()));
+    }
+
+    if (_pendingIsBase)
+    {
+        // Remove the previous base and entries, including leftovers of earlier sessions
+        auto baseInfoFile = os::replaceExtension(_pendingFilename, game::current::getInfoFileExtension());
+
+        for (const auto& file : fs::directory_iterator(_folder))
+        {
+            auto filename = file.path().filename().string();
+
+            if (filename != INDEX_FILENAME && filename != _pendingFilename && filename != baseInfoFile)
+            {
+                std::error_code ec;
+                fs::remove(file.path(), ec);
+            }
+        }
+
+        ++_baseNumber;
+        _numEntries = 0;
+        _baseSize = fileSize;
+        _entriesSize = 0;
+        _needsBase = false;
+    }
+    else
+    {
+        ++_numEntries;
+        _entriesSize += fileSize;
+    }
+
+    _entities.swap(_pendingEntities);
+    _pendingEntities.clear();
+}
+
+void AutosaveJournal::Recover(const fs::path& folder, const std::string& targetFilename)
+{
+    auto indexPath = folder / INDEX_FILENAME;
+    std::ifstream index(indexPath.string());
+
+    if (!index)
+    {
+        throw IMapResource::OperationException(fmt::format(_("Could not open the autosave journal {0}"), indexPath.string()));
+    }
+
+    auto throwMalformed = [&]()
+    {
+        throw IMapResource::OperationException(fmt::format(_("The autosave journal {0} is damaged"), indexPath.string()));
+    };
+
+    // The loaded files need to stay alive until the end
+    std::vector<IMapResourcePtr> resources;
+
+    scene::IMapRootNodePtr root;
+    std::map<std::string, RecoveredEntity> entities;
+    std::size_t numEntries = 0;
+
+    std::string entryType;
+
+    while (index >> entryType)
+    {
+        if (entryType != BASE && entryType != ENTRY) throwMalformed();
+
+        std::size_t changeCount;
+        std::string filename;
+        index >> changeCount >> std::quoted(filename);
+
+        std::vector<JournalOperation> operations;
+        auto complete = false;
+        std::string keyword;
+
+        while (index >> keyword)
+        {
+            if (keyword == END)
+            {
+                complete = true;
+                break;
+            }
+
+            JournalOperation operation;
+            operation.type = keyword;
+            index >> std::quoted(operation.key);
+
+            if (keyword == UPDATE)
+            {
+                std::size_t numRemoved = 0;
+                index >> numRemoved;
+                operation.removedPrimitives.resize(numRemoved);
+
+                for (auto& primitiveIndex : operation.removedPrimitives)
+                {
+                    index >> primitiveIndex;
+                }
+            }
+            else if (keyword != ADD && keyword != REMOVE)
+            {
+                throwMalformed();
+            }
+
+            if (!index) break;
+
+            operations.push_back(std::move(operation));
+        }
+
+        if (!complete)
+        {
+            // The application went down while the last entry was being written
+            rWarning() << "Ignoring the incomplete last entry of the autosave journal " << indexPath << std::endl;
+            break;
+        }
+
+        if (entryType == ENTRY && !root) throwMalformed();
+
+        auto file = loadJournalFile(folder / filename, resources);
+
+        if (entryType == BASE)
+        {
+            root = file;
+            entities.clear();
+            numEntries = 0;
+        }
+        else
+        {
+            copyMissingLayers(file->getLayerManager(), root->getLayerManager());
+
+            file->foreachProperty([&](const std::string& key, const std::string& value)
+            {
+                root->setProperty(key, value);
+            });
+
+            ++numEntries;
+        }
+
+        std::unique_ptr<SelectionMembershipTransfer> memberships;
+
+        if (file != root)
+        {
+            memberships = std::make_unique<SelectionMembershipTransfer>(file);
+        }
+
+        // The entities in the file appear in the order of the add/update operations
+        auto fileEntities = getEntities(file);
+        std::size_t fileEntityIndex = 0;
+
+        for (const auto& operation : operations)
+        {
+            if (operation.type == REMOVE)
+            {
+                auto existing = entities.find(operation.key);
+
+                if (existing != entities.end())
+                {
+                    scene::removeNodeFromParent(existing->second.node);
+                    entities.erase(existing);
+                }
+
+                continue;
+            }
+
+            if (fileEntityIndex >= fileEntities.size()) throwMalformed();
+
+            auto fileEntity = fileEntities[fileEntityIndex++];
+            auto filePrimitives = getPrimitives(fileEntity);
+
+            if (operation.type == ADD)
+            {
+                if (file != root)
+                {
+                    scene::removeNodeFromParent(fileEntity);
+                    root->addChildNode(fileEntity);
+
+                    memberships->applyTo(root, fileEntity);
+
+                    for (const auto& primitive : filePrimitives)
+                    {
+                        memberships->applyTo(root, primitive);
+                    }
+                }
+
+                entities[operation.key] = RecoveredEntity{ fileEntity, filePrimitives };
+                continue;
+            }
+
+            // Update: drop the removed primitives and append the new ones
+            auto existing = entities.find(operation.key);
+
+            if (!memberships || existing == entities.end()) throwMalformed();
+
+            auto& recovered = existing->second;
+            std::set<std::size_t> removedIndices(operation.removedPrimitives.begin(), operation.removedPrimitives.end());
+            std::vector<scene::INodePtr> retainedPrimitives;
+
+            for (std::size_t i = 0; i < recovered.primitives.size(); ++i)
+            {
+                if (removedIndices.count(i) > 0)
+                {
+                    scene::removeNodeFromParent(recovered.primitives[i]);
+                }
+                else
+                {
+                    retainedPrimitives.push_back(recovered.primitives[i]);
+                }
+            }
+
+            auto& existingEntity = *Node_getEntity(recovered.node);
+            const auto& fileEntityData = *Node_getEntity(fileEntity);
+
+            if (existingEntity.getKeyValue("classname") != fileEntityData.getKeyValue("classname"))
+            {
+                // The entity needs to be replaced, take the retained primitives along
+                for (const auto& primitive : retainedPrimitives)
+                {
+                    scene::removeNodeFromParent(primitive);
+                    fileEntity->addChildNode(primitive);
+                }
+
+                scene::removeNodeFromParent(recovered.node);
+                scene::removeNodeFromParent(fileEntity);
+                root->addChildNode(fileEntity);
+                memberships->applyTo(root, fileEntity);
+
+                recovered.node = fileEntity;
+            }
+            else
+            {
+                // Keep the node, such that worldspawn stays in front
+                assignKeyValues(existingEntity, fileEntityData);
+                recovered.node->assignToLayers(fileEntity->getLayers());
+
+                if (auto selectable = std::dynamic_pointer_cast<IGroupSelectable>(recovered.node); selectable)
+                {
+                    auto previousGroupIds = selectable->getGroupIds();
+
+                    for (auto groupId : previousGroupIds)
+                    {
+                        auto group = root->getSelectionGroupManager().getSelectionGroup(groupId);
+
+                        if (group)
+                        {
+                            group->removeNode(recovered.node);
+                        }
+                    }
+                }
+
+                removeFromSelectionSets(root, recovered.node);
+
+                memberships->applyTo(root, fileEntity, recovered.node);
+            }
+
+            for (const auto& primitive : filePrimitives)
+            {
+                scene::removeNodeFromParent(primitive);
+                recovered.node->addChildNode(primitive);
+                memberships->applyTo(root, primitive);
+            }
+
+            retainedPrimitives.insert(retainedPrimitives.end(), filePrimitives.begin(), filePrimitives.end());
+            recovered.primitives = std::move(retainedPrimitives);
+        }
+    }
+
+    if (!root)
+    {
+        throw IMapResource::OperationException(fmt::format(_("The autosave journal {0} is empty"), indexPath.string()));
+    }
+
+    scene::addOriginToChildPrimitives(root);
+
+    auto format = GlobalMapFormatManager().getMapFormatForFilename(targetFilename);
+
+    if (!format)
+    {
+        throw IMapResource::OperationException(fmt::format(_("Unknown map format: {0}"), targetFilename));
+    }
+
+    rMessage() << "Recovered the autosave journal " << folder << " with " << numEntries <<
+        " entries on top of the base snapshot" << std::endl;
+
+    MapResource::saveFile(*format, root, scene::traverse, targetFilename);
+}
+
+}
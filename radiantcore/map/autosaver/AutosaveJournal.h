@@ -0,0 +1,109 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "imap.h"
+#include "imapformat.h"
+#include "os/fs.h"
+
+#include "BackgroundMapSave.h"
+
+namespace map
+{
+
+/**
+ * Append-only change journal used by the auto saver in place of numbered
+ * snapshots. The journal folder holds a full base snapshot, a number of
+ * partial map files and an index file (journal.txt) listing the entries.
+ *
+ * Every entry exports only the entities whose spawnargs or primitives changed
+ * since the previous entry, and of those entities only the new primitives.
+ * The index records which primitives and entities have been removed.
+ * Primitives are compared by a hash of their contents, entities are keyed by name
+ * (unnamed entities by a hash of their spawnargs and primitives).
+ *
+ * The differences are not taken from the undo system's change tracking: every
+ * save takes a full copy of the scene like a regular snapshot, and serialises
+ * and hashes all of its primitives on the worker thread to find what changed.
+ * What the journal saves is disk space and write time, not the traversal.
+ * The change count is recorded in the index for information only, recovery
+ * doesn't use it.
+ *
+ * Once too many entries piled up (or the entries outweigh the base) the next
+ * save writes a new base snapshot and truncates the journal.
+ *
+ * The journal is not thread-safe, but the traversal and the write callback of
+ * the saves it creates run on the worker thread of that save. Don't create a
+ * new save before the previous one is finished.
+ */
+class AutosaveJournal
+{
+public:
+    // Number of entries after which the journal is compacted into a new base
+    static constexpr std::size_t MaxEntries = 25;
+
+private:
+    struct EntityState
+    {
+        std::size_t keyValueHash = 0;
+
+        // Hashes of the exported primitives, in the order they're recovered
+        std::vector<std::size_t> primitiveHashes;
+    };
+    using EntityStates = std::map<std::string, EntityState>;
+
+    fs::path _folder;
+    std::string _mapExtension;
+
+    // The state represented by the base snapshot and the entries written so far
+    EntityStates _entities;
+    std::size_t _numEntries;
+    bool _needsBase;
+
+    // Incremented with every base snapshot, such that the previous base is never overwritten
+    std::size_t _baseNumber;
+
+    // Accumulated file sizes, used to decide about compaction
+    std::uintmax_t _baseSize;
+    std::uintmax_t _entriesSize;
+
+    // Collected by the traversal of the running save, committed after it has been written
+    bool _pendingIsBase;
+    std::string _pendingFilename;
+    std::string _pendingRecord;
+    EntityStates _pendingEntities;
+
+public:
+    // The map extension determines the file names of the base snapshot and the entries
+    AutosaveJournal(const fs::path& folder, const std::string& mapExtension);
+
+    const fs::path& getFolder() const;
+
+    // Number of entries written after the current base snapshot
+    std::size_t getNumEntries() const;
+
+    // Prepares the next save of the given map, which is either a new entry or a
+    // base snapshot. The returned object needs to be started by the caller.
+    // Throws IMapResource::OperationException if the files can't be written.
+    std::unique_ptr<BackgroundMapSave> createSave(const scene::IMapRootNodePtr& root,
+        const MapFormat& format, std::size_t changeCount);
+
+    // Replays the journal in the given folder and writes the resulting map
+    // to the target file. Throws IMapResource::OperationException on failure.
+    static void Recover(const fs::path& folder, const std::string& targetFilename);
+
+private:
+    bool compactionIsDue() const;
+
+    // Visits the changed entities and primitives of the given root, recording
+    // the differences to the committed state in the pending members
+    void traverseChanges(const scene::INodePtr& root, scene::NodeVisitor& visitor);
+
+    // Appends the pending record to the index file and adopts the pending state
+    void commit();
+};
+
+}
@@ -0,0 +1,174 @@
+#include "BackgroundMapSave.h"
+
+#include <chrono>
+#include "i18n.h"
+#include "itextstream.h"
+#include "imapresource.h"
+#include "iradiant.h"
+
+#include "os/file.h"
+#include "os/path.h"
+#include "gamelib.h"
+#include "scene/Traverse.h"
+#include "messages/AutomaticMapSaveFinished.h"
+#include "map/algorithm/MapExporter.h"
+#include "map/algorithm/Snapshot.h"
+
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace
+{
+    void openOutputStream(std::ofstream& stream, const fs::path& path)
+    {
+        if (os::fileOrDirExists(path.string()) && !os::fileIsWritable(path))
+        {
+            throw IMapResource::OperationException(fmt::format(_("File is write-protected: {0}"), path.string()));
+        }
+
+        stream.open(path.string());
+
+        if (!stream.is_open())
+        {
+            throw IMapResource::OperationException(fmt::format(_("Could not open file for writing: {0}"), path.string()));
+        }
+    }
+
+    long long toMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+    }
+}
+
+BackgroundMapSave::BackgroundMapSave(const scene::IMapRootNodePtr& root, const MapFormat& format, const std::string& filename) :
+    BackgroundMapSave(root, format, filename, scene::traverse)
+{}
+
+BackgroundMapSave::BackgroundMapSave(const scene::IMapRootNodePtr& root, const MapFormat& format, const std::string& filename,
+    const GraphTraversalFunc& traverse) :
+    _filename(filename),
+    _traverse(traverse),
+    _finished(false)
+{
+    auto startTime = std::chrono::steady_clock::now();
+
+    fs::path auxFile = filename;
+    auxFile.replace_extension(game::current::getInfoFileExtension());
+
+    openOutputStream(_mapStream, filename);
+
+    if (format.allowInfoFileCreation())
+    {
+        _auxStream = std::make_unique<std::ofstream>();
+        openOutputStream(*_auxStream, auxFile);
+    }
+
+    _snapshot = algorithm::createSnapshot(root);
+    _writer = format.getMapWriter();
+
+    // The exporter prepares the snapshot right away, which involves subscribers
+    // that are only safe to call on the main thread (e.g. the camera position)
+    if (_auxStream)
+    {
+        _exporter = std::make_unique<MapExporter>(*_writer, _snapshot, _mapStream, *_auxStream);
+    }
+    else
+    {
+        _exporter = std::make_unique<MapExporter>(*_writer, _snapshot, _mapStream);
+    }
+
+    // No progress dialog for background saves
+    _exporter->disableProgressMessages();
+
+    rMessage() << "Autosave: scene snapshot taken in " <<
+        toMilliseconds(std::chrono::steady_clock::now() - startTime) << " ms" << std::endl;
+}
+
+BackgroundMapSave::~BackgroundMapSave()
+{
+    wait();
+}
+
+void BackgroundMapSave::setWrittenCallback(const std::function<void()>& callback)
+{
+    _onWritten = callback;
+}
+
+void BackgroundMapSave::start()
+{
+    _thread = std::thread(&BackgroundMapSave::run, this);
+}
+
+bool BackgroundMapSave::isFinished() const
+{
+    return _finished;
+}
+
+void BackgroundMapSave::wait()
+{
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    // Restore the snapshot scene on the calling thread
+    _exporter.reset();
+}
+
+void BackgroundMapSave::run()
+{
+    auto startTime = std::chrono::steady_clock::now();
+    std::string errorMessage;
+
+    try
+    {
+        _exporter->exportMap(_snapshot, _traverse);
+
+        // The exporter itself is destroyed on the main thread, since restoring
+        // the snapshot after export notifies the resource subscribers
+        _exporter->finishInfoFile();
+
+        _mapStream.close();
+
+        if (_mapStream.fail())
+        {
+            throw IMapResource::OperationException(fmt::format(_("Failure writing to file {0}"), _filename));
+        }
+
+        if (_auxStream)
+        {
+            _auxStream->close();
+
+            if (_auxStream->fail())
+            {
+                auto auxFile = os::replaceExtension(_filename, game::current::getInfoFileExtension());
+                throw IMapResource::OperationException(fmt::format(_("Failure writing to file {0}"), auxFile));
+            }
+        }
+
+        if (_onWritten)
+        {
+            _onWritten();
+        }
+
+        rMessage() << "Autosave: " << _filename << " written in " <<
+            toMilliseconds(std::chrono::steady_clock::now() - startTime) << " ms" << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        _exporter->finishInfoFile();
+
+        errorMessage = ex.what();
+        rError() << "Autosave: failed to write " << _filename << ": " << errorMessage << std::endl;
+    }
+
+    _finished = true;
+
+    GlobalRadiantCore().getMessageBus().postMessage(
+        std::make_unique<AutomaticMapSaveFinished>(_filename, errorMessage)
+    );
+}
+
+}
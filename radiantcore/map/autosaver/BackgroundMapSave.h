@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "imap.h"
+#include "imapformat.h"
+
+namespace map
+{
+
+class MapExporter;
+
+/**
+ * A single automatic save running on a worker thread. The constructor copies
+ * the scene into a detached snapshot on the calling (main) thread, all the
+ * serialisation and disk access happens on the worker thread afterwards.
+ *
+ * Once the file has been written an AutomaticMapSaveFinished message is posted
+ * to the message bus. The object must be waited for or destroyed on the main
+ * thread, this is where the exporter cleans up the snapshot afterwards.
+ */
+class BackgroundMapSave
+{
+private:
+    std::string _filename;
+
+    scene::IMapRootNodePtr _snapshot;
+
+    std::ofstream _mapStream;
+    std::unique_ptr<std::ofstream> _auxStream;
+
+    IMapWriterPtr _writer;
+    std::unique_ptr<MapExporter> _exporter;
+
+    GraphTraversalFunc _traverse;
+    std::function<void()> _onWritten;
+
+    std::thread _thread;
+    std::atomic<bool> _finished;
+
+public:
+    // Takes the snapshot of the given map and opens the output files,
+    // throws IMapResource::OperationException if the files cannot be written.
+    // The traversal function decides which nodes of the snapshot are exported,
+    // it is invoked on the worker thread.
+    BackgroundMapSave(const scene::IMapRootNodePtr& root, const MapFormat& format, const std::string& filename,
+        const GraphTraversalFunc& traverse);
+
+    BackgroundMapSave(const scene::IMapRootNodePtr& root, const MapFormat& format, const std::string& filename);
+
+    BackgroundMapSave(const BackgroundMapSave& other) = delete;
+    BackgroundMapSave& operator=(const BackgroundMapSave& other) = delete;
+
+    // Waits for the worker thread to finish
+    ~BackgroundMapSave();
+
+    // Sets a function to invoke on the worker thread after the files have been
+    // written successfully, before the finished message is posted
+    void setWrittenCallback(const std::function<void()>& callback);
+
+    // Starts writing the snapshot on the worker thread
+    void start();
+
+    // True once the worker thread is done writing, regardless of success
+    bool isFinished() const;
+
+    // Blocks until the worker thread is done, then releases the exporter.
+    // Must be called on the main thread.
+    void wait();
+
+private:
+    void run();
+};
+
+}
@@ -4,12 +4,31 @@
 #include "itextstream.h"
 #include "InfoFile.h"
 
+#include <mutex>
+#include <condition_variable>
+
 namespace map
 {
 
+namespace
+{
+    // The info file modules collect their data in member buffers, so only one
+    // export can run at a time. Exports started on the main thread might be
+    // finished on a worker thread (background autosave), a plain mutex won't do.
+    std::mutex _exportGateLock;
+    std::condition_variable _exportGateReleased;
+    bool _exportInProgress = false;
+}
+
 InfoFileExporter::InfoFileExporter(std::ostream& stream) :
     _stream(stream)
 {
+    {
+        std::unique_lock<std::mutex> lock(_exportGateLock);
+        _exportGateReleased.wait(lock, [] { return !_exportInProgress; });
+        _exportInProgress = true;
+    }
+
 	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
 	{
 		module.onInfoFileSaveStart();
@@ -39,6 +58,13 @@ InfoFileExporter::~InfoFileExporter()
 	{
 		module.onInfoFileSaveFinished();
 	});
+
+    {
+        std::lock_guard<std::mutex> lock(_exportGateLock);
+        _exportInProgress = false;
+    }
+
+    _exportGateReleased.notify_one();
 }
 
 void InfoFileExporter::beginSaveMap(const scene::IMapRootNodePtr& root)
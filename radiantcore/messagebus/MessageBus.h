@@ -1,8 +1,13 @@
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "imessagebus.h"
 #include "itextstream.h"
+#include "util/MpscQueue.h"
 
 namespace radiant
 {
@@ -11,31 +16,99 @@ class MessageBus :
 	public IMessageBus
 {
 private:
-    // Listener and its registration handle
-    using Channel = std::map<std::size_t, Listener>;
-    
-    // Maps message types to a set of listeners
-    std::map<std::size_t, Channel> _channels;
+    struct Subscription
+    {
+        std::size_t id;
+        Listener listener;
+
+        // Listeners removed during dispatch are only flagged,
+        // the vector is compacted once the dispatch is done
+        bool removed;
+    };
+
+    struct Channel
+    {
+        std::size_t messageType;
+
+        // Sorted by ID, which is the order of registration
+        std::vector<Subscription> subscriptions;
+
+        // Listeners added during dispatch, appended once it's done
+        std::vector<Subscription> pendingSubscriptions;
+
+        std::atomic<std::size_t> dispatchDepth{ 0 };
+        bool needsCompaction = false;
+
+        // Messages can be sent from any thread, the statistics are guarded
+        mutable std::mutex statisticsLock;
+        std::size_t numDispatches = 0;
+        std::chrono::nanoseconds totalDispatchTime{ 0 };
+        std::chrono::nanoseconds maxDispatchTime{ 0 };
+    };
+
+    // Marks the channel as dispatching during its lifetime, such that
+    // the channel is finished even if a listener throws
+    class DispatchScope
+    {
+    private:
+        MessageBus& _owner;
+        Channel& _channel;
+
+    public:
+        DispatchScope(MessageBus& owner, Channel& channel) :
+            _owner(owner),
+            _channel(channel)
+        {
+            ++_channel.dispatchDepth;
+        }
+
+        DispatchScope(const DispatchScope& other) = delete;
+        DispatchScope& operator=(const DispatchScope& other) = delete;
+
+        ~DispatchScope()
+        {
+            if (--_channel.dispatchDepth == 0)
+            {
+                _owner.finishDispatch(_channel);
+            }
+        }
+    };
+
+    // Sorted by message type. The channels are heap-allocated to
+    // keep them in place while adding channels during dispatch.
+    std::vector<std::unique_ptr<Channel>> _channels;
 
-    bool _processingMessage;
     std::size_t _nextId;
 
+    // Messages posted from any thread, delivered on the main thread
+    util::MpscQueue<std::unique_ptr<IMessage>> _postedMessages;
+
+    // Set when the notifier has been invoked and the queue is waiting to be processed
+    std::atomic<bool> _processingRequested;
+
+    std::mutex _notifierLock;
+    std::function<void()> _postedMessageNotifier;
+
 public:
-    MessageBus() : 
-        _nextId(1)
+    MessageBus() :
+        _nextId(1),
+        _processingRequested(false)
     {}
 
     std::size_t addListener(std::size_t messageType, const Listener& listener) override
     {
-        auto channel = _channels.find(messageType);
+        auto& channel = findOrInsertChannel(messageType);
+
+        auto subscriberId = _nextId++;
 
-        if (channel == _channels.end())
+        if (channel.dispatchDepth > 0)
         {
-            channel = _channels.emplace(messageType, Channel()).first;
+            channel.pendingSubscriptions.push_back(Subscription{ subscriberId, listener, false });
+        }
+        else
+        {
+            channel.subscriptions.push_back(Subscription{ subscriberId, listener, false });
         }
-
-        auto subscriberId = _nextId++;
-        channel->second.emplace(subscriberId, listener);
 
         return subscriberId;
     }
@@ -44,11 +117,8 @@ public:
     {
         for (auto& channel : _channels)
         {
-            auto l = channel.second.find(listenerId);
-
-            if (l != channel.second.end())
+            if (removeFromChannel(*channel, listenerId))
             {
-                channel.second.erase(l);
                 return;
             }
         }
@@ -58,18 +128,189 @@ public:
 
     void sendMessage(IMessage& message) override
     {
-        auto channel = _channels.find(message.getId());
+        auto channel = findChannel(message.getId());
 
-        if (channel == _channels.end())
+        if (channel == nullptr || channel->subscriptions.empty())
         {
             // No listeners for this message
             return;
         }
 
-        for (auto it = channel->second.begin();
-             it != channel->second.end(); /* in-loop */)
+        auto startTime = std::chrono::steady_clock::now();
+
+        {
+            DispatchScope scope(*this, *channel);
+
+            // The vector doesn't change size during dispatch, new listeners are kept aside
+            for (std::size_t i = 0; i < channel->subscriptions.size(); ++i)
+            {
+                if (!channel->subscriptions[i].removed)
+                {
+                    channel->subscriptions[i].listener(message);
+                }
+            }
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime);
+
+        std::lock_guard<std::mutex> lock(channel->statisticsLock);
+
+        ++channel->numDispatches;
+        channel->totalDispatchTime += duration;
+        channel->maxDispatchTime = std::max(channel->maxDispatchTime, duration);
+    }
+
+    void postMessage(std::unique_ptr<IMessage> message) override
+    {
+        _postedMessages.push(std::move(message));
+
+        // Only the first message after the last processing needs to wake up the main thread
+        requestProcessing();
+    }
+
+    std::size_t processPostedMessages() override
+    {
+        // Reset the flag first, messages posted from now on will request another run
+        _processingRequested = false;
+
+        std::size_t numProcessed = 0;
+        std::unique_ptr<IMessage> message;
+
+        while (_postedMessages.tryPop(message))
+        {
+            sendMessage(*message);
+            ++numProcessed;
+        }
+
+        // A message whose push was still in progress may have found the flag
+        // set before it got cleared, so nobody would request another run for it
+        if (!_postedMessages.empty())
+        {
+            requestProcessing();
+        }
+
+        return numProcessed;
+    }
+
+    void setPostedMessageNotifier(const std::function<void()>& notifier) override
+    {
+        std::lock_guard<std::mutex> lock(_notifierLock);
+        _postedMessageNotifier = notifier;
+    }
+
+    std::vector<ChannelStatistics> getChannelStatistics() const override
+    {
+        std::vector<ChannelStatistics> result;
+        result.reserve(_channels.size());
+
+        for (const auto& channel : _channels)
+        {
+            auto numListeners = std::count_if(channel->subscriptions.begin(), channel->subscriptions.end(),
+                [](const Subscription& s) { return !s.removed; }) + channel->pendingSubscriptions.size();
+
+            std::lock_guard<std::mutex> lock(channel->statisticsLock);
+
+            result.push_back(ChannelStatistics
+            {
+                channel->messageType,
+                static_cast<std::size_t>(numListeners),
+                channel->numDispatches,
+                channel->totalDispatchTime,
+                channel->maxDispatchTime
+            });
+        }
+
+        return result;
+    }
+
+private:
+    Channel* findChannel(std::size_t messageType)
+    {
+        auto found = std::lower_bound(_channels.begin(), _channels.end(), messageType,
+            [](const std::unique_ptr<Channel>& channel, std::size_t type) { return channel->messageType < type; });
+
+        return found != _channels.end() && (*found)->messageType == messageType ? found->get() : nullptr;
+    }
+
+    Channel& findOrInsertChannel(std::size_t messageType)
+    {
+        auto found = std::lower_bound(_channels.begin(), _channels.end(), messageType,
+            [](const std::unique_ptr<Channel>& channel, std::size_t type) { return channel->messageType < type; });
+
+        if (found == _channels.end() || (*found)->messageType != messageType)
+        {
+            found = _channels.insert(found, std::make_unique<Channel>());
+            (*found)->messageType = messageType;
+        }
+
+        return **found;
+    }
+
+    bool removeFromChannel(Channel& channel, std::size_t listenerId)
+    {
+        auto found = std::lower_bound(channel.subscriptions.begin(), channel.subscriptions.end(), listenerId,
+            [](const Subscription& s, std::size_t id) { return s.id < id; });
+
+        if (found != channel.subscriptions.end() && found->id == listenerId && !found->removed)
+        {
+            if (channel.dispatchDepth > 0)
+            {
+                // Don't destroy the listener while it might be executing
+                found->removed = true;
+                channel.needsCompaction = true;
+            }
+            else
+            {
+                channel.subscriptions.erase(found);
+            }
+
+            return true;
+        }
+
+        auto pending = std::find_if(channel.pendingSubscriptions.begin(), channel.pendingSubscriptions.end(),
+            [&](const Subscription& s) { return s.id == listenerId; });
+
+        if (pending != channel.pendingSubscriptions.end())
+        {
+            channel.pendingSubscriptions.erase(pending);
+            return true;
+        }
+
+        return false;
+    }
+
+    void finishDispatch(Channel& channel)
+    {
+        if (channel.needsCompaction)
+        {
+            channel.needsCompaction = false;
+            channel.subscriptions.erase(std::remove_if(channel.subscriptions.begin(), channel.subscriptions.end(),
+                [](const Subscription& s) { return s.removed; }), channel.subscriptions.end());
+        }
+
+        if (!channel.pendingSubscriptions.empty())
+        {
+            // IDs are increasing, so the order is preserved by appending
+            std::move(channel.pendingSubscriptions.begin(), channel.pendingSubscriptions.end(),
+                std::back_inserter(channel.subscriptions));
+            channel.pendingSubscriptions.clear();
+        }
+    }
+
+    // Sets the processing flag and wakes up the main thread, unless the flag was already set
+    void requestProcessing()
+    {
+        if (_processingRequested.exchange(true)) return;
+
+        std::function<void()> notifier;
+        {
+            std::lock_guard<std::mutex> lock(_notifierLock);
+            notifier = _postedMessageNotifier;
+        }
+
+        if (notifier)
         {
-            (*it++).second(message);
+            notifier();
         }
     }
 };
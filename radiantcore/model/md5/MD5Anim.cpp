@@ -1,17 +1,49 @@
 #include "MD5Anim.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "itextstream.h"
-#include "string/convert.h"
 
 namespace md5
 {
 
 MD5Anim::MD5Anim() :
 	_frameRate(0),
-	_numAnimatedComponents(0)
+	_numAnimatedComponents(0),
+	_numFrames(0)
 {}
 
-void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
+void MD5Anim::getFrameKeys(std::size_t index, FrameKeys& keys) const
+{
+	keys.resize(_numAnimatedComponents);
+
+	const auto* quantised = _frameKeys.data() + index * _numAnimatedComponents;
+
+	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
+	{
+		keys[i] = _componentMinimum[i] + quantised[i] * _componentScale[i];
+	}
+}
+
+std::size_t MD5Anim::getMemoryUsage() const
+{
+	auto size = sizeof(MD5Anim) + _commandLine.capacity();
+
+	for (const auto& joint : _joints)
+	{
+		size += sizeof(Joint) + joint.name.capacity() + joint.children.capacity() * sizeof(int);
+	}
+
+	size += _bounds.capacity() * sizeof(AABB);
+	size += _baseFrame.capacity() * sizeof(Key);
+	size += _frameKeys.capacity() * sizeof(std::uint16_t);
+	size += (_componentMinimum.capacity() + _componentScale.capacity()) * sizeof(float);
+
+	return size;
+}
+
+void MD5Anim::parseJointHierarchy(parser::BufferTokeniser& tok)
 {
 	tok.assertNextToken("hierarchy");
 	tok.assertNextToken("{");
@@ -24,11 +56,11 @@ void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
 		// Syntax: "<jointName>"	<parentId> <animComponentMask> <firstKey>
 		_joints[i].name = tok.nextToken();
 
-		int parentId = string::convert<int>(tok.nextToken());
+		int parentId = tok.nextNumber<int>();
 		_joints[i].parentId = parentId;	
 
-		_joints[i].animComponents = string::convert<std::size_t>(tok.nextToken());
-		_joints[i].firstKey = string::convert<std::size_t>(tok.nextToken());
+		_joints[i].animComponents = tok.nextNumber<std::size_t>();
+		_joints[i].firstKey = tok.nextNumber<std::size_t>();
 
 		// Some sanity checks
 		assert(_joints[i].parentId == -1 || (_joints[i].parentId >= 0 && _joints[i].parentId < static_cast<int>(_joints.size())));
@@ -45,26 +77,26 @@ void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseFrameBounds(parser::DefTokeniser& tok)
+void MD5Anim::parseFrameBounds(parser::BufferTokeniser& tok)
 {
 	tok.assertNextToken("bounds");
 	tok.assertNextToken("{");
 		
-	for (std::size_t i = 0; i < _frames.size(); ++i)
+	for (std::size_t i = 0; i < _numFrames; ++i)
 	{
 		tok.assertNextToken("(");
 
-		_bounds[i].origin.x() = string::convert<float>(tok.nextToken());
-		_bounds[i].origin.y() = string::convert<float>(tok.nextToken());
-		_bounds[i].origin.z() = string::convert<float>(tok.nextToken());
+		_bounds[i].origin.x() = tok.nextNumber<float>();
+		_bounds[i].origin.y() = tok.nextNumber<float>();
+		_bounds[i].origin.z() = tok.nextNumber<float>();
 
 		tok.assertNextToken(")");
 
 		tok.assertNextToken("(");
 
-		_bounds[i].extents.x() = string::convert<float>(tok.nextToken());
-		_bounds[i].extents.y() = string::convert<float>(tok.nextToken());
-		_bounds[i].extents.z() = string::convert<float>(tok.nextToken());
+		_bounds[i].extents.x() = tok.nextNumber<float>();
+		_bounds[i].extents.y() = tok.nextNumber<float>();
+		_bounds[i].extents.z() = tok.nextNumber<float>();
 
 		tok.assertNextToken(")");
 	}
@@ -72,7 +104,7 @@ void MD5Anim::parseFrameBounds(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
+void MD5Anim::parseBaseFrame(parser::BufferTokeniser& tok)
 {
 	tok.assertNextToken("baseframe");
 	tok.assertNextToken("{");
@@ -81,18 +113,18 @@ void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
 	{
 		tok.assertNextToken("(");
 		
-		_baseFrame[i].origin.x() = string::convert<float>(tok.nextToken());
-		_baseFrame[i].origin.y() = string::convert<float>(tok.nextToken());
-		_baseFrame[i].origin.z() = string::convert<float>(tok.nextToken());
+		_baseFrame[i].origin.x() = tok.nextNumber<float>();
+		_baseFrame[i].origin.y() = tok.nextNumber<float>();
+		_baseFrame[i].origin.z() = tok.nextNumber<float>();
 
 		tok.assertNextToken(")");
 
 		tok.assertNextToken("(");
 
 		Vector3 rawRotation;
-		rawRotation.x() = string::convert<float>(tok.nextToken());
-		rawRotation.y() = string::convert<float>(tok.nextToken());
-		rawRotation.z() = string::convert<float>(tok.nextToken());
+		rawRotation.x() = tok.nextNumber<float>();
+		rawRotation.y() = tok.nextNumber<float>();
+		rawRotation.z() = tok.nextNumber<float>();
 
 		// Calculate the fourth component of the quaternion
 		auto lSq = rawRotation.getLengthSquared();
@@ -111,41 +143,94 @@ void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
+void MD5Anim::parseFrame(std::size_t frame, parser::BufferTokeniser& tok, std::vector<float>& values)
 {
 	tok.assertNextToken("frame");
 
-	std::size_t parsedFrameNum = string::convert<std::size_t>(tok.nextToken());
+	std::size_t parsedFrameNum = tok.nextNumber<std::size_t>();
+
+	if (parsedFrameNum >= _numFrames)
+	{
+		throw parser::ParseException("Frame number " + std::to_string(parsedFrameNum) + " out of range");
+	}
 
 	assert(frame == parsedFrameNum);
 
 	tok.assertNextToken("{");
 
-	// Reserve space for the floats
-	_frames[parsedFrameNum].resize(_numAnimatedComponents);
-
 	// Each frame block has <numAnimatedComponents> float values
+	auto* frameValues = values.data() + parsedFrameNum * _numAnimatedComponents;
+
 	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
 	{
-		_frames[parsedFrameNum][i] = string::convert<float>(tok.nextToken());
+		frameValues[i] = tok.nextNumber<float>();
 	}
 
 	tok.assertNextToken("}");
 }
 
+void MD5Anim::quantiseFrameKeys(const std::vector<float>& values)
+{
+	constexpr auto MaxQuantisedValue = std::numeric_limits<std::uint16_t>::max();
+
+	_componentMinimum.assign(_numAnimatedComponents, 0);
+	_componentScale.assign(_numAnimatedComponents, 0);
+	_frameKeys.assign(values.size(), 0);
+
+	if (_numFrames == 0)
+	{
+		return;
+	}
+
+	for (std::size_t component = 0; component < _numAnimatedComponents; ++component)
+	{
+		auto minimum = std::numeric_limits<float>::max();
+		auto maximum = std::numeric_limits<float>::lowest();
+
+		for (std::size_t frame = 0; frame < _numFrames; ++frame)
+		{
+			auto value = values[frame * _numAnimatedComponents + component];
+			minimum = std::min(minimum, value);
+			maximum = std::max(maximum, value);
+		}
+
+		// Components which don't change stay at their exact minimum value
+		auto scale = (maximum - minimum) / MaxQuantisedValue;
+
+		_componentMinimum[component] = minimum;
+		_componentScale[component] = scale;
+
+		if (scale <= 0)
+		{
+			continue;
+		}
+
+		for (std::size_t frame = 0; frame < _numFrames; ++frame)
+		{
+			auto index = frame * _numAnimatedComponents + component;
+			auto quantised = std::lround((values[index] - minimum) / scale);
+
+			_frameKeys[index] = static_cast<std::uint16_t>(std::clamp<long>(quantised, 0, MaxQuantisedValue));
+		}
+	}
+}
+
 void MD5Anim::parseFromStream(std::istream& stream)
 {
-	parser::BasicDefTokeniser<std::istream> tokeniser(stream);
+	parser::BufferTokeniser tokeniser(stream);
 	parseFromTokens(tokeniser);
 }
 
-void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
+void MD5Anim::parseFromTokens(parser::BufferTokeniser& tok)
 {
+	// The frame values as parsed, before being quantised
+	std::vector<float> values;
+
 	try
 	{
 		tok.assertNextToken("MD5Version");
 
-		int version = string::convert<int>(tok.nextToken());
+		int version = tok.nextNumber<int>();
 
 		if (version != 10)
 		{
@@ -157,22 +242,23 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		_commandLine = tok.nextToken();
 
 		tok.assertNextToken("numFrames");
-		int numFrames = string::convert<int>(tok.nextToken());
+		_numFrames = tok.nextNumber<std::size_t>();
 
 		tok.assertNextToken("numJoints");
-		std::size_t numJoints = string::convert<std::size_t>(tok.nextToken());
+		std::size_t numJoints = tok.nextNumber<std::size_t>();
 
 		// Adjust the arrays
 		_joints.resize(numJoints);
-		_bounds.resize(numFrames);
+		_bounds.resize(_numFrames);
 		_baseFrame.resize(numJoints);
-		_frames.resize(numFrames);
 
 		tok.assertNextToken("frameRate");
-		_frameRate = string::convert<int>(tok.nextToken());
+		_frameRate = tok.nextNumber<int>();
 
 		tok.assertNextToken("numAnimatedComponents");
-		_numAnimatedComponents = string::convert<std::size_t>(tok.nextToken());
+		_numAnimatedComponents = tok.nextNumber<std::size_t>();
+
+		values.resize(_numFrames * _numAnimatedComponents);
 
 		// Parse hierarchy block
 		parseJointHierarchy(tok);
@@ -184,15 +270,19 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		parseBaseFrame(tok);
 
 		// Parse each actual frame
-		for (std::size_t i = 0; i < _frames.size(); ++i)
+		for (std::size_t i = 0; i < _numFrames; ++i)
 		{
-			parseFrame(i, tok);
+			parseFrame(i, tok, values);
 		}
 	}
 	catch (parser::ParseException& ex)
 	{
 		rError() << "Error parsing MD5 Animation: " << ex.what() << std::endl;
 	}
+
+	// Frames which could not be parsed keep their zero values
+	values.resize(_numFrames * _numAnimatedComponents);
+	quantiseFrameKeys(values);
 }
 
 } // namespace
@@ -1,8 +1,9 @@
 #pragma once
 
 #include "imd5anim.h"
+#include <cstdint>
 #include <vector>
-#include "parser/DefTokeniser.h"
+#include "parser/BufferTokeniser.h"
 #include "math/AABB.h"
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
@@ -10,8 +11,6 @@
 namespace md5
 {
 
-class MD5AnimTokeniser;
-
 class MD5Anim :
 	public IMD5Anim
 {
@@ -31,8 +30,16 @@ private:
 
 	Keys _baseFrame;
 
-	// Each frame has <numAnimatedComponents> float values
-	std::vector<FrameKeys> _frames;
+	std::size_t _numFrames;
+
+	// Each frame has <numAnimatedComponents> values, stored frame by frame.
+	// The values are quantised to 16 bits, relative to the range each
+	// animated component covers across all frames of this anim.
+	std::vector<std::uint16_t> _frameKeys;
+
+	// Per animated component: value = minimum + quantised value * scale
+	std::vector<float> _componentMinimum;
+	std::vector<float> _componentScale;
 
 public:
 	MD5Anim();
@@ -64,22 +71,30 @@ public:
 
 	std::size_t getNumFrames() const
 	{
-		return _frames.size();
+		return _numFrames;
 	}
 
-	const FrameKeys& getFrameKeys(std::size_t index) const
+	std::size_t getNumAnimatedComponents() const
 	{
-		return _frames[index];
+		return _numAnimatedComponents;
 	}
 
+	void getFrameKeys(std::size_t index, FrameKeys& keys) const;
+
+	// The approximate number of bytes occupied by this anim
+	std::size_t getMemoryUsage() const;
+
 	void parseFromStream(std::istream& stream);
 
 private:
-	void parseFromTokens(parser::DefTokeniser& tok);
-	void parseJointHierarchy(parser::DefTokeniser& tok);
-	void parseFrameBounds(parser::DefTokeniser& tok);
-	void parseBaseFrame(parser::DefTokeniser& tok);
-	void parseFrame(std::size_t frame, parser::DefTokeniser& tok);
+	void parseFromTokens(parser::BufferTokeniser& tok);
+	void parseJointHierarchy(parser::BufferTokeniser& tok);
+	void parseFrameBounds(parser::BufferTokeniser& tok);
+	void parseBaseFrame(parser::BufferTokeniser& tok);
+	void parseFrame(std::size_t frame, parser::BufferTokeniser& tok, std::vector<float>& values);
+
+	// Converts the parsed values (numFrames * numAnimatedComponents) to the quantised storage
+	void quantiseFrameKeys(const std::vector<float>& values);
 };
 typedef std::shared_ptr<MD5Anim> MD5AnimPtr;
 
@@ -3,7 +3,8 @@
 #include "iarchive.h"
 #include "ifilesystem.h"
 #include "itextstream.h"
-#include "parser/DefTokeniser.h"
+#include <algorithm>
+#include <vector>
 
 namespace md5
 {
@@ -52,6 +53,7 @@ const StringSet& MD5AnimationCache::getDependencies() const
 	if (_dependencies.empty())
 	{
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
+		_dependencies.insert(MODULE_COMMANDSYSTEM);
 	}
 
 	return _dependencies;
@@ -59,6 +61,8 @@ const StringSet& MD5AnimationCache::getDependencies() const
 
 void MD5AnimationCache::initialiseModule(const IApplicationContext& ctx)
 {
+	GlobalCommandSystem().addCommand("ShowAnimationCacheMemory",
+		sigc::mem_fun(*this, &MD5AnimationCache::showMemoryReport), { cmd::ARGTYPE_INT | cmd::ARGTYPE_OPTIONAL });
 }
 
 void MD5AnimationCache::shutdownModule()
@@ -66,4 +70,38 @@ void MD5AnimationCache::shutdownModule()
 	_animations.clear();
 }
 
+void MD5AnimationCache::showMemoryReport(const cmd::ArgumentList& args)
+{
+	auto numAnimsToShow = !args.empty() && args[0].getInt() > 0 ? static_cast<std::size_t>(args[0].getInt()) : 10;
+
+	std::vector<std::pair<std::string, std::size_t>> anims;
+	std::size_t totalSize = 0;
+	std::size_t totalFrames = 0;
+	std::size_t unquantisedFrameSize = 0;
+
+	for (const auto& [path, anim] : _animations)
+	{
+		auto size = anim->getMemoryUsage();
+
+		anims.emplace_back(path, size);
+		totalSize += size;
+		totalFrames += anim->getNumFrames();
+		unquantisedFrameSize += anim->getNumFrames() * anim->getNumAnimatedComponents() * sizeof(float);
+	}
+
+	// Largest anims first
+	std::sort(anims.begin(), anims.end(), [](const auto& a, const auto& b)
+	{
+		return a.second > b.second;
+	});
+
+	rMessage() << "Animation Cache: " << anims.size() << " anims, " << totalFrames << " frames, " <<
+		(totalSize / 1024) << " KiB (frame data as floats: " << (unquantisedFrameSize / 1024) << " KiB)" << std::endl;
+
+	for (std::size_t i = 0; i < anims.size() && i < numAnimsToShow; ++i)
+	{
+		rMessage() << "  " << (anims[i].second / 1024) << " KiB: " << anims[i].first << std::endl;
+	}
+}
+
 } // namespace
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "imd5anim.h"
+#include "icommandsystem.h"
 #include <map>
 
 #include "MD5Anim.h"
@@ -25,6 +26,10 @@ public:
 	const StringSet& getDependencies() const;
 	void initialiseModule(const IApplicationContext& ctx);
 	void shutdownModule();
+
+private:
+	// Prints the memory occupied by the cached anims to the console
+	void showMemoryReport(const cmd::ArgumentList& args);
 };
 typedef std::shared_ptr<MD5AnimationCache> MD5AnimationCachePtr;
 
@@ -3,7 +3,6 @@
 #include "ivolumetest.h"
 #include "texturelib.h"
 #include "ifilter.h"
-#include "string/convert.h"
 #include "math/Quaternion.h"
 #include "math/Ray.h"
 #include "MD5DataStructures.h"
@@ -198,7 +197,7 @@ const model::IIndexedModelSurface& MD5Model::getSurface(unsigned surfaceNum) con
 	return *_surfaces[surfaceNum];
 }
 
-void MD5Model::parseFromTokens(parser::DefTokeniser& tok)
+void MD5Model::parseFromTokens(parser::BufferTokeniser& tok)
 {
 	_vertexCount = 0;
 	_polyCount = 0;
@@ -213,9 +212,9 @@ void MD5Model::parseFromTokens(parser::DefTokeniser& tok)
 
 	// Number of joints and meshes
 	tok.assertNextToken("numJoints");
-	std::size_t numJoints = string::convert<std::size_t>(tok.nextToken());
+	std::size_t numJoints = tok.nextNumber<std::size_t>();
 	tok.assertNextToken("numMeshes");
-	std::size_t numMeshes = string::convert<std::size_t>(tok.nextToken());
+	std::size_t numMeshes = tok.nextNumber<std::size_t>();
 
 	// ------ JOINTS  ------
 
@@ -236,7 +235,7 @@ void MD5Model::parseFromTokens(parser::DefTokeniser& tok)
 		tok.skipTokens(1);
 
 		// Index of parent joint
-		i->parent = string::convert<int>(tok.nextToken());
+		i->parent = tok.nextNumber<int>();
 
 		// Joint's position vector
 		i->position = parseVector3(tok);
@@ -287,12 +286,12 @@ void MD5Model::parseFromTokens(parser::DefTokeniser& tok)
 	updateMaterialList();
 }
 
-Vector3 MD5Model::parseVector3(parser::DefTokeniser& tok) {
+Vector3 MD5Model::parseVector3(parser::BufferTokeniser& tok) {
 	tok.assertNextToken("(");
 
-	float x = string::convert<float>(tok.nextToken());
-	float y = string::convert<float>(tok.nextToken());
-	float z = string::convert<float>(tok.nextToken());
+	float x = tok.nextNumber<float>();
+	float y = tok.nextNumber<float>();
+	float z = tok.nextNumber<float>();
 
 	tok.assertNextToken(")");
 
@@ -4,7 +4,7 @@
 #include "imd5model.h"
 #include "math/AABB.h"
 #include <vector>
-#include "parser/DefTokeniser.h"
+#include "parser/BufferTokeniser.h"
 
 #include "MD5Surface.h"
 #include "MD5Skeleton.h"
@@ -64,7 +64,7 @@ public:
 
 	/** greebo: Reads the model data from the given tokeniser.
 	 */
-	void parseFromTokens(parser::DefTokeniser& tok);
+	void parseFromTokens(parser::BufferTokeniser& tok);
 
     const MD5Skeleton& getSkeleton() const
     {
@@ -124,7 +124,7 @@ public:
 	 * Helper: Parse an MD5 vector, which consists of three separated numbers
 	 * enclosed with parentheses.
 	 */
-	static Vector3 parseVector3(parser::DefTokeniser& tok);
+	static Vector3 parseVector3(parser::BufferTokeniser& tok);
 
     sigc::signal<void>& signal_ModelAnimationUpdated();
 
@@ -89,7 +89,7 @@ model::IModelPtr MD5ModelLoader::loadModelFromPath(const std::string& path)
     try
     {
         std::istream is(&inputStream);
-        parser::BasicDefTokeniser<std::istream> tokeniser(is);
+        parser::BufferTokeniser tokeniser(is);
 
         // Invoke the parser routine (might throw)
         model->parseFromTokens(tokeniser);
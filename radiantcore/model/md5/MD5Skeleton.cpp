@@ -91,6 +91,12 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 	std::size_t curFrame = static_cast<std::size_t>(std::floor(frameTime)) % _anim->getNumFrames();
 	std::size_t nextFrame = curFrame == _anim->getNumFrames() -1 ? curFrame : (curFrame + 1) % _anim->getNumFrames();
 
+	_anim->getFrameKeys(curFrame, _currentFrameKeys);
+	_anim->getFrameKeys(nextFrame, _nextFrameKeys);
+
+	const IMD5Anim::FrameKeys& cur = _currentFrameKeys;
+	const IMD5Anim::FrameKeys& next = _nextFrameKeys;
+
 	// Apply the current frame keys to the base frame
 	for (std::size_t i = 0; i < numJoints; ++i)
 	{
@@ -100,10 +106,6 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 		// Apply base frame
 		_skeleton[i].origin = baseKey.origin;
 		_skeleton[i].orientation = baseKey.orientation;
-		
-		// Apply actual frame data
-		const IMD5Anim::FrameKeys& cur = _anim->getFrameKeys(curFrame);
-		const IMD5Anim::FrameKeys& next = _anim->getFrameKeys(nextFrame);
 
 		// The joint.firstKey member holds the offset into the frame data array
 		std::size_t key = joint.firstKey;
@@ -20,6 +20,10 @@ protected:
 	// The current animation, needed to get joint information etc.
 	IMD5AnimPtr _anim;
 
+	// The values of the two frames being interpolated, re-used between updates
+	IMD5Anim::FrameKeys _currentFrameKeys;
+	IMD5Anim::FrameKeys _nextFrameKeys;
+
 public:
 	// Update the skeleton to match the given animation at the given time
 	void update(const IMD5AnimPtr& anim, std::size_t time);
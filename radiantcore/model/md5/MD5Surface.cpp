@@ -1,7 +1,6 @@
 #include "MD5Surface.h"
 
 #include "ivolumetest.h"
-#include "string/convert.h"
 #include "MD5Model.h"
 #include "math/Ray.h"
 
@@ -294,7 +293,7 @@ void MD5Surface::buildIndexArray()
 	}
 }
 
-void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
+void MD5Surface::parseFromTokens(parser::BufferTokeniser& tok)
 {
 	// Start of datablock
 	tok.assertNextToken("mesh");
@@ -311,7 +310,7 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 
 	// Read the vertex count
 	tok.assertNextToken("numverts");
-	std::size_t numVerts = string::convert<std::size_t>(tok.nextToken());
+	std::size_t numVerts = tok.nextNumber<std::size_t>();
 
 	// Initialise the vertex vector
 	MD5Verts& verts = mesh.vertices;
@@ -323,17 +322,17 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 		tok.assertNextToken("vert");
 
 		// Index of vert
-		vt->index = string::convert<std::size_t>(tok.nextToken());
+		vt->index = tok.nextNumber<std::size_t>();
 
 		// U and V texcoords
 		tok.assertNextToken("(");
-		vt->u = string::convert<float>(tok.nextToken());
-		vt->v = string::convert<float>(tok.nextToken());
+		vt->u = tok.nextNumber<float>();
+		vt->v = tok.nextNumber<float>();
 		tok.assertNextToken(")");
 
 		// Weight index and count
-		vt->weight_index = string::convert<std::size_t>(tok.nextToken());
-		vt->weight_count = string::convert<std::size_t>(tok.nextToken());
+		vt->weight_index = tok.nextNumber<std::size_t>();
+		vt->weight_count = tok.nextNumber<std::size_t>();
 
 	} // for each vertex
 
@@ -341,7 +340,7 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 
 	// Read the number of triangles
 	tok.assertNextToken("numtris");
-	std::size_t numTris = string::convert<std::size_t>(tok.nextToken());
+	std::size_t numTris = tok.nextNumber<std::size_t>();
 
 	// Initialise the triangle vector
 	MD5Tris& tris = mesh.triangles;
@@ -353,10 +352,10 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 		tok.assertNextToken("tri");
 
 		// Triangle index, followed by the indexes of its 3 vertices
-		tr->index = string::convert<std::size_t>(tok.nextToken());
-		tr->a = 	string::convert<std::size_t>(tok.nextToken());
-		tr->b = 	string::convert<std::size_t>(tok.nextToken());
-		tr->c = 	string::convert<std::size_t>(tok.nextToken());
+		tr->index = tok.nextNumber<std::size_t>();
+		tr->a = 	tok.nextNumber<std::size_t>();
+		tr->b = 	tok.nextNumber<std::size_t>();
+		tr->c = 	tok.nextNumber<std::size_t>();
 
 	} // for each triangle
 
@@ -364,7 +363,7 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 
 	// Read the number of weights
 	tok.assertNextToken("numweights");
-	std::size_t numWeights = string::convert<std::size_t>(tok.nextToken());
+	std::size_t numWeights = tok.nextNumber<std::size_t>();
 
 	// Initialise weights vector
 	MD5Weights& weights = mesh.weights;
@@ -376,11 +375,11 @@ void MD5Surface::parseFromTokens(parser::DefTokeniser& tok)
 		tok.assertNextToken("weight");
 
 		// Index and joint
-		w->index = string::convert<std::size_t>(tok.nextToken());
-		w->joint = string::convert<std::size_t>(tok.nextToken());
+		w->index = tok.nextNumber<std::size_t>();
+		w->joint = tok.nextNumber<std::size_t>();
 
 		// Strength and relative position
-		w->t = string::convert<float>(tok.nextToken());
+		w->t = tok.nextNumber<float>();
 		w->v = MD5Model::parseVector3(tok);
 
 	} // for each weight
@@ -9,7 +9,7 @@
 #include "imodelsurface.h"
 
 #include "MD5DataStructures.h"
-#include "parser/DefTokeniser.h"
+#include "parser/BufferTokeniser.h"
 
 class Ray;
 
@@ -89,7 +89,7 @@ public:
 
     const AABB& getSurfaceBounds() const override;
 
-	void parseFromTokens(parser::DefTokeniser& tok);
+	void parseFromTokens(parser::BufferTokeniser& tok);
 
 	// Rebuild the render index array - usually needs to be called only once
 	void buildIndexArray();
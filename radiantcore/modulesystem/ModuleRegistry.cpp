@@ -5,7 +5,11 @@
 #include "itextstream.h"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 #include "ModuleLoader.h"
+#include "profiling/Profiler.h"
+#include "profiling/ScopedSpan.h"
 
 #include <fmt/format.h>
 
@@ -127,7 +131,38 @@ void ModuleRegistry::initialiseModuleRecursive(const std::string& name)
 		_progress);
 
 	// Initialise the module itself, now that the dependencies are ready
+	profiling::ScopedSpan span(profiling::Profiler::Instance(), "Initialise " + name);
+
+	auto startTime = std::chrono::steady_clock::now();
 	module->initialiseModule(_context);
+	_initialisationTimes.emplace_back(name, std::chrono::steady_clock::now() - startTime);
+}
+
+void ModuleRegistry::logInitialisationTimes(std::chrono::steady_clock::duration totalTime)
+{
+	auto toMilliseconds = [](std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	};
+
+	rMessage() << fmt::format("ModuleRegistry: Initialised {0} modules in {1:.1f} ms",
+		_initialisationTimes.size(), toMilliseconds(totalTime)) << std::endl;
+
+	// Report the time spent per module, the slowest first
+	auto sortedTimes = _initialisationTimes;
+
+	std::sort(sortedTimes.begin(), sortedTimes.end(), [](const auto& a, const auto& b)
+	{
+		return a.second > b.second;
+	});
+
+	for (const auto& [name, duration] : sortedTimes)
+	{
+		// Skip the trivial ones
+		if (duration < std::chrono::milliseconds(1)) break;
+
+		rMessage() << fmt::format("  {0:>8.1f} ms  {1}", toMilliseconds(duration), name) << std::endl;
+	}
 }
 
 void ModuleRegistry::initialiseCoreModule()
@@ -171,12 +206,20 @@ void ModuleRegistry::loadAndInitialiseModules()
 	_progress = 0.1f;
 	_sigModuleInitialisationProgress.emit(_("Initialising Modules"), _progress);
 
-	for (ModulesMap::iterator i = _uninitialisedModules.begin();
-		 i != _uninitialisedModules.end(); ++i)
 	{
-		// greebo: Dive into the recursion
-		// (this will return immediately if the module is already initialised).
-		initialiseModuleRecursive(i->first);
+		profiling::ScopedSpan span(profiling::Profiler::Instance(), "ModuleRegistry::initialiseModules");
+
+		auto startTime = std::chrono::steady_clock::now();
+
+		for (ModulesMap::iterator i = _uninitialisedModules.begin();
+			 i != _uninitialisedModules.end(); ++i)
+		{
+			// greebo: Dive into the recursion
+			// (this will return immediately if the module is already initialised).
+			initialiseModuleRecursive(i->first);
+		}
+
+		logInitialisationTimes(std::chrono::steady_clock::now() - startTime);
 	}
 
 	_uninitialisedModules.clear();
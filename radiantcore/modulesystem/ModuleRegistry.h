@@ -2,6 +2,8 @@
 
 #include <map>
 #include <list>
+#include <vector>
+#include <chrono>
 #include "imodule.h"
 
 namespace module 
@@ -40,6 +42,9 @@ private:
 	// For progress meter in the splash screen
 	float _progress;
 
+	// Time spent in initialiseModule() of each module, excluding its dependencies
+	std::vector<std::pair<std::string, std::chrono::steady_clock::duration>> _initialisationTimes;
+
     // Signals fired after ALL modules have been initialised or shut down.
     sigc::signal<void> _sigAllModulesInitialised;
 	sigc::signal<void> _sigAllModulesUninitialised;
@@ -101,6 +106,9 @@ private:
 	// Initialises the module (including dependencies, recursively).
 	void initialiseModuleRecursive(const std::string& name);
 
+	// Writes the total initialisation time and the slowest modules to the log
+	void logInitialisationTimes(std::chrono::steady_clock::duration totalTime);
+
 }; // class Registry
 
 } // namespace module
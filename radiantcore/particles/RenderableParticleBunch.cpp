@@ -1,5 +1,7 @@
 #include "RenderableParticleBunch.h"
 
+#include <cmath>
+#include <algorithm>
 #include "itextstream.h"
 #include "math/pi.h"
 
@@ -13,12 +15,13 @@ RenderableParticleBunch::RenderableParticleBunch(std::size_t index,
     const Vector3& direction, const Vector3& entityColour) :
     _index(index),
     _stage(stage),
-    _quads(),
+    _numQuads(0),
     _randSeed(randSeed),
     _distributeParticlesRandomly(_stage.getRandomDistribution()),
     _offset(_stage.getOffset()),
     _viewRotation(viewRotation),
     _direction(direction),
+    _emitterRotation(Matrix4::getIdentity()),
     _entityColour(entityColour)
 {
     // Geometry is written in update(), just reserve the space
@@ -27,7 +30,9 @@ RenderableParticleBunch::RenderableParticleBunch(std::size_t index,
 void RenderableParticleBunch::update(std::size_t time)
 {
     _bounds = AABB();
-    _quads.clear();
+    _quadParms.clear();
+    _aimedQuads.clear();
+    _numQuads = 0;
 
     // Length of one cycle (duration + deadtime)
     std::size_t cycleMsec = static_cast<std::size_t>(_stage.getCycleMsec());
@@ -38,7 +43,17 @@ void RenderableParticleBunch::update(std::size_t time)
     }
 
     // Reserve enough space for all the particles (non-animated case)
-    _quads.reserve(_stage.getCount() * 4);
+    _quadParms.reserve(_stage.getCount());
+
+    // Check if the main direction is different to the z axis
+    Vector3 dir = _direction.getNormalised();
+    Vector3 zDir(0,0,1);
+
+    _emitterRotation = dir.angle(zDir) != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
+    _emitterOffset = _emitterRotation.transformPoint(_offset);
+
+    // if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
+    _gravity = (_stage.getWorldGravityFlag() ? Vector3(0,0,-1) : -dir) * _stage.getGravity();
 
     // Normalise the global input time into local cycle time
     // The cycleTime may be larger than the _stage.cycleMsec argument if bunching is turned off
@@ -149,42 +164,45 @@ void RenderableParticleBunch::update(std::size_t time)
             }
         }
     }
+
+    if (_stage.getOrientationType() == IStageDef::ORIENTATION_AIMED)
+    {
+        copyAimedQuads();
+    }
+    else
+    {
+        expandQuads();
+    }
 }
 
-void RenderableParticleBunch::addVertexData(std::vector<render::RenderVertex>& vertices, 
-    std::vector<unsigned int>& indices, const Matrix4& localToWorld)
+void RenderableParticleBunch::writeVertices(render::RenderVertex* vertices, const Matrix4& localToWorld) const
 {
-    if (_quads.empty()) return;
-
-    auto firstIndex = static_cast<unsigned int>(vertices.size());
+    // Single-precision copy of the transform, the vertex data is float anyway
+    const float m[12] = {
+        static_cast<float>(localToWorld.xx()), static_cast<float>(localToWorld.xy()), static_cast<float>(localToWorld.xz()),
+        static_cast<float>(localToWorld.yx()), static_cast<float>(localToWorld.yy()), static_cast<float>(localToWorld.yz()),
+        static_cast<float>(localToWorld.zx()), static_cast<float>(localToWorld.zy()), static_cast<float>(localToWorld.zz()),
+        static_cast<float>(localToWorld.tx()), static_cast<float>(localToWorld.ty()), static_cast<float>(localToWorld.tz()),
+    };
 
-    auto quadIndex = 0;
+    const auto numVertices = _numQuads * 4;
 
-    for (const auto& quad : _quads)
+    for (std::size_t i = 0; i < numVertices; ++i)
     {
-        for (auto i = 0; i < 4; ++i)
-        {
-            auto worldVertex = localToWorld * quad.verts[i].vertex;
-
-            vertices.push_back(render::RenderVertex(
-                worldVertex,
-                quad.verts[i].normal, 
-                quad.verts[i].texcoord, 
-                quad.verts[i].colour)
-            );
-        }
-
-        auto index = firstIndex + quadIndex * 4;
-
-        indices.push_back(index + 0);
-        indices.push_back(index + 1);
-        indices.push_back(index + 2);
-
-        indices.push_back(index + 0);
-        indices.push_back(index + 2);
-        indices.push_back(index + 3);
-
-        quadIndex++;
+        auto& vertex = vertices[i];
+
+        auto x = _vertices.x[i];
+        auto y = _vertices.y[i];
+        auto z = _vertices.z[i];
+
+        vertex.vertex = Vector3f(
+            m[0] * x + m[3] * y + m[6] * z + m[9],
+            m[1] * x + m[4] * y + m[7] * z + m[10],
+            m[2] * x + m[5] * y + m[8] * z + m[11]
+        );
+        vertex.normal = Vector3f(_vertices.normalX[i], _vertices.normalY[i], _vertices.normalZ[i]);
+        vertex.texcoord = Vector2f(_vertices.s[i], _vertices.t[i]);
+        vertex.colour = Vector4f(_vertices.red[i], _vertices.green[i], _vertices.blue[i], _vertices.alpha[i]);
     }
 }
 
@@ -314,16 +332,8 @@ void RenderableParticleBunch::calculateColour(ParticleRenderInfo& particle)
 
 void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
 {
-    // Check if the main direction is different to the z axis
-    Vector3 dir = _direction.getNormalised();
-    Vector3 zDir(0,0,1);
-
-    double deviation = dir.angle(zDir);
-
-    Matrix4 rotation = deviation != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
-
     // Consider offset as starting point
-    particle.origin = rotation.transformPoint(_offset);
+    particle.origin = _emitterOffset;
 
     switch (_stage.getCustomPathType())
     {
@@ -336,7 +346,7 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
             particle.origin += distributionOffset;
 
             // Calculate particle direction, pass distribution offset (this is needed for DIRECTION_OUTWARD)
-            Vector3 particleDirection = getDirection(particle, rotation, distributionOffset);
+            Vector3 particleDirection = getDirection(particle, _emitterRotation, distributionOffset);
 
             // Consider speed
             particle.origin += particleDirection * integrate(_stage.getSpeed(), particle.timeSecs);
@@ -423,10 +433,7 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
     };
 
     // Consider gravity
-    // if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
-    Vector3 gravity = _stage.getWorldGravityFlag() ? Vector3(0,0,-1) : -_direction.getNormalised();
-
-    particle.origin += gravity * _stage.getGravity() * particle.timeSecs * particle.timeSecs * 0.5f;
+    particle.origin += _gravity * particle.timeSecs * particle.timeSecs * 0.5f;
 }
 
 Vector3 RenderableParticleBunch::getDirection(ParticleRenderInfo& particle, const Matrix4& rotation, const Vector3& distributionOffset)
@@ -579,14 +586,119 @@ Vector3 RenderableParticleBunch::getDistributionOffset(ParticleRenderInfo& parti
 
 void RenderableParticleBunch::pushQuad(ParticleRenderInfo& particle, const Vector4& colour, float s0, float sWidth)
 {
+    // The vertices are generated in expandQuads()
+    _quadParms.push(particle, colour, s0, sWidth);
+}
+
+void RenderableParticleBunch::expandQuads()
+{
+    const auto numQuads = _quadParms.angle.size();
+
+    _numQuads = numQuads;
+    _vertices.resize(numQuads * 4);
+
     // greebo: Create a (rotated) quad facing the z axis
     // then rotate it to fit the requested orientation
     // finally translate it to its position.
-    const Vector3 normal = _viewRotation.zCol3();
+    const float xCol[3] = { static_cast<float>(_viewRotation.xx()), static_cast<float>(_viewRotation.xy()), static_cast<float>(_viewRotation.xz()) };
+    const float yCol[3] = { static_cast<float>(_viewRotation.yx()), static_cast<float>(_viewRotation.yy()), static_cast<float>(_viewRotation.yz()) };
+    const float tCol[3] = { static_cast<float>(_viewRotation.tx()), static_cast<float>(_viewRotation.ty()), static_cast<float>(_viewRotation.tz()) };
+
+    // The corners in quad space, before applying size, aspect and angle
+    constexpr float cornerX[4] = { -1, +1, +1, -1 };
+    constexpr float cornerY[4] = { +1, +1, -1, -1 };
+
+    const auto degreesToRadians = static_cast<float>(math::PI / 180.0);
+
+    // The arrays are plain floats without any aliasing, such that this loop can be vectorised
+    const auto* originX = _quadParms.originX.data();
+    const auto* originY = _quadParms.originY.data();
+    const auto* originZ = _quadParms.originZ.data();
+    const auto* angle = _quadParms.angle.data();
+    const auto* size = _quadParms.size.data();
+    const auto* aspect = _quadParms.aspect.data();
+
+    auto* x = _vertices.x.data();
+    auto* y = _vertices.y.data();
+    auto* z = _vertices.z.data();
+
+    for (std::size_t q = 0; q < numQuads; ++q)
+    {
+        auto cosPhi = std::cos(angle[q] * degreesToRadians);
+        auto sinPhi = std::sin(angle[q] * degreesToRadians);
+
+        auto width = size[q];
+        auto height = size[q] * aspect[q];
+
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            auto localX = cornerX[c] * width;
+            auto localY = cornerY[c] * height;
 
-    _quads.push_back(ParticleQuad(particle.size, particle.aspect, particle.angle, colour, normal, s0, sWidth));
-    _quads.back().transform(_viewRotation);
-    _quads.back().translate(particle.origin);
+            // Rotate around the z axis by the particle angle
+            auto rotatedX = localX * cosPhi + localY * sinPhi;
+            auto rotatedY = -localX * sinPhi + localY * cosPhi;
+
+            auto v = q * 4 + c;
+            x[v] = rotatedX * xCol[0] + rotatedY * yCol[0] + tCol[0] + originX[q];
+            y[v] = rotatedX * xCol[1] + rotatedY * yCol[1] + tCol[1] + originY[q];
+            z[v] = rotatedX * xCol[2] + rotatedY * yCol[2] + tCol[2] + originZ[q];
+        }
+    }
+
+    // Texture coordinates and colours
+    for (std::size_t q = 0; q < numQuads; ++q)
+    {
+        auto s0 = _quadParms.s0[q];
+        auto s1 = s0 + _quadParms.sWidth[q];
+        auto v = q * 4;
+
+        _vertices.s[v + 0] = s0; _vertices.t[v + 0] = 0;
+        _vertices.s[v + 1] = s1; _vertices.t[v + 1] = 0;
+        _vertices.s[v + 2] = s1; _vertices.t[v + 2] = 1;
+        _vertices.s[v + 3] = s0; _vertices.t[v + 3] = 1;
+
+        for (std::size_t c = 0; c < 4; ++c)
+        {
+            _vertices.red[v + c] = _quadParms.red[q];
+            _vertices.green[v + c] = _quadParms.green[q];
+            _vertices.blue[v + c] = _quadParms.blue[q];
+            _vertices.alpha[v + c] = _quadParms.alpha[q];
+        }
+    }
+
+    // All quads are sharing the same normal
+    std::fill(_vertices.normalX.begin(), _vertices.normalX.end(), static_cast<float>(_viewRotation.zx()));
+    std::fill(_vertices.normalY.begin(), _vertices.normalY.end(), static_cast<float>(_viewRotation.zy()));
+    std::fill(_vertices.normalZ.begin(), _vertices.normalZ.end(), static_cast<float>(_viewRotation.zz()));
+}
+
+void RenderableParticleBunch::copyAimedQuads()
+{
+    _numQuads = _aimedQuads.size();
+    _vertices.resize(_numQuads * 4);
+
+    std::size_t v = 0;
+
+    for (const auto& quad : _aimedQuads)
+    {
+        for (const auto& vertex : quad.verts)
+        {
+            _vertices.x[v] = static_cast<float>(vertex.vertex.x());
+            _vertices.y[v] = static_cast<float>(vertex.vertex.y());
+            _vertices.z[v] = static_cast<float>(vertex.vertex.z());
+            _vertices.s[v] = static_cast<float>(vertex.texcoord.x());
+            _vertices.t[v] = static_cast<float>(vertex.texcoord.y());
+            _vertices.normalX[v] = static_cast<float>(vertex.normal.x());
+            _vertices.normalY[v] = static_cast<float>(vertex.normal.y());
+            _vertices.normalZ[v] = static_cast<float>(vertex.normal.z());
+            _vertices.red[v] = static_cast<float>(vertex.colour.x());
+            _vertices.green[v] = static_cast<float>(vertex.colour.y());
+            _vertices.blue[v] = static_cast<float>(vertex.colour.z());
+            _vertices.alpha[v] = static_cast<float>(vertex.colour.w());
+            ++v;
+        }
+    }
 }
 
 void RenderableParticleBunch::pushAimedParticles(ParticleRenderInfo& particle, std::size_t stageDurationMsec)
@@ -667,10 +779,10 @@ void RenderableParticleBunch::pushAimedParticles(ParticleRenderInfo& particle, s
                 // Glue the first row of vertices to the last quad, if applicable
                 if (i > 1)
                 {
-                    snapQuads(curQuad, *(_quads.end()-2));
+                    snapQuads(curQuad, *(_aimedQuads.end()-2));
                 }
 
-                _quads.push_back(curQuad);
+                _aimedQuads.push_back(curQuad);
 
                 // "Next" quad, re-use the curQuad structure
                 curQuad.assignColour(aimedParticle.nextColour);
@@ -680,20 +792,20 @@ void RenderableParticleBunch::pushAimedParticles(ParticleRenderInfo& particle, s
 
                 if (i > 1)
                 {
-                    snapQuads(curQuad, *(_quads.end()-2));
+                    snapQuads(curQuad, *(_aimedQuads.end()-2));
                 }
 
-                _quads.push_back(curQuad);
+                _aimedQuads.push_back(curQuad);
             }
             else
             {
                 if (i > 1)
                 {
-                    snapQuads(curQuad, _quads.back());
+                    snapQuads(curQuad, _aimedQuads.back());
                 }
 
                 // Non-animated case
-                _quads.push_back(curQuad);
+                _aimedQuads.push_back(curQuad);
             }
         }
 
@@ -721,12 +833,68 @@ void RenderableParticleBunch::snapQuads(ParticleQuad& curQuad, ParticleQuad& pre
 
 void RenderableParticleBunch::calculateBounds()
 {
-    for (Quads::const_iterator i = _quads.begin(); i != _quads.end(); ++i)
+    const auto numVertices = _numQuads * 4;
+
+    if (numVertices == 0) return;
+
+    auto minX = _vertices.x[0], maxX = minX;
+    auto minY = _vertices.y[0], maxY = minY;
+    auto minZ = _vertices.z[0], maxZ = minZ;
+
+    for (std::size_t i = 1; i < numVertices; ++i)
+    {
+        minX = std::min(minX, _vertices.x[i]);
+        maxX = std::max(maxX, _vertices.x[i]);
+        minY = std::min(minY, _vertices.y[i]);
+        maxY = std::max(maxY, _vertices.y[i]);
+        minZ = std::min(minZ, _vertices.z[i]);
+        maxZ = std::max(maxZ, _vertices.z[i]);
+    }
+
+    _bounds = AABB::createFromMinMax(Vector3(minX, minY, minZ), Vector3(maxX, maxY, maxZ));
+}
+
+void RenderableParticleBunch::QuadParameters::clear()
+{
+    for (auto* array : { &originX, &originY, &originZ, &angle, &size, &aspect,
+                         &s0, &sWidth, &red, &green, &blue, &alpha })
+    {
+        array->clear();
+    }
+}
+
+void RenderableParticleBunch::QuadParameters::reserve(std::size_t numQuads)
+{
+    for (auto* array : { &originX, &originY, &originZ, &angle, &size, &aspect,
+                         &s0, &sWidth, &red, &green, &blue, &alpha })
+    {
+        array->reserve(numQuads);
+    }
+}
+
+void RenderableParticleBunch::QuadParameters::push(const ParticleRenderInfo& particle,
+    const Vector4& colour, float s0_, float sWidth_)
+{
+    originX.push_back(static_cast<float>(particle.origin.x()));
+    originY.push_back(static_cast<float>(particle.origin.y()));
+    originZ.push_back(static_cast<float>(particle.origin.z()));
+    angle.push_back(particle.angle);
+    size.push_back(particle.size);
+    aspect.push_back(particle.aspect);
+    s0.push_back(s0_);
+    sWidth.push_back(sWidth_);
+    red.push_back(static_cast<float>(colour.x()));
+    green.push_back(static_cast<float>(colour.y()));
+    blue.push_back(static_cast<float>(colour.z()));
+    alpha.push_back(static_cast<float>(colour.w()));
+}
+
+void RenderableParticleBunch::QuadVertices::resize(std::size_t numVertices)
+{
+    for (auto* array : { &x, &y, &z, &s, &t, &normalX, &normalY, &normalZ,
+                         &red, &green, &blue, &alpha })
     {
-        _bounds.includePoint(i->verts[0].vertex);
-        _bounds.includePoint(i->verts[1].vertex);
-        _bounds.includePoint(i->verts[2].vertex);
-        _bounds.includePoint(i->verts[3].vertex);
+        array->resize(numVertices);
     }
 }
 
@@ -27,9 +27,41 @@ class RenderableParticleBunch
 	// The stage this bunch is part of
 	const IStageDef& _stage;
 
-	// The quads of this particle bunch
+	// The parameters of each view/x/y/z-oriented quad, one entry per quad.
+	// These are collected while walking the particles and expanded
+	// into vertices in one go at the end of update().
+	struct QuadParameters
+	{
+		std::vector<float> originX, originY, originZ;
+		std::vector<float> angle, size, aspect;
+		std::vector<float> s0, sWidth;
+		std::vector<float> red, green, blue, alpha;
+
+		void clear();
+		void reserve(std::size_t numQuads);
+		void push(const ParticleRenderInfo& particle, const Vector4& colour, float s0_, float sWidth_);
+	};
+
+	QuadParameters _quadParms;
+
+	// Aimed quads need to be connected to their predecessor, they are generated one by one
 	typedef std::vector<ParticleQuad> Quads;
-	Quads _quads;
+	Quads _aimedQuads;
+
+	// The generated vertices of this bunch, stored as structure of arrays, 4 entries per quad
+	struct QuadVertices
+	{
+		std::vector<float> x, y, z;
+		std::vector<float> s, t;
+		std::vector<float> normalX, normalY, normalZ;
+		std::vector<float> red, green, blue, alpha;
+
+		void resize(std::size_t numVertices);
+	};
+
+	QuadVertices _vertices;
+
+	std::size_t _numQuads;
 
 	// The seed for our local randomiser, as passed by the parent stage
 	Rand48::result_type _randSeed;
@@ -52,6 +84,12 @@ class RenderableParticleBunch
 	// The bounds of this quad group, calculated on demand
 	AABB _bounds;
 
+	// The rotation of the z axis into the emitter direction, the rotated stage offset
+	// and the gravity vector. These are the same for all particles, calculated in update()
+	Matrix4 _emitterRotation;
+	Vector3 _emitterOffset;
+	Vector3 _gravity;
+
 	// The entity colour (instance owned by RenderableParticle)
 	const Vector3& _entityColour;
 
@@ -73,15 +111,15 @@ public:
 	// Time is specified in stage time without offset,in msecs.
 	void update(std::size_t time);
 
-    // Add the renderable geometry to the given arrays
-    void addVertexData(std::vector<render::RenderVertex>& vertices,
-        std::vector<unsigned int>& indices, const Matrix4& localToWorld);
+    // Writes the 4 * getNumQuads() vertices of this bunch to the given location,
+    // transformed to world space. The target array needs to be large enough.
+    void writeVertices(render::RenderVertex* vertices, const Matrix4& localToWorld) const;
 
 	const AABB& getBounds();
 
     std::size_t getNumQuads() const
     {
-        return _quads.size();
+        return _numQuads;
     }
 
 private:
@@ -119,6 +157,12 @@ private:
 	// colour, s0 and sWidth override the values in info
 	void pushQuad(ParticleRenderInfo& particle, const Vector4& colour, float s0 = 0.0f, float sWidth = 1.0f);
 
+	// Generates the vertices of all quads pushed since the last update
+	void expandQuads();
+
+	// Copies the vertices of the aimed quads to the vertex arrays
+	void copyAimedQuads();
+
 	// Makes the quad transition seamless by snapping the adjacent vertices at the midpoint
 	void snapQuads(ParticleQuad& curQuad, ParticleQuad& prevQuad);
 
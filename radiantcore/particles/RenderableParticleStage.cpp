@@ -83,32 +83,42 @@ std::size_t RenderableParticleStage::getNumQuads() const
 
 void RenderableParticleStage::updateGeometry()
 {
-    std::vector<render::RenderVertex> vertices;
-    std::vector<unsigned int> indices;
-
     auto numQuads = getNumQuads();
 
-    if (numQuads == 0)
+    // The index pattern only depends on the number of quads
+    if (_indices.size() != numQuads * 6)
     {
-        updateGeometryWithData(render::GeometryType::Triangles, vertices,
-                                                   indices);
-        return;
-    }
+        _indices.resize(numQuads * 6);
 
-    vertices.reserve(numQuads * 4);
-    indices.reserve(numQuads * 6);
+        for (unsigned int quad = 0; quad < numQuads; ++quad)
+        {
+            auto index = quad * 4;
+            auto* target = _indices.data() + quad * 6;
 
-    if (_bunches[0])
-    {
-        _bunches[0]->addVertexData(vertices, indices, _localToWorld);
+            target[0] = index + 0;
+            target[1] = index + 1;
+            target[2] = index + 2;
+
+            target[3] = index + 0;
+            target[4] = index + 2;
+            target[5] = index + 3;
+        }
     }
 
-    if (_bunches[1])
+    // Let the bunches write their vertices right into the buffer
+    _vertices.resize(numQuads * 4);
+
+    auto* target = _vertices.data();
+
+    for (const auto& bunch : _bunches)
     {
-        _bunches[1]->addVertexData(vertices, indices, _localToWorld);
+        if (!bunch) continue;
+
+        bunch->writeVertices(target, _localToWorld);
+        target += bunch->getNumQuads() * 4;
     }
 
-    updateGeometryWithData(render::GeometryType::Triangles, vertices, indices);
+    updateGeometryWithData(render::GeometryType::Triangles, _vertices, _indices);
 }
 
 const AABB& RenderableParticleStage::getBounds()
@@ -44,6 +44,11 @@ class RenderableParticleStage :
 	// The entity colour (instance owned by RenderableParticle)
 	const Vector3& _entityColour;
 
+	// The vertex and index buffers passed to the geometry renderer,
+	// kept around to avoid re-allocating them every frame
+	std::vector<render::RenderVertex> _vertices;
+	std::vector<unsigned int> _indices;
+
 public:
 	RenderableParticleStage(const IStageDef& stage, 
 							Rand48& random, 
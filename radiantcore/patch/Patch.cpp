@@ -48,6 +48,7 @@ inline bool double_valid(double f) {
 Patch::Patch(PatchNode& node) :
     _node(node),
     _undoStateSaver(nullptr),
+    _mesh(std::make_shared<PatchTesselation>()),
     _transformChanged(false),
     _tesselationChanged(true),
     _shader(texdef_name_default())
@@ -63,6 +64,7 @@ Patch::Patch(const Patch& other, PatchNode& node) :
     IUndoable(other),
     _node(node),
     _undoStateSaver(nullptr),
+    _mesh(std::make_shared<PatchTesselation>()),
     _transformChanged(false),
     _tesselationChanged(true),
     _shader(other._shader.getMaterialName())
@@ -193,14 +195,14 @@ void Patch::testSelect(Selector& selector, SelectionTest& test)
     updateTesselation();
 
     // The updateTesselation routine might have produced a degenerate patch, catch this
-    if (_mesh.vertices.empty()) return;
+    if (_mesh->vertices.empty()) return;
 
     SelectionIntersection best;
-    IndexPointer::index_type* pIndex = &_mesh.indices.front();
+    const IndexPointer::index_type* pIndex = &_mesh->indices.front();
 
-    for (std::size_t s=0; s<_mesh.numStrips; s++) {
-        test.TestQuadStrip(vertexpointer_Meshvertex(&_mesh.vertices.front()), IndexPointer(pIndex, _mesh.lenStrips), best);
-        pIndex += _mesh.lenStrips;
+    for (std::size_t s=0; s<_mesh->numStrips; s++) {
+        test.TestQuadStrip(vertexpointer_Meshvertex(&_mesh->vertices.front()), IndexPointer(pIndex, _mesh->lenStrips), best);
+        pIndex += _mesh->lenStrips;
     }
 
     if (best.isValid()) {
@@ -234,6 +236,8 @@ void Patch::transformChanged()
 {
     _transformChanged = true;
     _tesselationChanged = true;
+
+    queueForTesselation();
 }
 
 // Called to evaluate the transform
@@ -265,7 +269,9 @@ void Patch::freezeTransform()
     // Don't call controlPointsChanged() here since that one will re-apply the
     // current transformation matrix, possible the second time.
     transformChanged();
-    updateTesselation();
+
+    // The tesselation is updated on demand, possibly along with other patches
+    updateAABB();
 
     for (Observers::iterator i = _observers.begin(); i != _observers.end();)
     {
@@ -278,7 +284,9 @@ void Patch::controlPointsChanged()
 {
     transformChanged();
     evaluateTransform();
-    updateTesselation();
+
+    // The tesselation is updated on demand, possibly along with other patches
+    updateAABB();
     _node.onControlPointsChanged();
 
     for (Observers::iterator i = _observers.begin(); i != _observers.end();)
@@ -425,6 +433,8 @@ void Patch::check_shader()
 // Patch Destructor
 Patch::~Patch()
 {
+    PatchTesselationCache::Instance().dequeue(*this);
+
     for (Observers::iterator i = _observers.begin(); i != _observers.end();)
     {
         (*i++)->onPatchDestruction();
@@ -486,21 +496,56 @@ void Patch::updateTesselation(bool force)
 
     _tesselationChanged = false;
 
+    PatchTesselationCache::Instance().dequeue(*this);
+
     if (!isValid())
     {
-        _mesh.clear();
+        _mesh = std::make_shared<PatchTesselation>();
         _localAABB = AABB();
         return;
     }
 
-    // Run the tesselation code
-    _mesh.generate(_width, _height, _ctrlTransformed, subdivisionsFixed(), getSubdivisions(), _node.getRenderEntity());
+    // Look up the tesselation or generate a new one
+    setTesselation(PatchTesselationCache::Instance().acquire(getTesselationInput()));
+}
+
+bool Patch::tesselationIsOutdated() const
+{
+    return _tesselationChanged;
+}
+
+PatchTesselationCache::Input Patch::getTesselationInput() const
+{
+    auto renderEntity = _node.getRenderEntity();
+
+    return PatchTesselationCache::Input
+    {
+        _width, _height, &_ctrlTransformed, subdivisionsFixed(), getSubdivisions(),
+        renderEntity ? renderEntity->getEntityColour() : Vector4(1, 1, 1, 1)
+    };
+}
+
+void Patch::setTesselation(const PatchTesselation::Ptr& tesselation)
+{
+    _tesselationChanged = false;
+
+    PatchTesselationCache::Instance().dequeue(*this);
+
+    _mesh = tesselation;
 
     updateAABB();
 
     _node.onTesselationChanged();
 }
 
+void Patch::queueForTesselation()
+{
+    if (_node.inScene())
+    {
+        PatchTesselationCache::Instance().queue(*this);
+    }
+}
+
 void Patch::invertMatrix()
 {
   undoSave();
@@ -1664,7 +1709,7 @@ void Patch::alignTexture(AlignEdge align)
     controlPointsChanged();
 }
 
-PatchTesselation& Patch::getTesselation()
+const PatchTesselation::Ptr& Patch::getTesselation()
 {
     // Ensure the tesselation is up to date
     updateTesselation();
@@ -1679,9 +1724,9 @@ PatchRenderIndices Patch::getRenderIndices() const
 
 	PatchRenderIndices info;
 
-	info.indices = _mesh.indices;
-	info.lenStrips = _mesh.lenStrips;
-	info.numStrips = _mesh.numStrips;
+	info.indices = _mesh->indices;
+	info.lenStrips = _mesh->lenStrips;
+	info.numStrips = _mesh->numStrips;
 
 	return info;
 }
@@ -1693,11 +1738,11 @@ PatchMesh Patch::getTesselatedPatchMesh() const
 
     PatchMesh mesh;
 
-    mesh.width = _mesh.width;
-    mesh.height = _mesh.height;
+    mesh.width = _mesh->width;
+    mesh.height = _mesh->height;
 
-    for (std::vector<MeshVertex>::const_iterator i = _mesh.vertices.begin();
-        i != _mesh.vertices.end(); ++i)
+    for (std::vector<MeshVertex>::const_iterator i = _mesh->vertices.begin();
+        i != _mesh->vertices.end(); ++i)
     {
         VertexNT v;
 
@@ -2516,22 +2561,24 @@ bool Patch::subdivisionsFixed() const
 
 bool Patch::getIntersection(const Ray& ray, Vector3& intersection)
 {
-    std::vector<RenderIndex>::const_iterator stripStartIndex = _mesh.indices.begin();
+    updateTesselation();
+
+    std::vector<RenderIndex>::const_iterator stripStartIndex = _mesh->indices.begin();
 
     // Go over each quad strip and intersect the ray with its triangles
-    for (std::size_t strip = 0; strip < _mesh.numStrips; ++strip)
+    for (std::size_t strip = 0; strip < _mesh->numStrips; ++strip)
     {
         // Iterate over the indices. The +2 increment will lead up to the next quad
         for (std::vector<RenderIndex>::const_iterator indexIter = stripStartIndex;
-            indexIter + 2 < stripStartIndex + _mesh.lenStrips; indexIter += 2)
+            indexIter + 2 < stripStartIndex + _mesh->lenStrips; indexIter += 2)
         {
             Vector3 triangleIntersection;
 
             // Run a selection test against the quad's triangles
             {
-                const Vector3& p1 = _mesh.vertices[*indexIter].vertex;
-                const Vector3& p2 = _mesh.vertices[*(indexIter + 1)].vertex;
-                const Vector3& p3 = _mesh.vertices[*(indexIter + 2)].vertex;
+                const Vector3& p1 = _mesh->vertices[*indexIter].vertex;
+                const Vector3& p2 = _mesh->vertices[*(indexIter + 1)].vertex;
+                const Vector3& p3 = _mesh->vertices[*(indexIter + 2)].vertex;
 
                 if (ray.intersectTriangle(p1, p2, p3, triangleIntersection) == Ray::POINT)
                 {
@@ -2541,9 +2588,9 @@ bool Patch::getIntersection(const Ray& ray, Vector3& intersection)
             }
 
             {
-                const Vector3& p1 = _mesh.vertices[*(indexIter + 2)].vertex;
-                const Vector3& p2 = _mesh.vertices[*(indexIter + 1)].vertex;
-                const Vector3& p3 = _mesh.vertices[*(indexIter + 3)].vertex;
+                const Vector3& p1 = _mesh->vertices[*(indexIter + 2)].vertex;
+                const Vector3& p2 = _mesh->vertices[*(indexIter + 1)].vertex;
+                const Vector3& p3 = _mesh->vertices[*(indexIter + 3)].vertex;
 
                 if (ray.intersectTriangle(p1, p2, p3, triangleIntersection) == Ray::POINT)
                 {
@@ -2553,7 +2600,7 @@ bool Patch::getIntersection(const Ray& ray, Vector3& intersection)
             }
         }
 
-        stripStartIndex += _mesh.lenStrips;
+        stripStartIndex += _mesh->lenStrips;
     }
 
     return false;
@@ -2590,4 +2637,6 @@ sigc::signal<void>& Patch::signal_patchTextureChanged()
 void Patch::queueTesselationUpdate()
 {
     _tesselationChanged = true;
+
+    queueForTesselation();
 }
@@ -11,6 +11,7 @@
 #include "PatchConstants.h"
 #include "PatchControl.h"
 #include "PatchTesselation.h"
+#include "PatchTesselationCache.h"
 #include "PatchRenderables.h"
 #include "brush/FacePlane.h"
 #include "brush/Face.h"
@@ -50,8 +51,8 @@ class Patch :
 	PatchControlArray _ctrlTransformed;	// a temporary control array used during transformations, so that the
 										// changes can be reverted and overwritten by <_ctrl>
 
-	// The tesselation for this patch
-	PatchTesselation _mesh;
+	// The tesselation for this patch, possibly shared with other patches
+	PatchTesselation::Ptr _mesh;
 
 	bool _transformChanged;
 
@@ -157,7 +158,9 @@ public:
 		return _ctrl.end();
 	}
 
-	PatchTesselation& getTesselation();
+	// Returns the reference to the (updated) tesselation pointer. The pointer
+	// is replaced whenever the tesselation changes, never null.
+	const PatchTesselation::Ptr& getTesselation();
 
 	PatchRenderIndices getRenderIndices() const override;
 
@@ -328,6 +331,11 @@ public:
     void updateTesselation(bool force = false) override;
     void queueTesselationUpdate();
 
+    // Used by the PatchTesselationCache to tesselate batches of patches
+    bool tesselationIsOutdated() const;
+    PatchTesselationCache::Input getTesselationInput() const;
+    void setTesselation(const PatchTesselation::Ptr& tesselation);
+
 private:
 	// This notifies the surfaceinspector/patchinspector about the texture change
 	void textureChanged();
@@ -336,4 +344,7 @@ private:
 	void check_shader();
 
 	void updateAABB();
+
+	// Queues this patch for batch tesselation, if it is part of the scene
+	void queueForTesselation();
 };
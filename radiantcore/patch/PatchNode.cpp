@@ -307,10 +307,6 @@ void PatchNode::onInsertIntoScene(scene::IMapRootNode& root)
     // Mark the GL shader as used from now on, this is used by the TextureBrowser's filtering
     m_patch.getSurfaceShader().setInUse(true);
 
-    // When inserting a patch into the scene, it gets a parent entity assigned
-    // The colour of that entity will influence the tesselation's vertex colours
-    m_patch.queueTesselationUpdate();
-
     updateAllRenderables();
 
 	m_patch.connectUndoSystem(root.getUndoSystem());
@@ -320,6 +316,10 @@ void PatchNode::onInsertIntoScene(scene::IMapRootNode& root)
     _untransformedOrigin = worldAABB().getOrigin();
 
 	SelectableNode::onInsertIntoScene(root);
+
+    // When inserting a patch into the scene, it gets a parent entity assigned
+    // The colour of that entity will influence the tesselation's vertex colours
+    m_patch.queueTesselationUpdate();
 }
 
 void PatchNode::onRemoveFromScene(scene::IMapRootNode& root)
@@ -339,6 +339,8 @@ void PatchNode::onRemoveFromScene(scene::IMapRootNode& root)
     m_patch.getSurfaceShader().setInUse(false);
 
 	SelectableNode::onRemoveFromScene(root);
+
+    PatchTesselationCache::Instance().dequeue(m_patch);
 }
 
 bool PatchNode::getIntersection(const Ray& ray, Vector3& intersection)
@@ -348,6 +350,9 @@ bool PatchNode::getIntersection(const Ray& ray, Vector3& intersection)
 
 void PatchNode::onPreRender(const VolumeTest& volume)
 {
+    // Tesselate any larger batch of outdated patches in parallel
+    PatchTesselationCache::Instance().tesselateQueuedPatches();
+
     // Defer the tesselation calculation to the last minute
     m_patch.evaluateTransform();
     m_patch.updateTesselation();
@@ -99,14 +99,14 @@ private:
     static_assert(std::is_base_of_v<ITesselationIndexer, TesselationIndexerT>, "Indexer must implement ITesselationIndexer");
     TesselationIndexerT _indexer;
 
-    const PatchTesselation& _tess;
+    const PatchTesselation::Ptr& _tess;
     bool _needsUpdate;
 
     bool _whiteVertexColour;
 
 public:
     // When whiteVertexColour is set to true, all colour vertex attributes will be set to 1,1,1,1
-    RenderablePatchTesselation(const PatchTesselation& tess, bool whiteVertexColour) :
+    RenderablePatchTesselation(const PatchTesselation::Ptr& tess, bool whiteVertexColour) :
         _tess(tess),
         _needsUpdate(true),
         _whiteVertexColour(whiteVertexColour)
@@ -124,7 +124,7 @@ protected:
 
         _needsUpdate = false;
 
-        if (_tess.height == 0 || _tess.width == 0)
+        if (_tess->height == 0 || _tess->width == 0)
         {
             clear();
             return;
@@ -132,9 +132,9 @@ protected:
 
         // Generate the new index array
         std::vector<unsigned int> indices;
-        indices.reserve(_indexer.getNumIndices(_tess));
+        indices.reserve(_indexer.getNumIndices(*_tess));
 
-        _indexer.generateIndices(_tess, std::back_inserter(indices));
+        _indexer.generateIndices(*_tess, std::back_inserter(indices));
 
         updateGeometryWithData(_indexer.getType(), getColouredVertices(), indices);
     }
@@ -142,9 +142,9 @@ protected:
     std::vector<render::RenderVertex> getColouredVertices()
     {
         std::vector<render::RenderVertex> vertices;
-        vertices.reserve(_tess.vertices.size());
+        vertices.reserve(_tess->vertices.size());
 
-        for (const auto& vertex : _tess.vertices)
+        for (const auto& vertex : _tess->vertices)
         {
             // Copy vertex data, but set the colour to 1,1,1,1
             vertices.push_back(render::RenderVertex(vertex.vertex, vertex.normal,
@@ -837,7 +837,7 @@ void PatchTesselation::generateIndices()
 
 void PatchTesselation::generate(std::size_t patchWidth, std::size_t patchHeight,
 	const PatchControlArray& controlPoints, bool subdivionsFixed, const Subdivisions& subdivs,
-    IRenderEntity* renderEntity)
+    const Vector4& colour)
 {
 	width = patchWidth;
 	height = patchHeight;
@@ -870,7 +870,6 @@ void PatchTesselation::generate(std::size_t patchWidth, std::size_t patchHeight,
 	}
 
     // Final update: assign colours and normalise normals
-    auto colour = renderEntity ? renderEntity->getEntityColour() : Vector4(1, 1, 1, 1);
 
 	for (MeshVertex& vertex : vertices)
 	{
@@ -1,14 +1,19 @@
 #pragma once
 
+#include <memory>
 #include "render.h"
 #include "PatchControl.h"
 
 struct FaceTangents;
 
 /// Representation of a patch as mesh geometry
+/// Once generated, tesselations are immutable and can be shared between patches,
+/// see PatchTesselationCache
 class PatchTesselation
 {
 public:
+	using Ptr = std::shared_ptr<const PatchTesselation>;
+
 	// The vertex data, each vertex equipped with texcoord and ntb vectors
 	std::vector<MeshVertex> vertices;
 
@@ -44,9 +49,10 @@ public:
     /// Clear all patch data
     void clear();
 
-	// Generates the tesselated mesh based on the input parameters
+	// Generates the tesselated mesh based on the input parameters,
+	// the given colour is assigned to all vertices
 	void generate(std::size_t width, std::size_t height, const PatchControlArray& controlPoints, 
-		bool subdivionsFixed, const Subdivisions& subdivs, IRenderEntity* renderEntity);
+		bool subdivionsFixed, const Subdivisions& subdivs, const Vector4& colour);
 
 private:
 	// Private methods used for tesselation, modeled after the patch subdivision code found in idTech4
@@ -0,0 +1,243 @@
+#include "PatchTesselationCache.h"
+
+#include <future>
+#include <thread>
+#include <algorithm>
+#include "math/Hash.h"
+#include "Patch.h"
+
+namespace
+{
+    // Parallel tesselation is not worth it for fewer patches than this
+    constexpr std::size_t MinPatchesPerWorker = 32;
+
+    constexpr std::size_t MinPruneThreshold = 1024;
+
+    inline std::size_t hashDouble(double value)
+    {
+        return std::hash<double>()(value);
+    }
+}
+
+std::size_t PatchTesselationCache::Input::getHash() const
+{
+    auto hash = std::hash<std::size_t>()(width);
+
+    math::combineHash(hash, height);
+    math::combineHash(hash, subdivisionsFixed ? 1 : 0);
+    math::combineHash(hash, subdivisions.x());
+    math::combineHash(hash, subdivisions.y());
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        math::combineHash(hash, hashDouble(colour[i]));
+    }
+
+    for (const auto& ctrl : *controlPoints)
+    {
+        math::combineHash(hash, hashDouble(ctrl.vertex.x()));
+        math::combineHash(hash, hashDouble(ctrl.vertex.y()));
+        math::combineHash(hash, hashDouble(ctrl.vertex.z()));
+        math::combineHash(hash, hashDouble(ctrl.texcoord.x()));
+        math::combineHash(hash, hashDouble(ctrl.texcoord.y()));
+    }
+
+    return hash;
+}
+
+bool PatchTesselationCache::Entry::matches(const Input& input) const
+{
+    if (width != input.width || height != input.height ||
+        subdivisionsFixed != input.subdivisionsFixed || subdivisions != input.subdivisions ||
+        colour != input.colour || controlPoints.size() != input.controlPoints->size())
+    {
+        return false;
+    }
+
+    return std::equal(controlPoints.begin(), controlPoints.end(), input.controlPoints->begin(),
+        [](const PatchControl& a, const PatchControl& b)
+    {
+        return a.vertex == b.vertex && a.texcoord == b.texcoord;
+    });
+}
+
+PatchTesselationCache::PatchTesselationCache() :
+    _pruneThreshold(MinPruneThreshold),
+    _numGenerated(0),
+    _numShared(0)
+{}
+
+PatchTesselation::Ptr PatchTesselationCache::acquire(const Input& input)
+{
+    auto hash = input.getHash();
+
+    if (auto existing = findExisting(hash, input); existing)
+    {
+        return existing;
+    }
+
+    // Generate the tesselation without holding the lock
+    auto tesselation = std::make_shared<PatchTesselation>();
+    tesselation->generate(input.width, input.height, *input.controlPoints,
+        input.subdivisionsFixed, input.subdivisions, input.colour);
+
+    std::lock_guard<std::mutex> lock(_entryLock);
+
+    // Another thread might have been quicker, share its result
+    auto range = _entries.equal_range(hash);
+
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (!i->second.matches(input)) continue;
+
+        if (auto existing = i->second.tesselation.lock(); existing)
+        {
+            ++_numShared;
+            return existing;
+        }
+
+        // Re-use the expired entry
+        i->second.tesselation = tesselation;
+        ++_numGenerated;
+        return tesselation;
+    }
+
+    _entries.emplace(hash, Entry{ input.width, input.height, *input.controlPoints,
+        input.subdivisionsFixed, input.subdivisions, input.colour, tesselation });
+    ++_numGenerated;
+
+    if (_entries.size() > _pruneThreshold)
+    {
+        pruneExpiredEntries();
+    }
+
+    return tesselation;
+}
+
+PatchTesselation::Ptr PatchTesselationCache::findExisting(std::size_t hash, const Input& input)
+{
+    std::lock_guard<std::mutex> lock(_entryLock);
+
+    auto range = _entries.equal_range(hash);
+
+    for (auto i = range.first; i != range.second; ++i)
+    {
+        if (!i->second.matches(input)) continue;
+
+        if (auto existing = i->second.tesselation.lock(); existing)
+        {
+            ++_numShared;
+            return existing;
+        }
+    }
+
+    return PatchTesselation::Ptr();
+}
+
+void PatchTesselationCache::pruneExpiredEntries()
+{
+    for (auto i = _entries.begin(); i != _entries.end();)
+    {
+        if (i->second.tesselation.expired())
+        {
+            i = _entries.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    _pruneThreshold = std::max(MinPruneThreshold, _entries.size() * 2);
+}
+
+void PatchTesselationCache::queue(Patch& patch)
+{
+    _queuedPatches.insert(&patch);
+}
+
+void PatchTesselationCache::dequeue(Patch& patch)
+{
+    _queuedPatches.erase(&patch);
+}
+
+void PatchTesselationCache::tesselateQueuedPatches()
+{
+    auto numWorkers = std::min<std::size_t>(std::thread::hardware_concurrency(),
+        _queuedPatches.size() / MinPatchesPerWorker);
+
+    if (numWorkers < 2)
+    {
+        return; // the patches will tesselate themselves when needed
+    }
+
+    // Take the queue, evaluating the transforms might add patches to it again
+    std::vector<Patch*> queued(_queuedPatches.begin(), _queuedPatches.end());
+    _queuedPatches.clear();
+
+    std::vector<Patch*> patches;
+    std::vector<Input> inputs;
+
+    patches.reserve(queued.size());
+    inputs.reserve(queued.size());
+
+    // Evaluate the transforms and collect the input on this thread,
+    // the control points stay untouched until all workers are done
+    for (auto patch : queued)
+    {
+        patch->evaluateTransform();
+
+        if (!patch->isValid() || !patch->tesselationIsOutdated())
+        {
+            continue;
+        }
+
+        patches.push_back(patch);
+        inputs.push_back(patch->getTesselationInput());
+    }
+
+    std::vector<PatchTesselation::Ptr> results(patches.size());
+    std::vector<std::future<void>> workers;
+
+    auto chunkSize = (patches.size() + numWorkers - 1) / numWorkers;
+
+    for (std::size_t begin = 0; begin < patches.size(); begin += chunkSize)
+    {
+        auto end = std::min(begin + chunkSize, patches.size());
+
+        workers.emplace_back(std::async(std::launch::async, [this, &inputs, &results, begin, end]()
+        {
+            for (auto i = begin; i < end; ++i)
+            {
+                results[i] = acquire(inputs[i]);
+            }
+        }));
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    // Assign the results on this thread, this is notifying the nodes
+    for (std::size_t i = 0; i < patches.size(); ++i)
+    {
+        patches[i]->setTesselation(results[i]);
+    }
+}
+
+std::size_t PatchTesselationCache::getNumGenerated() const
+{
+    return _numGenerated;
+}
+
+std::size_t PatchTesselationCache::getNumShared() const
+{
+    return _numShared;
+}
+
+PatchTesselationCache& PatchTesselationCache::Instance()
+{
+    static PatchTesselationCache _instance;
+    return _instance;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include "PatchTesselation.h"
+
+class Patch;
+
+/**
+ * Shares the tesselations of patches with identical control nets.
+ *
+ * Tesselations are looked up by a hash of the control points, the
+ * subdivision settings and the vertex colour. The cache only keeps weak
+ * references, a tesselation is discarded as soon as the last patch using
+ * it changes shape or is destroyed.
+ *
+ * Patches with outdated tesselations are queued here as well, such that
+ * larger numbers of them (after loading a map or transforming a selection)
+ * can be tesselated on several threads before they are rendered.
+ */
+class PatchTesselationCache
+{
+public:
+    // The parameters of a tesselation request
+    struct Input
+    {
+        std::size_t width;
+        std::size_t height;
+        const PatchControlArray* controlPoints;
+        bool subdivisionsFixed;
+        Subdivisions subdivisions;
+        Vector4 colour;
+
+        std::size_t getHash() const;
+    };
+
+private:
+    struct Entry
+    {
+        std::size_t width;
+        std::size_t height;
+        PatchControlArray controlPoints;
+        bool subdivisionsFixed;
+        Subdivisions subdivisions;
+        Vector4 colour;
+
+        std::weak_ptr<const PatchTesselation> tesselation;
+
+        bool matches(const Input& input) const;
+    };
+
+    std::unordered_multimap<std::size_t, Entry> _entries;
+    std::mutex _entryLock;
+
+    // Expired entries are removed when the map grows beyond this size
+    std::size_t _pruneThreshold;
+
+    // Patches in the scene waiting for their tesselation to be updated
+    std::unordered_set<Patch*> _queuedPatches;
+
+    std::size_t _numGenerated;
+    std::size_t _numShared;
+
+public:
+    PatchTesselationCache();
+
+    // Returns the tesselation for the given input, generating it if necessary.
+    // This method is safe to be called from several threads at once.
+    PatchTesselation::Ptr acquire(const Input& input);
+
+    // Main thread only: maintains the set of patches with outdated tesselations
+    void queue(Patch& patch);
+    void dequeue(Patch& patch);
+
+    // Main thread only: if enough patches are queued, their tesselations
+    // are generated in parallel and assigned to the patches
+    void tesselateQueuedPatches();
+
+    // The number of tesselations generated and the number of requests served by a shared one
+    std::size_t getNumGenerated() const;
+    std::size_t getNumShared() const;
+
+    static PatchTesselationCache& Instance();
+
+private:
+    PatchTesselation::Ptr findExisting(std::size_t hash, const Input& input);
+    void pruneExpiredEntries();
+};
@@ -0,0 +1,174 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+
+namespace profiling
+{
+
+namespace
+{
+    void writeJsonString(std::ostream& stream, const std::string& value)
+    {
+        stream << '"';
+
+        for (auto c : value)
+        {
+            switch (c)
+            {
+            case '"': stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\r': stream << "\\r"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') <<
+                        static_cast<int>(c) << std::dec << std::setfill(' ');
+                }
+                else
+                {
+                    stream << c;
+                }
+            }
+        }
+
+        stream << '"';
+    }
+
+    // Trace timestamps are microseconds, as floating point values
+    double toMicroseconds(IProfiler::Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::micro>(duration).count();
+    }
+}
+
+Profiler::Profiler() :
+    _enabled(false),
+    _numSpans(0),
+    _numDroppedSpans(0),
+    _epoch(Clock::now()),
+    _mainThreadId(std::this_thread::get_id())
+{}
+
+bool Profiler::isEnabled() const
+{
+    return _enabled.load(std::memory_order_relaxed);
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void Profiler::recordSpan(std::string_view name, Clock::time_point start, Clock::time_point end)
+{
+    if (_numSpans.fetch_add(1) >= MaxSpans)
+    {
+        _numSpans.fetch_sub(1);
+        ++_numDroppedSpans;
+        return;
+    }
+
+    auto& buffer = getBufferForCurrentThread();
+
+    std::lock_guard<std::mutex> lock(buffer.lock);
+    buffer.spans.push_back(Span{ std::string(name), start, end });
+}
+
+void Profiler::clear()
+{
+    std::lock_guard<std::mutex> lock(_bufferLock);
+
+    for (const auto& buffer : _buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->lock);
+        buffer->spans.clear();
+    }
+
+    _numSpans = 0;
+    _numDroppedSpans = 0;
+}
+
+std::size_t Profiler::getNumRecordedSpans() const
+{
+    return _numSpans;
+}
+
+void Profiler::writeChromeTrace(std::ostream& stream) const
+{
+    std::lock_guard<std::mutex> lock(_bufferLock);
+
+    stream << "{\"traceEvents\":[" << std::endl;
+    stream << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"DarkRadiant\"}}";
+
+    stream << std::fixed << std::setprecision(3);
+
+    for (const auto& buffer : _buffers)
+    {
+        std::lock_guard<std::mutex> bufferLock(buffer->lock);
+
+        auto threadName = buffer->threadIndex == 0 ? std::string("Main") : "Thread " + std::to_string(buffer->threadIndex);
+
+        stream << "," << std::endl << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadIndex <<
+            ",\"args\":{\"name\":";
+        writeJsonString(stream, threadName);
+        stream << "}}";
+
+        // Parents need to come before their children starting at the same time
+        auto spans = buffer->spans;
+
+        std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b)
+        {
+            return a.start < b.start || (a.start == b.start && a.end > b.end);
+        });
+
+        for (const auto& span : spans)
+        {
+            stream << "," << std::endl << "{\"name\":";
+            writeJsonString(stream, span.name);
+            stream << ",\"cat\":\"darkradiant\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadIndex <<
+                ",\"ts\":" << toMicroseconds(span.start - _epoch) <<
+                ",\"dur\":" << toMicroseconds(span.end - span.start) << "}";
+        }
+    }
+
+    stream << std::endl << "],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedSpans\":" <<
+        _numDroppedSpans.load() << "}}" << std::endl;
+}
+
+Profiler::ThreadBuffer& Profiler::getBufferForCurrentThread()
+{
+    thread_local const Profiler* owner = nullptr;
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+
+    if (owner != this || !buffer)
+    {
+        std::lock_guard<std::mutex> lock(_bufferLock);
+
+        buffer = std::make_shared<ThreadBuffer>();
+        owner = this;
+
+        // The main thread gets index 0, the others are numbered in order of their first span
+        std::size_t maxIndex = 0;
+
+        for (const auto& existing : _buffers)
+        {
+            maxIndex = std::max(maxIndex, existing->threadIndex);
+        }
+
+        buffer->threadIndex = std::this_thread::get_id() == _mainThreadId ? 0 : maxIndex + 1;
+        _buffers.push_back(buffer);
+    }
+
+    return *buffer;
+}
+
+Profiler& Profiler::Instance()
+{
+    static Profiler _profiler;
+    return _profiler;
+}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "iprofiler.h"
+
+namespace profiling
+{
+
+class Profiler :
+    public IProfiler
+{
+public:
+    // Spans beyond this number are dropped (and counted) to keep the memory bounded
+    static constexpr std::size_t MaxSpans = 2000000;
+
+private:
+    struct Span
+    {
+        std::string name;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    // Each thread records into its own buffer, the lock is only contended while writing a trace
+    struct ThreadBuffer
+    {
+        std::size_t threadIndex;
+        std::mutex lock;
+        std::vector<Span> spans;
+    };
+
+    std::atomic<bool> _enabled;
+    std::atomic<std::size_t> _numSpans;
+    std::atomic<std::size_t> _numDroppedSpans;
+
+    // All thread buffers ever created, they are kept after their thread exited
+    mutable std::mutex _bufferLock;
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+
+    // Timestamps in the trace are relative to this point in time
+    Clock::time_point _epoch;
+
+    // The thread constructing the profiler, listed first in the trace
+    std::thread::id _mainThreadId;
+
+public:
+    Profiler();
+
+    bool isEnabled() const override;
+    void setEnabled(bool enabled) override;
+
+    void recordSpan(std::string_view name, Clock::time_point start, Clock::time_point end) override;
+
+    void clear() override;
+    std::size_t getNumRecordedSpans() const override;
+
+    void writeChromeTrace(std::ostream& stream) const override;
+
+    // Contains the static singleton instance of the profiler
+    static Profiler& Instance();
+
+private:
+    ThreadBuffer& getBufferForCurrentThread();
+};
+
+}
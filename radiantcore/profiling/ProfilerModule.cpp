@@ -0,0 +1,95 @@
+#include "imodule.h"
+#include "icommandsystem.h"
+#include "itextstream.h"
+#include "i18n.h"
+
+#include <fstream>
+#include "Profiler.h"
+#include "command/ExecutionFailure.h"
+#include "module/StaticModule.h"
+
+#include <fmt/format.h>
+
+namespace profiling
+{
+
+// Offers the commands to control the profiler and to export the recorded spans
+class ProfilerModule :
+    public RegisterableModule
+{
+public:
+    // RegisterableModule implementation
+    const std::string& getName() const override
+    {
+        static std::string _name("ProfilerModule");
+        return _name;
+    }
+
+    const StringSet& getDependencies() const override
+    {
+        static StringSet _dependencies;
+
+        if (_dependencies.empty())
+        {
+            _dependencies.insert(MODULE_COMMANDSYSTEM);
+        }
+
+        return _dependencies;
+    }
+
+    void initialiseModule(const IApplicationContext& ctx) override
+    {
+        GlobalCommandSystem().addCommand("StartProfiling", startProfiling);
+        GlobalCommandSystem().addCommand("StopProfiling", stopProfiling);
+        GlobalCommandSystem().addCommand("ClearProfilingSpans", clearSpans);
+
+        // WriteProfilingTrace <OutputFile>
+        GlobalCommandSystem().addCommand("WriteProfilingTrace", writeTrace, { cmd::ARGTYPE_STRING });
+    }
+
+private:
+    static void startProfiling(const cmd::ArgumentList& args)
+    {
+        Profiler::Instance().setEnabled(true);
+        rMessage() << "Profiling started" << std::endl;
+    }
+
+    static void stopProfiling(const cmd::ArgumentList& args)
+    {
+        Profiler::Instance().setEnabled(false);
+        rMessage() << "Profiling stopped, " << Profiler::Instance().getNumRecordedSpans() <<
+            " spans recorded" << std::endl;
+    }
+
+    static void clearSpans(const cmd::ArgumentList& args)
+    {
+        Profiler::Instance().clear();
+    }
+
+    static void writeTrace(const cmd::ArgumentList& args)
+    {
+        auto path = args[0].getString();
+        std::ofstream stream(path);
+
+        if (!stream)
+        {
+            throw cmd::ExecutionFailure(fmt::format(_("Could not open file for writing: {0}"), path));
+        }
+
+        Profiler::Instance().writeChromeTrace(stream);
+
+        stream.close();
+
+        if (stream.fail())
+        {
+            throw cmd::ExecutionFailure(fmt::format(_("Failure writing to file {0}"), path));
+        }
+
+        rMessage() << "Wrote " << Profiler::Instance().getNumRecordedSpans() <<
+            " profiling spans to " << path << std::endl;
+    }
+};
+
+module::StaticModuleRegistration<ProfilerModule> profilerModule;
+
+}
@@ -9,16 +9,20 @@
 #include "ideclmanager.h"
 
 #include "math/Matrix4.h"
+#include "registry/registry.h"
 #include "module/StaticModule.h"
+#include "profiling/ScopedSpan.h"
 #include "backend/GLProgramFactory.h"
 #include "backend/BuiltInShader.h"
 #include "backend/ColourShader.h"
 #include "backend/LightingModeRenderer.h"
 #include "backend/FullBrightRenderer.h"
 #include "backend/ObjectRenderer.h"
+#include "backend/glprogram/InstancedObjectProgram.h"
 #include "debugging/debugging.h"
 
 #include <functional>
+#include <fmt/format.h>
 
 namespace render
 {
@@ -170,21 +174,47 @@ IRenderResult::Ptr OpenGLRenderSystem::renderLitScene(RenderStateFlags globalFla
 
 IRenderResult::Ptr OpenGLRenderSystem::render(SceneRenderer& renderer, RenderStateFlags globalFlagsMask, const IRenderView& view)
 {
+    profiling::ScopedSpan span("OpenGLRenderSystem::render");
+
+    auto& timer = getPassTimer(renderer.getViewType());
+    timer.beginFrame();
+
+    // Everything since startFrame() has been spent in the front end
+    if (_frameStartTime != std::chrono::steady_clock::time_point())
+    {
+        timer.setCpuTime(RenderPass::FrontEnd, std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - _frameStartTime).count());
+
+        _frameStartTime = std::chrono::steady_clock::time_point();
+    }
+
     // Make sure all shaders are ready for rendering, submitting their data to the store
-    for (const auto& [_, shader] : _shaders)
     {
-        shader->prepareForRendering();
+        RenderPassTimer::Scope timing(timer, RenderPass::ShaderPreparation);
+
+        for (const auto& [_, shader] : _shaders)
+        {
+            shader->prepareForRendering();
+        }
     }
 
-    auto result = renderer.render(globalFlagsMask, view, _time);
+    auto result = renderer.render(globalFlagsMask, view, _time, timer);
 
-    renderText();
+    {
+        RenderPassTimer::Scope timing(timer, RenderPass::Text);
+        renderText();
+    }
 
     return result;
 }
 
 void OpenGLRenderSystem::startFrame()
 {
+    if (_cameraPassTimer.isEnabled())
+    {
+        _frameStartTime = std::chrono::steady_clock::now();
+    }
+
     // Prepare the storage objects
     _geometryStore.onFrameStart();
 }
@@ -216,6 +246,13 @@ void OpenGLRenderSystem::realise()
     if (shaderProgramsAvailable() && getCurrentShaderProgram() != SHADER_PROGRAM_NONE)
     {
         _glProgramFactory->realise();
+
+        // Instanced vertex attributes are available since GL 3.3
+        if (GLEW_VERSION_3_3)
+        {
+            _objectRenderer.setInstancedObjectProgram(static_cast<InstancedObjectProgram*>(
+                _glProgramFactory->getBuiltInProgram(render::ShaderProgram::InstancedObject)));
+        }
     }
 
     // Realise all shaders
@@ -248,8 +285,15 @@ void OpenGLRenderSystem::unrealise()
         getCurrentShaderProgram() != SHADER_PROGRAM_NONE)
     {
         // Unrealise the GLPrograms
+        _objectRenderer.setInstancedObjectProgram(nullptr);
         _glProgramFactory->unrealise();
     }
+
+    if (GlobalOpenGLContext().getSharedContext())
+    {
+        _cameraPassTimer.releaseQueries();
+        _orthoPassTimer.releaseQueries();
+    }
 }
 
 GLProgramFactory& OpenGLRenderSystem::getGLProgramFactory()
@@ -310,6 +354,24 @@ void OpenGLRenderSystem::extensionsInitialised()
         rWarning() << "Light rendering requires OpenGL 2.0 or newer.\n";
     }
 
+    // Persistently mapped geometry buffers need three frames in flight to
+    // avoid overwriting data the GPU is still reading
+    if (registry::getValue<bool>(RKEY_PERSISTENT_GEOMETRY_BUFFERS) &&
+        _geometryStore.getNumFrameBuffers() == 1)
+    {
+        if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage)
+        {
+            rMessage() << "[OpenGLRenderSystem] Using persistently mapped geometry buffers.\n";
+
+            _bufferObjectProvider.setPersistentMapping(true);
+            _geometryStore.setNumFrameBuffers(3);
+        }
+        else
+        {
+            rWarning() << "Persistent geometry buffers require OpenGL 4.4 or ARB_buffer_storage.\n";
+        }
+    }
+
     // Now that GL extensions are done, we can realise our shaders
     // This was previously done explicitly by the OpenGLModule after the
     // shared context was created. But we need realised shaders before
@@ -331,6 +393,27 @@ bool OpenGLRenderSystem::shaderProgramsAvailable() const
     return _shaderProgramsAvailable;
 }
 
+void OpenGLRenderSystem::setPassTimingsEnabled(bool enabled)
+{
+    _cameraPassTimer.setEnabled(enabled);
+    _orthoPassTimer.setEnabled(enabled);
+}
+
+bool OpenGLRenderSystem::getPassTimingsEnabled() const
+{
+    return _cameraPassTimer.isEnabled();
+}
+
+RenderPassTimings OpenGLRenderSystem::getPassTimings(RenderViewType viewType) const
+{
+    return viewType == RenderViewType::Camera ? _cameraPassTimer.getTimings() : _orthoPassTimer.getTimings();
+}
+
+RenderPassTimer& OpenGLRenderSystem::getPassTimer(RenderViewType viewType)
+{
+    return viewType == RenderViewType::Camera ? _cameraPassTimer : _orthoPassTimer;
+}
+
 void OpenGLRenderSystem::insertSortedState(const OpenGLStates::value_type& val) {
     _state_sorted.insert(val);
 }
@@ -406,6 +489,10 @@ void OpenGLRenderSystem::initialiseModule(const IApplicationContext& ctx)
 
     GlobalCommandSystem().addCommand("ShowRenderMemoryStats",
         sigc::mem_fun(*this, &OpenGLRenderSystem::showMemoryStats));
+    GlobalCommandSystem().addCommand("ToggleRenderPassTimings",
+        sigc::mem_fun(*this, &OpenGLRenderSystem::togglePassTimings));
+    GlobalCommandSystem().addCommand("ShowRenderPassTimings",
+        sigc::mem_fun(*this, &OpenGLRenderSystem::showPassTimings));
 }
 
 void OpenGLRenderSystem::shutdownModule()
@@ -485,6 +572,53 @@ void OpenGLRenderSystem::showMemoryStats(const cmd::ArgumentList& args)
     _geometryStore.printMemoryStats();
 }
 
+void OpenGLRenderSystem::togglePassTimings(const cmd::ArgumentList& args)
+{
+    setPassTimingsEnabled(!getPassTimingsEnabled());
+
+    rMessage() << "Render pass timings " << (getPassTimingsEnabled() ? "enabled" : "disabled") << std::endl;
+}
+
+void OpenGLRenderSystem::showPassTimings(const cmd::ArgumentList& args)
+{
+    if (!getPassTimingsEnabled())
+    {
+        rWarning() << "Render pass timings are disabled, use ToggleRenderPassTimings to enable them" << std::endl;
+        return;
+    }
+
+    auto formatTime = [](double milliseconds)
+    {
+        return milliseconds < 0 ? std::string("-") : fmt::format("{0:.3f}", milliseconds);
+    };
+
+    for (auto viewType : { RenderViewType::Camera, RenderViewType::OrthoView })
+    {
+        auto timings = getPassTimings(viewType);
+
+        rMessage() << (viewType == RenderViewType::Camera ? "Camera" : "Ortho View") <<
+            " render passes (CPU / GPU, ms):" << std::endl;
+
+        double cpuTotal = 0;
+        double gpuTotal = 0;
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(RenderPass::NumPasses); ++i)
+        {
+            auto pass = static_cast<RenderPass>(i);
+
+            if (timings.getCpuTime(pass) < 0) continue;
+
+            cpuTotal += timings.getCpuTime(pass);
+            gpuTotal += std::max(timings.getGpuTime(pass), 0.0);
+
+            rMessage() << fmt::format("  {0:<20}{1:>10} / {2}", getRenderPassName(pass),
+                formatTime(timings.getCpuTime(pass)), formatTime(timings.getGpuTime(pass))) << std::endl;
+        }
+
+        rMessage() << fmt::format("  {0:<20}{1:>10} / {2}", "Total", formatTime(cpuTotal), formatTime(gpuTotal)) << std::endl;
+    }
+}
+
 // Define the static OpenGLRenderSystem module
 module::StaticModuleRegistration<OpenGLRenderSystem> openGLRenderSystemModule;
 
@@ -3,6 +3,7 @@
 #include "irender.h"
 #include "icommandsystem.h"
 #include <sigc++/connection.h>
+#include <chrono>
 #include <map>
 #include "imodule.h"
 #include "backend/OpenGLStateManager.h"
@@ -13,6 +14,7 @@
 #include "backend/FenceSyncProvider.h"
 #include "backend/BufferObjectProvider.h"
 #include "backend/ObjectRenderer.h"
+#include "backend/RenderPassTimer.h"
 #include "render/GeometryStore.h"
 
 namespace render
@@ -75,6 +77,13 @@ class OpenGLRenderSystem final
     std::unique_ptr<SceneRenderer> _editorPreviewRenderer;
     std::unique_ptr<SceneRenderer> _lightingModeRenderer;
 
+    // Pass timings, one for each view type
+    RenderPassTimer _cameraPassTimer;
+    RenderPassTimer _orthoPassTimer;
+
+    // Set in startFrame(), to measure the front end
+    std::chrono::steady_clock::time_point _frameStartTime;
+
 public:
 	OpenGLRenderSystem();
 
@@ -108,6 +117,10 @@ public:
 	sigc::signal<void> signal_extensionsInitialised() override;
 	bool shaderProgramsAvailable() const override;
 
+    void setPassTimingsEnabled(bool enabled) override;
+    bool getPassTimingsEnabled() const override;
+    RenderPassTimings getPassTimings(RenderViewType viewType) const override;
+
 	typedef std::set<Renderable*> Renderables;
 	Renderables m_renderables;
 	mutable bool m_traverseRenderablesMutex;
@@ -144,7 +157,11 @@ private:
 
     ShaderPtr capture(const std::string& name, const std::function<OpenGLShaderPtr()>& createShader);
 
+    RenderPassTimer& getPassTimer(RenderViewType viewType);
+
     void showMemoryStats(const cmd::ArgumentList& args);
+    void togglePassTimings(const cmd::ArgumentList& args);
+    void showPassTimings(const cmd::ArgumentList& args);
 };
 
 } // namespace
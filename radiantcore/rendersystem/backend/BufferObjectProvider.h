@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <cstring>
 #include "igl.h"
 #include "igeometrystore.h"
 
@@ -20,23 +21,23 @@ private:
         GLenum _target;
         std::size_t _allocatedSize;
 
+        // Persistently mapped buffers are written through this pointer
+        bool _persistent;
+        unsigned char* _mappedMemory;
+
     public:
-        BufferObject(IBufferObject::Type type) :
+        BufferObject(IBufferObject::Type type, bool persistent) :
             _type(type),
             _buffer(0),
             _target(_type == Type::Vertex ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER),
-            _allocatedSize(0)
+            _allocatedSize(0),
+            _persistent(persistent),
+            _mappedMemory(nullptr)
         {}
 
         ~BufferObject() override
         {
-            if (_buffer != 0)
-            {
-                glDeleteBuffers(1, &_buffer);
-            }
-
-            _allocatedSize = 0;
-            _buffer = 0;
+            deleteBuffer();
         }
 
         void bind() override
@@ -56,6 +57,13 @@ private:
                 throw std::runtime_error("Buffer is too small, resize first");
             }
 
+            if (_mappedMemory != nullptr)
+            {
+                // The mapping is coherent, no need to flush anything
+                std::memcpy(_mappedMemory + offset, firstElement, numBytes);
+                return;
+            }
+
             glBufferSubData(_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(numBytes), firstElement);
             debug::assertNoGlErrors();
         }
@@ -64,6 +72,12 @@ private:
         {
             std::vector<unsigned char> data(numBytes, 255);
 
+            if (_mappedMemory != nullptr)
+            {
+                std::memcpy(data.data(), _mappedMemory + offset, numBytes);
+                return data;
+            }
+
             glGetBufferSubData(_target, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(numBytes), data.data());
             debug::assertNoGlErrors();
 
@@ -74,6 +88,12 @@ private:
         // from the old internal buffer to the new one.
         void resize(std::size_t newSize) override
         {
+            if (_persistent)
+            {
+                resizePersistent(newSize);
+                return;
+            }
+
             if (_buffer == 0)
             {
                 glGenBuffers(1, &_buffer);
@@ -96,12 +116,72 @@ private:
 
             glBindBuffer(_target, 0);
         }
+
+    private:
+        // Immutable storage cannot be resized, the buffer is replaced by a new one
+        void resizePersistent(std::size_t newSize)
+        {
+            deleteBuffer();
+
+            constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+            glGenBuffers(1, &_buffer);
+            glBindBuffer(_target, _buffer);
+
+            glBufferStorage(_target, static_cast<GLsizeiptr>(newSize), nullptr, flags);
+            debug::assertNoGlErrors();
+
+            _mappedMemory = static_cast<unsigned char*>(glMapBufferRange(_target, 0, static_cast<GLsizeiptr>(newSize), flags));
+            debug::assertNoGlErrors();
+
+            if (_mappedMemory == nullptr)
+            {
+                throw std::runtime_error("Failed to map the GL buffer object");
+            }
+
+            _allocatedSize = newSize;
+
+            glBindBuffer(_target, 0);
+        }
+
+        void deleteBuffer()
+        {
+            if (_buffer != 0)
+            {
+                if (_mappedMemory != nullptr)
+                {
+                    glBindBuffer(_target, _buffer);
+                    glUnmapBuffer(_target);
+                    glBindBuffer(_target, 0);
+                }
+
+                glDeleteBuffers(1, &_buffer);
+            }
+
+            _mappedMemory = nullptr;
+            _allocatedSize = 0;
+            _buffer = 0;
+        }
     };
 
+    bool _persistentMapping;
+
 public:
+    BufferObjectProvider() :
+        _persistentMapping(false)
+    {}
+
+    // When enabled, buffer objects created from now on use persistently mapped storage
+    // (requires GL 4.4 or ARB_buffer_storage). The client is responsible for not
+    // writing to regions the GPU is still reading, e.g. by cycling through several buffers.
+    void setPersistentMapping(bool enabled)
+    {
+        _persistentMapping = enabled;
+    }
+
     IBufferObject::Ptr createBufferObject(IBufferObject::Type type) override
     {
-        return std::make_shared<BufferObject>(type);
+        return std::make_shared<BufferObject>(type, _persistentMapping);
     }
 };
 
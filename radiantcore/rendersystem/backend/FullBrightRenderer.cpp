@@ -2,6 +2,8 @@
 
 #include "OpenGLShaderPass.h"
 #include "OpenGLShader.h"
+#include "RenderPassTimer.h"
+#include "profiling/ScopedSpan.h"
 
 namespace render
 {
@@ -14,24 +16,46 @@ class FullBrightRenderResult :
 {
 private:
     std::string _statistics;
+    IObjectRenderer::Statistics _drawStatistics;
 
 public:
-    FullBrightRenderResult(const std::string& statistics) :
-        _statistics(statistics)
+    FullBrightRenderResult(const std::string& statistics, const IObjectRenderer::Statistics& drawStatistics) :
+        _statistics(statistics),
+        _drawStatistics(drawStatistics)
     {}
 
     std::string toString() override
     {
         return _statistics;
     }
+
+    std::size_t getDrawCalls() override
+    {
+        return _drawStatistics.drawCalls;
+    }
+
+    std::size_t getInstancedDrawCalls() override
+    {
+        return _drawStatistics.instancedDrawCalls;
+    }
 };
 
 }
 
-IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, const IRenderView& view, std::size_t time)
+IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, const IRenderView& view,
+    std::size_t time, RenderPassTimer& timer)
 {
+    profiling::ScopedSpan span("FullBrightRenderer::render");
+
     // Make sure all the data is uploaded
-    _geometryStore.syncToBufferObjects();
+    {
+        RenderPassTimer::Scope timing(timer, RenderPass::GeometryUpload);
+        _geometryStore.syncToBufferObjects();
+    }
+
+    _objectRenderer.resetStatistics();
+
+    RenderPassTimer::Scope timing(timer, RenderPass::FullBright);
 
     // Construct default OpenGL state
     OpenGLState current;
@@ -65,7 +89,7 @@ IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, cons
             if (!pass->hasRenderables())
             {
                 // All regular geometry like patches, brushes, meshes, single vertices
-                pass->submitSurfaces(view);
+                pass->submitSurfaces(view, current);
             }
             else
             {
@@ -83,7 +107,7 @@ IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, cons
 
     cleanupState();
 
-    return std::make_shared<FullBrightRenderResult>(view.getCullStats());
+    return std::make_shared<FullBrightRenderResult>(view.getCullStats(), _objectRenderer.getStatistics());
 }
 
 }
@@ -24,7 +24,8 @@ public:
         _objectRenderer(objectRenderer)
     {}
 
-    IRenderResult::Ptr render(RenderStateFlags globalstate, const IRenderView& view, std::size_t time) override;
+    IRenderResult::Ptr render(RenderStateFlags globalstate, const IRenderView& view,
+        std::size_t time, RenderPassTimer& timer) override;
 };
 
 }
@@ -7,6 +7,7 @@
 #include "glprogram/ShadowMapProgram.h"
 #include "glprogram/RegularStageProgram.h"
 #include "glprogram/BlendLightProgram.h"
+#include "glprogram/InstancedObjectProgram.h"
 
 #include "irender.h"
 #include "itextstream.h"
@@ -70,6 +71,7 @@ void GLProgramFactory::realise()
     _builtInPrograms[ShaderProgram::ShadowMap] = std::make_shared<ShadowMapProgram>();
     _builtInPrograms[ShaderProgram::RegularStage] = std::make_shared<RegularStageProgram>();
     _builtInPrograms[ShaderProgram::BlendLight] = std::make_shared<BlendLightProgram>();
+    _builtInPrograms[ShaderProgram::InstancedObject] = std::make_shared<InstancedObjectProgram>();
 }
 
 // Unrealise the program factory.
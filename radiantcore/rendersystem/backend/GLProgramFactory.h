@@ -19,6 +19,7 @@ enum class ShaderProgram
     ShadowMap,
     RegularStage,
     BlendLight,
+    InstancedObject,
 };
 
 /// Factory class reponsible for creating GLProgam instances addressed by name.
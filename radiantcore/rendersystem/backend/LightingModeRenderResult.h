@@ -27,6 +27,11 @@ public:
             visibleLights, visibleLights + skippedLights, entities, objects, depthDrawCalls, 
             interactionDrawCalls, nonInteractionDrawCalls, shadowDrawCalls);
     }
+
+    std::size_t getDrawCalls() override
+    {
+        return depthDrawCalls + interactionDrawCalls + nonInteractionDrawCalls + shadowDrawCalls;
+    }
 };
 
 }
@@ -6,10 +6,12 @@
 #include "OpenGLShader.h"
 #include "ObjectRenderer.h"
 #include "OpenGLState.h"
+#include "RenderPassTimer.h"
 #include "glprogram/CubeMapProgram.h"
 #include "glprogram/DepthFillAlphaProgram.h"
 #include "glprogram/InteractionProgram.h"
 #include "glprogram/RegularStageProgram.h"
+#include "profiling/ScopedSpan.h"
 
 namespace render
 {
@@ -26,6 +28,7 @@ LightingModeRenderer::LightingModeRenderer(GLProgramFactory& programFactory,
     _entities(entities),
     _shadowMapProgram(nullptr),
     _blendLightProgram(nullptr),
+    _passTimer(nullptr),
     _shadowMappingEnabled(RKEY_ENABLE_SHADOW_MAPPING)
 {
     _untransformedObjectsWithoutAlphaTest.reserve(10000);
@@ -60,9 +63,12 @@ void LightingModeRenderer::ensureShadowMapSetup()
 }
 
 IRenderResult::Ptr LightingModeRenderer::render(RenderStateFlags globalFlagsMask, 
-    const IRenderView& view, std::size_t time)
+    const IRenderView& view, std::size_t time, RenderPassTimer& timer)
 {
+    profiling::ScopedSpan span("LightingModeRenderer::render");
+
     _result = std::make_shared<LightingModeRenderResult>();
+    _passTimer = &timer;
 
     ensureShadowMapSetup();
 
@@ -74,7 +80,10 @@ IRenderResult::Ptr LightingModeRenderer::render(RenderStateFlags globalFlagsMask
     setupState(current);
 
     // Past this point, everything in the geometry store is up to date
-    _geometryStore.syncToBufferObjects();
+    {
+        RenderPassTimer::Scope timing(timer, RenderPass::GeometryUpload);
+        _geometryStore.syncToBufferObjects();
+    }
 
     auto [vertexBuffer, indexBuffer] = _geometryStore.getBufferObjects();
 
@@ -111,12 +120,16 @@ IRenderResult::Ptr LightingModeRenderer::render(RenderStateFlags globalFlagsMask
     _regularLights.clear();
     _nearestShadowLights.clear();
     _blendLights.clear();
+    _passTimer = nullptr;
 
     return std::move(_result); // move-return our result reference
 }
 
 void LightingModeRenderer::collectLights(const IRenderView& view)
 {
+    profiling::ScopedSpan span("Collect lights");
+    RenderPassTimer::Scope timing(*_passTimer, RenderPass::LightCollection);
+
     _regularLights.reserve(_lights.size());
 
     // Categorise all visible lights
@@ -230,6 +243,9 @@ void LightingModeRenderer::addToShadowLights(RegularLight& light, const Vector3&
 void LightingModeRenderer::drawInteractingLights(OpenGLState& current, RenderStateFlags globalFlagsMask,
     const IRenderView& view, std::size_t renderTime)
 {
+    profiling::ScopedSpan span("Interaction pass");
+    RenderPassTimer::Scope timing(*_passTimer, RenderPass::Interaction);
+
     // Draw the surfaces per light and material
     auto interactionState = InteractionPass::GenerateInteractionState(_programFactory);
 
@@ -276,8 +292,12 @@ void LightingModeRenderer::drawInteractingLights(OpenGLState& current, RenderSta
 void LightingModeRenderer::drawBlendLights(OpenGLState& current, RenderStateFlags globalFlagsMask,
     const IRenderView& view, std::size_t renderTime)
 {
+    profiling::ScopedSpan span("Blend light pass");
+
     if (_blendLights.empty()) return;
 
+    RenderPassTimer::Scope timing(*_passTimer, RenderPass::BlendLight);
+
     // Set the openGL state
     auto blendLightState = OpenGLShaderPass::CreateBlendLightState(_blendLightProgram);
 
@@ -294,8 +314,12 @@ void LightingModeRenderer::drawBlendLights(OpenGLState& current, RenderStateFlag
 
 void LightingModeRenderer::drawShadowMaps(OpenGLState& current,std::size_t renderTime)
 {
+    profiling::ScopedSpan span("Shadow map pass");
+
     if (!_shadowMappingEnabled.get()) return;
 
+    RenderPassTimer::Scope timing(*_passTimer, RenderPass::ShadowMap);
+
     // Draw the shadow maps of each light
     // Save the viewport set up in the camera code
     GLint previousViewport[4];
@@ -356,6 +380,9 @@ void LightingModeRenderer::drawShadowMaps(OpenGLState& current,std::size_t rende
 void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFlags globalFlagsMask,
     const IRenderView& view, std::size_t renderTime)
 {
+    profiling::ScopedSpan span("Depth fill pass");
+    RenderPassTimer::Scope timing(*_passTimer, RenderPass::DepthFill);
+
     // Run the depth fill pass
     auto depthFillState = DepthFillPass::GenerateDepthFillState(_programFactory);
 
@@ -393,6 +420,9 @@ void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFl
 void LightingModeRenderer::drawNonInteractionPasses(OpenGLState& current, RenderStateFlags globalFlagsMask, 
     const IRenderView& view, std::size_t time)
 {
+    profiling::ScopedSpan span("Non-interaction passes");
+    RenderPassTimer::Scope timing(*_passTimer, RenderPass::NonInteraction);
+
     glUseProgram(0);
     glActiveTexture(GL_TEXTURE0);
     glClientActiveTexture(GL_TEXTURE0);
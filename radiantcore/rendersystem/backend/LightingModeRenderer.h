@@ -18,6 +18,7 @@ namespace render
 
 class GLProgramFactory;
 class LightingModeRenderResult;
+class RenderPassTimer;
 
 class LightingModeRenderer final :
     public SceneRenderer
@@ -52,6 +53,7 @@ private:
     std::vector<BlendLight> _blendLights;
 
     std::shared_ptr<LightingModeRenderResult> _result;
+    RenderPassTimer* _passTimer;
 
 public:
     LightingModeRenderer(GLProgramFactory& programFactory,
@@ -60,7 +62,8 @@ public:
         const std::set<RendererLightPtr>& lights,
         const std::set<IRenderEntityPtr>& entities);
 
-    IRenderResult::Ptr render(RenderStateFlags globalFlagsMask, const IRenderView& view, std::size_t time) override;
+    IRenderResult::Ptr render(RenderStateFlags globalFlagsMask, const IRenderView& view,
+        std::size_t time, RenderPassTimer& timer) override;
 
 private:
     void collectLights(const IRenderView& view);
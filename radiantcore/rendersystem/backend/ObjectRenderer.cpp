@@ -1,17 +1,36 @@
 #include "ObjectRenderer.h"
 
+#include <algorithm>
 #include "GLProgramAttributes.h"
 #include "irenderableobject.h"
 #include "math/Matrix4.h"
 #include "render/RenderVertex.h"
+#include "glprogram/InstancedObjectProgram.h"
+#include "debugging/gl.h"
 
 namespace render
 {
 
 ObjectRenderer::ObjectRenderer(IGeometryStore& store) :
-    _store(store)
+    _store(store),
+    _instancedObjectProgram(nullptr),
+    _instanceBuffer(0),
+    _instanceBufferSize(0)
 {}
 
+void ObjectRenderer::setInstancedObjectProgram(InstancedObjectProgram* program)
+{
+    _instancedObjectProgram = program;
+
+    // The buffer belongs to the context the program has been created in
+    if (_instancedObjectProgram == nullptr && _instanceBuffer != 0)
+    {
+        glDeleteBuffers(1, &_instanceBuffer);
+        _instanceBuffer = 0;
+        _instanceBufferSize = 0;
+    }
+}
+
 void ObjectRenderer::submitObject(IRenderableObject& object)
 {
     // Orient the object
@@ -25,6 +44,89 @@ void ObjectRenderer::submitObject(IRenderableObject& object)
     glPopMatrix();
 }
 
+void ObjectRenderer::submitInstancedObjects(IGeometryStore::Slot slot, const std::vector<const Matrix4*>& transforms, bool textured)
+{
+    if (transforms.empty()) return;
+
+    if (_instancedObjectProgram == nullptr)
+    {
+        // No instancing available, draw them one by one
+        glMatrixMode(GL_MODELVIEW);
+
+        for (auto transform : transforms)
+        {
+            glPushMatrix();
+            glMultMatrixd(*transform);
+            submitGeometry(slot, GL_TRIANGLES);
+            glPopMatrix();
+        }
+
+        return;
+    }
+
+    // Convert the transforms to single precision, column-major like the matrices themselves
+    _instanceData.resize(transforms.size() * 16);
+
+    auto target = _instanceData.data();
+
+    for (auto transform : transforms)
+    {
+        for (auto i = 0; i < 16; ++i)
+        {
+            *target++ = static_cast<float>((*transform)[i]);
+        }
+    }
+
+    auto numBytes = _instanceData.size() * sizeof(float);
+
+    if (_instanceBuffer == 0)
+    {
+        glGenBuffers(1, &_instanceBuffer);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+
+    // Grow the buffer if necessary, otherwise orphan it to avoid waiting for the previous draw
+    _instanceBufferSize = std::max(_instanceBufferSize, numBytes);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(_instanceBufferSize), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(numBytes), _instanceData.data());
+
+    // One matrix column per attribute, advancing once per instance
+    for (auto column = 0; column < 4; ++column)
+    {
+        auto offset = reinterpret_cast<const void*>(column * 4 * sizeof(float));
+
+        glVertexAttribPointer(GLProgramAttribute::ObjectTransform + column, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(float), offset);
+        glVertexAttribDivisor(GLProgramAttribute::ObjectTransform + column, 1);
+    }
+
+    _instancedObjectProgram->enable();
+    _instancedObjectProgram->setUseTexture(textured);
+
+    const auto renderParams = _store.getBufferAddresses(slot);
+
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(renderParams.indexCount),
+        GL_UNSIGNED_INT, renderParams.firstIndex, static_cast<GLsizei>(transforms.size()),
+        static_cast<GLint>(renderParams.firstVertex));
+
+    _instancedObjectProgram->disable();
+
+    for (auto column = 0; column < 4; ++column)
+    {
+        glVertexAttribDivisor(GLProgramAttribute::ObjectTransform + column, 0);
+    }
+
+    // Restore the geometry buffer binding
+    auto [vertexBuffer, _] = _store.getBufferObjects();
+    vertexBuffer->bind();
+
+    ++_statistics.drawCalls;
+    ++_statistics.instancedDrawCalls;
+    _statistics.instances += transforms.size();
+
+    debug::assertNoGlErrors();
+}
+
 void ObjectRenderer::initAttributePointers()
 {
     const RenderVertex* bufferStart = nullptr;
@@ -48,6 +150,8 @@ void ObjectRenderer::submitGeometry(IGeometryStore::Slot slot, GLenum primitiveM
 
     glDrawElementsBaseVertex(primitiveMode, static_cast<GLsizei>(renderParams.indexCount),
         GL_UNSIGNED_INT, const_cast<unsigned int*>(renderParams.firstIndex), static_cast<GLint>(renderParams.firstVertex));
+
+    ++_statistics.drawCalls;
 }
 
 void ObjectRenderer::submitInstancedGeometry(IGeometryStore::Slot slot, int numInstances, GLenum primitiveMode)
@@ -56,6 +160,8 @@ void ObjectRenderer::submitInstancedGeometry(IGeometryStore::Slot slot, int numI
 
     glDrawElementsInstancedBaseVertex(primitiveMode, static_cast<GLsizei>(renderParams.indexCount),
         GL_UNSIGNED_INT, renderParams.firstIndex, static_cast<GLint>(numInstances), static_cast<GLint>(renderParams.firstVertex));
+
+    ++_statistics.drawCalls;
 }
 
 void ObjectRenderer::submitGeometryWithCustomIndices(IGeometryStore::Slot slot, GLenum primitiveMode,
@@ -71,6 +177,8 @@ void ObjectRenderer::submitGeometryWithCustomIndices(IGeometryStore::Slot slot,
         GL_UNSIGNED_INT, const_cast<unsigned int*>(indices.data()), static_cast<GLint>(renderParams.firstVertex));
 
     indexBuffer->bind();
+
+    ++_statistics.drawCalls;
 }
 
 template<typename ContainerT>
@@ -104,12 +212,18 @@ void SubmitGeometryInternal(const ContainerT& slots, GLenum primitiveMode, IGeom
 
 void ObjectRenderer::submitGeometry(const std::set<IGeometryStore::Slot>& slots, GLenum primitiveMode)
 {
+    if (slots.empty()) return;
+
     SubmitGeometryInternal(slots, primitiveMode, _store);
+    ++_statistics.drawCalls;
 }
 
 void ObjectRenderer::submitGeometry(const std::vector<IGeometryStore::Slot>& slots, GLenum primitiveMode)
 {
+    if (slots.empty()) return;
+
     SubmitGeometryInternal(slots, primitiveMode, _store);
+    ++_statistics.drawCalls;
 }
 
 void ObjectRenderer::submitInstancedGeometry(const std::vector<IGeometryStore::Slot>& slots, int numInstances, GLenum primitiveMode)
@@ -120,4 +234,14 @@ void ObjectRenderer::submitInstancedGeometry(const std::vector<IGeometryStore::S
     }
 }
 
+const IObjectRenderer::Statistics& ObjectRenderer::getStatistics() const
+{
+    return _statistics;
+}
+
+void ObjectRenderer::resetStatistics()
+{
+    _statistics = Statistics();
+}
+
 }
@@ -8,6 +8,7 @@ namespace render
 
 class IGeometryStore;
 class IRenderableObject;
+class InstancedObjectProgram;
 
 // Helper object issuing the glDraw calls. Used by all kinds of render passes,
 // be it Depth Fill, Interaction or Blend passes.
@@ -17,15 +18,32 @@ class ObjectRenderer :
 private:
     IGeometryStore& _store;
 
+    // Program used for instanced object rendering, null if not supported
+    InstancedObjectProgram* _instancedObjectProgram;
+
+    // Buffer receiving the per-instance transforms, allocated on first use
+    GLuint _instanceBuffer;
+    std::size_t _instanceBufferSize;
+    std::vector<float> _instanceData;
+
+    Statistics _statistics;
+
 public:
     ObjectRenderer(IGeometryStore& store);
 
+    // Set by the render system once the GL programs are realised. Passing nullptr
+    // releases the instance buffer and falls back to rendering one object after the other.
+    void setInstancedObjectProgram(InstancedObjectProgram* program);
+
     // Initialise the vertex attribute pointers using the given start address (can be nullptr)
     void initAttributePointers() override;
 
     // Draws the given object, sets up transform and submits geometry
     void submitObject(IRenderableObject& object) override;
 
+    // Draws the geometry of the given slot once per transform, using a single instanced draw call
+    void submitInstancedObjects(IGeometryStore::Slot slot, const std::vector<const Matrix4*>& transforms, bool textured) override;
+
     // Draws the geometry of the given slot in the given primitive mode, no transforms
     void submitGeometry(IGeometryStore::Slot slot, GLenum primitiveMode) override;
 
@@ -43,6 +61,9 @@ public:
 
     // Draws all geometry as defined by their store IDs in the given mode, no transforms (std::vector variant)
     void submitInstancedGeometry(const std::vector<IGeometryStore::Slot>& slots, int numInstances, GLenum primitiveMode) override;
+
+    const Statistics& getStatistics() const override;
+    void resetStatistics() override;
 };
 
 }
@@ -93,7 +93,7 @@ void OpenGLShader::addRenderable(const OpenGLRenderable& renderable,
     }
 }
 
-void OpenGLShader::drawSurfaces(const VolumeTest& view)
+void OpenGLShader::drawSurfaces(const VolumeTest& view, const OpenGLState& current)
 {
     glEnableClientState(GL_VERTEX_ARRAY);
     glEnableClientState(GL_TEXTURE_COORD_ARRAY);
@@ -118,7 +118,13 @@ void OpenGLShader::drawSurfaces(const VolumeTest& view)
         // Surfaces are not allowed to render vertex colours (for now)
         // otherwise they don't show up in their parent entity's colour
         glDisableClientState(GL_COLOR_ARRAY);
-        _surfaceRenderer.render(view);
+
+        // Instancing reproduces the plain fixed-function pipeline only
+        auto flags = current.getRenderFlags();
+        auto useInstancing = current.glProgram == nullptr &&
+            (flags & (RENDER_LIGHTING | RENDER_TEXTURE_CUBEMAP | RENDER_BUMP | RENDER_PROGRAM)) == 0;
+
+        _surfaceRenderer.render(view, useInstancing, (flags & RENDER_TEXTURE_2D) != 0);
     }
 
     // Render all windings (without vertex colours)
@@ -99,7 +99,8 @@ public:
 					   const Matrix4& modelview) override;
 
     bool hasSurfaces() const;
-    void drawSurfaces(const VolumeTest& view);
+    // Draws the surfaces of this shader, current is the state applied by the calling pass
+    void drawSurfaces(const VolumeTest& view, const OpenGLState& current);
     void prepareForRendering();
 
     IGeometryRenderer::Slot addGeometry(GeometryType indexType,
@@ -80,9 +80,9 @@ void OpenGLShaderPass::addRenderable(const OpenGLRenderable& renderable,
     _transformedRenderables.emplace_back(renderable, modelview);
 }
 
-void OpenGLShaderPass::submitSurfaces(const VolumeTest& view)
+void OpenGLShaderPass::submitSurfaces(const VolumeTest& view, const OpenGLState& current)
 {
-    _owner.drawSurfaces(view);
+    _owner.drawSurfaces(view, current);
 }
 
 void OpenGLShaderPass::submitRenderables(OpenGLState& current)
@@ -103,8 +103,11 @@ public:
      *
      * \param view
      * The render view used to cull surfaces
+     *
+     * \param current
+     * The GL state as applied by evaluateStagesAndApplyState()
      */
-	void submitSurfaces(const VolumeTest& view);
+	void submitSurfaces(const VolumeTest& view, const OpenGLState& current);
 
     /**
      * \brief
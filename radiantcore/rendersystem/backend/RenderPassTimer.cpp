@@ -0,0 +1,175 @@
+#include "RenderPassTimer.h"
+
+namespace render
+{
+
+namespace
+{
+    inline double toMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+RenderPassTimer::RenderPassTimer() :
+    _enabled(false),
+    _nextQuerySet(0),
+    _activeQuerySet(nullptr)
+{}
+
+void RenderPassTimer::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+bool RenderPassTimer::isEnabled() const
+{
+    return _enabled;
+}
+
+void RenderPassTimer::beginFrame()
+{
+    _activeQuerySet = nullptr;
+
+    if (!_enabled)
+    {
+        // Clean up after being disabled, now that we have a GL context
+        if (!_querySets.empty())
+        {
+            releaseQueries();
+        }
+
+        return;
+    }
+
+    _timings.cpu.fill(-1);
+
+    if (!timerQueriesSupported()) return;
+
+    if (_querySets.empty())
+    {
+        _querySets.resize(NumQuerySets);
+
+        for (auto& querySet : _querySets)
+        {
+            glGenQueries(static_cast<GLsizei>(querySet.queries.size()), querySet.queries.data());
+        }
+    }
+
+    collectQueryResults();
+
+    auto& querySet = _querySets[_nextQuerySet];
+
+    // If the GPU didn't catch up yet, skip the queries of this frame
+    if (querySet.pending) return;
+
+    querySet.issued.fill(false);
+    querySet.lastQuery = 0;
+    querySet.pending = true;
+
+    _activeQuerySet = &querySet;
+    _nextQuerySet = (_nextQuerySet + 1) % NumQuerySets;
+}
+
+void RenderPassTimer::beginPass(RenderPass pass)
+{
+    if (!_enabled) return;
+
+    auto index = static_cast<std::size_t>(pass);
+    _passStart[index] = Clock::now();
+
+    // The front end doesn't issue any GL commands, there's nothing to measure
+    if (_activeQuerySet && pass != RenderPass::FrontEnd)
+    {
+        glQueryCounter(_activeQuerySet->queries[index * 2], GL_TIMESTAMP);
+        _activeQuerySet->issued[index] = true;
+        _activeQuerySet->lastQuery = _activeQuerySet->queries[index * 2];
+    }
+}
+
+void RenderPassTimer::endPass(RenderPass pass)
+{
+    if (!_enabled) return;
+
+    auto index = static_cast<std::size_t>(pass);
+    _timings.cpu[index] = toMilliseconds(Clock::now() - _passStart[index]);
+
+    if (_activeQuerySet && _activeQuerySet->issued[index])
+    {
+        glQueryCounter(_activeQuerySet->queries[index * 2 + 1], GL_TIMESTAMP);
+        _activeQuerySet->lastQuery = _activeQuerySet->queries[index * 2 + 1];
+    }
+}
+
+void RenderPassTimer::setCpuTime(RenderPass pass, double milliseconds)
+{
+    if (!_enabled) return;
+
+    _timings.cpu[static_cast<std::size_t>(pass)] = milliseconds;
+}
+
+const RenderPassTimings& RenderPassTimer::getTimings() const
+{
+    return _timings;
+}
+
+void RenderPassTimer::releaseQueries()
+{
+    for (auto& querySet : _querySets)
+    {
+        glDeleteQueries(static_cast<GLsizei>(querySet.queries.size()), querySet.queries.data());
+    }
+
+    _querySets.clear();
+    _nextQuerySet = 0;
+    _activeQuerySet = nullptr;
+
+    _timings.gpu.fill(-1);
+}
+
+bool RenderPassTimer::timerQueriesSupported() const
+{
+    return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+void RenderPassTimer::collectQueryResults()
+{
+    // Walk the sets from the oldest to the newest, the results
+    // become available in the order the queries have been issued
+    for (std::size_t i = 0; i < NumQuerySets; ++i)
+    {
+        auto& querySet = _querySets[(_nextQuerySet + i) % NumQuerySets];
+
+        if (!querySet.pending) continue;
+
+        // Once the query issued last in that frame is available, all of them are
+        if (querySet.lastQuery != 0)
+        {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(querySet.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (available == GL_FALSE) return;
+
+            for (std::size_t pass = 0; pass < NumPasses; ++pass)
+            {
+                if (!querySet.issued[pass])
+                {
+                    _timings.gpu[pass] = -1;
+                    continue;
+                }
+
+                GLuint64 start = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(querySet.queries[pass * 2], GL_QUERY_RESULT, &start);
+                glGetQueryObjectui64v(querySet.queries[pass * 2 + 1], GL_QUERY_RESULT, &end);
+
+                // Timestamps are in nanoseconds
+                _timings.gpu[pass] = end > start ? (end - start) / 1000000.0 : 0;
+            }
+        }
+
+        querySet.pending = false;
+    }
+}
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+#include "igl.h"
+#include "irender.h"
+
+namespace render
+{
+
+/**
+ * Measures the CPU and GPU time spent in the passes of a rendered frame.
+ * The GPU time is measured using GL_TIMESTAMP queries, whose results are
+ * read back a few frames later to not stall the pipeline.
+ *
+ * Nothing is measured (and no GL calls are made) while the timer is disabled.
+ * All methods apart from setEnabled() and getTimings() need a current GL context.
+ */
+class RenderPassTimer
+{
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::size_t NumPasses = static_cast<std::size_t>(RenderPass::NumPasses);
+
+    // Number of frames that can be in flight before the GPU queries are skipped
+    static constexpr std::size_t NumQuerySets = 4;
+
+    // The timestamp queries of a single frame, two for each pass
+    struct QuerySet
+    {
+        std::array<GLuint, NumPasses * 2> queries;
+        std::array<bool, NumPasses> issued;
+
+        // The query issued last in that frame, its result is the last one to become available
+        GLuint lastQuery = 0;
+
+        bool pending = false;
+    };
+
+    bool _enabled;
+
+    std::vector<QuerySet> _querySets;
+    std::size_t _nextQuerySet;
+
+    // The query set used in the current frame, null if no GPU queries are issued
+    QuerySet* _activeQuerySet;
+
+    std::array<Clock::time_point, NumPasses> _passStart;
+
+    RenderPassTimings _timings;
+
+public:
+    RenderPassTimer();
+
+    RenderPassTimer(const RenderPassTimer& other) = delete;
+    RenderPassTimer& operator=(const RenderPassTimer& other) = delete;
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    // Starts timing a new frame, collects the GPU results of earlier frames
+    void beginFrame();
+
+    void beginPass(RenderPass pass);
+    void endPass(RenderPass pass);
+
+    // Stores a CPU time that has been measured elsewhere
+    void setCpuTime(RenderPass pass, double milliseconds);
+
+    const RenderPassTimings& getTimings() const;
+
+    // Deletes the GL query objects
+    void releaseQueries();
+
+    // Measures the lifetime of this object as the given pass
+    class Scope
+    {
+    private:
+        RenderPassTimer& _timer;
+        RenderPass _pass;
+
+    public:
+        Scope(RenderPassTimer& timer, RenderPass pass) :
+            _timer(timer),
+            _pass(pass)
+        {
+            _timer.beginPass(_pass);
+        }
+
+        Scope(const Scope& other) = delete;
+        Scope& operator=(const Scope& other) = delete;
+
+        ~Scope()
+        {
+            _timer.endPass(_pass);
+        }
+    };
+
+private:
+    bool timerQueriesSupported() const;
+    void collectQueryResults();
+};
+
+}
@@ -7,6 +7,7 @@ namespace render
 
 class OpenGLState;
 class IRenderView;
+class RenderPassTimer;
 
 /**
  * Common base class for FullBright and LightingMode renderers.
@@ -30,7 +31,9 @@ public:
     virtual ~SceneRenderer()
     {}
 
-    virtual IRenderResult::Ptr render(RenderStateFlags globalstate, const IRenderView& view, std::size_t time) = 0;
+    // Renders the scene, measuring the passes using the given timer
+    virtual IRenderResult::Ptr render(RenderStateFlags globalstate, const IRenderView& view,
+        std::size_t time, RenderPassTimer& timer) = 0;
 
     RenderViewType getViewType() const
     {
@@ -2,10 +2,12 @@
 
 #include <map>
 #include <stdexcept>
+#include <unordered_map>
 #include "irender.h"
 #include "isurfacerenderer.h"
 #include "igeometrystore.h"
 #include "iobjectrenderer.h"
+#include "math/Hash.h"
 
 namespace render
 {
@@ -31,6 +33,28 @@ private:
     };
     std::map<Slot, SurfaceInfo> _surfaces;
 
+    // Surfaces with identical vertices and indices (like the same model
+    // placed several times) share their storage in the geometry store
+    struct SharedGeometry
+    {
+        std::size_t hash;
+        std::size_t numUsers;
+
+        // The surface new users are compared against, or InvalidSlot if it
+        // has been removed, in which case no more users can join
+        Slot representative;
+    };
+    std::map<IGeometryStore::Slot, SharedGeometry> _geometry;
+    std::unordered_multimap<std::size_t, IGeometryStore::Slot> _geometryByHash;
+
+    // Surfaces sharing the same storage are drawn in one instanced call,
+    // starting from this number of visible instances
+    static constexpr std::size_t MinInstanceCount = 2;
+
+    // Visible surfaces of the current frame, sorted by storage to find the instances
+    std::vector<std::pair<IGeometryStore::Slot, IRenderableSurface*>> _visibleSurfaces;
+    std::vector<const Matrix4*> _instanceTransforms;
+
     Slot _freeSlotMappingHint;
 
     std::vector<Slot> _surfacesNeedingUpdate;
@@ -54,15 +78,9 @@ public:
         // Find a free slot
         auto newSlotIndex = getNextFreeSlotIndex();
 
-        const auto& vertices = surface.getVertices();
-        const auto& indices = surface.getIndices();
-
-        auto slot = _store.allocateSlot(vertices.size(), indices.size());
+        auto storageHandle = acquireGeometry(newSlotIndex, surface);
 
-        // Transform the vertices to single precision
-        _store.updateData(slot, ConvertToRenderVertices(vertices), indices);
-
-        _surfaces.emplace(newSlotIndex, SurfaceInfo(surface, slot));
+        _surfaces.emplace(newSlotIndex, SurfaceInfo(surface, storageHandle));
 
         return newSlotIndex;
     }
@@ -72,8 +90,8 @@ public:
         auto surface = _surfaces.find(slot);
         assert(surface != _surfaces.end());
 
-        // Deallocate the storage
-        _store.deallocateSlot(surface->second.storageHandle);
+        // Deallocate the storage if this was the last user
+        releaseGeometry(slot, surface->second.storageHandle);
         _surfaces.erase(surface);
 
         if (slot < _freeSlotMappingHint)
@@ -89,11 +107,65 @@ public:
         _surfacesNeedUpdate = true;
     }
 
-    void render(const VolumeTest& view)
+    // Renders all visible surfaces. If instancing is enabled, surfaces sharing
+    // their geometry are submitted together (this is only possible in passes
+    // without GLSL program and lighting).
+    void render(const VolumeTest& view, bool useInstancing, bool textured)
     {
-        for (auto& surface : _surfaces)
+        if (!useInstancing)
+        {
+            for (auto& surface : _surfaces)
+            {
+                renderSlot(surface.second, &view);
+            }
+
+            return;
+        }
+
+        _visibleSurfaces.clear();
+
+        for (auto& [_, info] : _surfaces)
+        {
+            auto& surface = info.surface.get();
+
+            if (view.TestAABB(surface.getObjectBounds(), surface.getObjectTransform()) == VOLUME_OUTSIDE)
+            {
+                continue;
+            }
+
+            if (info.surfaceDataChanged)
+            {
+                throw std::logic_error("Cannot render unprepared slot, ensure calling SurfaceRenderer::prepareForRendering first");
+            }
+
+            _visibleSurfaces.emplace_back(info.storageHandle, &surface);
+        }
+
+        std::stable_sort(_visibleSurfaces.begin(), _visibleSurfaces.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        for (auto first = _visibleSurfaces.begin(); first != _visibleSurfaces.end();)
         {
-            renderSlot(surface.second, &view);
+            auto storageHandle = first->first;
+            auto last = std::find_if(first, _visibleSurfaces.end(), [&](const auto& s) { return s.first != storageHandle; });
+
+            if (static_cast<std::size_t>(last - first) < MinInstanceCount)
+            {
+                _renderer.submitObject(*first->second);
+                first = last;
+                continue;
+            }
+
+            _instanceTransforms.clear();
+
+            for (auto i = first; i != last; ++i)
+            {
+                _instanceTransforms.push_back(&i->second->getObjectTransform());
+            }
+
+            _renderer.submitInstancedObjects(storageHandle, _instanceTransforms, textured);
+
+            first = last;
         }
     }
 
@@ -127,7 +199,25 @@ public:
                 surfaceInfo.surfaceDataChanged = false;
 
                 auto& surface = surfaceInfo.surface.get();
-                _store.updateData(surfaceInfo.storageHandle, ConvertToRenderVertices(surface.getVertices()), surface.getIndices());
+                auto& geometry = _geometry.at(surfaceInfo.storageHandle);
+
+                if (geometry.numUsers == 1)
+                {
+                    // Not shared, the data can be replaced in place
+                    unregisterGeometryHash(surfaceInfo.storageHandle, geometry);
+
+                    _store.updateData(surfaceInfo.storageHandle, ConvertToRenderVertices(surface.getVertices()), surface.getIndices());
+
+                    geometry.hash = CalculateGeometryHash(surface);
+                    geometry.representative = slotIndex;
+                    _geometryByHash.emplace(geometry.hash, surfaceInfo.storageHandle);
+                }
+                else
+                {
+                    // Leave the shared storage, this might join another one
+                    releaseGeometry(slotIndex, surfaceInfo.storageHandle);
+                    surfaceInfo.storageHandle = acquireGeometry(slotIndex, surface);
+                }
             }
         }
 
@@ -149,6 +239,112 @@ private:
         return transformedVertices;
     }
 
+    static std::size_t CalculateGeometryHash(IRenderableSurface& surface)
+    {
+        const auto& vertices = surface.getVertices();
+        const auto& indices = surface.getIndices();
+
+        auto hash = vertices.size();
+        math::combineHash(hash, indices.size());
+
+        for (const auto& vertex : vertices)
+        {
+            math::combineHash(hash, std::hash<double>()(vertex.vertex.x()));
+            math::combineHash(hash, std::hash<double>()(vertex.vertex.y()));
+            math::combineHash(hash, std::hash<double>()(vertex.vertex.z()));
+            math::combineHash(hash, std::hash<double>()(vertex.texcoord.x()));
+            math::combineHash(hash, std::hash<double>()(vertex.texcoord.y()));
+        }
+
+        for (auto index : indices)
+        {
+            math::combineHash(hash, index);
+        }
+
+        return hash;
+    }
+
+    static bool HasSameGeometry(IRenderableSurface& a, IRenderableSurface& b)
+    {
+        if (a.getIndices() != b.getIndices()) return false;
+
+        const auto& verticesA = a.getVertices();
+        const auto& verticesB = b.getVertices();
+
+        return &verticesA == &verticesB || std::equal(verticesA.begin(), verticesA.end(), verticesB.begin(), verticesB.end(),
+            [](const MeshVertex& v1, const MeshVertex& v2)
+        {
+            return v1 == v2 && v1.colour == v2.colour && v1.tangent == v2.tangent && v1.bitangent == v2.bitangent;
+        });
+    }
+
+    // Returns the storage handle of existing identical geometry, or allocates a new one
+    IGeometryStore::Slot acquireGeometry(Slot slotIndex, IRenderableSurface& surface)
+    {
+        auto hash = CalculateGeometryHash(surface);
+        auto [first, last] = _geometryByHash.equal_range(hash);
+
+        for (auto i = first; i != last; ++i)
+        {
+            auto& geometry = _geometry.at(i->second);
+
+            if (HasSameGeometry(_surfaces.at(geometry.representative).surface.get(), surface))
+            {
+                ++geometry.numUsers;
+                return i->second;
+            }
+        }
+
+        const auto& vertices = surface.getVertices();
+        const auto& indices = surface.getIndices();
+
+        auto storageHandle = _store.allocateSlot(vertices.size(), indices.size());
+
+        // Transform the vertices to single precision
+        _store.updateData(storageHandle, ConvertToRenderVertices(vertices), indices);
+
+        _geometry.emplace(storageHandle, SharedGeometry{ hash, 1, slotIndex });
+        _geometryByHash.emplace(hash, storageHandle);
+
+        return storageHandle;
+    }
+
+    void releaseGeometry(Slot slotIndex, IGeometryStore::Slot storageHandle)
+    {
+        auto found = _geometry.find(storageHandle);
+        assert(found != _geometry.end());
+
+        auto& geometry = found->second;
+
+        if (geometry.representative == slotIndex)
+        {
+            // Surfaces still using this storage can't be compared against anymore
+            unregisterGeometryHash(storageHandle, geometry);
+        }
+
+        if (--geometry.numUsers == 0)
+        {
+            _store.deallocateSlot(storageHandle);
+            _geometry.erase(found);
+        }
+    }
+
+    void unregisterGeometryHash(IGeometryStore::Slot storageHandle, SharedGeometry& geometry)
+    {
+        geometry.representative = InvalidSlot;
+
+        auto [first, last] = _geometryByHash.equal_range(geometry.hash);
+
+        for (auto i = first; i != last; ++i)
+        {
+            if (i->second == storageHandle)
+            {
+                _geometryByHash.erase(i);
+                break;
+            }
+        }
+    }
+
     void renderSlot(SurfaceInfo& slot, const VolumeTest* view = nullptr)
     {
         auto& surface = slot.surface.get();
@@ -0,0 +1,70 @@
+#include "InstancedObjectProgram.h"
+
+#include "GLProgramAttributes.h"
+#include "../GLProgramFactory.h"
+#include "debugging/gl.h"
+
+#include "itextstream.h"
+
+namespace render
+{
+
+namespace
+{
+    const char* INSTANCED_OBJECT_VP_FILENAME = "instanced_object_vp.glsl";
+    const char* INSTANCED_OBJECT_FP_FILENAME = "instanced_object_fp.glsl";
+}
+
+InstancedObjectProgram::InstancedObjectProgram()
+{
+    // Create the program object
+    rMessage() << "[renderer] Creating GLSL instanced object program" << std::endl;
+
+    _programObj = GLProgramFactory::createGLSLProgram(
+        INSTANCED_OBJECT_VP_FILENAME, INSTANCED_OBJECT_FP_FILENAME
+    );
+
+    // The matrix occupies four consecutive attribute locations
+    glBindAttribLocation(_programObj, GLProgramAttribute::ObjectTransform, "attr_ObjectTransform");
+
+    glLinkProgram(_programObj);
+
+    debug::assertNoGlErrors();
+
+    _locUseTexture = glGetUniformLocation(_programObj, "u_UseTexture");
+
+    glUseProgram(_programObj);
+    debug::assertNoGlErrors();
+
+    auto samplerLoc = glGetUniformLocation(_programObj, "u_Diffuse");
+    glUniform1i(samplerLoc, 0);
+
+    debug::assertNoGlErrors();
+}
+
+void InstancedObjectProgram::enable()
+{
+    GLSLProgramBase::enable();
+
+    for (auto column = 0; column < 4; ++column)
+    {
+        glEnableVertexAttribArray(GLProgramAttribute::ObjectTransform + column);
+    }
+}
+
+void InstancedObjectProgram::disable()
+{
+    GLSLProgramBase::disable();
+
+    for (auto column = 0; column < 4; ++column)
+    {
+        glDisableVertexAttribArray(GLProgramAttribute::ObjectTransform + column);
+    }
+}
+
+void InstancedObjectProgram::setUseTexture(bool useTexture)
+{
+    glUniform1i(_locUseTexture, useTexture ? 1 : 0);
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "GLSLProgramBase.h"
+
+namespace render
+{
+
+/**
+ * Program drawing several instances of the same geometry, each with its
+ * own object transform read from an instanced vertex attribute.
+ * Apart from that it reproduces the fixed-function pipeline used by
+ * the editor passes (pass colour and optional texture on unit 0).
+ */
+class InstancedObjectProgram :
+    public GLSLProgramBase
+{
+private:
+    int _locUseTexture = -1;
+
+public:
+    InstancedObjectProgram();
+
+    void enable() override;
+    void disable() override;
+
+    void setUseTexture(bool useTexture);
+};
+
+}
@@ -11,6 +11,7 @@
 #include "SceneGraphFactory.h"
 #include "util/ScopedBoolLock.h"
 #include "module/StaticModule.h"
+#include "profiling/ScopedSpan.h"
 
 namespace scene
 {
@@ -203,6 +204,8 @@ void SceneGraph::nodeBoundsChanged(const INodePtr& node)
 
 void SceneGraph::foreachNode(const INode::VisitorFunc& functor)
 {
+	profiling::ScopedSpan span("SceneGraph::foreachNode");
+
 	if (!_root) return;
 
 	// First hit the root node
@@ -242,6 +245,8 @@ void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, const INod
 
 void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden)
 {
+    profiling::ScopedSpan span("SceneGraph::foreachNodeInVolume");
+
     // Acquire the worldAABB() of the scenegraph root - if any node got changed in the graph
     // the scenegraph's root bounds are marked as "dirty" and the bounds will be re-calculated
     // which in turn might trigger a re-link in the Octree. We want to avoid that the Octree
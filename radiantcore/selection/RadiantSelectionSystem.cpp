@@ -476,11 +476,22 @@ scene::INodePtr RadiantSelectionSystem::penultimateSelected()
 // Deselect or select all the instances in the scenegraph and notify the manipulator class as well
 void RadiantSelectionSystem::setSelectedAll(bool selected)
 {
-	GlobalSceneGraph().foreachNode([&] (const scene::INodePtr& node)->bool
-	{
-		Node_setSelected(node, selected);
-		return true;
-	});
+    if (!selected)
+    {
+        // Every selected node is in the list, no need to walk the whole scene
+        _selection.foreach([&](const scene::INodePtr& node)
+        {
+            Node_setSelected(node, false);
+        });
+    }
+    else
+    {
+        GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)->bool
+        {
+            Node_setSelected(node, true);
+            return true;
+        });
+    }
 
     _activeManipulator->setSelected(selected);
 }
@@ -514,46 +525,40 @@ void RadiantSelectionSystem::setSelectedAllComponents(bool selected)
 // Traverse the current selection components and visit them with the given visitor class
 void RadiantSelectionSystem::foreachSelectedComponent(const Visitor& visitor)
 {
-    for (auto i = _componentSelection.begin(); i != _componentSelection.end(); /* in-loop increment */)
+    _componentSelection.foreach([&](const scene::INodePtr& node)
     {
-        visitor.visit((i++)->first);
-    }
+        visitor.visit(node);
+    });
 }
 
 void RadiantSelectionSystem::foreachSelected(const std::function<void(const scene::INodePtr&)>& functor)
 {
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
-    {
-        functor((i++)->first);
-    }
+	_selection.foreach(functor);
 }
 
 void RadiantSelectionSystem::foreachSelectedComponent(const std::function<void(const scene::INodePtr&)>& functor)
 {
-	for (auto i = _componentSelection.begin(); i != _componentSelection.end(); /* in-loop increment */)
-    {
-        functor((i++)->first);
-    }
+	_componentSelection.foreach(functor);
 }
 
 void RadiantSelectionSystem::foreachBrush(const std::function<void(Brush&)>& functor)
 {
 	BrushSelectionWalker walker(functor);
 
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
+	_selection.foreach([&](const scene::INodePtr& node)
     {
-		walker.visit((i++)->first); // Handles group nodes recursively
-    }
+		walker.visit(node); // Handles group nodes recursively
+    });
 }
 
 void RadiantSelectionSystem::foreachFace(const std::function<void(IFace&)>& functor)
 {
 	FaceSelectionWalker walker(functor);
 
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
+	_selection.foreach([&](const scene::INodePtr& node)
     {
-		walker.visit((i++)->first); // Handles group nodes recursively
-    }
+		walker.visit(node); // Handles group nodes recursively
+    });
 
 	// Handle the component selection too
 	algorithm::forEachSelectedFaceComponent(functor);
@@ -563,10 +568,10 @@ void RadiantSelectionSystem::foreachPatch(const std::function<void(IPatch&)>& fu
 {
 	PatchSelectionWalker walker(functor);
 
-	for (auto i = _selection.begin(); i != _selection.end(); /* in-loop increment */)
+	_selection.foreach([&](const scene::INodePtr& node)
     {
-		walker.visit((i++)->first); // Handles group nodes recursively
-    }
+		walker.visit(node); // Handles group nodes recursively
+    });
 }
 
 std::size_t RadiantSelectionSystem::getSelectedFaceCount()
@@ -1065,18 +1070,13 @@ void RadiantSelectionSystem::shutdownModule()
 	// selectable node a chance to remove itself from the container by setting
 	// its own selected state to false (rather than waiting for this to happen
 	// in its destructor).
-    for (auto i = _selection.begin(); i != _selection.end(); )
+    _selection.foreach([](const scene::INodePtr& node)
     {
-        // Take a reference to the node and increment the iterator while the
-        // iterator is still valid.
-        scene::INodePtr node = (i++)->first;
-
-        // If this is a selectable node, unselect it (which might remove it from
-        // the map and invalidate the original iterator)
+        // If this is a selectable node, unselect it (which will remove it from the list)
         auto selectable = scene::node_cast<ISelectable>(node);
         if (selectable)
             selectable->setSelected(false);
-    }
+    });
 
     // Clear the list of anything which remains.
 	_selection.clear();
@@ -5,6 +5,7 @@
 #include "iselectiontest.h"
 #include "icommandsystem.h"
 #include "imap.h"
+#include <map>
 
 #include "selectionlib.h"
 #include "SelectedNodeList.h"
@@ -1,7 +1,10 @@
 #include "SceneSelectionTesters.h"
 
 #include "iscenegraph.h"
+#include "iorthoview.h"
+#include "registry/registry.h"
 #include "SelectionTestWalkers.h"
+#include "SelectionCandidateList.h"
 #include "selection/EntitiesFirstSelector.h"
 #include "selection/SelectionPool.h"
 
@@ -25,6 +28,35 @@ void SelectionTesterBase::testNode(const scene::INodePtr& node, SelectionTestWal
     }
 }
 
+void SelectionTesterBase::testVisibleNodesInVolume(const VolumeTest& view, SelectionTest& test,
+    Selector& selector, SelectionTestWalker& tester)
+{
+    if (!registry::getValue<bool>(RKEY_PARALLEL_SELECTION_TESTS))
+    {
+        GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+        {
+            testNode(node, tester);
+            return true;
+        });
+
+        return;
+    }
+
+    // Traverse the octree first, collecting the nodes to test
+    SelectionCandidateList candidates;
+    tester.setCandidateList(&candidates);
+
+    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+    {
+        testNode(node, tester);
+        return true;
+    });
+
+    tester.setCandidateList(nullptr);
+
+    candidates.testSelect(selector, test);
+}
+
 bool SelectionTesterBase::hasSelectables() const
 {
     return !_selectables.empty();
@@ -76,11 +108,7 @@ void PrimitiveSelectionTester::testSelectSceneWithFilter(const VolumeTest& view,
         static_cast<Selector&>(sortedPool) : simplePool;
 
     AnySelector anyTester(targetPool, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
-    {
-        testNode(node, anyTester);
-        return true;
-    });
+    testVisibleNodesInVolume(view, test, targetPool, anyTester);
 
     storeSelectablesInPool(targetPool, predicate);
 }
@@ -100,11 +128,7 @@ void EntitySelectionTester::testSelectSceneWithFilter(const VolumeTest& view, Se
     SelectionPool selector;
 
     EntitySelector tester(selector, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
-    {
-        testNode(node, tester);
-        return true;
-    });
+    testVisibleNodesInVolume(view, test, selector, tester);
 
     storeSelectablesInPool(selector, predicate);
 }
@@ -119,11 +143,7 @@ void GroupChildPrimitiveSelectionTester::testSelectSceneWithFilter(const VolumeT
     SelectionPool selector;
 
     GroupChildPrimitiveSelector tester(selector, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
-    {
-        testNode(node, tester);
-        return true;
-    });
+    testVisibleNodesInVolume(view, test, selector, tester);
 
     storeSelectablesInPool(selector, predicate);
 }
@@ -138,11 +158,7 @@ void MergeActionSelectionTester::testSelectSceneWithFilter(const VolumeTest& vie
     SelectionPool selector;
 
     MergeActionSelector tester(selector, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
-    {
-        testNode(node, tester);
-        return true;
-    });
+    testVisibleNodesInVolume(view, test, selector, tester);
 
     storeSelectablesInPool(selector, predicate);
 }
@@ -34,6 +34,12 @@ protected:
     // tester only if it passed the predicate passed to the constructor
     void testNode(const scene::INodePtr& node, SelectionTestWalker& tester);
 
+    // Tests all visible nodes in the given volume using the given walker, the results
+    // are submitted to the selector the walker has been constructed with.
+    // The tests are distributed across several threads if enabled in the preferences.
+    void testVisibleNodesInVolume(const VolumeTest& view, SelectionTest& test,
+        Selector& selector, SelectionTestWalker& tester);
+
     bool nodeIsEligible(const scene::INodePtr& node) const;
 
     void storeSelectablesInPool(Selector& selector, const std::function<bool(ISelectable*)>& predicate);
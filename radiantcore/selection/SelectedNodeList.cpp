@@ -1,119 +1,166 @@
 #include "SelectedNodeList.h"
 
-const scene::INodePtr& SelectedNodeList::ultimate() {
-	if (size() == 0) {
-		return end()->first; // return invalid iterator
-	}
+#include <cassert>
 
-	std::size_t latestTime(0);
-	iterator latest;
+namespace
+{
+	const scene::INodePtr _emptyNode;
+}
 
-	for (iterator i = begin(); i != end(); i++) {
-		if (i->second > latestTime) {
-			latestTime = i->second;
-			latest = i;
+const scene::INodePtr& SelectedNodeList::ultimate() const
+{
+	// Trailing gaps are removed after erase, unless we're iterating
+	for (auto i = _entries.rbegin(); i != _entries.rend(); ++i)
+	{
+		if (i->node)
+		{
+			return i->node;
 		}
 	}
 
-	return latest->first;
+	return _emptyNode;
 }
 
-const scene::INodePtr& SelectedNodeList::ultimate() const {
-	if (size() == 0) {
-		return end()->first; // return invalid iterator
+const scene::INodePtr& SelectedNodeList::penultimate() const
+{
+	if (_size <= 1)
+	{
+		return _emptyNode;
 	}
 
-	std::size_t latestTime(0);
-	const_iterator latest;
+	bool ultimateFound = false;
+
+	for (auto i = _entries.rbegin(); i != _entries.rend(); ++i)
+	{
+		if (!i->node) continue;
 
-	for (const_iterator i = begin(); i != end(); i++) {
-		if (i->second > latestTime) {
-			latestTime = i->second;
-			latest = i;
+		if (ultimateFound)
+		{
+			return i->node;
 		}
+
+		ultimateFound = true;
 	}
 
-	return latest->first;
+	return _emptyNode;
 }
 
-const scene::INodePtr& SelectedNodeList::penultimate() const {
-	if (size() <= 1) {
-		return end()->first; // return invalid iterator
+void SelectedNodeList::append(const scene::INodePtr& selected)
+{
+	auto [existing, inserted] = _index.try_emplace(selected.get(), _entries.size());
+
+	std::size_t previous = InvalidIndex;
+
+	if (!inserted)
+	{
+		// This node is already in the list, chain the new entry to the previous one
+		previous = existing->second;
+		existing->second = _entries.size();
 	}
 
-	std::size_t ultimateTime(0);
-	std::size_t penUltimateTime(0);
-	const_iterator ultimate;
-	const_iterator penUltimate;
+	_entries.push_back(Entry{ selected, previous });
+	++_size;
+}
+
+void SelectedNodeList::erase(const scene::INodePtr& selected)
+{
+	auto found = _index.find(selected.get());
 
-	for (const_iterator i = begin(); i != end(); i++) {
-		if (i->second > ultimateTime) {
-			penUltimateTime = ultimateTime;
-			penUltimate = ultimate;
+	assert(found != _index.end());
 
-			ultimateTime = i->second;
-			ultimate = i;
-		}
-		else if (i->second > penUltimateTime) {
-			penUltimateTime = i->second;
-			penUltimate = i;
-		}
+	if (found == _index.end()) return;
+
+	// Remove the entry inserted last, leave the others
+	auto& entry = _entries[found->second];
+
+	if (entry.previous != InvalidIndex)
+	{
+		found->second = entry.previous;
+	}
+	else
+	{
+		_index.erase(found);
 	}
 
-	return penUltimate->first;
-}
+	entry.node.reset();
+	--_size;
 
-const scene::INodePtr& SelectedNodeList::penultimate() {
-	if (size() <= 1) {
-		return end()->first; // return invalid iterator
+	// Entries must stay in place while iterating, foreach() cleans up afterwards
+	if (_iterationDepth == 0)
+	{
+		removeGaps();
 	}
+}
 
-	std::size_t ultimateTime(0);
-	std::size_t penUltimateTime(0);
-	iterator ultimate;
-	iterator penUltimate;
+void SelectedNodeList::clear()
+{
+	assert(_iterationDepth == 0);
 
-	for (iterator i = begin(); i != end(); i++) {
-		if (i->second > ultimateTime) {
-			penUltimateTime = ultimateTime;
-			penUltimate = ultimate;
+	_entries.clear();
+	_index.clear();
+	_size = 0;
+}
 
-			ultimateTime = i->second;
-			ultimate = i;
-		}
-		else if (i->second > penUltimateTime) {
-			penUltimateTime = i->second;
-			penUltimate = i;
-		}
+void SelectedNodeList::foreach(const std::function<void(const scene::INodePtr&)>& functor)
+{
+	++_iterationDepth;
+
+	// Nodes appended by the functor are not visited
+	auto count = _entries.size();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		if (!_entries[i].node) continue;
+
+		// Copy the reference, the functor might erase this entry or grow the vector
+		scene::INodePtr node = _entries[i].node;
+		functor(node);
 	}
 
-	return penUltimate->first;
+	if (--_iterationDepth == 0)
+	{
+		// Get rid of the gaps which have been left during iteration
+		removeGaps();
+	}
 }
 
-void SelectedNodeList::append(const scene::INodePtr& selected) {
-	time++;
-	MapType::insert(value_type(selected, time));
-}
+void SelectedNodeList::removeGaps()
+{
+	// Trailing gaps can be dropped right away, ultimate() will find its node quickly
+	while (!_entries.empty() && !_entries.back().node)
+	{
+		_entries.pop_back();
+	}
 
-void SelectedNodeList::erase(const scene::INodePtr& selected) {
-	iterator last;
-	std::size_t lastTime(0);
+	// Compact the array once it's more than half empty
+	if (_entries.size() <= 16 || _size >= _entries.size() / 2)
+	{
+		return;
+	}
 
-	// Lookup the instance selected last
-	for (iterator it = MapType::find(selected);
-		 it != upper_bound(selected) && it != end();
-		 it++)
+	std::vector<std::size_t> newIndices(_entries.size(), InvalidIndex);
+	std::size_t target = 0;
+
+	for (std::size_t i = 0; i < _entries.size(); ++i)
 	{
-		if (it->second > lastTime) {
-			last = it;
-			lastTime = it->second;
+		if (!_entries[i].node) continue;
+
+		newIndices[i] = target;
+
+		auto& entry = _entries[target++];
+		entry = std::move(_entries[i]);
+
+		if (entry.previous != InvalidIndex)
+		{
+			// Previous entries of the same node are always in front of this one
+			entry.previous = newIndices[entry.previous];
 		}
 	}
 
-	assert(last != end());
+	_entries.resize(target);
 
-	// Remove the element selected last, leave the others
-	MapType::erase(last);
+	for (auto& pair : _index)
+	{
+		pair.second = newIndices[pair.second];
+	}
 }
-
-std::size_t SelectedNodeList::time = 1;
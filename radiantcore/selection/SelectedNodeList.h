@@ -1,49 +1,79 @@
 #ifndef SELECTEDNODELIST_H_
 #define SELECTEDNODELIST_H_
 
-#include <map>
+#include <vector>
+#include <unordered_map>
+#include <functional>
 #include "inode.h"
 
 /**
- * greebo: This container adapts a std::multimap to keep track of
- * all the selected nodes in the scene. Additionally,
- * the insertion order is remembered to allow for retrieval
+ * greebo: This container keeps track of all the selected nodes in the
+ * scene, remembering their insertion order to allow for retrieval
  * of the ultimate/penultimate selected node.
  *
  * It also allows for the same node occuring multiple times in
- * the map at once. On deletion, the node which has been added
+ * the list at once. On deletion, the node which has been added
  * latest is removed.
  *
- * It is not as fast when inserting new elements as std::list but
- * allows for fast lookup of arbitrary nodes.
- *
- * Also, the map interface is extended by the penultimate() accessor
- * which is needed by the RadiantSelectionSystem.
+ * The nodes are stored in a dense array in insertion order, an index
+ * keyed by node address makes append, erase and contains run in
+ * constant time. Erased entries are left as gaps that are compacted
+ * once they make up more than half of the array (never during iteration).
  */
-class SelectedNodeList :
-	public std::multimap<scene::INodePtr, std::size_t>
+class SelectedNodeList
 {
-	// Shortcut typedef
-	typedef std::multimap<scene::INodePtr, std::size_t> MapType;
+private:
+	static constexpr std::size_t InvalidIndex = static_cast<std::size_t>(-1);
+
+	struct Entry
+	{
+		// Empty if this entry has been erased
+		scene::INodePtr node;
+
+		// The index of the previous entry of the same node (or InvalidIndex)
+		std::size_t previous;
+	};
+
+	// All entries in insertion order, including gaps
+	std::vector<Entry> _entries;
+
+	// Maps each node to the index of its latest entry
+	std::unordered_map<scene::INode*, std::size_t> _index;
+
+	// Number of non-empty entries
+	std::size_t _size = 0;
+
+	// Greater than zero while foreach() is running
+	std::size_t _iterationDepth = 0;
 
-	// This is an ever-incrementing counter, some sort of "insertion time"
-	static std::size_t time;
 public:
+	std::size_t size() const
+	{
+		return _size;
+	}
+
+	bool empty() const
+	{
+		return _size == 0;
+	}
+
+	// Returns true if the given node is part of this list
+	bool contains(const scene::INodePtr& node) const
+	{
+		return _index.count(node.get()) > 0;
+	}
+
 	/**
 	 * greebo: Returns the element which has been inserted last.
-	 *
-	 * Note: Runs in linear time = SLOW
+	 * Returns an empty reference if the list is empty.
 	 */
-	const scene::INodePtr& ultimate();
 	const scene::INodePtr& ultimate() const;
 
 	/**
 	 * greebo: Returns the element right before the last selected.
-	 *
-	 * Note: Runs in linear time = SLOW
+	 * Returns an empty reference if the list has less than two elements.
 	 */
 	const scene::INodePtr& penultimate() const;
-	const scene::INodePtr& penultimate();
 
 	/**
 	 * greebo: Inserts a new element to this container.
@@ -54,11 +84,22 @@ public:
 
 	/**
 	 * greebo: Removes the node which has been selected last
-	 * from this map. If multiple nodes with the same
-	 * address exist in the map, only the one with the
-	 * highest time is removed, the others are left.
+	 * from this list. If multiple entries of the same node
+	 * exist in the list, only the latest one is removed.
 	 */
 	void erase(const scene::INodePtr& selected);
+
+	// Removes all entries
+	void clear();
+
+	/**
+	 * Visits all nodes in insertion order. It is safe to append or erase
+	 * nodes during iteration, nodes appended during the visit are not visited.
+	 */
+	void foreach(const std::function<void(const scene::INodePtr&)>& functor);
+
+private:
+	void removeGaps();
 };
 
 #endif /*SELECTEDNODELIST_H_*/
@@ -0,0 +1,230 @@
+#include "SelectionCandidateList.h"
+
+#include <future>
+#include <thread>
+#include "ibrush.h"
+
+namespace selection
+{
+
+namespace
+{
+    // Worker threads are not worth it for fewer brushes than this
+    constexpr std::size_t MinCandidatesPerWorker = 256;
+
+    // Records the committed selectables, following the same
+    // push/pop logic as the SelectionPool does
+    class RecordingSelector :
+        public Selector
+    {
+    private:
+        std::vector<std::pair<ISelectable*, SelectionIntersection>>& _commits;
+
+        ISelectable* _curSelectable;
+        SelectionIntersection _curIntersection;
+
+    public:
+        RecordingSelector(std::vector<std::pair<ISelectable*, SelectionIntersection>>& commits) :
+            _commits(commits),
+            _curSelectable(nullptr)
+        {}
+
+        void pushSelectable(ISelectable& selectable) override
+        {
+            _curIntersection = SelectionIntersection();
+            _curSelectable = &selectable;
+        }
+
+        void popSelectable() override
+        {
+            if (_curIntersection.isValid())
+            {
+                _commits.emplace_back(_curSelectable, _curIntersection);
+            }
+
+            _curIntersection = SelectionIntersection();
+        }
+
+        void addIntersection(const SelectionIntersection& intersection) override
+        {
+            _curIntersection.assignIfCloser(intersection);
+        }
+
+        bool empty() const override
+        {
+            return _commits.empty();
+        }
+
+        void foreachSelectable(const std::function<void(ISelectable*)>& functor) override
+        {
+            for (const auto& [selectable, _] : _commits)
+            {
+                functor(selectable);
+            }
+        }
+    };
+
+    // Keeps the best intersection of a single selectable
+    class IntersectionSelector :
+        public Selector
+    {
+    private:
+        SelectionIntersection _best;
+
+    public:
+        const SelectionIntersection& getBestIntersection() const
+        {
+            return _best;
+        }
+
+        void pushSelectable(ISelectable& selectable) override
+        {
+            _best = SelectionIntersection();
+        }
+
+        void popSelectable() override
+        {}
+
+        void addIntersection(const SelectionIntersection& intersection) override
+        {
+            _best.assignIfCloser(intersection);
+        }
+
+        bool empty() const override
+        {
+            return !_best.isValid();
+        }
+
+        void foreachSelectable(const std::function<void(ISelectable*)>& functor) override
+        {}
+    };
+}
+
+SelectionCandidateList::SelectionCandidateList() :
+    _numParallelCandidates(0)
+{}
+
+void SelectionCandidateList::add(ISelectable& selectable, const scene::INodePtr& node)
+{
+    auto testable = dynamic_cast<SelectionTestable*>(node.get());
+
+    if (!testable) return; // nothing to test
+
+    bool parallel = Node_isBrush(node);
+
+    if (parallel)
+    {
+        // Evaluate the transform and the windings now, the worker threads must not
+        node->localToWorld();
+        node->worldAABB();
+        ++_numParallelCandidates;
+    }
+
+    _candidates.emplace_back(Candidate{ &selectable, testable, parallel, SelectionIntersection(), 0, 0 });
+}
+
+void SelectionCandidateList::testSelect(Selector& selector, SelectionTest& test)
+{
+    auto numWorkers = std::min<std::size_t>(std::thread::hardware_concurrency(),
+        _numParallelCandidates / MinCandidatesPerWorker);
+
+    std::vector<std::future<void>> workers;
+    std::vector<std::size_t> parallelIndices;
+
+    if (numWorkers > 1)
+    {
+        parallelIndices.reserve(_numParallelCandidates);
+
+        for (std::size_t i = 0; i < _candidates.size(); ++i)
+        {
+            if (_candidates[i].parallel)
+            {
+                parallelIndices.push_back(i);
+            }
+        }
+
+        // Each worker gets a contiguous range of brushes and its own copy of the test
+        auto chunkSize = (parallelIndices.size() + numWorkers - 1) / numWorkers;
+
+        for (std::size_t begin = 0; begin < parallelIndices.size(); begin += chunkSize)
+        {
+            auto end = std::min(begin + chunkSize, parallelIndices.size());
+
+            workers.emplace_back(std::async(std::launch::async,
+                [this, &parallelIndices, begin, end, workerTest = test.clone()]()
+            {
+                testParallelCandidates(parallelIndices, begin, end, *workerTest);
+            }));
+        }
+    }
+    else
+    {
+        // Not enough brushes, test everything on this thread
+        for (auto& candidate : _candidates)
+        {
+            candidate.parallel = false;
+        }
+    }
+
+    testSequentialCandidates(test);
+
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    // Merge the results in the order the candidates have been added
+    for (const auto& candidate : _candidates)
+    {
+        if (candidate.parallel)
+        {
+            if (candidate.intersection.isValid())
+            {
+                selector.addWithIntersection(*candidate.selectable, candidate.intersection);
+            }
+
+            continue;
+        }
+
+        for (auto i = candidate.firstCommit; i < candidate.firstCommit + candidate.numCommits; ++i)
+        {
+            selector.addWithIntersection(*_commits[i].first, _commits[i].second);
+        }
+    }
+}
+
+void SelectionCandidateList::testSequentialCandidates(SelectionTest& test)
+{
+    RecordingSelector recorder(_commits);
+
+    for (auto& candidate : _candidates)
+    {
+        if (candidate.parallel) continue;
+
+        candidate.firstCommit = _commits.size();
+
+        recorder.pushSelectable(*candidate.selectable);
+        candidate.testable->testSelect(recorder, test);
+        recorder.popSelectable();
+
+        candidate.numCommits = _commits.size() - candidate.firstCommit;
+    }
+}
+
+void SelectionCandidateList::testParallelCandidates(const std::vector<std::size_t>& indices,
+    std::size_t begin, std::size_t end, SelectionTest& test)
+{
+    IntersectionSelector selector;
+
+    for (auto i = begin; i < end; ++i)
+    {
+        auto& candidate = _candidates[indices[i]];
+
+        selector.pushSelectable(*candidate.selectable);
+        candidate.testable->testSelect(selector, test);
+
+        candidate.intersection = selector.getBestIntersection();
+    }
+}
+
+}
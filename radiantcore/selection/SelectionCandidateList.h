@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include "iselectiontest.h"
+
+namespace selection
+{
+
+/**
+ * Collects the nodes a SelectionTestWalker would like to test, such that
+ * the actual tests can be spread across several threads.
+ *
+ * Brush tests are only reading data which is up to date after the scene
+ * traversal and are distributed across worker threads. All other nodes
+ * might evaluate shared state (like patch tesselations or materials) during
+ * their test and are tested on the calling thread.
+ *
+ * The results are submitted to the target Selector in the order the
+ * candidates have been added, which yields the same result as a
+ * sequential test.
+ */
+class SelectionCandidateList
+{
+private:
+    struct Candidate
+    {
+        ISelectable* selectable;
+        SelectionTestable* testable;
+
+        // True if this candidate is tested by a worker thread
+        bool parallel;
+
+        // The intersection found by the worker thread
+        SelectionIntersection intersection;
+
+        // The range of selectables committed by the sequential test
+        std::size_t firstCommit;
+        std::size_t numCommits;
+    };
+
+    std::vector<Candidate> _candidates;
+
+    // Selectables and their intersections committed by the sequential tests
+    std::vector<std::pair<ISelectable*, SelectionIntersection>> _commits;
+
+    std::size_t _numParallelCandidates;
+
+public:
+    SelectionCandidateList();
+
+    // Adds the given candidate, the node will be tested for selection
+    // and the given selectable is submitted to the Selector.
+    void add(ISelectable& selectable, const scene::INodePtr& node);
+
+    // Tests all candidates and submits the results to the given selector
+    void testSelect(Selector& selector, SelectionTest& test);
+
+private:
+    void testSequentialCandidates(SelectionTest& test);
+    void testParallelCandidates(const std::vector<std::size_t>& indices,
+        std::size_t begin, std::size_t end, SelectionTest& test);
+};
+
+}
@@ -7,6 +7,7 @@
 #include "iselectiontest.h"
 #include "entitylib.h"
 #include "debugging/ScenegraphUtils.h"
+#include "SelectionCandidateList.h"
 
 namespace selection
 {
@@ -52,6 +53,13 @@ void SelectionTestWalker::performSelectionTest(const scene::INodePtr& selectable
 
 	if (!selectable) return; // skip non-selectables
 
+	if (_candidates)
+	{
+		// The candidate list is going to perform the test
+		_candidates->add(*selectable, nodeToBeTested);
+		return;
+	}
+
 	_selector.pushSelectable(*selectable);
 
 	// Test the node for selection, this will add an intersection to the selector
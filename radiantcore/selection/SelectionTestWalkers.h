@@ -6,6 +6,8 @@
 namespace selection
 {
 
+class SelectionCandidateList;
+
 // Base class for SelectionTesters, provides some convenience methods
 class SelectionTestWalker
 {
@@ -13,15 +15,26 @@ protected:
 	Selector& _selector;
 	SelectionTest& _test;
 
+	// If set, the tests are not performed right away but collected in this list
+	SelectionCandidateList* _candidates;
+
 public:
     virtual ~SelectionTestWalker() {}
 
     virtual void testNode(const scene::INodePtr& node) = 0;
 
+	// Let this walker add the nodes to the given list instead of testing them,
+	// such that they can be tested in parallel later on. Pass nullptr to disable.
+	void setCandidateList(SelectionCandidateList* candidates)
+	{
+		_candidates = candidates;
+	}
+
 protected:
 	SelectionTestWalker(Selector& selector, SelectionTest& test) :
 		_selector(selector),
-		_test(test)
+		_test(test),
+		_candidates(nullptr)
 	{}
 
 	void printNodeName(const scene::INodePtr& node);
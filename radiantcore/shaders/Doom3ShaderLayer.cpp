@@ -124,7 +124,8 @@ Doom3ShaderLayer::Doom3ShaderLayer(ShaderTemplate& material, IShaderLayer::Type
     _textureMatrix(_expressionSlots, _registers),
 	_privatePolygonOffset(0),
     _parseFlags(0),
-    _enabled(true)
+    _enabled(true),
+    _expressionProgramNeedsUpdate(true)
 {
 	_registers[REG_ZERO] = 0;
 	_registers[REG_ONE] = 1;
@@ -170,7 +171,8 @@ Doom3ShaderLayer::Doom3ShaderLayer(const Doom3ShaderLayer& other, ShaderTemplate
     _privatePolygonOffset(other._privatePolygonOffset),
     _renderMapSize(other._renderMapSize),
     _parseFlags(other._parseFlags),
-    _enabled(other._enabled)
+    _enabled(other._enabled),
+    _expressionProgramNeedsUpdate(true)
 {}
 
 TexturePtr Doom3ShaderLayer::getTexture() const
@@ -298,7 +300,7 @@ void Doom3ShaderLayer::setColourExpression(ColourComponentSelector comp, const I
 		break;
 	};
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setColour(const Vector4& col)
@@ -321,7 +323,7 @@ void Doom3ShaderLayer::setColour(const Vector4& col)
 		}
 	}
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::appendTransformation(const Transformation& transform)
@@ -344,7 +346,7 @@ void Doom3ShaderLayer::appendTransformation(const Transformation& transform)
     // Construct a transformation matrix and multiply it on top of the existing one
     _textureMatrix.applyTransformation(copy);
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const std::vector<IShaderLayer::Transformation>& Doom3ShaderLayer::getTransformations()
@@ -385,7 +387,7 @@ const Vector2& Doom3ShaderLayer::getRenderMapSize() const
 void Doom3ShaderLayer::setRenderMapSize(const Vector2& size)
 {
     _renderMapSize = size;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 bool Doom3ShaderLayer::hasAlphaTest() const
@@ -406,7 +408,7 @@ const IShaderExpression::Ptr& Doom3ShaderLayer::getAlphaTestExpression() const
 void Doom3ShaderLayer::setAlphaTestExpressionFromString(const std::string& expression)
 {
     _expressionSlots.assignFromString(Expression::AlphaTest, expression, REG_ZERO);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const shaders::IShaderExpression::Ptr& Doom3ShaderLayer::getConditionExpression() const
@@ -417,11 +419,17 @@ const shaders::IShaderExpression::Ptr& Doom3ShaderLayer::getConditionExpression(
 void Doom3ShaderLayer::setCondition(const IShaderExpression::Ptr& conditionExpr)
 {
     _expressionSlots.assign(Expression::Condition, conditionExpr, REG_ONE);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::evaluateExpressions(std::size_t time)
 {
+    if (ensureExpressionProgram())
+    {
+        _expressionProgram->execute(time, nullptr, _registers);
+        return;
+    }
+
     for (const auto& slot : _expressionSlots)
     {
         if (slot.expression)
@@ -441,6 +449,12 @@ void Doom3ShaderLayer::evaluateExpressions(std::size_t time)
 
 void Doom3ShaderLayer::evaluateExpressions(std::size_t time, const IRenderEntity& entity)
 {
+    if (ensureExpressionProgram())
+    {
+        _expressionProgram->execute(time, &entity, _registers);
+        return;
+    }
+
     for (const auto& slot : _expressionSlots)
     {
         if (slot.expression)
@@ -458,6 +472,43 @@ void Doom3ShaderLayer::evaluateExpressions(std::size_t time, const IRenderEntity
     }
 }
 
+bool Doom3ShaderLayer::ensureExpressionProgram()
+{
+    if (_expressionProgramNeedsUpdate)
+    {
+        _expressionProgramNeedsUpdate = false;
+
+        // Collect the expressions along with the registers they need to write to
+        std::vector<std::pair<IShaderExpression::Ptr, std::size_t>> expressions;
+
+        for (const auto& slot : _expressionSlots)
+        {
+            if (slot.expression)
+            {
+                expressions.emplace_back(slot.expression, slot.registerIndex);
+            }
+        }
+
+        for (const auto& parm : _vertexParms)
+        {
+            if (parm.expression)
+            {
+                expressions.emplace_back(parm.expression, parm.registerIndex);
+            }
+        }
+
+        _expressionProgram = ExpressionProgram::Compile(expressions);
+    }
+
+    return _expressionProgram != nullptr;
+}
+
+void Doom3ShaderLayer::onLayerChanged()
+{
+    _expressionProgramNeedsUpdate = true;
+    _material.onLayerChanged();
+}
+
 IShaderExpression::Ptr Doom3ShaderLayer::getExpression(Expression::Slot slot)
 {
     return _expressionSlots[slot].expression;
@@ -466,7 +517,7 @@ IShaderExpression::Ptr Doom3ShaderLayer::getExpression(Expression::Slot slot)
 void Doom3ShaderLayer::setBindableTexture(NamedBindablePtr btex)
 {
     _bindableTex = btex;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 NamedBindablePtr Doom3ShaderLayer::getBindableTexture() const
@@ -477,7 +528,7 @@ NamedBindablePtr Doom3ShaderLayer::getBindableTexture() const
 void Doom3ShaderLayer::setLayerType(IShaderLayer::Type type)
 {
     _type = type;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 IShaderLayer::Type Doom3ShaderLayer::getType() const
@@ -493,19 +544,19 @@ int Doom3ShaderLayer::getStageFlags() const
 void Doom3ShaderLayer::setStageFlags(int flags)
 {
     _stageFlags = flags;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setStageFlag(IShaderLayer::Flags flag)
 {
     _stageFlags |= flag;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::clearStageFlag(IShaderLayer::Flags flag)
 {
     _stageFlags &= ~flag;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 ClampType Doom3ShaderLayer::getClampType() const
@@ -516,7 +567,7 @@ ClampType Doom3ShaderLayer::getClampType() const
 void Doom3ShaderLayer::setClampType(ClampType type)
 {
     _clampType = type;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 bool Doom3ShaderLayer::hasOverridingClampType() const
@@ -532,7 +583,7 @@ IShaderLayer::TexGenType Doom3ShaderLayer::getTexGenType() const
 void Doom3ShaderLayer::setTexGenType(TexGenType type)
 {
     _texGenType = type;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 float Doom3ShaderLayer::getTexGenParam(std::size_t index) const
@@ -557,7 +608,7 @@ void Doom3ShaderLayer::setTexGenExpression(std::size_t index, const IShaderExpre
 
     _expressionSlots.assign(slot, expression, REG_ZERO);
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setBlendFuncStrings(const StringPair& func)
@@ -581,7 +632,7 @@ void Doom3ShaderLayer::setBlendFuncStrings(const StringPair& func)
         setLayerType(IShaderLayer::BLEND);
     }
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const StringPair& Doom3ShaderLayer::getBlendFuncStrings() const
@@ -592,19 +643,19 @@ const StringPair& Doom3ShaderLayer::getBlendFuncStrings() const
 void Doom3ShaderLayer::setVertexColourMode(VertexColourMode mode)
 {
     _vertexColourMode = mode;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setCubeMapMode(CubeMapMode mode)
 {
     _cubeMapMode = mode;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setAlphaTest(const IShaderExpression::Ptr& expression)
 {
     _expressionSlots.assign(Expression::AlphaTest, expression, REG_ZERO);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 float Doom3ShaderLayer::getRegisterValue(std::size_t index) const
@@ -633,7 +684,7 @@ const std::string& Doom3ShaderLayer::getVertexProgram() const
 void Doom3ShaderLayer::setVertexProgram(const std::string& name)
 {
     _vertexProgram = name;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 const std::string& Doom3ShaderLayer::getFragmentProgram() const
@@ -644,7 +695,7 @@ const std::string& Doom3ShaderLayer::getFragmentProgram() const
 void Doom3ShaderLayer::setFragmentProgram(const std::string& name)
 {
     _fragmentProgram = name;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 std::size_t Doom3ShaderLayer::getNumFragmentMaps() const
@@ -679,7 +730,7 @@ void Doom3ShaderLayer::addFragmentMap(const IShaderLayer::FragmentMap& fragmentM
     }
 
     _fragmentMaps[fragmentMap.index] = fragmentMap;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 std::string Doom3ShaderLayer::getMapImageFilename() const
@@ -702,7 +753,7 @@ float Doom3ShaderLayer::getPrivatePolygonOffset() const
 void Doom3ShaderLayer::setPrivatePolygonOffset(double value)
 {
     _privatePolygonOffset = static_cast<float>(value);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 IMapExpression::Ptr Doom3ShaderLayer::getMapExpression() const
@@ -722,7 +773,7 @@ void Doom3ShaderLayer::setMapExpressionFromString(const std::string& expression)
     {
         setBindableTexture(MapExpression::createForString(expression));
     }
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 int Doom3ShaderLayer::getParseFlags() const
@@ -825,7 +876,7 @@ void Doom3ShaderLayer::addVertexParm(const VertexParm& parm)
     // At this point the array needs to be empty or its size a multiple of 4
     assert(_vertexParms.size() % 4 == 0);
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::recalculateTransformationMatrix()
@@ -841,7 +892,7 @@ void Doom3ShaderLayer::recalculateTransformationMatrix()
 void Doom3ShaderLayer::setEnabled(bool enabled)
 {
     _enabled = enabled;
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 std::size_t Doom3ShaderLayer::addTransformation(TransformType type, const std::string& expression1, const std::string& expression2)
@@ -855,7 +906,7 @@ std::size_t Doom3ShaderLayer::addTransformation(TransformType type, const std::s
 
     recalculateTransformationMatrix();
 
-    _material.onLayerChanged();
+    onLayerChanged();
 
     return _transformations.size() - 1;
 }
@@ -867,7 +918,7 @@ void Doom3ShaderLayer::removeTransformation(std::size_t index)
     _transformations.erase(_transformations.begin() + index);
 
     recalculateTransformationMatrix();
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::updateTransformation(std::size_t index, TransformType type, const std::string& expression1, const std::string& expression2)
@@ -890,7 +941,7 @@ void Doom3ShaderLayer::updateTransformation(std::size_t index, TransformType typ
 
     recalculateTransformationMatrix();
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setColourExpressionFromString(ColourComponentSelector component, const std::string& expression)
@@ -921,7 +972,7 @@ void Doom3ShaderLayer::setConditionExpressionFromString(const std::string& expre
         condition->setIsSurroundedByParentheses(true);
     }
 
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setTexGenExpressionFromString(std::size_t index, const std::string& expression)
@@ -930,19 +981,19 @@ void Doom3ShaderLayer::setTexGenExpressionFromString(std::size_t index, const st
 
     auto slot = static_cast<Expression::Slot>(Expression::TexGenParam1 + index);
     _expressionSlots.assignFromString(slot, expression, REG_ZERO);
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setSoundMapWaveForm(bool waveForm)
 {
     setBindableTexture(std::make_shared<SoundMapExpression>(waveForm));
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 void Doom3ShaderLayer::setVideoMapProperties(const std::string& filePath, bool looping)
 {
     setBindableTexture(std::make_shared<VideoMapExpression>(filePath, looping));
-    _material.onLayerChanged();
+    onLayerChanged();
 }
 
 }
@@ -9,6 +9,7 @@
 #include "ShaderExpression.h"
 #include "ExpressionSlots.h"
 #include "TextureMatrix.h"
+#include "ExpressionProgram.h"
 
 namespace shaders
 {
@@ -94,6 +95,11 @@ private:
 
     bool _enabled;
 
+    // All expressions of this stage compiled into one program, built on demand.
+    // Stays empty if the expressions could not be compiled.
+    ExpressionProgram::Ptr _expressionProgram;
+    bool _expressionProgramNeedsUpdate;
+
 public:
     using Ptr = std::shared_ptr<Doom3ShaderLayer>;
 
@@ -287,6 +293,12 @@ public:
 
 private:
     void recalculateTransformationMatrix();
+
+    // Invalidates the compiled expressions and notifies the owning material
+    void onLayerChanged();
+
+    // Compiles the expressions if necessary, returns false if they need to be evaluated one by one
+    bool ensureExpressionProgram();
 };
 
 }
@@ -0,0 +1,210 @@
+#include "ExpressionProgram.h"
+
+#include <cmath>
+#include <stdexcept>
+#include "irender.h"
+#include "ShaderExpression.h"
+
+namespace shaders
+{
+
+namespace
+{
+    inline float evaluateOperation(ExpressionProgram::OpCode op, float a, float b)
+    {
+        using OpCode = ExpressionProgram::OpCode;
+
+        switch (op)
+        {
+        case OpCode::Add: return a + b;
+        case OpCode::Subtract: return a - b;
+        case OpCode::Multiply: return a * b;
+        case OpCode::Divide: return a / b;
+        case OpCode::Modulo: return fmod(a, b);
+        case OpCode::Less: return a < b ? 1.0f : 0;
+        case OpCode::LessOrEqual: return a <= b ? 1.0f : 0;
+        case OpCode::Greater: return a > b ? 1.0f : 0;
+        case OpCode::GreaterOrEqual: return a >= b ? 1.0f : 0;
+        case OpCode::Equal: return a == b ? 1.0f : 0;
+        case OpCode::NotEqual: return a != b ? 1.0f : 0;
+        case OpCode::LogicalAnd: return (a != 0 && b != 0) ? 1.0f : 0;
+        case OpCode::LogicalOr: return (a != 0 || b != 0) ? 1.0f : 0;
+        default:
+            throw std::logic_error("Not a binary operation");
+        }
+    }
+}
+
+ExpressionProgram::ExpressionProgram() :
+    _isTimeDependent(false),
+    _isEntityDependent(false),
+    _hasBeenExecuted(false)
+{}
+
+std::size_t ExpressionProgram::compile(const IShaderExpression::Ptr& expression)
+{
+    auto existing = _compiledExpressions.find(expression.get());
+
+    if (existing != _compiledExpressions.end())
+    {
+        return existing->second;
+    }
+
+    auto shaderExpression = std::dynamic_pointer_cast<ShaderExpression>(expression);
+
+    if (!shaderExpression)
+    {
+        throw std::invalid_argument("Unsupported shader expression type");
+    }
+
+    auto valueIndex = shaderExpression->compile(*this);
+    _compiledExpressions.emplace(expression.get(), valueIndex);
+
+    return valueIndex;
+}
+
+void ExpressionProgram::addStore(std::size_t valueIndex, std::size_t registerIndex)
+{
+    _instructions.push_back(Instruction{ OpCode::Store,
+        static_cast<std::uint32_t>(registerIndex), static_cast<std::uint32_t>(valueIndex), 0 });
+}
+
+std::size_t ExpressionProgram::addConstant(float value)
+{
+    _values.push_back(value);
+    _valueIsConstant.push_back(true);
+
+    return _values.size() - 1;
+}
+
+std::size_t ExpressionProgram::addTime()
+{
+    _isTimeDependent = true;
+    return addInstruction(OpCode::Time, 0, 0);
+}
+
+std::size_t ExpressionProgram::addShaderParm(int parmNum)
+{
+    _isEntityDependent = true;
+    return addInstruction(OpCode::ShaderParm, static_cast<std::size_t>(parmNum), 0);
+}
+
+std::size_t ExpressionProgram::addOperation(OpCode op, std::size_t a, std::size_t b)
+{
+    // Fold operations on constants right away
+    if (_valueIsConstant[a] && _valueIsConstant[b])
+    {
+        return addConstant(evaluateOperation(op, _values[a], _values[b]));
+    }
+
+    return addInstruction(op, a, b);
+}
+
+std::size_t ExpressionProgram::addTableLookup(const ITableDefinition::Ptr& table, std::size_t lookup)
+{
+    // Lookups are never folded, the table contents might change when reloading decls
+    _tables.push_back(table);
+    _tableParseStamps.push_back(0);
+
+    return addInstruction(OpCode::TableLookup, lookup, _tables.size() - 1);
+}
+
+std::size_t ExpressionProgram::addInstruction(OpCode op, std::size_t a, std::size_t b)
+{
+    _values.push_back(0);
+    _valueIsConstant.push_back(false);
+
+    auto target = _values.size() - 1;
+
+    _instructions.push_back(Instruction{ op, static_cast<std::uint32_t>(target),
+        static_cast<std::uint32_t>(a), static_cast<std::uint32_t>(b) });
+
+    return target;
+}
+
+bool ExpressionProgram::resultIsUpToDate() const
+{
+    if (!_hasBeenExecuted || !isConstant())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < _tables.size(); ++i)
+    {
+        if (_tables[i]->getParseStamp() != _tableParseStamps[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void ExpressionProgram::execute(std::size_t time, const IRenderEntity* entity, Registers& registers)
+{
+    if (resultIsUpToDate())
+    {
+        return;
+    }
+
+    auto* values = _values.data();
+
+    for (const auto& instruction : _instructions)
+    {
+        switch (instruction.op)
+        {
+        case OpCode::Time:
+            values[instruction.target] = time / 1000.0f; // convert msecs to secs
+            break;
+
+        case OpCode::ShaderParm:
+            // Without entity, the RGBA _color parms [0-3] have default value 1.0, the rest is 0
+            values[instruction.target] = entity != nullptr ?
+                entity->getShaderParm(static_cast<int>(instruction.a)) : (instruction.a < 4 ? 1.0f : 0.0f);
+            break;
+
+        case OpCode::TableLookup:
+            values[instruction.target] = _tables[instruction.b]->getValue(values[instruction.a]);
+            break;
+
+        case OpCode::Store:
+            registers[instruction.target] = values[instruction.a];
+            break;
+
+        default:
+            values[instruction.target] = evaluateOperation(instruction.op, values[instruction.a], values[instruction.b]);
+            break;
+        }
+    }
+
+    for (std::size_t i = 0; i < _tables.size(); ++i)
+    {
+        _tableParseStamps[i] = _tables[i]->getParseStamp();
+    }
+
+    _hasBeenExecuted = true;
+}
+
+ExpressionProgram::Ptr ExpressionProgram::Compile(const std::vector<std::pair<IShaderExpression::Ptr, std::size_t>>& expressions)
+{
+    auto program = std::make_unique<ExpressionProgram>();
+
+    try
+    {
+        for (const auto& [expression, registerIndex] : expressions)
+        {
+            program->addStore(program->compile(expression), registerIndex);
+        }
+    }
+    catch (const std::invalid_argument&)
+    {
+        return Ptr();
+    }
+
+    // The lookup table is not needed anymore
+    program->_compiledExpressions.clear();
+
+    return program;
+}
+
+}
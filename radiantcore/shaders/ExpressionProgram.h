@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "ishaders.h"
+#include "ishaderexpression.h"
+
+class IRenderEntity;
+
+namespace shaders
+{
+
+/**
+ * The shader expressions of a material stage, compiled to a linear list of
+ * instructions operating on an array of float values. Executing the program
+ * writes the same values to the stage registers as evaluating each
+ * expression tree would, without any virtual calls per tree node.
+ *
+ * Sub-expressions depending on constants only are folded at compile time,
+ * sub-expressions shared by several slots are only evaluated once.
+ * Programs which are neither depending on time nor on the entity are
+ * only executed once.
+ */
+class ExpressionProgram
+{
+public:
+    enum class OpCode : std::uint8_t
+    {
+        Time,           // target = time in seconds
+        ShaderParm,     // target = entity shaderparm a
+        Add,            // target = a + b
+        Subtract,       // target = a - b
+        Multiply,       // target = a * b
+        Divide,         // target = a / b
+        Modulo,         // target = fmod(a, b)
+        Less,           // target = a < b
+        LessOrEqual,    // target = a <= b
+        Greater,        // target = a > b
+        GreaterOrEqual, // target = a >= b
+        Equal,          // target = a == b
+        NotEqual,       // target = a != b
+        LogicalAnd,     // target = a && b
+        LogicalOr,      // target = a || b
+        TableLookup,    // target = table b [a]
+        Store,          // registers[target] = a
+    };
+
+private:
+    struct Instruction
+    {
+        OpCode op;
+        std::uint32_t target;
+        std::uint32_t a;
+        std::uint32_t b;
+    };
+
+    std::vector<Instruction> _instructions;
+
+    // The values the instructions are operating on, constants are filled in at compile time
+    std::vector<float> _values;
+
+    // Whether the value at the corresponding index is known at compile time
+    std::vector<bool> _valueIsConstant;
+
+    std::vector<ITableDefinition::Ptr> _tables;
+
+    // The parse stamps of the tables at the time of the last execution,
+    // table lookups need to be re-evaluated after the tables have been reloaded
+    std::vector<std::size_t> _tableParseStamps;
+
+    // Maps each compiled expression to its value index
+    std::unordered_map<const IShaderExpression*, std::size_t> _compiledExpressions;
+
+    bool _isTimeDependent;
+    bool _isEntityDependent;
+    bool _hasBeenExecuted;
+
+public:
+    using Ptr = std::unique_ptr<ExpressionProgram>;
+
+    ExpressionProgram();
+
+    // Compiles the given expression (if not done yet), and returns the index of its value.
+    // Throws std::invalid_argument if the expression type is not supported.
+    std::size_t compile(const IShaderExpression::Ptr& expression);
+
+    // Adds an instruction writing the given value to the given stage register
+    void addStore(std::size_t valueIndex, std::size_t registerIndex);
+
+    // Instruction factories used by the ShaderExpression implementations,
+    // each of them returns the index of the resulting value
+    std::size_t addConstant(float value);
+    std::size_t addTime();
+    std::size_t addShaderParm(int parmNum);
+    std::size_t addOperation(OpCode op, std::size_t a, std::size_t b);
+    std::size_t addTableLookup(const ITableDefinition::Ptr& table, std::size_t lookup);
+
+    // True if the program is neither depending on time nor on entity parameters
+    bool isConstant() const
+    {
+        return !_isTimeDependent && !_isEntityDependent;
+    }
+
+    std::size_t getNumInstructions() const
+    {
+        return _instructions.size();
+    }
+
+    // Run the program and write the results to the given registers.
+    // Pass a null entity to evaluate the program with the default shaderparm values.
+    void execute(std::size_t time, const IRenderEntity* entity, Registers& registers);
+
+    // Compiles the given pairs of expressions and their target registers into a program.
+    // Returns an empty pointer if any of the expressions cannot be compiled.
+    static Ptr Compile(const std::vector<std::pair<IShaderExpression::Ptr, std::size_t>>& expressions);
+
+private:
+    std::size_t addInstruction(OpCode op, std::size_t a, std::size_t b);
+
+    // True if this program has been executed before and would produce the same result again
+    bool resultIsUpToDate() const;
+};
+
+}
@@ -6,6 +6,7 @@
 #include "fmt/format.h"
 #include "string/convert.h"
 #include "TableDefinition.h"
+#include "ExpressionProgram.h"
 
 namespace shaders
 {
@@ -119,6 +120,10 @@ public:
 
     // To be implemented by the subclasses
     virtual std::string convertToString() = 0;
+
+    // Adds the instructions calculating this expression to the given program,
+    // returns the index of the program value holding the result
+    virtual std::size_t compile(ExpressionProgram& program) = 0;
 };
 
 // Detail namespace
@@ -164,6 +169,11 @@ public:
         return fmt::format("parm{0}", _parmNum);
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addShaderParm(_parmNum);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<ShaderParmExpression>(*this);
@@ -204,6 +214,11 @@ public:
         return fmt::format("global{0}", _parmNum);
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addConstant(0.0f);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<GlobalShaderParmExpression>(*this);
@@ -238,6 +253,11 @@ public:
         return "time";
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addTime();
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<TimeExpression>(*this);
@@ -277,6 +297,11 @@ public:
         return fmt::format("{0}", _value);
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addConstant(_value);
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<ConstantExpression>(*this);
@@ -326,6 +351,11 @@ public:
         return fmt::format("{0}[{1}]", _tableDef->getDeclName(), _lookupExpr->getExpressionString());
     }
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addTableLookup(_tableDef, program.compile(_lookupExpr));
+    }
+
     virtual Ptr clone() const override
     {
         return std::make_shared<TableLookupExpression>(*this);
@@ -390,6 +420,18 @@ public:
 	{
 		_b = b;
 	}
+
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        auto a = program.compile(_a);
+        auto b = program.compile(_b);
+
+        return program.addOperation(getOpCode(), a, b);
+    }
+
+protected:
+    // The instruction performing this operation
+    virtual ExpressionProgram::OpCode getOpCode() const = 0;
 };
 typedef std::shared_ptr<BinaryExpression> BinaryExpressionPtr;
 
@@ -426,6 +468,12 @@ public:
     {
         return std::make_shared<AddExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Add;
+    }
 };
 
 // An expression subtracting the value of two expressions
@@ -461,6 +509,12 @@ public:
     {
         return std::make_shared<SubtractExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Subtract;
+    }
 };
 
 // An expression multiplying the value of two expressions
@@ -496,6 +550,12 @@ public:
     {
         return std::make_shared<MultiplyExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Multiply;
+    }
 };
 
 // An expression dividing the value of two expressions
@@ -531,6 +591,12 @@ public:
     {
         return std::make_shared<DivideExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Divide;
+    }
 };
 
 // An expression returning modulo of A % B
@@ -566,6 +632,12 @@ public:
     {
         return std::make_shared<ModuloExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Modulo;
+    }
 };
 
 // An expression returning 1 if A < B, otherwise 0
@@ -601,6 +673,12 @@ public:
     {
         return std::make_shared<LessThanExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Less;
+    }
 };
 
 // An expression returning 1 if A <= B, otherwise 0
@@ -636,6 +714,12 @@ public:
     {
         return std::make_shared<LessThanOrEqualExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::LessOrEqual;
+    }
 };
 
 // An expression returning 1 if A > B, otherwise 0
@@ -671,6 +755,12 @@ public:
     {
         return std::make_shared<GreaterThanExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Greater;
+    }
 };
 
 // An expression returning 1 if A >= B, otherwise 0
@@ -706,6 +796,12 @@ public:
     {
         return std::make_shared<GreaterThanOrEqualExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::GreaterOrEqual;
+    }
 };
 
 // An expression returning 1 if A == B, otherwise 0
@@ -741,6 +837,12 @@ public:
     {
         return std::make_shared<EqualityExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::Equal;
+    }
 };
 
 // An expression returning 1 if A != B, otherwise 0
@@ -776,6 +878,12 @@ public:
     {
         return std::make_shared<InequalityExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::NotEqual;
+    }
 };
 
 // An expression returning 1 if both A and B are true (non-zero), otherwise 0
@@ -811,6 +919,12 @@ public:
     {
         return std::make_shared<LogicalAndExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::LogicalAnd;
+    }
 };
 
 // An expression returning 1 if either A or B are true (non-zero), otherwise 0
@@ -846,6 +960,12 @@ public:
     {
         return std::make_shared<LogicalOrExpression>(*this);
     }
+
+protected:
+    ExpressionProgram::OpCode getOpCode() const override
+    {
+        return ExpressionProgram::OpCode::LogicalOr;
+    }
 };
 
 } // namespace
@@ -42,6 +42,11 @@ std::string RegistryTree::prepareKey(const std::string& key)
 	}
 }
 
+std::size_t RegistryTree::getChangeCount() const
+{
+	return _tree.getChangeCount();
+}
+
 xml::NodeList RegistryTree::findXPath(const std::string& xPath)
 {
 	return _tree.findXPath(prepareKey(xPath));
@@ -62,6 +62,9 @@ public:
 	// Dump the tree to std::out for debugging purposes
 	void dump() const;
 
+	// Changes whenever the tree is modified, including through the nodes handed out
+	std::size_t getChangeCount() const;
+
 private:
 	/* Checks whether the key is an absolute or a relative path
 	 * Absolute paths are returned unchanged, a prefix with the
@@ -1,7 +1,10 @@
 #include "XMLRegistry.h"
 
 #include <iostream>
+#include <iomanip>
 #include <stdexcept>
+#include <algorithm>
+#include <cctype>
 #include "itextstream.h"
 
 #include "os/file.h"
@@ -19,17 +22,43 @@ namespace registry
 namespace
 {
 	const char* const RKEY_SKIP_REGISTRY_SAVE = "user/skipRegistrySaveOnShutdown";
+
+	// True if the given key is a relative path consisting of plain node names only,
+	// which can only match the node at this path and none of its siblings
+	bool isPlainPath(const std::string& key)
+	{
+		if (key.empty() || key.front() == '/' || key.back() == '/') return false;
+
+		char previous = '\0';
+
+		for (auto c : key)
+		{
+			if (c == '/' && previous == '/') return false; // descendant axis
+
+			if (!std::isalnum(static_cast<unsigned char>(c)) && c != '/' && c != '_' && c != '-')
+			{
+				return false; // predicates, wildcards, attributes, etc.
+			}
+
+			previous = c;
+		}
+
+		return true;
+	}
 }
 
 XMLRegistry::XMLRegistry() :
     _queryCounter(0),
+    _cacheHits(0),
+    _queryCacheChangeCount(0),
     _changesSinceLastSave(0),
     _shutdown(false)
 {}
 
 void XMLRegistry::shutdown()
 {
-    rMessage() << "XMLRegistry Shutdown: " << _queryCounter << " queries processed." << std::endl;
+    rMessage() << "XMLRegistry Shutdown: " << _queryCounter << " queries processed, " <<
+        _cacheHits << " of them answered from the cache." << std::endl;
 
     saveToDisk();
 
@@ -120,9 +149,7 @@ sigc::signal<void> XMLRegistry::signalForKey(const std::string& key) const
 
 bool XMLRegistry::keyExists(const std::string& key)
 {
-    // Pass the query on to findXPath which queries the subtrees
-    xml::NodeList result = findXPath(key);
-    return !result.empty();
+    return queryKey(key, nullptr);
 }
 
 void XMLRegistry::deleteXPath(const std::string& path)
@@ -134,6 +161,8 @@ void XMLRegistry::deleteXPath(const std::string& path)
     auto numDeletedNodes = _userTree.deleteXPath(path);
     numDeletedNodes += _standardTree.deleteXPath(path);
 
+    invalidateQueryCache();
+
     if (numDeletedNodes > 0)
     {
         _changesSinceLastSave++;
@@ -174,7 +203,11 @@ void XMLRegistry::setAttribute(const std::string& path,
 
     _changesSinceLastSave++;
 
+    auto changeCountBefore = getTreeChangeCount();
+
     _userTree.setAttribute(path, attrName, attrValue);
+
+    invalidateCachedKey(path, changeCountBefore, getTreeChangeCount());
 }
 
 std::string XMLRegistry::getAttribute(const std::string& path, const std::string& attrName)
@@ -188,19 +221,119 @@ std::string XMLRegistry::getAttribute(const std::string& path, const std::string
 
 std::string XMLRegistry::get(const std::string& key)
 {
-    if (const xml::NodeList nodeList = findXPath(key); !nodeList.empty()) {
+    std::string value;
+    queryKey(key, &value);
+
+    return value;
+}
+
+bool XMLRegistry::queryKey(const std::string& key, std::string* value)
+{
+    std::lock_guard<std::mutex> lock(_queryCacheLock);
+
+    // The trees have been modified without going through set() or setAttribute()
+    if (auto changeCount = getTreeChangeCount(); changeCount != _queryCacheChangeCount)
+    {
+        for (auto& [_, cached] : _queryCache)
+        {
+            cached.isValid = false;
+        }
+
+        _queryCacheChangeCount = changeCount;
+    }
+
+    auto& query = _queryCache[key];
+    query.numQueries++;
+
+    if (query.isValid)
+    {
+        _cacheHits++;
+        _queryCounter++;
+
+        if (value != nullptr) *value = query.value;
+        return query.exists;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    const auto nodeList = findXPath(key);
+
+    query.exists = !nodeList.empty();
+    query.value.clear();
+
+    if (query.exists) {
         if (const auto content = nodeList[0].getContent(); !content.empty()) {
-            return string::utf8_to_mb(content);
+            query.value = string::utf8_to_mb(content);
         }
         else {
-            return string::utf8_to_mb(nodeList[0].getAttributeValue("value"));
+            query.value = string::utf8_to_mb(nodeList[0].getAttributeValue("value"));
+        }
+    }
+
+    query.isValid = true;
+    query.numMisses++;
+    query.queryTime += std::chrono::steady_clock::now() - start;
+
+    if (value != nullptr) *value = query.value;
+    return query.exists;
+}
+
+void XMLRegistry::invalidateCachedKey(const std::string& key, std::size_t changeCountBefore, std::size_t changeCountAfter)
+{
+    if (!isPlainPath(key))
+    {
+        // Cannot tell which nodes have been affected
+        invalidateQueryCache();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_queryCacheLock);
+
+    // The change to this key is handled right here, unless the trees have been
+    // modified by other means since the cache was last up to date
+    if (_queryCacheChangeCount == changeCountBefore)
+    {
+        _queryCacheChangeCount = changeCountAfter;
+    }
+
+    for (auto& [cachedKey, query] : _queryCache)
+    {
+        if (!query.isValid) continue;
+
+        // Setting a key might create the node and its parents, which changes
+        // the result of previously failed queries, queries of the parent nodes
+        // and any non-trivial XPath expression
+        if (!query.exists || !isPlainPath(cachedKey) ||
+            (key.compare(0, cachedKey.length(), cachedKey) == 0 &&
+             (key.length() == cachedKey.length() || key[cachedKey.length()] == '/')))
+        {
+            query.isValid = false;
         }
     }
-    return {};
+}
+
+void XMLRegistry::invalidateQueryCache()
+{
+    std::lock_guard<std::mutex> lock(_queryCacheLock);
+
+    for (auto& [_, query] : _queryCache)
+    {
+        query.isValid = false;
+    }
+
+    _queryCacheChangeCount = getTreeChangeCount();
+}
+
+std::size_t XMLRegistry::getTreeChangeCount() const
+{
+    return _userTree.getChangeCount() + _standardTree.getChangeCount();
 }
 
 void XMLRegistry::set(const std::string& key, const std::string& value)
 {
+    std::size_t changeCountBefore;
+    std::size_t changeCountAfter;
+
     {
         std::lock_guard<std::mutex> lock(_writeLock);
 
@@ -208,11 +341,15 @@ void XMLRegistry::set(const std::string& key, const std::string& value)
 
         // Create or set the value in the user tree, the default tree stays untouched
         // Convert the string to UTF-8 before storing it into the RegistryTree
+        changeCountBefore = getTreeChangeCount();
         _userTree.set(key, string::mb_to_utf8(value));
+        changeCountAfter = getTreeChangeCount();
 
         _changesSinceLastSave++;
     }
 
+    invalidateCachedKey(key, changeCountBefore, changeCountAfter);
+
     // Notify the observers
     emitSignalForKey(key);
 }
@@ -233,6 +370,8 @@ void XMLRegistry::import(const std::string& importFilePath, const std::string& p
             break;
     }
 
+    invalidateQueryCache();
+
     _changesSinceLastSave++;
 }
 
@@ -332,6 +471,10 @@ void XMLRegistry::initialiseModule(const IApplicationContext& ctx)
     module::GlobalModuleRegistry().signal_allModulesInitialised().connect([this]()
     {
         _autosaveTimer->start();
+
+        // The command system depends on the registry, so register the command this late
+        GlobalCommandSystem().addCommand("ShowRegistryStatistics",
+            sigc::mem_fun(*this, &XMLRegistry::showStatistics), { cmd::ARGTYPE_INT | cmd::ARGTYPE_OPTIONAL });
     });
 }
 
@@ -352,6 +495,38 @@ void XMLRegistry::onAutoSaveTimerIntervalReached()
     saveToDisk();
 }
 
+void XMLRegistry::showStatistics(const cmd::ArgumentList& args)
+{
+    auto numKeysToShow = !args.empty() && args[0].getInt() > 0 ? static_cast<std::size_t>(args[0].getInt()) : 20;
+
+    std::vector<std::pair<std::string, CachedQuery>> queries;
+
+    {
+        std::lock_guard<std::mutex> lock(_queryCacheLock);
+        queries.assign(_queryCache.begin(), _queryCache.end());
+    }
+
+    // Most frequently queried keys first
+    std::sort(queries.begin(), queries.end(), [](const auto& a, const auto& b)
+    {
+        return a.second.numQueries > b.second.numQueries;
+    });
+
+    rMessage() << "Registry: " << _queryCounter << " queries, " << _cacheHits << " cache hits, " <<
+        queries.size() << " distinct keys" << std::endl;
+    rMessage() << std::setw(10) << "Queries" << std::setw(10) << "Misses" <<
+        std::setw(14) << "XPath (usec)" << "  Key" << std::endl;
+
+    for (std::size_t i = 0; i < queries.size() && i < numKeysToShow; ++i)
+    {
+        const auto& [key, query] = queries[i];
+        auto usecs = std::chrono::duration_cast<std::chrono::microseconds>(query.queryTime).count();
+
+        rMessage() << std::setw(10) << query.numQueries << std::setw(10) << query.numMisses <<
+            std::setw(14) << usecs << "  " << key << std::endl;
+    }
+}
+
 // Static module instance
 module::StaticModuleRegistration<XMLRegistry> xmlRegistryModule;
 
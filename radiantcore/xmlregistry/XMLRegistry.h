@@ -24,8 +24,11 @@
 #include "iregistry.h"
 #include <map>
 #include <mutex>
+#include <chrono>
+#include <unordered_map>
 
 #include "imodule.h"
+#include "icommandsystem.h"
 #include "RegistryTree.h"
 #include "time/Timer.h"
 
@@ -53,6 +56,32 @@ private:
 	// The query counter for some statistics :)
 	unsigned int _queryCounter;
 
+	// The result of get() and keyExists() for a given key, along with
+	// the number of queries and the time spent evaluating the XPath
+	struct CachedQuery
+	{
+		bool isValid = false;
+		bool exists = false;
+		std::string value;
+
+		std::size_t numQueries = 0;
+		std::size_t numMisses = 0;
+		std::chrono::steady_clock::duration queryTime = std::chrono::steady_clock::duration::zero();
+	};
+
+	// Key => value cache in front of the XPath queries. Entries are invalidated
+	// by every write operation which might affect their result. The entries
+	// are not removed to keep the statistics around.
+	std::unordered_map<std::string, CachedQuery> _queryCache;
+	std::mutex _queryCacheLock;
+
+	// The change count of both trees the cache is up to date with. Changes made
+	// through the nodes returned by findXPath() or createKey() can't be attributed
+	// to a key, the whole cache is invalidated when the trees have been modified.
+	std::size_t _queryCacheChangeCount;
+
+	std::size_t _cacheHits;
+
 	// Change tracking counter, is reset when saveToDisk() is called
 	unsigned int _changesSinceLastSave;
 
@@ -140,6 +169,21 @@ private:
 	void shutdown();
 
 	void onAutoSaveTimerIntervalReached();
+
+	// Queries both trees for the given key, using the cache if possible.
+	// Returns true if the key exists, its value is written to the given string (if non-null).
+	bool queryKey(const std::string& key, std::string* value);
+
+	// Drops the cached result of the given key and all cached queries which
+	// might be affected by a change to the node at this key. The change counts
+	// are the ones before and after the key has been modified.
+	void invalidateCachedKey(const std::string& key, std::size_t changeCountBefore, std::size_t changeCountAfter);
+	void invalidateQueryCache();
+
+	// The sum of the change counts of both trees
+	std::size_t getTreeChangeCount() const;
+
+	void showStatistics(const cmd::ArgumentList& args);
 };
 typedef std::shared_ptr<XMLRegistry> XMLRegistryPtr;
 
@@ -0,0 +1,217 @@
+#include "RadiantTest.h"
+
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <fmt/format.h>
+#include "iaasfile.h"
+#include "os/fs.h"
+#include "testutil/TemporaryFile.h"
+
+namespace test
+{
+
+using AasTest = RadiantTest;
+
+namespace
+{
+
+constexpr int CellSize = 64;
+
+// Generates the text of an AAS file consisting of a grid of cubic areas
+// in the XY plane, area 1 being the cell at the origin, growing along X first
+std::string generateGridAasFile(int cellsPerAxis)
+{
+    std::ostringstream planes, vertices, edges, edgeIndex, faces, faceIndex, areas;
+
+    int numPlanes = 0, numVertices = 0, numEdges = 1, numFaces = 1, numAreas = 1;
+
+    // Edge 0, face 0 and area 0 are unused
+    edges << "\t0 ( 0 0 )\n";
+    faces << "\t0 ( 0 0 0 0 0 0 )\n";
+    areas << "\t0 ( 0 0 0 0 0 0 ) 0 {\n\t}\n";
+
+    for (int y = 0; y < cellsPerAxis; ++y)
+    {
+        for (int x = 0; x < cellsPerAxis; ++x)
+        {
+            int areaNum = numAreas++;
+            int firstFace = numFaces - 1;
+            Vector3 min(x * CellSize, y * CellSize, 0);
+            Vector3 max = min + Vector3(CellSize, CellSize, CellSize);
+
+            // The planes are facing inwards, the area is at their front side
+            const std::pair<Vector3, double> areaPlanes[6] =
+            {
+                { Vector3(1, 0, 0), min.x() }, { Vector3(-1, 0, 0), -max.x() },
+                { Vector3(0, 1, 0), min.y() }, { Vector3(0, -1, 0), -max.y() },
+                { Vector3(0, 0, 1), min.z() }, { Vector3(0, 0, -1), -max.z() },
+            };
+
+            for (const auto& [normal, dist] : areaPlanes)
+            {
+                // Four vertices on the plane, sharing the coordinate of the normal axis
+                std::vector<Vector3> corners;
+
+                for (auto a : { 0, 1 })
+                {
+                    for (auto b : { 0, 1 })
+                    {
+                        Vector3 corner = min;
+                        int axis = normal.x() != 0 ? 0 : normal.y() != 0 ? 1 : 2;
+                        corner[axis] = normal[axis] > 0 ? min[axis] : max[axis];
+                        corner[(axis + 1) % 3] = a ? max[(axis + 1) % 3] : min[(axis + 1) % 3];
+                        corner[(axis + 2) % 3] = (a ^ b) ? max[(axis + 2) % 3] : min[(axis + 2) % 3];
+                        corners.push_back(corner);
+                    }
+                }
+
+                int firstEdge = numEdges - 1;
+
+                for (std::size_t i = 0; i < corners.size(); ++i)
+                {
+                    vertices << "\t" << numVertices << " ( " << corners[i].x() << " " << corners[i].y() << " " << corners[i].z() << " )\n";
+                    edges << "\t" << numEdges << " ( " << numVertices << " " << (numVertices - i + (i + 1) % 4) << " )\n";
+                    edgeIndex << "\t" << (numEdges - 1) << " ( " << numEdges << " )\n";
+                    ++numVertices;
+                    ++numEdges;
+                }
+
+                planes << "\t" << numPlanes << " ( " << normal.x() << " " << normal.y() << " " << normal.z() << " " << dist << " )\n";
+                faces << "\t" << numFaces << " ( " << numPlanes << " 0 " << areaNum << " 0 " << firstEdge << " 4 )\n";
+                faceIndex << "\t" << (numFaces - 1) << " ( " << numFaces << " )\n";
+                ++numPlanes;
+                ++numFaces;
+            }
+
+            areas << "\t" << areaNum << " ( 0 1 " << firstFace << " 6 0 0 ) 0 {\n\t}\n";
+        }
+    }
+
+    std::ostringstream file;
+
+    file << "DewmAAS 1.07\n\n1234567\n\n";
+    file << "planes " << numPlanes << " {\n" << planes.str() << "}\n";
+    file << "vertices " << numVertices << " {\n" << vertices.str() << "}\n";
+    file << "edges " << numEdges << " {\n" << edges.str() << "}\n";
+    file << "edgeIndex " << (numEdges - 1) << " {\n" << edgeIndex.str() << "}\n";
+    file << "faces " << numFaces << " {\n" << faces.str() << "}\n";
+    file << "faceIndex " << (numFaces - 1) << " {\n" << faceIndex.str() << "}\n";
+    file << "areas " << numAreas << " {\n" << areas.str() << "}\n";
+
+    return file.str();
+}
+
+void expectAreaQueriesWork(const map::IAasFilePtr& aasFile, int cellsPerAxis)
+{
+    ASSERT_TRUE(aasFile);
+    EXPECT_EQ(aasFile->getNumAreas(), cellsPerAxis * cellsPerAxis + 1);
+
+    for (int y = 0; y < cellsPerAxis; ++y)
+    {
+        for (int x = 0; x < cellsPerAxis; ++x)
+        {
+            auto areaNum = 1 + y * cellsPerAxis + x;
+            Vector3 cellMin(x * CellSize, y * CellSize, 0);
+
+            EXPECT_TRUE(math::isNear(aasFile->getArea(areaNum).bounds.getExtents(), Vector3(32, 32, 32), 0.01));
+            EXPECT_EQ(aasFile->getAreaContainingPoint(cellMin + Vector3(10, 50, 20)), areaNum);
+        }
+    }
+
+    EXPECT_EQ(aasFile->getAreaContainingPoint(Vector3(10, 10, 1000)), -1) << "Point is above all areas";
+    EXPECT_EQ(aasFile->getAreaContainingPoint(Vector3(-100, 10, 10)), -1) << "Point is outside the grid";
+
+    // A box spanning the first two rows and columns
+    std::set<int> foundAreas;
+    aasFile->forEachAreaIntersecting(AABB::createFromMinMax({ 10, 10, 10 }, { 100, 100, 20 }), [&](int areaNum)
+    {
+        EXPECT_TRUE(foundAreas.insert(areaNum).second) << "Area " << areaNum << " visited twice";
+    });
+
+    EXPECT_EQ(foundAreas, std::set<int>({ 1, 2, 1 + cellsPerAxis, 2 + cellsPerAxis }));
+}
+
+}
+
+TEST_F(AasTest, LoadAasFileAndQueryAreas)
+{
+    auto aasPath = _context.getTemporaryDataPath() + "grid.aas";
+    TemporaryFile aasFile(aasPath, generateGridAasFile(10));
+
+    // First load is parsing the text file
+    expectAreaQueriesWork(GlobalAasFileManager().loadAasFile(aasPath), 10);
+
+    EXPECT_FALSE(fs::is_empty(_context.getCacheDataPath() + "aas/")) << "Binary cache should have been written";
+
+    // Second load is reading the binary cache, results should be the same
+    expectAreaQueriesWork(GlobalAasFileManager().loadAasFile(aasPath), 10);
+
+    // Changing the file invalidates the cached version
+    aasFile.setContents(generateGridAasFile(12));
+    expectAreaQueriesWork(GlobalAasFileManager().loadAasFile(aasPath), 12);
+}
+
+namespace
+{
+
+std::string readBinaryFile(const std::string& path)
+{
+    std::ifstream stream(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+void writeBinaryFile(const std::string& path, const std::string& contents)
+{
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(contents.data(), contents.size());
+}
+
+}
+
+TEST_F(AasTest, DamagedBinaryCacheIsReplaced)
+{
+    auto aasPath = _context.getTemporaryDataPath() + "damaged_grid.aas";
+    TemporaryFile aasFile(aasPath, generateGridAasFile(4));
+
+    auto parsedFile = GlobalAasFileManager().loadAasFile(aasPath);
+    ASSERT_TRUE(parsedFile);
+
+    auto cachePath = _context.getCacheDataPath() + fmt::format("aas/{0:016x}.bin", std::hash<std::string>()(aasPath));
+    ASSERT_TRUE(fs::exists(cachePath)) << "Binary cache should have been written to " << cachePath;
+
+    auto validCache = readBinaryFile(cachePath);
+
+    // Header (magic, version, source file stamp, path), followed by the planes and vertices
+    auto edgesOffset = 8 + 4 + 16 + 8 + aasPath.size() +
+        8 + parsedFile->getNumPlanes() * 4 * sizeof(double) +
+        8 + parsedFile->getNumVertices() * 3 * sizeof(double);
+
+    std::string invalidVertexNumber = validCache;
+    std::int32_t vertexNumber = 0x7fffffff;
+    invalidVertexNumber.replace(edgesOffset + 8, sizeof(vertexNumber), reinterpret_cast<const char*>(&vertexNumber), sizeof(vertexNumber));
+
+    std::string invalidEdgeCount = validCache;
+    std::uint64_t edgeCount = parsedFile->getNumEdges() + 1000;
+    invalidEdgeCount.replace(edgesOffset, sizeof(edgeCount), reinterpret_cast<const char*>(&edgeCount), sizeof(edgeCount));
+
+    std::map<std::string, std::string> damagedCaches
+    {
+        { "invalid vertex number", invalidVertexNumber },
+        { "invalid edge count", invalidEdgeCount },
+        { "truncated", validCache.substr(0, validCache.size() - 10) },
+        { "trailing data", validCache + "garbage" },
+    };
+
+    for (const auto& [description, contents] : damagedCaches)
+    {
+        writeBinaryFile(cachePath, contents);
+
+        // The source file is parsed again, which writes a new cache file
+        expectAreaQueriesWork(GlobalAasFileManager().loadAasFile(aasPath), 4);
+        EXPECT_EQ(readBinaryFile(cachePath), validCache) << "Cache has not been replaced after loading a " << description << " file";
+    }
+}
+
+}
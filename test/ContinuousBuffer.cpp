@@ -650,4 +650,165 @@ TEST(ContinuousBufferTest, SyncToBufferAfterApplyingTransaction)
     EXPECT_TRUE(checkDataInBufferObject(buffer, handle2, *bufferObject, eight)) << "Data sync unsuccessful";
 }
 
+
+TEST(ContinuousBufferTest, Compaction)
+{
+    auto eight = std::vector<int>({ 0,1,2,3,4,5,6,7 });
+    auto eight2 = std::vector<int>({ 8,9,10,11,12,13,14,15 });
+
+    render::ContinuousBuffer<int> buffer(64);
+
+    auto handle1 = buffer.allocate(eight.size());
+    auto handle2 = buffer.allocate(eight.size());
+    auto handle3 = buffer.allocate(eight.size());
+    auto handle4 = buffer.allocate(eight.size());
+
+    buffer.setData(handle1, eight);
+    buffer.setData(handle2, eight);
+    buffer.setData(handle3, eight2);
+    buffer.setData(handle4, eight2);
+
+    // Punch two holes into the buffer
+    buffer.deallocate(handle1);
+    buffer.deallocate(handle3);
+
+    EXPECT_EQ(buffer.getNumReleasedElements(), 16);
+
+    auto stats = buffer.getMemoryStatistics();
+    EXPECT_EQ(stats.usedElements, 16);
+    EXPECT_EQ(stats.numFreeBlocks, 3) << "Expected two holes and the free block at the end";
+    EXPECT_GT(stats.getFragmentation(), 0);
+
+    std::vector<render::ContinuousBuffer<int>::Handle> movedHandles;
+    EXPECT_TRUE(buffer.compact(1024, [&](render::ContinuousBuffer<int>::Handle handle, std::size_t numElements)
+    {
+        EXPECT_EQ(numElements, eight.size());
+        movedHandles.push_back(handle);
+    }));
+
+    EXPECT_EQ(movedHandles, std::vector<render::ContinuousBuffer<int>::Handle>({ handle2, handle4 }));
+
+    // The remaining slots are packed at the start of the buffer
+    EXPECT_EQ(buffer.getOffset(handle2), 0);
+    EXPECT_EQ(buffer.getOffset(handle4), 8);
+    EXPECT_TRUE(checkData(buffer, handle2, eight));
+    EXPECT_TRUE(checkData(buffer, handle4, eight2));
+
+    stats = buffer.getMemoryStatistics();
+    EXPECT_EQ(stats.bufferSize, 64);
+    EXPECT_EQ(stats.usedElements, 16);
+    EXPECT_EQ(stats.numFreeBlocks, 1);
+    EXPECT_EQ(stats.largestFreeBlock, 48);
+    EXPECT_EQ(stats.getFragmentation(), 0);
+    EXPECT_EQ(buffer.getNumReleasedElements(), 0);
+
+    // The free space is fully usable without growing the buffer
+    auto handle5 = buffer.allocate(48);
+    EXPECT_EQ(buffer.getOffset(handle5), 16);
+    EXPECT_EQ(buffer.getMemoryStatistics().bufferSize, 64);
+}
+
+TEST(ContinuousBufferTest, CompactionWithBudget)
+{
+    auto eight = std::vector<int>({ 0,1,2,3,4,5,6,7 });
+
+    render::ContinuousBuffer<int> buffer(64);
+
+    auto handle1 = buffer.allocate(eight.size());
+    auto handle2 = buffer.allocate(eight.size());
+    auto handle3 = buffer.allocate(eight.size());
+    auto handle4 = buffer.allocate(eight.size());
+    buffer.setData(handle2, eight);
+    buffer.setData(handle4, eight);
+
+    buffer.deallocate(handle1);
+    buffer.deallocate(handle3);
+
+    // Every call is moving one slot only
+    EXPECT_FALSE(buffer.compact(1));
+    EXPECT_EQ(buffer.getOffset(handle2), 0);
+    EXPECT_EQ(buffer.getOffset(handle4), 24) << "Slot 4 should not have been moved yet";
+    EXPECT_TRUE(checkData(buffer, handle2, eight));
+
+    EXPECT_TRUE(buffer.compact(1));
+    EXPECT_EQ(buffer.getOffset(handle4), 8);
+    EXPECT_TRUE(checkData(buffer, handle4, eight));
+
+    // Allocations must not overlap the moved data
+    auto handle5 = buffer.allocate(8);
+    EXPECT_EQ(buffer.getOffset(handle5), 16);
+}
+
+TEST(ContinuousBufferTest, CompactionShrinksBuffer)
+{
+    auto sixteen = std::vector<int>({ 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15 });
+
+    render::ContinuousBuffer<int> buffer(16);
+
+    std::vector<render::ContinuousBuffer<int>::Handle> handles;
+
+    for (auto i = 0; i < 8; ++i)
+    {
+        handles.push_back(buffer.allocate(sixteen.size()));
+        buffer.setData(handles.back(), sixteen);
+    }
+
+    EXPECT_GE(buffer.getMemoryStatistics().bufferSize, 128);
+
+    // Keep only the last slot
+    for (auto i = 0; i < 7; ++i)
+    {
+        buffer.deallocate(handles[i]);
+    }
+
+    EXPECT_TRUE(buffer.compact(1024));
+
+    // Shrinks to twice the size of the data
+    EXPECT_EQ(buffer.getMemoryStatistics().bufferSize, 32);
+    EXPECT_EQ(buffer.getOffset(handles[7]), 0);
+    EXPECT_TRUE(checkData(buffer, handles[7], sixteen));
+
+    auto stats = buffer.getMemoryStatistics();
+    EXPECT_EQ(stats.usedElements, 16);
+    EXPECT_EQ(stats.freeElements, 16);
+
+    // Syncing the shrunk buffer re-uploads everything
+    auto bufferObject = std::make_shared<TestBufferObject>();
+    buffer.syncModificationsToBufferObject(bufferObject);
+    EXPECT_EQ(bufferObject->buffer.size(), 32 * sizeof(int));
+    EXPECT_TRUE(checkDataInBufferObject(buffer, handles[7], *bufferObject, sixteen));
+}
+
+// Moved slots can be replicated to another buffer through the transaction log
+TEST(ContinuousBufferTest, ApplyCompactionTransactions)
+{
+    auto eight = std::vector<int>({ 0,1,2,3,4,5,6,7 });
+    auto eight2 = std::vector<int>({ 8,9,10,11,12,13,14,15 });
+
+    render::ContinuousBuffer<int> buffer(64);
+
+    auto handle1 = buffer.allocate(eight.size());
+    auto handle2 = buffer.allocate(eight.size());
+    auto handle3 = buffer.allocate(eight.size());
+    buffer.setData(handle1, eight);
+    buffer.setData(handle2, eight);
+    buffer.setData(handle3, eight2);
+    buffer.deallocate(handle1);
+
+    auto buffer2 = buffer;
+
+    std::vector<render::detail::BufferTransaction> transactionLog;
+    buffer.compact(1024, [&](render::ContinuousBuffer<int>::Handle handle, std::size_t numElements)
+    {
+        transactionLog.emplace_back(render::detail::BufferTransaction{ handle, 0, numElements });
+    });
+
+    buffer2.applyTransactions(transactionLog, buffer, [&](render::IGeometryStore::Slot slot) { return static_cast<uint32_t>(slot); });
+
+    EXPECT_EQ(buffer2.getOffset(handle2), 0);
+    EXPECT_EQ(buffer2.getOffset(handle3), 8);
+    EXPECT_TRUE(checkData(buffer2, handle2, eight));
+    EXPECT_TRUE(checkData(buffer2, handle3, eight2));
+}
+
 }
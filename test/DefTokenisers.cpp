@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 
 #include "parser/DefTokeniser.h"
+#include "parser/BufferTokeniser.h"
 
 namespace test
 {
@@ -128,4 +129,40 @@ TEST(DefTokeniser, EmptyQuotesAtEndOfBlock)
     EXPECT_EQ(keyValuePairs["mins"], "-1 -1 -3");
 }
 
+TEST(BufferTokeniser, TokensMatchBasicDefTokeniser)
+{
+    std::string testString = R"(// header comment
+numJoints 2
+joints {
+	"origin"	-1 ( 0 0.5 -2.25 ) ( -0.5 0 0 )		/* inline */ // origin
+	"flag"{}
+}
+)";
+
+    parser::BasicDefTokeniser<std::string> basicTokeniser(testString);
+    parser::BufferTokeniser bufferTokeniser(testString);
+
+    while (basicTokeniser.hasMoreTokens())
+    {
+        EXPECT_TRUE(bufferTokeniser.hasMoreTokens());
+        EXPECT_EQ(bufferTokeniser.peek(), basicTokeniser.peek());
+        EXPECT_EQ(bufferTokeniser.nextToken(), basicTokeniser.nextToken());
+    }
+
+    EXPECT_FALSE(bufferTokeniser.hasMoreTokens());
+}
+
+TEST(BufferTokeniser, ParseNumbers)
+{
+    parser::BufferTokeniser tokeniser(std::string("2 -0.5 1e3 +4 noNumber 12"));
+
+    EXPECT_EQ(tokeniser.nextNumber<std::size_t>(), 2);
+    EXPECT_EQ(tokeniser.nextNumber<float>(), -0.5f);
+    EXPECT_EQ(tokeniser.nextNumber<double>(), 1000.0);
+    EXPECT_EQ(tokeniser.nextNumber<int>(), 4);
+    EXPECT_EQ(tokeniser.nextNumber<int>(), 0);
+    EXPECT_EQ(tokeniser.nextTokenView(), "12");
+    EXPECT_FALSE(tokeniser.hasMoreTokens());
+}
+
 }
@@ -8,17 +8,23 @@
 #include "ifilesystem.h"
 #include "isound.h"
 #include "iundo.h"
+#include "icommandsystem.h"
+#include "ilogwriter.h"
 #include "ishaders.h"
 #include "render/RenderableCollectionWalker.h"
 
 #include "render/NopVolumeTest.h"
 #include "string/convert.h"
+#include "string/predicate.h"
 #include "transformlib.h"
 #include "registry/registry.h"
 #include "scenelib.h"
 #include "algorithm/Entity.h"
 #include "algorithm/Scene.h"
 
+#include <cstdio>
+#include <sstream>
+
 namespace test
 {
 
@@ -241,6 +247,150 @@ TEST_F(EntityTest, CopySpawnargs)
     EXPECT_EQ(overlap.size(), 0);
 }
 
+TEST_F(EntityTest, KeyLookupIgnoresCase)
+{
+    auto entity = algorithm::createEntityByClassName("atdm:light_base");
+    auto& spawnArgs = entity->getEntity();
+
+    // A key that has never been used anywhere is not found
+    EXPECT_EQ(spawnArgs.getKeyValue("a_key_nobody_has_ever_used"), "");
+
+    spawnArgs.setKeyValue("Custom_Spawnarg", "1");
+    EXPECT_EQ(spawnArgs.getKeyValue("custom_spawnarg"), "1");
+    EXPECT_EQ(spawnArgs.getKeyValue("CUSTOM_SPAWNARG"), "1");
+
+    // Assigning a different spelling overwrites the existing key, keeping its spelling
+    spawnArgs.setKeyValue("CUSTOM_SPAWNARG", "2");
+
+    std::vector<std::string> customKeys;
+    spawnArgs.forEachKeyValue([&](const std::string& k, const std::string& v)
+    {
+        if (string::iequals(k, "custom_spawnarg"))
+        {
+            customKeys.push_back(k);
+            EXPECT_EQ(v, "2");
+        }
+    });
+
+    EXPECT_EQ(customKeys, std::vector<std::string>{ "Custom_Spawnarg" });
+
+    // Removal works regardless of case too
+    spawnArgs.setKeyValue("custom_SPAWNARG", "");
+    EXPECT_EQ(spawnArgs.getKeyValue("Custom_Spawnarg"), "");
+}
+
+namespace
+{
+
+// Collects the log output while it's alive
+class LogCapture :
+    public applog::ILogDevice
+{
+private:
+    applog::ILogWriter& _writer;
+
+public:
+    std::string output;
+
+    LogCapture(applog::ILogWriter& writer) :
+        _writer(writer)
+    {
+        _writer.attach(this);
+    }
+
+    ~LogCapture()
+    {
+        _writer.detach(this);
+    }
+
+    void writeLog(const std::string& outputStr, applog::LogLevel level) override
+    {
+        output.append(outputStr);
+    }
+};
+
+struct EntityMemoryStats
+{
+    std::size_t numSpawnargs = 0;
+    std::size_t numObservedSpawnargs = 0;
+    std::size_t numInternedKeys = 0;
+};
+
+// Runs the ShowEntityMemoryStats command and parses its output
+EntityMemoryStats getEntityMemoryStats(applog::ILogWriter& logWriter)
+{
+    LogCapture capture(logWriter);
+    GlobalCommandSystem().executeCommand("ShowEntityMemoryStats");
+
+    EntityMemoryStats stats;
+    std::istringstream lines(capture.output);
+
+    for (std::string line; std::getline(lines, line);)
+    {
+        std::sscanf(line.c_str(), "Spawnargs: %zu (%zu", &stats.numSpawnargs, &stats.numObservedSpawnargs);
+        std::sscanf(line.c_str(), "Interned Keys: %zu", &stats.numInternedKeys);
+    }
+
+    return stats;
+}
+
+std::size_t countSpawnargsInMap()
+{
+    std::size_t count = 0;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity)
+        {
+            entity->forEachKeyValue([&](const std::string&, const std::string&) { ++count; });
+        }
+
+        return true;
+    });
+
+    return count;
+}
+
+}
+
+TEST_F(EntityTest, SpawnargMemoryStats)
+{
+    auto& logWriter = _coreModule->get()->getLogWriter();
+
+    auto first = TestEntity::create("light");
+    auto second = TestEntity::create("light");
+
+    first.args().setKeyValue("memory_stats_test_key", "1");
+
+    auto before = getEntityMemoryStats(logWriter);
+
+    EXPECT_EQ(before.numSpawnargs, countSpawnargsInMap());
+    EXPECT_GT(before.numInternedKeys, 0);
+
+    // Only the keys with observers attached carry the extra state, the custom key has none
+    EXPECT_LT(before.numObservedSpawnargs, before.numSpawnargs);
+
+    // A key used by another entity is not stored again
+    second.args().setKeyValue("memory_stats_test_key", "2");
+    second.args().setKeyValue("MEMORY_STATS_TEST_KEY", "3");
+
+    auto after = getEntityMemoryStats(logWriter);
+
+    EXPECT_EQ(after.numSpawnargs, before.numSpawnargs + 1);
+    EXPECT_EQ(after.numInternedKeys, before.numInternedKeys);
+    EXPECT_EQ(second.args().getKeyValue("memory_stats_test_key"), "3");
+
+    // Copies reuse the interned keys of the original
+    auto copy = first.node->clone();
+    scene::addNodeToContainer(copy, GlobalMapModule().getRoot());
+
+    auto afterCopy = getEntityMemoryStats(logWriter);
+
+    EXPECT_EQ(afterCopy.numSpawnargs, countSpawnargsInMap());
+    EXPECT_GT(afterCopy.numSpawnargs, after.numSpawnargs);
+    EXPECT_EQ(afterCopy.numInternedKeys, after.numInternedKeys);
+}
+
 TEST_F(EntityTest, UndoRedoSpawnargValueChange)
 {
     // Create entity with initial default args.
@@ -500,6 +500,123 @@ entityDef changingVisibility
     EXPECT_EQ(eclass->getVisibility(), vfs::Visibility::NORMAL) << "Should be visible now";
 }
 
+TEST_F(EntityClassTest, InheritedAttributesUpdatedAfterReloadDecls)
+{
+    TemporaryFile tempFile(_context.getTestProjectPath() + "def/temporary_file.def");
+
+    tempFile.setContents(R"(
+entityDef reloadTestParent
+{
+    "editor_usage" "parent"
+    "first_key" "1"
+}
+entityDef reloadTestChild
+{
+    "inherit" "reloadTestParent"
+    "second_key" "2"
+}
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    auto child = GlobalEntityClassManager().findClass("reloadTestChild");
+    ASSERT_TRUE(child);
+    EXPECT_EQ(child->getAttributeValue("first_key"), "1");
+    EXPECT_EQ(child->getAttributeValue("FIRST_KEY"), "1") << "Attribute lookup should ignore case";
+    EXPECT_EQ(child->getAttributeValue("second_key"), "2");
+
+    // Change the parent only, the child must pick up the new inherited values
+    tempFile.setContents(R"(
+entityDef reloadTestParent
+{
+    "editor_usage" "parent"
+    "first_key" "one"
+    "third_key" "3"
+}
+entityDef reloadTestChild
+{
+    "inherit" "reloadTestParent"
+    "second_key" "2"
+}
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_EQ(child->getAttributeValue("first_key"), "one");
+    EXPECT_EQ(child->getAttributeValue("third_key"), "3");
+
+    std::map<std::string, bool> attributes;
+    child->forEachAttribute([&](const EntityClassAttribute& a, bool inherited)
+    {
+        EXPECT_TRUE(attributes.emplace(a.getName(), inherited).second) << "Attribute visited twice: " << a.getName();
+    }, false);
+
+    EXPECT_EQ(attributes.count("editor_usage"), 0) << "Editor keys should have been skipped";
+    EXPECT_EQ(attributes.at("first_key"), true);
+    EXPECT_EQ(attributes.at("third_key"), true);
+    EXPECT_EQ(attributes.at("second_key"), false);
+}
+
+TEST_F(EntityClassTest, InheritedAttributesFollowGrandparentReload)
+{
+    TemporaryFile tempFile(_context.getTestProjectPath() + "def/temporary_file.def");
+
+    const std::string derivedClasses = R"(
+entityDef reloadTestParent
+{
+    "inherit" "reloadTestGrandparent"
+    "second_key" "2"
+}
+entityDef reloadTestChild
+{
+    "inherit" "reloadTestParent"
+    "third_key" "3"
+}
+)";
+
+    tempFile.setContents(R"(
+entityDef reloadTestGrandparent
+{
+    "first_key" "1"
+}
+)" + derivedClasses);
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    // Query the child first, its ancestors have not been parsed yet
+    auto child = GlobalEntityClassManager().findClass("reloadTestChild");
+    ASSERT_TRUE(child);
+    EXPECT_EQ(child->getAttributeValue("first_key"), "1");
+    EXPECT_EQ(child->getAttributeValue("second_key"), "2");
+    EXPECT_EQ(child->getAttributeValue("third_key"), "3");
+
+    // Only the grandparent changes, the classes in between are not touched
+    tempFile.setContents(R"(
+entityDef reloadTestGrandparent
+{
+    "first_key" "one"
+    "fourth_key" "4"
+}
+)" + derivedClasses);
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_EQ(child->getAttributeValue("first_key"), "one");
+    EXPECT_EQ(child->getAttributeValue("fourth_key"), "4");
+    EXPECT_EQ(child->getAttributeValue("second_key"), "2");
+
+    std::map<std::string, bool> attributes;
+    child->forEachAttribute([&](const EntityClassAttribute& a, bool inherited)
+    {
+        attributes.emplace(a.getName(), inherited);
+    }, false);
+
+    EXPECT_EQ(attributes.at("first_key"), true);
+    EXPECT_EQ(attributes.at("second_key"), true);
+    EXPECT_EQ(attributes.at("third_key"), false);
+    EXPECT_EQ(attributes.at("fourth_key"), true);
+}
+
 TEST_F(EntityClassTest, GetAttributeValue)
 {
     auto eclass = GlobalEntityClassManager().findClass("attribute_type_test");
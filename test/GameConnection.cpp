@@ -0,0 +1,291 @@
+#include "RadiantTest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include "imap.h"
+#include "ientity.h"
+#include "algorithm/Entity.h"
+#include <fmt/format.h>
+
+#include "../plugins/dm.gameconnection/AutomationEngine.h"
+#include "../plugins/dm.gameconnection/MapObserver.h"
+#include "../plugins/dm.gameconnection/MapUpdateSender.h"
+#include "../plugins/dm.gameconnection/MessageTcp.h"
+#include "../plugins/dm.gameconnection/clsocket/PassiveSocket.h"
+
+namespace test
+{
+
+namespace
+{
+
+// The port the AutomationEngine is connecting to
+constexpr int AUTOMATION_PORT = 3879;
+
+constexpr int TAG_UPDATEMAP = 8;
+
+// Stands in for a game instance with automation enabled, running on the same thread
+class FakeGameServer
+{
+public:
+    struct Request
+    {
+        int seqno;
+        std::string content;
+    };
+
+private:
+    CPassiveSocket _listener;
+    gameconn::MessageTcp _connection;
+
+public:
+    bool listen()
+    {
+        return _listener.Initialize() && _listener.Listen("127.0.0.1", AUTOMATION_PORT);
+    }
+
+    bool accept()
+    {
+        std::unique_ptr<CActiveSocket> socket(_listener.Accept());
+
+        if (!socket || !socket->SetNonblocking())
+        {
+            return false;
+        }
+
+        _connection.init(std::move(socket));
+        return _connection.isAlive();
+    }
+
+    // Returns the requests received since the last call
+    std::vector<Request> receive()
+    {
+        std::vector<Request> requests;
+        std::vector<char> message;
+
+        _connection.think();
+
+        while (_connection.readMessage(message))
+        {
+            int seqno = 0, lineLength = 0;
+            std::sscanf(message.data(), "seqno %d\n%n", &seqno, &lineLength);
+
+            requests.push_back(Request{ seqno, std::string(message.begin() + lineLength, message.end()) });
+        }
+
+        return requests;
+    }
+
+    void respond(int seqno, const std::string& content)
+    {
+        auto response = fmt::format("response {0}\n", seqno) + content;
+        _connection.writeMessage(response.data(), static_cast<int>(response.size()));
+        _connection.think();
+    }
+};
+
+}
+
+class GameConnectionTest :
+    public RadiantTest
+{
+protected:
+    FakeGameServer _server;
+    gameconn::AutomationEngine _engine;
+    gameconn::MapObserver _observer;
+    std::unique_ptr<gameconn::MapUpdateSender> _sender;
+
+    std::vector<scene::INodePtr> _entities;
+
+    void SetUp() override
+    {
+        RadiantTest::SetUp();
+
+        if (!_server.listen())
+        {
+            GTEST_SKIP() << "Automation port " << AUTOMATION_PORT << " is not available";
+        }
+
+        ASSERT_TRUE(_engine.connect()) << "Could not connect to the fake game";
+        ASSERT_TRUE(_server.accept()) << "Fake game didn't accept the connection";
+
+        // The request just lists the names of the changed entities
+        _sender = std::make_unique<gameconn::MapUpdateSender>(_engine, _observer, TAG_UPDATEMAP,
+            [](const gameconn::DiffEntityStatuses& changes)
+        {
+            std::string request;
+
+            for (const auto& [name, status] : changes)
+            {
+                request += name + "\n";
+            }
+
+            return request;
+        });
+
+        for (int i = 0; i < 3; ++i)
+        {
+            auto entity = algorithm::createEntityByClassName("light");
+            GlobalMapModule().getRoot()->addChildNode(entity);
+            _entities.push_back(entity);
+        }
+
+        _observer.setEnabled(true);
+    }
+
+    void TearDown() override
+    {
+        _observer.setEnabled(false);
+        _sender.reset();
+        _engine.disconnect(true);
+        _entities.clear();
+
+        RadiantTest::TearDown();
+    }
+
+    std::string changeEntity(std::size_t index)
+    {
+        auto* entity = Node_getEntity(_entities.at(index));
+        entity->setKeyValue("_color", entity->getKeyValue("_color") == "1 0 0" ? "0 1 0" : "1 0 0");
+
+        return entity->getKeyValue("name");
+    }
+
+    // Runs both ends of the connection until the given number of requests arrived at the game
+    std::vector<FakeGameServer::Request> receiveRequests(std::size_t count)
+    {
+        std::vector<FakeGameServer::Request> requests;
+
+        for (int i = 0; i < 1000 && requests.size() < count; ++i)
+        {
+            _engine.think();
+
+            for (const auto& request : _server.receive())
+            {
+                requests.push_back(request);
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return requests;
+    }
+
+    // Runs the engine until all diffs in flight have been answered
+    void waitForResponses()
+    {
+        for (int i = 0; i < 1000 && _sender->getNumInFlight() > 0; ++i)
+        {
+            _engine.think();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+};
+
+TEST_F(GameConnectionTest, MapUpdateSuccess)
+{
+    auto name = changeEntity(0);
+    EXPECT_EQ(_observer.getChanges().count(name), 1);
+
+    EXPECT_TRUE(_sender->send());
+
+    // The changes are taken out of the observer as soon as they are sent
+    EXPECT_TRUE(_observer.getChanges().empty());
+    EXPECT_EQ(_sender->getNumInFlight(), 1);
+
+    auto requests = receiveRequests(1);
+    ASSERT_EQ(requests.size(), 1);
+    EXPECT_EQ(requests[0].content, name + "\n");
+
+    _server.respond(requests[0].seqno, "HotReload: SUCCESS\n");
+    waitForResponses();
+
+    EXPECT_EQ(_sender->getNumInFlight(), 0);
+    EXPECT_TRUE(_observer.getChanges().empty()) << "Applied changes should not be sent again";
+}
+
+TEST_F(GameConnectionTest, FailedMapUpdateIsRestored)
+{
+    auto firstName = changeEntity(0);
+    EXPECT_TRUE(_sender->send());
+
+    // This one happens while the first diff is in flight
+    auto secondName = changeEntity(1);
+
+    auto requests = receiveRequests(1);
+    ASSERT_EQ(requests.size(), 1);
+
+    _server.respond(requests[0].seqno, "HotReload: FAILED\n");
+    waitForResponses();
+
+    EXPECT_EQ(_sender->getNumInFlight(), 0);
+
+    // Both changes need to go with the next diff
+    EXPECT_EQ(_observer.getChanges().size(), 2);
+    EXPECT_EQ(_observer.getChanges().count(firstName), 1);
+    EXPECT_EQ(_observer.getChanges().count(secondName), 1);
+}
+
+TEST_F(GameConnectionTest, MultipleMapUpdatesInFlight)
+{
+    std::vector<std::string> names;
+
+    for (int i = 0; i < gameconn::MapUpdateSender::MAX_IN_FLIGHT; ++i)
+    {
+        EXPECT_TRUE(_sender->canSendMore());
+
+        names.push_back(changeEntity(i));
+        EXPECT_TRUE(_sender->send());
+    }
+
+    EXPECT_EQ(_sender->getNumInFlight(), gameconn::MapUpdateSender::MAX_IN_FLIGHT);
+    EXPECT_FALSE(_sender->canSendMore()) << "Sender should wait for the game to catch up";
+
+    // The diffs arrive in the order they have been sent
+    auto requests = receiveRequests(names.size());
+    ASSERT_EQ(requests.size(), names.size());
+
+    for (std::size_t i = 0; i < names.size(); ++i)
+    {
+        EXPECT_EQ(requests[i].content, names[i] + "\n");
+    }
+
+    // The game fails to apply the middle one
+    _server.respond(requests[0].seqno, "HotReload: SUCCESS\n");
+    _server.respond(requests[1].seqno, "HotReload: FAILED\n");
+    _server.respond(requests[2].seqno, "HotReload: SUCCESS\n");
+    waitForResponses();
+
+    EXPECT_EQ(_sender->getNumInFlight(), 0);
+    EXPECT_TRUE(_sender->canSendMore());
+
+    EXPECT_EQ(_observer.getChanges().size(), 1);
+    EXPECT_EQ(_observer.getChanges().count(names[1]), 1);
+}
+
+TEST_F(GameConnectionTest, MapUpdatesInFlightAreRestoredOnDisconnect)
+{
+    auto firstName = changeEntity(0);
+    EXPECT_TRUE(_sender->send());
+
+    auto secondName = changeEntity(1);
+    EXPECT_TRUE(_sender->send());
+
+    auto pendingName = changeEntity(2);
+
+    ASSERT_EQ(receiveRequests(2).size(), 2);
+
+    // The game goes away without responding
+    _sender->restoreInFlight();
+    _engine.disconnect(true);
+
+    EXPECT_EQ(_sender->getNumInFlight(), 0);
+
+    EXPECT_EQ(_observer.getChanges().size(), 3);
+    EXPECT_EQ(_observer.getChanges().count(firstName), 1);
+    EXPECT_EQ(_observer.getChanges().count(secondName), 1);
+    EXPECT_EQ(_observer.getChanges().count(pendingName), 1);
+}
+
+}
@@ -398,6 +398,108 @@ TEST(GeometryStore, FrameBufferSwitching)
     EXPECT_GT(deallocationCount, 0) << "No deallocation operations performed";
 }
 
+// Switching the number of frame buffers keeps the stored data
+TEST(GeometryStore, SetNumFrameBuffers)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+
+    std::vector<Allocation> allocations;
+
+    store.onFrameStart();
+
+    for (auto i = 0; i < 10; ++i)
+    {
+        auto vertices = generateVertices(i, (i + 5) * 20);
+        auto indices = generateIndices(vertices);
+
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        store.updateData(slot, vertices, indices);
+
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
+
+    store.onFrameFinished();
+
+    store.setNumFrameBuffers(3);
+    EXPECT_EQ(store.getNumFrameBuffers(), 3);
+
+    // Every frame buffer needs to have the full data set
+    for (auto frame = 0; frame < 3; ++frame)
+    {
+        store.onFrameStart();
+        verifyAllAllocations(store, allocations);
+        store.onFrameFinished();
+    }
+}
+
+// Deallocations leave gaps in the buffers, which are closed over the next frames
+TEST(GeometryStore, CompactionAfterDeallocation)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+    store.setNumFrameBuffers(3);
+
+    std::vector<Allocation> allocations;
+
+    store.onFrameStart();
+
+    for (auto i = 0; i < 200; ++i)
+    {
+        auto vertices = generateVertices(i, 200 + i % 7);
+        auto indices = generateIndices(vertices);
+
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        store.updateData(slot, vertices, indices);
+
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
+
+    store.onFrameFinished();
+
+    // Release every second allocation, leaving lots of holes
+    store.onFrameStart();
+
+    std::vector<Allocation> remainingAllocations;
+
+    for (auto i = 0; i < allocations.size(); ++i)
+    {
+        if (i % 2 == 0)
+        {
+            store.deallocateSlot(allocations[i].slot);
+        }
+        else
+        {
+            remainingAllocations.push_back(allocations[i]);
+        }
+    }
+
+    EXPECT_GT(store.getMemoryStatistics().first.numFreeBlocks, 50);
+
+    store.onFrameFinished();
+
+    std::minstd_rand rand(17); // fixed seed
+
+    // Compaction is spread over several frames, data must be intact after every step
+    for (auto frame = 0; frame < 20; ++frame)
+    {
+        store.onFrameStart();
+        verifyAllAllocations(store, remainingAllocations);
+
+        // Modify some data while the slots are moving around
+        auto& allocation = remainingAllocations[rand() % remainingAllocations.size()];
+        allocation.vertices = generateVertices(frame, allocation.vertices.size());
+        store.updateData(allocation.slot, allocation.vertices, allocation.indices);
+
+        store.onFrameFinished();
+    }
+
+    auto [vertexStats, indexStats] = store.getMemoryStatistics();
+
+    EXPECT_EQ(vertexStats.numFreeBlocks, 1) << "Vertex storage should be compacted";
+    EXPECT_EQ(vertexStats.getFragmentation(), 0);
+    EXPECT_EQ(indexStats.numFreeBlocks, 1) << "Index storage should be compacted";
+    EXPECT_EQ(indexStats.getFragmentation(), 0);
+}
+
 TEST(GeometryStore, SyncObjectAcquisition)
 {
     render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
@@ -9,6 +9,7 @@
 #include "ifilesystem.h"
 #include "iradiant.h"
 #include "iselectiongroup.h"
+#include "iselectionset.h"
 #include "ilightnode.h"
 #include "icommandsystem.h"
 #include "messages/ApplicationShutdownRequest.h"
@@ -17,15 +18,22 @@
 #include "messages/MapFileOperation.h"
 #include "messages/FileSaveConfirmation.h"
 #include "messages/NotificationMessage.h"
+#include "messages/AutomaticMapSaveFinished.h"
 #include "algorithm/Scene.h"
 #include "algorithm/XmlUtils.h"
 #include "algorithm/Primitives.h"
+#include "algorithm/Entity.h"
+#include "algorithm/FileUtils.h"
 #include "os/file.h"
 #include <sigc++/connection.h>
 #include "testutil/FileSelectionHelper.h"
 #include "testutil/FileSaveConfirmationHelper.h"
 #include "registry/registry.h"
 #include "testutil/TemporaryFile.h"
+#include "string/predicate.h"
+#include <fmt/format.h>
+
+#include "../radiantcore/map/autosaver/AutosaveJournal.h"
 
 using namespace std::chrono_literals;
 
@@ -1310,6 +1318,448 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportAbsolutePaths)
 namespace
 {
 
+const char* const TEST_SELECTION_SET_NAME = "Autosave Test Set";
+
+// Puts two worldspawn primitives and the worldspawn itself into a new selection set
+void createTestSelectionSet(const scene::IMapRootNodePtr& root)
+{
+    auto worldspawn = algorithm::findWorldspawn(root);
+    auto set = root->getSelectionSetManager().createSelectionSet(TEST_SELECTION_SET_NAME);
+
+    set->addNode(worldspawn);
+
+    std::size_t numPrimitives = 0;
+    worldspawn->foreachNode([&](const scene::INodePtr& node)
+    {
+        set->addNode(node);
+        return ++numPrimitives < 2;
+    });
+
+    ASSERT_EQ(set->getNodes().size(), 3);
+}
+
+void checkTestSelectionSet(const scene::IMapRootNodePtr& root)
+{
+    auto set = root->getSelectionSetManager().findSelectionSet(TEST_SELECTION_SET_NAME);
+    ASSERT_TRUE(set) << "Selection set has not been restored";
+
+    auto nodes = set->getNodes();
+    EXPECT_EQ(nodes.size(), 3);
+    EXPECT_EQ(nodes.count(algorithm::findWorldspawn(root)), 1) << "Worldspawn should be a member";
+
+    for (const auto& node : nodes)
+    {
+        EXPECT_EQ(node->getRootNode(), root) << "Set member is not part of the map";
+    }
+}
+
+}
+
+TEST_F(MapSavingTest, AutoSaveInBackground)
+{
+    std::string modRelativePath = "maps/altar.map";
+    GlobalCommandSystem().executeCommand("OpenMap", modRelativePath);
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "backgroundsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+    registry::setValue(map::RKEY_AUTOSAVE_IN_BACKGROUND, true);
+
+    // The altar info file doesn't define any selection sets
+    createTestSelectionSet(GlobalMapModule().getRoot());
+
+    std::string expectedSnapshotPath = snapshotFolder + "altar.0.map";
+    EXPECT_FALSE(os::fileOrDirExists(expectedSnapshotPath)) << "Snapshot already exists in " << expectedSnapshotPath;
+
+    std::size_t numFinishedMessages = 0;
+    bool saveSucceeded = false;
+    auto msgSubscription = GlobalRadiantCore().getMessageBus().addListener(
+        radiant::IMessage::Type::AutomaticMapSaveFinished,
+        radiant::TypeListener<map::AutomaticMapSaveFinished>([&](map::AutomaticMapSaveFinished& msg)
+    {
+        ++numFinishedMessages;
+        saveSucceeded = msg.isSuccessful();
+    }));
+
+    GlobalAutoSaver().performAutosave();
+
+    // Changes made while the autosave is running must not end up in the file
+    auto worldspawn = algorithm::findWorldspawn(GlobalMapModule().getRoot());
+    auto colourBeforeSave = Node_getEntity(worldspawn)->getKeyValue("_color");
+    EXPECT_NE(colourBeforeSave, "1 0 0") << "Test map already has the colour we're going to set";
+
+    Node_getEntity(worldspawn)->setKeyValue("_color", "1 0 0");
+
+    GlobalAutoSaver().waitForPendingSave();
+    GlobalRadiantCore().getMessageBus().processPostedMessages();
+
+    EXPECT_EQ(numFinishedMessages, 1) << "Expected the finished message after the background save";
+    EXPECT_TRUE(saveSucceeded) << "Background save reported a failure";
+    EXPECT_TRUE(os::fileOrDirExists(expectedSnapshotPath)) << "Snapshot should now exist in " << expectedSnapshotPath;
+
+    GlobalRadiantCore().getMessageBus().removeListener(msgSubscription);
+
+    auto infoFilePath = os::replaceExtension(expectedSnapshotPath, "darkradiant");
+    EXPECT_TRUE(algorithm::fileContainsText(infoFilePath, TEST_SELECTION_SET_NAME)) << "Selection set missing in the info file";
+
+    // The snapshot needs to contain the same layers, groups, sets and properties
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", expectedSnapshotPath);
+    checkAltarScene();
+    checkTestSelectionSet(GlobalMapModule().getRoot());
+
+    // The snapshot has been taken before the colour was changed
+    auto savedWorldspawn = algorithm::findWorldspawn(GlobalMapModule().getRoot());
+    EXPECT_NE(Node_getEntity(savedWorldspawn)->getKeyValue("_color"), "1 0 0") << "Change made during the save ended up in the file";
+    EXPECT_EQ(Node_getEntity(savedWorldspawn)->getKeyValue("_color"), colourBeforeSave);
+
+    fs::remove(os::replaceExtension(expectedSnapshotPath, "darkradiant"));
+    fs::remove(expectedSnapshotPath);
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalRecovery)
+{
+    std::string modRelativePath = "maps/altar.map";
+    GlobalCommandSystem().executeCommand("OpenMap", modRelativePath);
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journalsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+    registry::setValue(map::RKEY_AUTOSAVE_JOURNAL_ENABLED, true);
+
+    auto journalFolder = snapshotFolder + "altar.map.journal/";
+
+    // The first save writes the base snapshot
+    GlobalAutoSaver().performAutosave();
+
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "journal.txt")) << "Journal index should exist";
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "base.1.map")) << "Base snapshot should exist";
+
+    // Remove one brush and change a spawnarg
+    auto funcStatic = algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66");
+    scene::INodePtr brush;
+    funcStatic->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isBrush(node))
+        {
+            brush = node;
+            return false;
+        }
+
+        return true;
+    });
+    scene::removeNodeFromParent(brush);
+
+    auto light = algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13");
+    Node_getEntity(light)->setKeyValue("_color", "0.1 0.2 0.3");
+
+    // The second save writes an entry containing the changed entities only
+    GlobalAutoSaver().performAutosave();
+    GlobalRadiantCore().getMessageBus().processPostedMessages();
+
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "1.map")) << "Journal entry should exist";
+    EXPECT_LT(os::getFileSize(journalFolder + "1.map"), os::getFileSize(journalFolder + "base.1.map"))
+        << "Journal entry should be smaller than the base snapshot";
+
+    auto recoveredPath = _context.getTemporaryDataPath() + "altar_recovered.map";
+    GlobalCommandSystem().executeCommand("RecoverAutosaveJournal", journalFolder, recoveredPath);
+
+    EXPECT_TRUE(os::fileOrDirExists(recoveredPath)) << "Recovered map should exist";
+
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", recoveredPath);
+
+    auto root = GlobalMapModule().getRoot();
+    auto isBrush = [](const scene::INodePtr& node) { return Node_isBrush(node); };
+
+    EXPECT_EQ(algorithm::getChildCount(algorithm::getEntityByName(root, "func_static_66"), isBrush), 3);
+    EXPECT_EQ(Node_getEntity(algorithm::getEntityByName(root, "light_torchflame_13"))->getKeyValue("_color"), "0.1 0.2 0.3");
+    EXPECT_EQ(Node_getEntity(algorithm::findWorldspawn(root))->getKeyValue("_color"), "0.286 0.408 0.259");
+    EXPECT_EQ(algorithm::getChildCount(root, isBrush), 36);
+    EXPECT_TRUE(root->getLayerManager().getLayerID("Windows") != -1);
+    EXPECT_EQ(root->getProperty("LastShaderClipboardMaterial"), "textures/tiles01");
+
+    fs::remove_all(snapshotFolder);
+    fs::remove(os::replaceExtension(recoveredPath, "darkradiant"));
+    fs::remove(recoveredPath);
+}
+
+namespace
+{
+
+// Opens the altar map and enables the journal, returns the journal folder
+std::string setupAutosaveJournal(const std::string& snapshotFolder)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", std::string("maps/altar.map"));
+
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+    registry::setValue(map::RKEY_AUTOSAVE_JOURNAL_ENABLED, true);
+
+    return snapshotFolder + "altar.map.journal/";
+}
+
+// Returns the lines of the last base or entry record in the journal index, including the header
+std::vector<std::string> getLastJournalRecord(const std::string& journalFolder)
+{
+    std::vector<std::string> record;
+    std::istringstream index(algorithm::loadFileToString(journalFolder + "journal.txt"));
+
+    for (std::string line; std::getline(index, line);)
+    {
+        if (string::starts_with(line, "base ") || string::starts_with(line, "entry "))
+        {
+            record.clear();
+        }
+
+        record.push_back(line);
+    }
+
+    return record;
+}
+
+void performAutosaveAndWait()
+{
+    GlobalAutoSaver().performAutosave();
+    GlobalAutoSaver().waitForPendingSave();
+    GlobalRadiantCore().getMessageBus().processPostedMessages();
+}
+
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalRecoversSelectionSets)
+{
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journalsets/";
+    auto journalFolder = setupAutosaveJournal(snapshotFolder);
+
+    // The base snapshot contains the first set
+    createTestSelectionSet(GlobalMapModule().getRoot());
+    performAutosaveAndWait();
+
+    // Adding an entity to another set is a change recorded in the next entry
+    auto light = algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13");
+    GlobalMapModule().getRoot()->getSelectionSetManager().createSelectionSet("Journal Entry Set")->addNode(light);
+
+    performAutosaveAndWait();
+
+    auto record = getLastJournalRecord(journalFolder);
+    ASSERT_EQ(record.size(), 3) << "Expected a single update";
+    EXPECT_EQ(record[1], "update \"light_torchflame_13\" 0");
+
+    auto recoveredPath = _context.getTemporaryDataPath() + "altar_recovered_sets.map";
+    GlobalCommandSystem().executeCommand("RecoverAutosaveJournal", journalFolder, recoveredPath);
+
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", recoveredPath);
+
+    auto root = GlobalMapModule().getRoot();
+    checkTestSelectionSet(root);
+
+    auto entrySet = root->getSelectionSetManager().findSelectionSet("Journal Entry Set");
+    ASSERT_TRUE(entrySet) << "Selection set of the journal entry has not been recovered";
+
+    auto members = entrySet->getNodes();
+    EXPECT_EQ(members.size(), 1);
+    EXPECT_EQ(members.count(algorithm::getEntityByName(root, "light_torchflame_13")), 1);
+
+    fs::remove_all(snapshotFolder);
+    fs::remove(os::replaceExtension(recoveredPath, "darkradiant"));
+    fs::remove(recoveredPath);
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalEntityRemoval)
+{
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journalremoval/";
+    auto journalFolder = setupAutosaveJournal(snapshotFolder);
+
+    performAutosaveAndWait();
+
+    scene::removeNodeFromParent(algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13"));
+
+    performAutosaveAndWait();
+
+    auto record = getLastJournalRecord(journalFolder);
+    ASSERT_EQ(record.size(), 3);
+    EXPECT_TRUE(string::ends_with(record[0], "\"1.map\"")) << record[0];
+    EXPECT_EQ(record[1], "remove \"light_torchflame_13\"") << "Entry should only record the removal";
+    EXPECT_EQ(record[2], "end");
+
+    auto recoveredPath = _context.getTemporaryDataPath() + "altar_removal_recovered.map";
+    GlobalCommandSystem().executeCommand("RecoverAutosaveJournal", journalFolder, recoveredPath);
+
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", recoveredPath);
+
+    auto root = GlobalMapModule().getRoot();
+    EXPECT_FALSE(algorithm::getEntityByName(root, "light_torchflame_13")) << "Removed entity has been recovered";
+    EXPECT_TRUE(algorithm::getEntityByName(root, "func_static_66")) << "Unrelated entity is missing";
+    EXPECT_EQ(algorithm::getChildCount(root, [](const scene::INodePtr& node) { return Node_isBrush(node); }), 37);
+
+    fs::remove_all(snapshotFolder);
+    fs::remove(os::replaceExtension(recoveredPath, "darkradiant"));
+    fs::remove(recoveredPath);
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalUnnamedEntityKeysAreStable)
+{
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journalunnamed/";
+    auto journalFolder = setupAutosaveJournal(snapshotFolder);
+
+    // Three unnamed entities with different brushes
+    std::vector<scene::INodePtr> unnamedEntities;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        auto entity = algorithm::createEntityByClassName("func_static");
+        GlobalMapModule().getRoot()->addChildNode(entity);
+        algorithm::createCubicBrush(entity, Vector3(512 + i * 128, 0, 0));
+        Node_getEntity(entity)->setKeyValue("name", "");
+
+        unnamedEntities.push_back(entity);
+    }
+
+    performAutosaveAndWait();
+
+    // Removing the first one must not affect how the others are identified
+    scene::removeNodeFromParent(unnamedEntities.front());
+
+    performAutosaveAndWait();
+
+    auto record = getLastJournalRecord(journalFolder);
+    ASSERT_EQ(record.size(), 3) << "Entry should consist of a single removal";
+    EXPECT_TRUE(string::starts_with(record[1], "remove \"func_static@")) << record[1];
+    EXPECT_EQ(record[2], "end");
+
+    // Changing an unnamed entity replaces it
+    algorithm::createCubicBrush(unnamedEntities.back(), Vector3(1024, 0, 0));
+
+    performAutosaveAndWait();
+
+    record = getLastJournalRecord(journalFolder);
+    ASSERT_EQ(record.size(), 4);
+    EXPECT_TRUE(string::starts_with(record[1], "add \"func_static@")) << record[1];
+    EXPECT_TRUE(string::starts_with(record[2], "remove \"func_static@")) << record[2];
+
+    fs::remove_all(snapshotFolder);
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalCompactsAfterMaxEntries)
+{
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journalmaxentries/";
+    auto journalFolder = setupAutosaveJournal(snapshotFolder);
+
+    performAutosaveAndWait();
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "base.1.map"));
+
+    auto light = algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13");
+
+    for (std::size_t i = 1; i <= map::AutosaveJournal::MaxEntries; ++i)
+    {
+        Node_getEntity(light)->setKeyValue("_color", fmt::format("0 0 {0}", i));
+        performAutosaveAndWait();
+    }
+
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + fmt::format("{0}.map", map::AutosaveJournal::MaxEntries)));
+    EXPECT_FALSE(os::fileOrDirExists(journalFolder + "base.2.map")) << "Small entries shouldn't trigger a compaction yet";
+
+    // The next save writes a new base, replacing everything else
+    Node_getEntity(light)->setKeyValue("_color", "0.5 0.5 0.5");
+    performAutosaveAndWait();
+
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "base.2.map")) << "Journal should have been compacted";
+    EXPECT_FALSE(os::fileOrDirExists(journalFolder + "base.1.map")) << "Previous base should have been removed";
+    EXPECT_FALSE(os::fileOrDirExists(journalFolder + "1.map")) << "Previous entries should have been removed";
+    auto header = getLastJournalRecord(journalFolder).front();
+    EXPECT_TRUE(string::starts_with(header, "base ") && string::ends_with(header, "\"base.2.map\"")) << header;
+
+    auto recoveredPath = _context.getTemporaryDataPath() + "altar_compacted_recovered.map";
+    GlobalCommandSystem().executeCommand("RecoverAutosaveJournal", journalFolder, recoveredPath);
+
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", recoveredPath);
+
+    EXPECT_EQ(Node_getEntity(algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13"))->getKeyValue("_color"), "0.5 0.5 0.5");
+
+    fs::remove_all(snapshotFolder);
+    fs::remove(os::replaceExtension(recoveredPath, "darkradiant"));
+    fs::remove(recoveredPath);
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalCompactsLargeEntries)
+{
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journallargeentries/";
+    auto journalFolder = setupAutosaveJournal(snapshotFolder);
+
+    performAutosaveAndWait();
+
+    // Add more brushes than the whole map contains
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    for (int i = 0; i < 300; ++i)
+    {
+        algorithm::createCubicBrush(worldspawn, Vector3(2048 + (i % 20) * 64, (i / 20) * 64, 0));
+    }
+
+    performAutosaveAndWait();
+
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "1.map"));
+    EXPECT_GT(os::getFileSize(journalFolder + "1.map"), os::getFileSize(journalFolder + "base.1.map"))
+        << "Test entry should be larger than the base";
+
+    // A small change, still the journal is compacted since its entries outweigh the base
+    auto light = algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13");
+    Node_getEntity(light)->setKeyValue("_color", "0.1 0.2 0.3");
+
+    performAutosaveAndWait();
+
+    EXPECT_TRUE(os::fileOrDirExists(journalFolder + "base.2.map")) << "Journal should have been compacted";
+    EXPECT_FALSE(os::fileOrDirExists(journalFolder + "1.map")) << "Previous entries should have been removed";
+    EXPECT_FALSE(os::fileOrDirExists(journalFolder + "2.map")) << "No entry should have been written";
+
+    fs::remove_all(snapshotFolder);
+}
+
+TEST_F(MapSavingTest, AutoSaveJournalIgnoresIncompleteLastEntry)
+{
+    auto snapshotFolder = _context.getTemporaryDataPath() + "journalincomplete/";
+    auto journalFolder = setupAutosaveJournal(snapshotFolder);
+
+    performAutosaveAndWait();
+
+    auto light = algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13");
+    Node_getEntity(light)->setKeyValue("_color", "0.1 0.2 0.3");
+
+    performAutosaveAndWait();
+
+    // Simulate a crash while writing the next entry: the record lacks its end, the file is missing
+    {
+        std::ofstream index(journalFolder + "journal.txt", std::ios::app);
+        index << "entry 0 \"2.map\"" << std::endl;
+        index << "update \"light_torchflame_13\" 0" << std::endl;
+    }
+
+    auto recoveredPath = _context.getTemporaryDataPath() + "altar_incomplete_recovered.map";
+    GlobalCommandSystem().executeCommand("RecoverAutosaveJournal", journalFolder, recoveredPath);
+
+    EXPECT_TRUE(os::fileOrDirExists(recoveredPath)) << "Recovery should have ignored the incomplete entry";
+
+    FileSaveConfirmationHelper helper(radiant::FileSaveConfirmation::Action::DiscardChanges);
+    GlobalCommandSystem().executeCommand("OpenMap", recoveredPath);
+
+    // The state of the last complete entry
+    EXPECT_EQ(Node_getEntity(algorithm::getEntityByName(GlobalMapModule().getRoot(), "light_torchflame_13"))->getKeyValue("_color"), "0.1 0.2 0.3");
+    checkAltarScene();
+
+    fs::remove_all(snapshotFolder);
+    fs::remove(os::replaceExtension(recoveredPath, "darkradiant"));
+    fs::remove(recoveredPath);
+}
+
+namespace
+{
+
 void checkBehaviourWithoutUnsavedChanges(std::function<void()> action)
 {
     std::string modRelativePath = "maps/altar.map";
@@ -2035,4 +2035,56 @@ TEST_F(MaterialsTest, EditorImageUpdatedBeforeMaterialChangedSignalEmission)
     EXPECT_FALSE(material->isEditorImageNoTex()) << "Editor image should have been updated";
 }
 
+TEST_F(MaterialsTest, CompiledStageExpressionsMatchExpressionTrees)
+{
+    auto material = GlobalMaterialManager().getMaterial("textures/parsertest/colourexpr10");
+    auto stage = material->getLayer(0);
+
+    for (std::size_t time : { 0, 16, 1000, 2500, 123456 })
+    {
+        stage->evaluateExpressions(time);
+
+        auto colour = stage->getColour();
+        EXPECT_NEAR(colour.x(), stage->getColourExpression(IShaderLayer::COMP_RED)->getValue(time), 1e-4);
+        EXPECT_NEAR(colour.y(), stage->getColourExpression(IShaderLayer::COMP_GREEN)->getValue(time), 1e-4);
+        EXPECT_NEAR(colour.z(), stage->getColourExpression(IShaderLayer::COMP_BLUE)->getValue(time), 1e-4);
+        EXPECT_NEAR(colour.w(), stage->getColourExpression(IShaderLayer::COMP_ALPHA)->getValue(time), 1e-4);
+    }
+
+    material = GlobalMaterialManager().getMaterial("textures/parsertest/program/vertexProgram4");
+    stage = material->getLayer(0);
+
+    for (std::size_t time : { 0, 500, 3000 })
+    {
+        stage->evaluateExpressions(time);
+
+        const auto& parm = stage->getVertexParm(0);
+        auto value = stage->getVertexParmValue(0);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_NEAR(value[i], parm.expressions[i]->getValue(time), 1e-4);
+        }
+    }
+}
+
+TEST_F(MaterialsTest, ConstantStageExpressionsAreUpdatedAfterModification)
+{
+    auto material = GlobalMaterialManager().getMaterial("textures/exporttest/empty");
+
+    auto layer = material->getEditableLayer(material->addLayer(IShaderLayer::DIFFUSE));
+    layer->setColourExpressionFromString(IShaderLayer::COMP_RED, "0.5 * 0.5");
+
+    auto stage = material->getLayer(0);
+    stage->evaluateExpressions(0);
+    EXPECT_NEAR(stage->getColour().x(), 0.25, 1e-4);
+
+    // The compiled program must pick up the changed expression
+    layer->setColourExpressionFromString(IShaderLayer::COMP_RED, "0.75");
+    stage->evaluateExpressions(0);
+    EXPECT_NEAR(stage->getColour().x(), 0.75, 1e-4);
+
+    material->revertModifications();
+}
+
 }
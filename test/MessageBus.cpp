@@ -1,6 +1,11 @@
 #include "RadiantTest.h"
 
+#include <algorithm>
+#include <atomic>
 #include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 #include "imessagebus.h"
 
 namespace test
@@ -169,4 +174,196 @@ TEST_F(MessageBusTest, MultipleThreadsCanSendMessages)
     }
 }
 
+TEST_F(MessageBusTest, PostedMessagesAreDeliveredOnProcessing)
+{
+    std::size_t counter = 0;
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    auto listenerId = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&) { ++counter; });
+
+    constexpr std::size_t NumThreads = 4;
+    constexpr std::size_t MessagesPerThread = 1000;
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < NumThreads; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (std::size_t i = 0; i < MessagesPerThread; ++i)
+            {
+                messageBus.postMessage(std::make_unique<CustomMessage1>());
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    // Nothing is delivered before processing
+    EXPECT_EQ(counter, 0);
+
+    EXPECT_EQ(messageBus.processPostedMessages(), NumThreads * MessagesPerThread);
+    EXPECT_EQ(counter, NumThreads * MessagesPerThread);
+
+    // Queue is empty now
+    EXPECT_EQ(messageBus.processPostedMessages(), 0);
+
+    messageBus.removeListener(listenerId);
+}
+
+TEST_F(MessageBusTest, PostedMessageNotifier)
+{
+    std::atomic<std::size_t> notifications(0);
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    messageBus.setPostedMessageNotifier([&]() { ++notifications; });
+
+    // Only the first message should request processing
+    messageBus.postMessage(std::make_unique<CustomMessage1>());
+    messageBus.postMessage(std::make_unique<CustomMessage1>());
+    EXPECT_EQ(notifications, 1);
+
+    EXPECT_EQ(messageBus.processPostedMessages(), 2);
+
+    // After processing the next message notifies again
+    messageBus.postMessage(std::make_unique<CustomMessage2>());
+    EXPECT_EQ(notifications, 2);
+
+    messageBus.processPostedMessages();
+    messageBus.setPostedMessageNotifier({});
+}
+
+TEST_F(MessageBusTest, RegistrationDuringCallback)
+{
+    auto counter1 = 0;
+    auto counter2 = 0;
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    std::size_t listenerId2 = 0;
+
+    auto listenerId1 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&)
+    {
+        ++counter1;
+
+        // Listeners added during dispatch will be invoked by the next message only
+        if (listenerId2 == 0)
+        {
+            listenerId2 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&) { ++counter2; });
+        }
+    });
+
+    CustomMessage1 msg1;
+    messageBus.sendMessage(msg1);
+
+    EXPECT_EQ(counter1, 1);
+    EXPECT_EQ(counter2, 0);
+
+    messageBus.sendMessage(msg1);
+
+    EXPECT_EQ(counter1, 2);
+    EXPECT_EQ(counter2, 1);
+
+    messageBus.removeListener(listenerId1);
+    messageBus.removeListener(listenerId2);
+}
+
+TEST_F(MessageBusTest, ChannelStatistics)
+{
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    auto listenerId = messageBus.addListener(CustomMessage2::Id, [&](radiant::IMessage&) {});
+
+    CustomMessage2 msg2;
+    messageBus.sendMessage(msg2);
+    messageBus.sendMessage(msg2);
+    messageBus.sendMessage(msg2);
+
+    auto statistics = messageBus.getChannelStatistics();
+
+    auto channel = std::find_if(statistics.begin(), statistics.end(), [](const radiant::IMessageBus::ChannelStatistics& s)
+    {
+        return s.messageType == CustomMessage2::Id;
+    });
+
+    ASSERT_NE(channel, statistics.end());
+    EXPECT_EQ(channel->numListeners, 1);
+    EXPECT_EQ(channel->numDispatches, 3);
+    EXPECT_LE(channel->maxDispatchTime, channel->totalDispatchTime);
+
+    messageBus.removeListener(listenerId);
+}
+
+TEST_F(MessageBusTest, ThrowingListenerFinishesDispatch)
+{
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    auto throwingListenerId = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&)
+    {
+        throw std::runtime_error("Listener failure");
+    });
+
+    CustomMessage1 msg1;
+    EXPECT_THROW(messageBus.sendMessage(msg1), std::runtime_error);
+
+    // The channel must not be considered dispatching anymore,
+    // the removal and the new listener take effect immediately
+    messageBus.removeListener(throwingListenerId);
+
+    std::size_t counter = 0;
+    auto listenerId = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&) { ++counter; });
+
+    EXPECT_NO_THROW(messageBus.sendMessage(msg1));
+    EXPECT_EQ(counter, 1) << "Listener added after the failed dispatch has not been invoked";
+
+    messageBus.removeListener(listenerId);
+}
+
+TEST_F(MessageBusTest, ChannelStatisticsWithMultipleThreads)
+{
+    constexpr std::size_t NumThreads = 4;
+    constexpr std::size_t NumMessagesPerThread = 500;
+
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    std::atomic<std::size_t> counter{ 0 };
+    auto listenerId = messageBus.addListener(CustomMessage2::Id, [&](radiant::IMessage&) { ++counter; });
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t t = 0; t < NumThreads; ++t)
+    {
+        threads.emplace_back([&]()
+        {
+            for (std::size_t i = 0; i < NumMessagesPerThread; ++i)
+            {
+                CustomMessage2 msg2;
+                messageBus.sendMessage(msg2);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter, NumThreads * NumMessagesPerThread);
+
+    auto statistics = messageBus.getChannelStatistics();
+
+    auto channel = std::find_if(statistics.begin(), statistics.end(), [](const radiant::IMessageBus::ChannelStatistics& s)
+    {
+        return s.messageType == CustomMessage2::Id;
+    });
+
+    ASSERT_NE(channel, statistics.end());
+    EXPECT_EQ(channel->numDispatches, NumThreads * NumMessagesPerThread);
+    EXPECT_LE(channel->maxDispatchTime, channel->totalDispatchTime);
+
+    messageBus.removeListener(listenerId);
+}
+
 }
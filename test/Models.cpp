@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include "imodelsurface.h"
 #include "imodelcache.h"
+#include "imd5anim.h"
 #include "scenelib.h"
 #include "algorithm/Entity.h"
 #include "algorithm/FileUtils.h"
@@ -515,6 +516,45 @@ TEST_F(ModelTest, ModelKeyReferencesMd5Model)
     performModelNodeTest(_context.getTestProjectPath(), "models/md5/flag01.md5mesh", 96);
 }
 
+TEST_F(ModelTest, LoadMd5Anim)
+{
+    auto anim = GlobalAnimationCache().getAnim("models/md5/testflag_wave.md5anim");
+    ASSERT_TRUE(anim) << "Anim should have been loaded";
+
+    EXPECT_EQ(anim->getNumJoints(), 2);
+    EXPECT_EQ(anim->getNumFrames(), 3);
+    EXPECT_EQ(anim->getFrameRate(), 24);
+
+    EXPECT_EQ(anim->getJoint(0).name, "origin");
+    EXPECT_EQ(anim->getJoint(1).name, "root");
+    EXPECT_EQ(anim->getJoint(1).parentId, 0);
+    EXPECT_EQ(anim->getJoint(1).animComponents, 15);
+    EXPECT_EQ(anim->getJoint(0).children, std::vector<int>{ 1 });
+
+    EXPECT_TRUE(math::isNear(anim->getBaseFrameKey(1).origin, Vector3(-71.658241, 0.000002, 0), 1e-5));
+
+    // The frame values are stored quantised, expect them to be close to the file values
+    std::vector<std::vector<float>> expectedKeys =
+    {
+        { -71.658241f, 0.000002f, 0.0f, 0.0f },
+        { -71.658241f, 2.5f, 0.0f, 0.125f },
+        { -71.658241f, 5.0f, 1.25f, -0.25f },
+    };
+
+    md5::IMD5Anim::FrameKeys keys;
+
+    for (std::size_t frame = 0; frame < expectedKeys.size(); ++frame)
+    {
+        anim->getFrameKeys(frame, keys);
+        ASSERT_EQ(keys.size(), 4);
+
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            EXPECT_NEAR(keys[i], expectedKeys[frame][i], 1e-4) << "Frame " << frame << ", component " << i;
+        }
+    }
+}
+
 TEST_F(ModelTest, ModelKeyReferencesModelDef)
 {
     auto funcStatic = algorithm::createEntityByClassName("func_static");
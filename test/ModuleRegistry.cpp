@@ -0,0 +1,100 @@
+#include "RadiantTest.h"
+
+#include <algorithm>
+#include "imodule.h"
+#include "icommandsystem.h"
+
+namespace test
+{
+
+namespace
+{
+
+// Records the order in which the modules have been initialised
+class OrderRecordingModule :
+    public RegisterableModule
+{
+private:
+    std::string _name;
+    StringSet _dependencies;
+    std::vector<std::string>& _initialisationOrder;
+
+public:
+    // Set by initialiseModule() if the command system was already usable
+    bool commandSystemWasReady = false;
+
+    OrderRecordingModule(const std::string& name, const StringSet& dependencies,
+        std::vector<std::string>& initialisationOrder) :
+        _name(name),
+        _dependencies(dependencies),
+        _initialisationOrder(initialisationOrder)
+    {}
+
+    const std::string& getName() const override
+    {
+        return _name;
+    }
+
+    const StringSet& getDependencies() const override
+    {
+        return _dependencies;
+    }
+
+    void initialiseModule(const IApplicationContext& ctx) override
+    {
+        _initialisationOrder.push_back(_name);
+
+        if (_dependencies.count(MODULE_COMMANDSYSTEM) > 0)
+        {
+            // The command system registers its built-in commands during initialisation
+            commandSystemWasReady = GlobalCommandSystem().commandExists("bind");
+        }
+    }
+};
+
+}
+
+class ModuleRegistryTest :
+    public RadiantTest
+{
+protected:
+    std::vector<std::string> _initialisationOrder;
+
+    // The names are sorted in the opposite order of the dependencies
+    std::shared_ptr<OrderRecordingModule> _first;
+    std::shared_ptr<OrderRecordingModule> _second;
+    std::shared_ptr<OrderRecordingModule> _third;
+
+    void setupTestModules() override
+    {
+        RadiantTest::setupTestModules();
+
+        _third = std::make_shared<OrderRecordingModule>("AAA_TestModule",
+            StringSet{ "MMM_TestModule", MODULE_COMMANDSYSTEM }, _initialisationOrder);
+        _second = std::make_shared<OrderRecordingModule>("MMM_TestModule",
+            StringSet{ "ZZZ_TestModule" }, _initialisationOrder);
+        _first = std::make_shared<OrderRecordingModule>("ZZZ_TestModule",
+            StringSet(), _initialisationOrder);
+
+        auto& registry = _coreModule->get()->getModuleRegistry();
+
+        registry.registerModule(_third);
+        registry.registerModule(_second);
+        registry.registerModule(_first);
+    }
+};
+
+TEST_F(ModuleRegistryTest, ModulesAreInitialisedAfterTheirDependencies)
+{
+    std::vector<std::string> expectedOrder{ "ZZZ_TestModule", "MMM_TestModule", "AAA_TestModule" };
+    EXPECT_EQ(_initialisationOrder, expectedOrder);
+
+    EXPECT_TRUE(_third->commandSystemWasReady) << "Command system has not been initialised before its dependent";
+
+    for (const auto& name : expectedOrder)
+    {
+        EXPECT_TRUE(module::GlobalModuleRegistry().moduleExists(name)) << name << " is not registered as initialised";
+    }
+}
+
+}
@@ -2,6 +2,7 @@
 
 #include "iparticles.h"
 #include "iparticlestage.h"
+#include "irendersystemfactory.h"
 #include "os/path.h"
 #include "string/replace.h"
 #include "algorithm/FileUtils.h"
@@ -539,4 +540,61 @@ TEST_F(ParticlesTest, AcquireParticleNode)
     EXPECT_TRUE(GlobalParticlesManager().createParticleNode("firefly_blue_in_pk4"));
 }
 
+TEST_F(ParticlesTest, RenderableParticleQuadGeometry)
+{
+    auto def = GlobalParticlesManager().findOrInsertParticleDef("particle_quad_geometry_test");
+    auto stage = def->getStage(def->addParticleStage());
+
+    // All quads are spawned at the origin and stay there, rotated by 90 degrees
+    stage->setMaterialName("_white");
+    stage->setCount(500);
+    stage->setDuration(1.0f);
+    stage->setBunching(0.0f);
+    stage->setDistributionType(particles::IStageDef::DISTRIBUTION_RECT);
+    stage->setDistributionParm(0, 0);
+    stage->setDistributionParm(1, 0);
+    stage->setDistributionParm(2, 0);
+    stage->getSpeed().setFrom(0);
+    stage->getSpeed().setTo(0);
+    stage->getRotationSpeed().setFrom(0);
+    stage->getRotationSpeed().setTo(0);
+    stage->setGravity(0);
+    stage->setInitialAngle(90);
+    stage->getSize().setFrom(8);
+    stage->getSize().setTo(8);
+    stage->getAspect().setFrom(2);
+    stage->getAspect().setTo(2);
+    stage->setOrientationType(particles::IStageDef::ORIENTATION_Z);
+
+    auto particle = GlobalParticlesManager().getRenderableParticle("particle_quad_geometry_test");
+    ASSERT_TRUE(particle);
+
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+    particle->setRenderSystem(backend);
+    backend->setTime(500);
+
+    particle->update(Matrix4::getIdentity(), Matrix4::getIdentity(), nullptr);
+
+    // The 16x8 quads are rotated by 90 degrees in the XY plane
+    auto bounds = particle->getBounds();
+    EXPECT_TRUE(bounds.isValid());
+    EXPECT_NEAR(bounds.getOrigin().x(), 0, 0.01);
+    EXPECT_NEAR(bounds.getOrigin().y(), 0, 0.01);
+    EXPECT_NEAR(bounds.getOrigin().z(), 0, 0.01);
+    EXPECT_NEAR(bounds.getExtents().x(), 16, 0.01);
+    EXPECT_NEAR(bounds.getExtents().y(), 8, 0.01);
+    EXPECT_NEAR(bounds.getExtents().z(), 0, 0.01);
+
+    // Aimed particles are generated through a separate path, the bounds should be valid too
+    stage->setOrientationType(particles::IStageDef::ORIENTATION_AIMED);
+    stage->getSpeed().setFrom(100);
+    stage->getSpeed().setTo(100);
+
+    particle->update(Matrix4::getIdentity(), Matrix4::getIdentity(), nullptr);
+    bounds = particle->getBounds();
+
+    EXPECT_TRUE(bounds.isValid());
+    EXPECT_GT(bounds.getExtents().z(), 0) << "Aimed particles should extend along their velocity";
+}
+
 }
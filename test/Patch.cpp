@@ -65,6 +65,48 @@ TEST_F(PatchTest, SnapVertexToGrid)
     EXPECT_TRUE(math::isNear(ctrl.vertex, vertexAfterSnapping, 0.01)) << "Vertex should be snapped to grid now";
 }
 
+// Identical patches share their tesselation, modifying one of them must not affect the other
+TEST_F(PatchTest, IdenticalPatchesTesselateIndependently)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto firstNode = algorithm::createPatchFromBounds(worldspawn, AABB({ 0,0,0 }, { 64, 32, 16 }));
+    auto secondNode = algorithm::createPatchFromBounds(worldspawn, AABB({ 0,0,0 }, { 64, 32, 16 }));
+
+    auto first = Node_getIPatch(firstNode);
+    auto second = Node_getIPatch(secondNode);
+
+    auto firstMesh = first->getTesselatedPatchMesh();
+    auto secondMesh = second->getTesselatedPatchMesh();
+
+    EXPECT_GT(firstMesh.vertices.size(), 0) << "Patch should have been tesselated";
+    EXPECT_EQ(firstMesh.width, secondMesh.width);
+    EXPECT_EQ(firstMesh.height, secondMesh.height);
+    ASSERT_EQ(firstMesh.vertices.size(), secondMesh.vertices.size());
+
+    for (std::size_t i = 0; i < firstMesh.vertices.size(); ++i)
+    {
+        EXPECT_TRUE(math::isNear(firstMesh.vertices[i].vertex, secondMesh.vertices[i].vertex, 0.001)) << "Vertex mismatch at " << i;
+    }
+
+    // Move a control point of the first patch
+    first->ctrlAt(0, 0).vertex += Vector3(0, 0, 48);
+    first->controlPointsChanged();
+
+    auto changedMesh = first->getTesselatedPatchMesh();
+    auto unchangedMesh = second->getTesselatedPatchMesh();
+
+    EXPECT_FALSE(math::isNear(changedMesh.vertices.front().vertex, firstMesh.vertices.front().vertex, 0.001))
+        << "Tesselation of the first patch should have been updated";
+
+    ASSERT_EQ(unchangedMesh.vertices.size(), secondMesh.vertices.size());
+
+    for (std::size_t i = 0; i < unchangedMesh.vertices.size(); ++i)
+    {
+        EXPECT_TRUE(math::isNear(unchangedMesh.vertices[i].vertex, secondMesh.vertices[i].vertex, 0.001)) << "Second patch changed at " << i;
+    }
+}
+
 // Checks that snapping a single vertex to grid is undoable
 TEST_F(PatchTest, VertexSnappingIsUndoable)
 {
@@ -42,6 +42,63 @@ TEST_F(PointTraceTest, ConstructPointTraceWithData)
     EXPECT_EQ(ps[4], Vector3(544, 64, 112));
 }
 
+TEST_F(PointTraceTest, ConstructPointTraceAcrossChunks)
+{
+    // Generate enough data to require several buffer refills, the
+    // numbers will straddle the chunk boundaries at some point
+    std::ostringstream data;
+    for (int i = 0; i < 20000; ++i)
+    {
+        data << (i * 0.5) << " " << -i << " +" << (i % 7) << ".250000\n";
+    }
+
+    std::istringstream iss(data.str());
+    map::PointTrace trace(iss);
+
+    auto ps = trace.points();
+    ASSERT_EQ(ps.size(), 20000);
+    EXPECT_EQ(ps[0], Vector3(0, 0, 0.25));
+    EXPECT_EQ(ps[12345], Vector3(6172.5, -12345, 4.25));
+    EXPECT_EQ(ps[19999], Vector3(9999.5, -19999, 0.25));
+}
+
+TEST_F(PointTraceTest, ConstructPointTraceStopsAtInvalidData)
+{
+    // Incomplete or invalid coordinates end the trace
+    std::istringstream iss(LIN_DATA + "1 2 garbage\n3 4 5\n");
+
+    map::PointTrace trace(iss);
+    EXPECT_EQ(trace.points().size(), 5);
+}
+
+TEST_F(PointTraceTest, SimplifyCollinearPoints)
+{
+    std::istringstream iss("0 0 0\n"
+                           "16 0 0\n"
+                           "32 0 0\n"
+                           "32 0 0\n"
+                           "64 0 0\n"
+                           "64 32 0\n"
+                           "64 64 0\n"
+                           "64 64 64\n"
+                           "64 64 0\n");
+
+    map::PointTrace trace(iss, true);
+
+    // The corners remain, including the reversal at the end
+    auto ps = trace.points();
+    ASSERT_EQ(ps.size(), 5);
+    EXPECT_EQ(ps[0], Vector3(0, 0, 0));
+    EXPECT_EQ(ps[1], Vector3(64, 0, 0));
+    EXPECT_EQ(ps[2], Vector3(64, 64, 0));
+    EXPECT_EQ(ps[3], Vector3(64, 64, 64));
+    EXPECT_EQ(ps[4], Vector3(64, 64, 0));
+
+    // Nothing to simplify in this one
+    std::istringstream linData(LIN_DATA);
+    EXPECT_EQ(map::PointTrace(linData, true).points().size(), 5);
+}
+
 namespace
 {
 
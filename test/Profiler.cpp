@@ -0,0 +1,99 @@
+#include "RadiantTest.h"
+
+#include <thread>
+#include "iprofiler.h"
+#include "icommandsystem.h"
+#include "profiling/ScopedSpan.h"
+#include "testutil/TemporaryFile.h"
+#include "algorithm/FileUtils.h"
+
+namespace test
+{
+
+class ProfilerTest :
+    public RadiantTest
+{
+protected:
+    void SetUp() override
+    {
+        RadiantTest::SetUp();
+        GlobalProfiler().clear();
+    }
+
+    void TearDown() override
+    {
+        GlobalProfiler().setEnabled(false);
+        GlobalProfiler().clear();
+        RadiantTest::TearDown();
+    }
+};
+
+TEST_F(ProfilerTest, DisabledByDefault)
+{
+    EXPECT_FALSE(GlobalProfiler().isEnabled());
+
+    {
+        profiling::ScopedSpan span("Unrecorded span");
+    }
+
+    EXPECT_EQ(GlobalProfiler().getNumRecordedSpans(), 0);
+}
+
+TEST_F(ProfilerTest, StartAndStopCommands)
+{
+    GlobalCommandSystem().executeCommand("StartProfiling");
+    EXPECT_TRUE(GlobalProfiler().isEnabled());
+
+    {
+        profiling::ScopedSpan span("Recorded span");
+    }
+
+    GlobalCommandSystem().executeCommand("StopProfiling");
+    EXPECT_FALSE(GlobalProfiler().isEnabled());
+
+    {
+        profiling::ScopedSpan span("Unrecorded span");
+    }
+
+    EXPECT_EQ(GlobalProfiler().getNumRecordedSpans(), 1);
+
+    GlobalCommandSystem().executeCommand("ClearProfilingSpans");
+    EXPECT_EQ(GlobalProfiler().getNumRecordedSpans(), 0);
+}
+
+TEST_F(ProfilerTest, WriteChromeTrace)
+{
+    GlobalProfiler().setEnabled(true);
+
+    {
+        profiling::ScopedSpan outer("Outer \"span\"");
+        profiling::ScopedSpan inner("Inner span");
+    }
+
+    // Spans of other threads should end up in the same trace
+    std::thread([]()
+    {
+        profiling::ScopedSpan span("Worker span");
+    }).join();
+
+    EXPECT_EQ(GlobalProfiler().getNumRecordedSpans(), 3);
+
+    auto tracePath = _context.getTemporaryDataPath() + "trace.json";
+    TemporaryFile traceFile(tracePath);
+
+    GlobalCommandSystem().executeCommand("WriteProfilingTrace", cmd::Argument(tracePath));
+
+    auto trace = algorithm::loadFileToString(tracePath);
+
+    EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+    EXPECT_NE(trace.find("\"name\":\"Outer \\\"span\\\"\""), std::string::npos) << "Span name not escaped";
+    EXPECT_NE(trace.find("\"name\":\"Inner span\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"Worker span\""), std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"thread_name\""), std::string::npos);
+
+    // The outer span has to be listed before the inner one
+    EXPECT_LT(trace.find("Outer"), trace.find("Inner span"));
+}
+
+}
@@ -111,4 +111,74 @@ TEST_F(RegistryTest, SetAttributeOnNode)
     EXPECT_EQ(node.getContent(), "");
 }
 
+TEST_F(RegistryTest, CachedValuesFollowModifications)
+{
+    const char* KEY = "user/test/cached/value";
+
+    EXPECT_FALSE(GlobalRegistry().keyExists(KEY));
+    EXPECT_EQ(GlobalRegistry().get(KEY), "");
+
+    // Query twice to get the value into the cache
+    GlobalRegistry().set(KEY, "first");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "first");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "first");
+    EXPECT_TRUE(GlobalRegistry().keyExists(KEY));
+    EXPECT_TRUE(GlobalRegistry().keyExists("user/test/cached"));
+
+    GlobalRegistry().set(KEY, "second");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "second");
+
+    // XPath expressions matching the node are updated too
+    EXPECT_EQ(GlobalRegistry().get("user/test//value"), "second");
+    GlobalRegistry().set(KEY, "third");
+    EXPECT_EQ(GlobalRegistry().get("user/test//value"), "third");
+
+    GlobalRegistry().setAttribute(KEY, "value", "attribute");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "third"); // content has precedence
+
+    GlobalRegistry().deleteXPath(KEY);
+    EXPECT_FALSE(GlobalRegistry().keyExists(KEY));
+    EXPECT_EQ(GlobalRegistry().get(KEY), "");
+
+    // Legacy value attributes set through the API are picked up
+    GlobalRegistry().setAttribute(KEY, "value", "legacy");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "legacy");
+}
+
+TEST_F(RegistryTest, CachedValuesFollowNodeModifications)
+{
+    const char* KEY = "user/test/cachedNode/value";
+
+    GlobalRegistry().set(KEY, "first");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "first");
+
+    // Changing the content of a node handed out by findXPath
+    auto nodes = GlobalRegistry().findXPath(KEY);
+    ASSERT_EQ(nodes.size(), 1);
+
+    EXPECT_EQ(GlobalRegistry().get(KEY), "first"); // cached again
+    nodes[0].setContent("changed through node");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "changed through node");
+
+    // The same handle can be used multiple times
+    EXPECT_EQ(GlobalRegistry().get(KEY), "changed through node");
+    nodes[0].setContent("changed again");
+    EXPECT_EQ(GlobalRegistry().get(KEY), "changed again");
+
+    // Legacy value attribute on a node created through createKey
+    const char* ATTRIBUTE_KEY = "user/test/cachedNode/attribute";
+    auto node = GlobalRegistry().createKey(ATTRIBUTE_KEY);
+
+    EXPECT_TRUE(GlobalRegistry().keyExists(ATTRIBUTE_KEY));
+    EXPECT_EQ(GlobalRegistry().get(ATTRIBUTE_KEY), "");
+    node.setAttributeValue("value", "from node");
+    EXPECT_EQ(GlobalRegistry().get(ATTRIBUTE_KEY), "from node");
+
+    // Removing the node
+    nodes[0].erase();
+    EXPECT_FALSE(GlobalRegistry().keyExists(KEY));
+    EXPECT_EQ(GlobalRegistry().get(KEY), "");
+    EXPECT_EQ(GlobalRegistry().get(ATTRIBUTE_KEY), "from node");
+}
+
 }
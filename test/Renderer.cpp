@@ -4,8 +4,14 @@
 #include "ientity.h"
 #include "irender.h"
 #include "ilightnode.h"
+#include "icommandsystem.h"
 #include "math/Matrix4.h"
 #include "scenelib.h"
+#include "imap.h"
+#include "render/View.h"
+#include "render/RenderableCollectionWalker.h"
+#include "algorithm/Primitives.h"
+#include "algorithm/View.h"
 
 namespace test
 {
@@ -13,6 +19,23 @@ namespace test
 using RendererTest = RadiantTest;
 using RenderSystemTest = RadiantTest;
 
+namespace
+{
+    // Front end collector without any highlighting, like a camera view without selection
+    class FullBrightRenderableCollector :
+        public render::RenderableCollectorBase
+    {
+    public:
+        bool supportsFullMaterials() const override
+        {
+            return true;
+        }
+
+        void addHighlightRenderable(const OpenGLRenderable& renderable, const Matrix4& localToWorld) override
+        {}
+    };
+}
+
 IEntityNodePtr createByClassName(const std::string& className)
 {
     auto cls = GlobalEntityClassManager().findClass(className);
@@ -490,4 +513,64 @@ TEST_F(RenderSystemTest, AttachmentIsRegisteredAsLight)
     EXPECT_EQ(getLightCount(renderSystem), 1) << "Rendersystem should know of 1 light after removing the torch";
 }
 
+
+TEST_F(RenderSystemTest, TogglePassTimings)
+{
+    EXPECT_FALSE(GlobalRenderSystem().getPassTimingsEnabled()) << "Pass timings should be disabled by default";
+
+    GlobalCommandSystem().executeCommand("ToggleRenderPassTimings");
+    EXPECT_TRUE(GlobalRenderSystem().getPassTimingsEnabled());
+
+    // No frame has been rendered, no pass should report any time
+    for (auto viewType : { RenderViewType::Camera, RenderViewType::OrthoView })
+    {
+        auto timings = GlobalRenderSystem().getPassTimings(viewType);
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(RenderPass::NumPasses); ++i)
+        {
+            EXPECT_LT(timings.getCpuTime(static_cast<RenderPass>(i)), 0);
+            EXPECT_LT(timings.getGpuTime(static_cast<RenderPass>(i)), 0);
+        }
+    }
+
+    // Render one fullbright camera frame of a brush
+    auto brush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn(), Vector3(0, 0, 0), "textures/numbers/1");
+
+    render::View view(true);
+    algorithm::constructCameraView(view, brush->worldAABB(), Vector3(0, 0, -1), Vector3(-90, 0, 0));
+
+    auto flags = RENDER_DEPTHTEST | RENDER_MASKCOLOUR | RENDER_DEPTHWRITE | RENDER_ALPHATEST |
+        RENDER_BLEND | RENDER_CULLFACE | RENDER_OFFSETLINE | RENDER_VERTEX_COLOUR |
+        RENDER_FILL | RENDER_LIGHTING | RENDER_TEXTURE_2D | RENDER_SMOOTH | RENDER_SCALED;
+
+    FullBrightRenderableCollector collector;
+
+    GlobalRenderSystem().startFrame();
+    render::RenderableCollectionWalker::CollectRenderablesInScene(collector, view);
+    GlobalRenderSystem().renderFullBrightScene(RenderViewType::Camera, flags, view);
+    GlobalRenderSystem().endFrame();
+
+    // The passes of the fullbright renderer have been measured, the lighting mode passes haven't run
+    auto timings = GlobalRenderSystem().getPassTimings(RenderViewType::Camera);
+
+    for (auto pass : { RenderPass::FrontEnd, RenderPass::ShaderPreparation, RenderPass::GeometryUpload,
+        RenderPass::FullBright, RenderPass::Text })
+    {
+        EXPECT_GE(timings.getCpuTime(pass), 0) << getRenderPassName(pass) << " should have been measured";
+    }
+
+    for (auto pass : { RenderPass::LightCollection, RenderPass::ShadowMap, RenderPass::DepthFill,
+        RenderPass::Interaction, RenderPass::NonInteraction, RenderPass::BlendLight })
+    {
+        EXPECT_LT(timings.getCpuTime(pass), 0) << getRenderPassName(pass) << " should not have been executed";
+    }
+
+    // The ortho views are timed separately
+    auto orthoTimings = GlobalRenderSystem().getPassTimings(RenderViewType::OrthoView);
+    EXPECT_LT(orthoTimings.getCpuTime(RenderPass::FullBright), 0);
+
+    GlobalCommandSystem().executeCommand("ToggleRenderPassTimings");
+    EXPECT_FALSE(GlobalRenderSystem().getPassTimingsEnabled());
+}
+
 }
@@ -0,0 +1,479 @@
+#include "RadiantTest.h"
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <sigc++/connection.h>
+#include <fmt/format.h>
+#include "iscript.h"
+#include "imap.h"
+#include "ientity.h"
+#include "icommandsystem.h"
+#include "iselectable.h"
+#include "iundo.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "algorithm/Entity.h"
+#include "algorithm/Primitives.h"
+
+namespace test
+{
+
+class ScriptingSystemTest :
+    public RadiantTest
+{
+protected:
+    void SetUp() override
+    {
+        RadiantTest::SetUp();
+
+        // The script module is living outside the core binary, it might not have been built
+        if (!module::GlobalModuleRegistry().moduleExists(MODULE_SCRIPTING_SYSTEM))
+        {
+            GTEST_SKIP() << "Scripting system is not available";
+        }
+    }
+
+    // Polls the script until the predicate is fulfilled or the script finished
+    bool waitFor(const script::IAsyncScriptExecution::Ptr& execution, const std::function<bool()>& predicate)
+    {
+        for (int i = 0; i < 5000 && !execution->isFinished(); ++i)
+        {
+            if (predicate()) return true;
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        return predicate();
+    }
+};
+
+namespace
+{
+
+// Collects the names of the undo operations recorded during its lifetime
+class UndoOperationRecorder
+{
+private:
+    sigc::connection _connection;
+
+public:
+    std::vector<std::string> operations;
+
+    UndoOperationRecorder()
+    {
+        _connection = GlobalUndoSystem().signal_undoEvent().connect(
+            [this](IUndoSystem::EventType type, const std::string& operationName)
+        {
+            if (type == IUndoSystem::EventType::OperationRecorded)
+            {
+                operations.push_back(operationName);
+            }
+        });
+    }
+
+    ~UndoOperationRecorder()
+    {
+        _connection.disconnect();
+    }
+};
+
+// Creates two selected brushes, the second one has a different shader on its first face
+std::pair<scene::INodePtr, scene::INodePtr> createSelectedTestBrushes()
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto first = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    auto second = algorithm::createCubicBrush(worldspawn, Vector3(128, 0, 0), "textures/numbers/2");
+    Node_getIBrush(second)->getFace(0).setShader("textures/numbers/1");
+
+    Node_setSelected(first, true);
+    Node_setSelected(second, true);
+
+    return { first, second };
+}
+
+// Creates a selected 3x3 and a selected 5x3 patch, each control is set to (col, row, patch)
+// with the texture coordinates (col, row)
+std::pair<scene::INodePtr, scene::INodePtr> createSelectedTestPatches()
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto first = algorithm::createPatchFromBounds(worldspawn);
+    auto second = algorithm::createPatchFromBounds(worldspawn);
+    Node_getIPatch(second)->setDims(5, 3);
+
+    for (const auto& node : { first, second })
+    {
+        auto& patch = *Node_getIPatch(node);
+
+        for (std::size_t row = 0; row < patch.getHeight(); ++row)
+        {
+            for (std::size_t col = 0; col < patch.getWidth(); ++col)
+            {
+                patch.ctrlAt(row, col).vertex = Vector3(col, row, node == first ? 0 : 1);
+                patch.ctrlAt(row, col).texcoord = Vector2(col, row);
+            }
+        }
+
+        patch.controlPointsChanged();
+        Node_setSelected(node, true);
+    }
+
+    return { first, second };
+}
+
+std::vector<std::string> getFaceShaders(const scene::INodePtr& brushNode)
+{
+    std::vector<std::string> shaders;
+    auto& brush = *Node_getIBrush(brushNode);
+
+    for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+    {
+        shaders.push_back(brush.getFace(i).getShader());
+    }
+
+    return shaders;
+}
+
+std::vector<Vector3> getControlVertices(const scene::INodePtr& patchNode)
+{
+    std::vector<Vector3> vertices;
+
+    algorithm::foreachPatchVertex(*Node_getIPatch(patchNode), [&](const PatchControl& control)
+    {
+        vertices.push_back(control.vertex);
+    });
+
+    return vertices;
+}
+
+}
+
+TEST_F(ScriptingSystemTest, BulkSetEntityKeyValuesValidatesFirst)
+{
+    auto first = algorithm::createEntityByClassName("light");
+    auto second = algorithm::createEntityByClassName("light");
+    GlobalMapModule().getRoot()->addChildNode(first);
+    GlobalMapModule().getRoot()->addChildNode(second);
+    Node_setSelected(first, true);
+    Node_setSelected(second, true);
+
+    // The second key is not a string, nothing must be changed
+    auto result = GlobalScriptingSystem().executeString(
+        "nodes = GlobalBulkScene.getEntityKeyValues(True)['nodes']\n"
+        "GlobalBulkScene.setEntityKeyValues(nodes, ['test_key', 5], ['first', 'second'])\n");
+
+    EXPECT_TRUE(result->errorOccurred) << result->output;
+    EXPECT_EQ(Node_getEntity(first)->getKeyValue("test_key"), "");
+    EXPECT_EQ(Node_getEntity(second)->getKeyValue("test_key"), "");
+
+    result = GlobalScriptingSystem().executeString(
+        "nodes = GlobalBulkScene.getEntityKeyValues(True)['nodes']\n"
+        "GlobalBulkScene.setEntityKeyValues(nodes, ['test_key', 'test_key'], ['', 'changed'])\n"
+        "GlobalBulkScene.setEntityKeyValues(nodes, ['test_key', 'test_key'], ['changed', 'changed'])\n");
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_EQ(Node_getEntity(first)->getKeyValue("test_key"), "changed");
+    EXPECT_EQ(Node_getEntity(second)->getKeyValue("test_key"), "changed");
+
+    // Each call is a single undo step
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(Node_getEntity(first)->getKeyValue("test_key"), "");
+    EXPECT_EQ(Node_getEntity(second)->getKeyValue("test_key"), "changed");
+}
+
+TEST_F(ScriptingSystemTest, BulkGetBrushFaces)
+{
+    auto [first, second] = createSelectedTestBrushes();
+
+    auto result = GlobalScriptingSystem().executeString(
+        "faces = GlobalBulkScene.getBrushFaces(True)\n"
+        "offsets = faces['faceOffsets']\n"
+        "print('nodes=' + str(len(faces['nodes'])))\n"
+        "print('offsets=' + str([int(o) for o in offsets]))\n"
+        "print('planes=' + str(faces['planes'].shape))\n"
+        "print('shaderNames=' + str(len(faces['shaderNames'])))\n"
+        "print('first=' + faces['shaderNames'][faces['shaderIndices'][offsets[1]]])\n"
+        "print('second=' + faces['shaderNames'][faces['shaderIndices'][offsets[1] + 1]])\n"
+        "print('plane=' + ' '.join(str(int(round(x))) for x in faces['planes'][offsets[1]]))\n");
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_NE(result->output.find("nodes=2"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("offsets=[0, 6, 12]"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("planes=(12, 4)"), std::string::npos) << result->output;
+
+    // Shader names are stored once, the faces refer to them by index
+    EXPECT_NE(result->output.find("shaderNames=2"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("first=textures/numbers/1"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("second=textures/numbers/2"), std::string::npos) << result->output;
+
+    // The planes of the second brush start at its offset, as normal and distance
+    const auto& plane = Node_getIBrush(second)->getFace(0).getPlane3();
+    auto expectedPlane = fmt::format("plane={0} {1} {2} {3}", std::lround(plane.normal().x()),
+        std::lround(plane.normal().y()), std::lround(plane.normal().z()), std::lround(plane.dist()));
+    EXPECT_NE(result->output.find(expectedPlane), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, BulkGetPatchControlNets)
+{
+    auto [first, second] = createSelectedTestPatches();
+
+    auto result = GlobalScriptingSystem().executeString(
+        "nets = GlobalBulkScene.getPatchControlNets(True)\n"
+        "offsets = nets['controlOffsets']\n"
+        "print('nodes=' + str(len(nets['nodes'])))\n"
+        "print('offsets=' + str([int(o) for o in offsets]))\n"
+        "print('dimensions=' + str([[int(d) for d in row] for row in nets['dimensions']]))\n"
+        "print('vertices=' + str(nets['vertices'].shape))\n"
+        "print('texcoords=' + str(nets['texcoords'].shape))\n"
+        "index = offsets[1] + 2 * 5 + 3\n"
+        "print('vertex=' + ' '.join(str(int(round(x))) for x in nets['vertices'][index]))\n"
+        "print('texcoord=' + ' '.join(str(int(round(x))) for x in nets['texcoords'][index]))\n");
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_NE(result->output.find("nodes=2"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("offsets=[0, 9, 24]"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("dimensions=[[3, 3], [5, 3]]"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("vertices=(24, 3)"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("texcoords=(24, 2)"), std::string::npos) << result->output;
+
+    // Controls are stored row by row, row 2 column 3 of the second patch
+    EXPECT_NE(result->output.find("vertex=3 2 1"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("texcoord=3 2"), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, BulkSetBrushFaceShadersValidatesFirst)
+{
+    auto [first, second] = createSelectedTestBrushes();
+    auto patch = algorithm::createPatchFromBounds(GlobalMapModule().findOrInsertWorldspawn());
+    Node_setSelected(patch, true);
+
+    auto firstShaders = getFaceShaders(first);
+    auto secondShaders = getFaceShaders(second);
+
+    UndoOperationRecorder recorder;
+
+    for (auto statement : {
+        "GlobalBulkScene.setBrushFaceShaders(nodes, [0] * 11, ['textures/numbers/3'])", // too few indices
+        "GlobalBulkScene.setBrushFaceShaders(nodes, [0] * 11 + [1], ['textures/numbers/3'])", // index out of range
+        "GlobalBulkScene.setBrushFaceShaders(nodes, [[0] * 12], ['textures/numbers/3'])", // wrong dimension
+        "GlobalBulkScene.setBrushFaceShaders(nodes + GlobalBulkScene.getPatchControlNets(True)['nodes'], [0] * 12, ['textures/numbers/3'])" })
+    {
+        auto result = GlobalScriptingSystem().executeString(
+            std::string("nodes = GlobalBulkScene.getBrushFaces(True)['nodes']\n") + statement + "\n");
+
+        EXPECT_TRUE(result->errorOccurred) << statement << " should have been rejected";
+        EXPECT_FALSE(GlobalUndoSystem().operationStarted()) << statement;
+    }
+
+    EXPECT_EQ(getFaceShaders(first), firstShaders);
+    EXPECT_EQ(getFaceShaders(second), secondShaders);
+    EXPECT_TRUE(recorder.operations.empty()) << "Rejected calls must not record an undo step";
+
+    auto result = GlobalScriptingSystem().executeString(
+        "nodes = GlobalBulkScene.getBrushFaces(True)['nodes']\n"
+        "GlobalBulkScene.setBrushFaceShaders(nodes, [0] * 12, ['textures/numbers/3'])\n");
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_EQ(getFaceShaders(first), std::vector<std::string>(6, "textures/numbers/3"));
+    EXPECT_EQ(getFaceShaders(second), std::vector<std::string>(6, "textures/numbers/3"));
+    EXPECT_EQ(recorder.operations, std::vector<std::string>{ "setBrushFaceShaders" });
+
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(getFaceShaders(first), firstShaders);
+    EXPECT_EQ(getFaceShaders(second), secondShaders);
+}
+
+TEST_F(ScriptingSystemTest, BulkSetPatchControlNetsValidatesFirst)
+{
+    auto [first, second] = createSelectedTestPatches();
+    auto brush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn());
+    Node_setSelected(brush, true);
+
+    auto firstVertices = getControlVertices(first);
+    auto secondVertices = getControlVertices(second);
+
+    UndoOperationRecorder recorder;
+
+    for (auto statement : {
+        "GlobalBulkScene.setPatchControlNets(nodes, nets['vertices'][:-1])", // too few controls
+        "GlobalBulkScene.setPatchControlNets(nodes, nets['vertices'][:, :2])", // wrong number of columns
+        "GlobalBulkScene.setPatchControlNets(nodes, nets['vertices'], nets['texcoords'][:-1])", // too few texcoords
+        "GlobalBulkScene.setPatchControlNets(nodes + GlobalBulkScene.getBrushFaces(True)['nodes'], nets['vertices'])" })
+    {
+        auto result = GlobalScriptingSystem().executeString(
+            std::string("nets = GlobalBulkScene.getPatchControlNets(True)\n"
+                "nodes = nets['nodes']\n") + statement + "\n");
+
+        EXPECT_TRUE(result->errorOccurred) << statement << " should have been rejected";
+        EXPECT_FALSE(GlobalUndoSystem().operationStarted()) << statement;
+    }
+
+    EXPECT_EQ(getControlVertices(first), firstVertices);
+    EXPECT_EQ(getControlVertices(second), secondVertices);
+    EXPECT_TRUE(recorder.operations.empty()) << "Rejected calls must not record an undo step";
+
+    auto result = GlobalScriptingSystem().executeString(
+        "nets = GlobalBulkScene.getPatchControlNets(True)\n"
+        "vertices = nets['vertices'].copy()\n"
+        "vertices[:, 2] += 8\n"
+        "GlobalBulkScene.setPatchControlNets(nets['nodes'], vertices)\n");
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_EQ(recorder.operations, std::vector<std::string>{ "setPatchControlNets" });
+
+    auto movedVertices = getControlVertices(second);
+    ASSERT_EQ(movedVertices.size(), secondVertices.size());
+
+    for (std::size_t i = 0; i < movedVertices.size(); ++i)
+    {
+        EXPECT_EQ(movedVertices[i], secondVertices[i] + Vector3(0, 0, 8));
+    }
+
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(getControlVertices(first), firstVertices);
+    EXPECT_EQ(getControlVertices(second), secondVertices);
+}
+
+TEST_F(ScriptingSystemTest, AsyncScriptReadsSnapshot)
+{
+    auto entity = algorithm::createEntityByClassName("light");
+    GlobalMapModule().getRoot()->addChildNode(entity);
+    Node_getEntity(entity)->setKeyValue("name", "snapshot_light");
+    Node_getEntity(entity)->setKeyValue("test_key", "before");
+
+    auto execution = GlobalScriptingSystem().executeStringAsync(
+        "for i in range(Snapshot.getEntityCount()):\n"
+        "    if Snapshot.getEntityKeyValue(i, 'name') == 'snapshot_light':\n"
+        "        print('test_key=' + Snapshot.getEntityKeyValue(i, 'test_key'))\n");
+
+    // The live scene changing doesn't affect the snapshot the script is working on
+    Node_getEntity(entity)->setKeyValue("test_key", "after");
+
+    auto result = execution->waitForResult();
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_NE(result->output.find("test_key=before"), std::string::npos) << result->output;
+    EXPECT_EQ(result->output.find("test_key=after"), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, AsyncScriptSnapshotContainsPrimitives)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+
+    auto execution = GlobalScriptingSystem().executeStringAsync(
+        "print('entities=' + str(Snapshot.getEntityCount()))\n"
+        "print('brushes=' + str(Snapshot.getBrushCount()))\n"
+        "print('faces=' + str(Snapshot.getBrushFaceCount(0)))\n"
+        "print('shader=' + Snapshot.getBrushFaceShader(0, 0))\n"
+        "print('classname=' + Snapshot.getEntityKeyValue(Snapshot.getBrushEntity(0), 'classname'))\n");
+
+    auto result = execution->waitForResult();
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_NE(result->output.find("entities=1"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("brushes=1"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("faces=6"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("shader=textures/numbers/1"), std::string::npos) << result->output;
+    EXPECT_NE(result->output.find("classname=worldspawn"), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, AsyncScriptCannotAccessLiveScene)
+{
+    for (auto statement : { "GlobalSceneGraph.root()", "GlobalMap.getMapName()", "DR.Vector3(0, 0, 0)",
+        "GlobalSelectionSystem.countSelected()", "GlobalBulkScene" })
+    {
+        auto result = GlobalScriptingSystem().executeStringAsync(statement)->waitForResult();
+
+        EXPECT_TRUE(result->errorOccurred) << statement << " should not be available";
+        EXPECT_NE(result->output.find("NameError"), std::string::npos) << result->output;
+    }
+
+    // The math types are safe to use
+    auto result = GlobalScriptingSystem().executeStringAsync(
+        "print('length=' + str(Vector3(3, 4, 0).getLength()))\n")->waitForResult();
+
+    EXPECT_FALSE(result->errorOccurred) << result->output;
+    EXPECT_NE(result->output.find("length=5"), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, AsyncScriptErrors)
+{
+    auto result = GlobalScriptingSystem().executeStringAsync("raise RuntimeError('failing on purpose')")->waitForResult();
+
+    EXPECT_TRUE(result->errorOccurred);
+    EXPECT_NE(result->output.find("failing on purpose"), std::string::npos) << result->output;
+
+    // Snapshot accessors are range-checked
+    result = GlobalScriptingSystem().executeStringAsync("Snapshot.getEntityKeyValue(100000, 'name')")->waitForResult();
+
+    EXPECT_TRUE(result->errorOccurred);
+    EXPECT_NE(result->output.find("out of range"), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, AsyncScriptProgressAndCancel)
+{
+    auto execution = GlobalScriptingSystem().executeStringAsync(
+        "AsyncScript.reportProgress(0.5, 'halfway')\n"
+        "while True:\n"
+        "    pass\n");
+
+    EXPECT_TRUE(waitFor(execution, [&] { return execution->getProgress() == 0.5f; }));
+    EXPECT_EQ(execution->getProgressText(), "halfway");
+    EXPECT_FALSE(execution->isFinished());
+
+    execution->cancel();
+
+    auto result = execution->waitForResult();
+
+    EXPECT_TRUE(execution->isFinished());
+    EXPECT_FALSE(result->errorOccurred) << "Cancelling is not an error: " << result->output;
+    EXPECT_NE(result->output.find("Script cancelled"), std::string::npos) << result->output;
+}
+
+TEST_F(ScriptingSystemTest, AsyncScriptCommandsRunOnMainThread)
+{
+    std::vector<std::string> receivedArguments;
+    std::vector<std::thread::id> executingThreads;
+
+    GlobalCommandSystem().addCommand("TestAsyncScriptCommand", [&](const cmd::ArgumentList& args)
+    {
+        receivedArguments.push_back(args.at(0).getString());
+        executingThreads.push_back(std::this_thread::get_id());
+    }, { cmd::ARGTYPE_STRING });
+
+    auto execution = GlobalScriptingSystem().executeStringAsync(
+        "AsyncScript.executeCommand('TestAsyncScriptCommand first')\n"
+        "AsyncScript.executeCommand('TestAsyncScriptCommand second')\n"
+        "AsyncScript.reportProgress(1.0)\n"
+        "while not AsyncScript.isCancelled():\n"
+        "    pass\n");
+
+    EXPECT_TRUE(waitFor(execution, [&] { return execution->getProgress() == 1.0f; }));
+
+    // Nothing is executed before the main thread asks for it
+    EXPECT_TRUE(receivedArguments.empty());
+
+    execution->processPendingCommands();
+
+    std::vector<std::string> expectedArguments{ "first", "second" };
+    EXPECT_EQ(receivedArguments, expectedArguments);
+
+    execution->cancel();
+    execution->waitForResult();
+
+    EXPECT_EQ(receivedArguments, expectedArguments) << "Commands should be executed only once";
+
+    for (const auto& threadId : executingThreads)
+    {
+        EXPECT_EQ(threadId, std::this_thread::get_id());
+    }
+
+    GlobalCommandSystem().removeCommand("TestAsyncScriptCommand");
+}
+
+}
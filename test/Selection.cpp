@@ -9,6 +9,7 @@
 #include "ibrush.h"
 #include "ipatch.h"
 #include "ientity.h"
+#include "iorthoview.h"
 #include "ieclass.h"
 #include "algorithm/Scene.h"
 #include "algorithm/Primitives.h"
@@ -24,6 +25,7 @@
 #include "algorithm/XmlUtils.h"
 #include "command/ExecutionNotPossible.h"
 #include "scene/Group.h"
+#include <set>
 
 namespace test
 {
@@ -239,6 +241,96 @@ TEST_F(SelectionTest, WorkzoneIsRecalculatedAfterSelectionChange)
     EXPECT_EQ(GlobalSelectionSystem().getWorkZone().bounds, smallBounds);
 }
 
+TEST_F(SelectionTest, SelectionOrderPreservedAfterDeselection)
+{
+    loadMap("selection_test2.map");
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/numbers/1");
+    auto brush2 = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/numbers/2");
+    auto brush3 = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/numbers/3");
+
+    Node_setSelected(brush2, true);
+    Node_setSelected(brush, true);
+    Node_setSelected(brush3, true);
+
+    EXPECT_EQ(GlobalSelectionSystem().ultimateSelected(), brush3);
+    EXPECT_EQ(GlobalSelectionSystem().penultimateSelected(), brush);
+
+    // Deselecting the ultimate node moves the older ones up
+    Node_setSelected(brush3, false);
+
+    EXPECT_EQ(GlobalSelectionSystem().ultimateSelected(), brush);
+    EXPECT_EQ(GlobalSelectionSystem().penultimateSelected(), brush2);
+
+    // Deselecting a node in the middle leaves the order of the others intact
+    Node_setSelected(brush3, true);
+    Node_setSelected(brush, false);
+
+    std::vector<scene::INodePtr> visited;
+    GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node) { visited.push_back(node); });
+
+    EXPECT_EQ(visited, std::vector<scene::INodePtr>({ brush2, brush3 }));
+    EXPECT_EQ(GlobalSelectionSystem().penultimateSelected(), brush2);
+
+    // Deselect all while iterating over the selection
+    GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node) { Node_setSelected(node, false); });
+
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0);
+    expectNodeSelectionStatus({}, { brush, brush2, brush3 });
+
+    Node_setSelected(brush, true);
+    Node_setSelected(brush2, true);
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0);
+    expectNodeSelectionStatus({}, { brush, brush2, brush3 });
+}
+
+TEST_F(SelectionTest, ParallelAreaSelectionMatchesSequentialTest)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // Enough brushes to have the tests distributed across several threads
+    std::vector<scene::INodePtr> brushes;
+
+    for (int x = -20; x < 20; ++x)
+    {
+        for (int y = -20; y < 20; ++y)
+        {
+            brushes.push_back(algorithm::createCuboidBrush(worldspawn,
+                AABB(Vector3(x * 15 + 7.5, y * 15 + 7.5, 0), Vector3(4, 4, 4))));
+        }
+    }
+
+    auto performAreaSelection = [&]()
+    {
+        GlobalSelectionSystem().setSelectedAll(false);
+
+        render::View view(false);
+        algorithm::constructCenteredOrthoview(view, Vector3(0, 0, 0));
+
+        // Select the left half of the view
+        ConstructSelectionTest(view, selection::Rectangle::ConstructFromArea(Vector2(-1, -1), Vector2(1, 2)));
+        SelectionVolume test(view);
+
+        GlobalSelectionSystem().selectArea(test, selection::SelectionSystem::eReplace, false);
+
+        std::set<scene::INodePtr> selected;
+        GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node) { selected.insert(node); });
+        return selected;
+    };
+
+    registry::setValue(RKEY_PARALLEL_SELECTION_TESTS, false);
+    auto sequentialResult = performAreaSelection();
+
+    registry::setValue(RKEY_PARALLEL_SELECTION_TESTS, true);
+    auto parallelResult = performAreaSelection();
+
+    EXPECT_EQ(sequentialResult.size(), brushes.size() / 2) << "Expected the left half of the brushes to be selected";
+    EXPECT_EQ(parallelResult, sequentialResult) << "Parallel test should select the same brushes";
+}
+
 TEST_F(SelectionTest, InitialSelectionFocusState)
 {
     EXPECT_FALSE(GlobalSelectionSystem().selectionFocusIsActive());
@@ -92,4 +92,17 @@ TEST_F(SoundManagerTest, GetSoundFileDurationWithoutExtension)
     EXPECT_NEAR(duration, oggDuration, 0.001) << "The OGG file should have been found, not the wav file";
 }
 
+TEST_F(SoundManagerTest, RepeatedSoundFileDurationQueries)
+{
+    // The second round is answered from the duration cache and must yield the same values
+    auto oggDuration = GlobalSoundManager().getSoundFileDuration("sound/test/jorge.ogg");
+    auto wavDuration = GlobalSoundManager().getSoundFileDuration("sound/test/jorge.wav");
+    auto fallbackDuration = GlobalSoundManager().getSoundFileDuration("sound/test/jorge");
+
+    EXPECT_EQ(GlobalSoundManager().getSoundFileDuration("sound/test/jorge.ogg"), oggDuration);
+    EXPECT_EQ(GlobalSoundManager().getSoundFileDuration("sound/test/jorge.wav"), wavDuration);
+    EXPECT_EQ(GlobalSoundManager().getSoundFileDuration("sound/test/jorge"), fallbackDuration);
+    EXPECT_NEAR(fallbackDuration, oggDuration, 0.001) << "The cached lookup should still prefer the OGG file";
+}
+
 }
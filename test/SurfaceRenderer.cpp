@@ -0,0 +1,278 @@
+#include "gtest/gtest.h"
+
+#include <sigc++/signal.h>
+#include "render/MeshVertex.h"
+#include "render/GeometryStore.h"
+#include "render/NopVolumeTest.h"
+#include "testutil/TestBufferObjectProvider.h"
+#include "testutil/TestObjectRenderer.h"
+#include "testutil/TestSyncObjectProvider.h"
+
+#include "../radiantcore/rendersystem/backend/SurfaceRenderer.h"
+
+namespace test
+{
+
+namespace
+{
+
+// Quad surface placed at the given origin
+class TestSurface :
+    public render::IRenderableSurface
+{
+private:
+    std::vector<MeshVertex> _vertices;
+    std::vector<unsigned int> _indices;
+    Matrix4 _transform;
+    AABB _bounds;
+    sigc::signal<void> _sigBoundsChanged;
+
+public:
+    TestSurface(const Vector3& origin, double size) :
+        _indices({ 0, 1, 2, 0, 2, 3 }),
+        _transform(Matrix4::getTranslation(origin))
+    {
+        setSize(size);
+    }
+
+    // Replaces the geometry, the renderer needs to be notified through updateSurface()
+    void setSize(double size)
+    {
+        _vertices =
+        {
+            MeshVertex({ 0, 0, 0 }, { 0, 0, 1 }, { 0, 0 }),
+            MeshVertex({ size, 0, 0 }, { 0, 0, 1 }, { 1, 0 }),
+            MeshVertex({ size, size, 0 }, { 0, 0, 1 }, { 1, 1 }),
+            MeshVertex({ 0, size, 0 }, { 0, 0, 1 }, { 0, 1 }),
+        };
+
+        _bounds = AABB::createFromMinMax({ 0, 0, 0 }, { size, size, 0 });
+    }
+
+    const std::vector<MeshVertex>& getVertices() override
+    {
+        return _vertices;
+    }
+
+    const std::vector<unsigned int>& getIndices() override
+    {
+        return _indices;
+    }
+
+    bool isVisible() override
+    {
+        return true;
+    }
+
+    bool isOriented() override
+    {
+        return true;
+    }
+
+    const Matrix4& getObjectTransform() override
+    {
+        return _transform;
+    }
+
+    const AABB& getObjectBounds() override
+    {
+        return _bounds;
+    }
+
+    sigc::signal<void>& signal_boundsChanged() override
+    {
+        return _sigBoundsChanged;
+    }
+
+    render::IGeometryStore::Slot getStorageLocation() override
+    {
+        return std::numeric_limits<render::IGeometryStore::Slot>::max();
+    }
+
+    bool isShadowCasting() override
+    {
+        return false;
+    }
+};
+
+// Checks that the geometry store holds the vertices and indices of the given surface at that slot
+void verifySurfaceStorage(render::IGeometryStore& store, render::IGeometryStore::Slot slot, TestSurface& surface)
+{
+    auto renderParms = store.getBufferAddresses(slot);
+    const auto& indices = surface.getIndices();
+
+    ASSERT_EQ(renderParms.indexCount, indices.size()) << "Index count mismatch";
+
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        EXPECT_EQ(renderParms.clientFirstIndex[i], indices[i]) << "Index data mismatch";
+    }
+
+    auto vertex = renderParms.clientBufferStart + renderParms.firstVertex;
+
+    for (const auto& expected : surface.getVertices())
+    {
+        render::RenderVertex expectedVertex(expected.vertex, expected.normal, expected.texcoord,
+            expected.colour, expected.tangent, expected.bitangent);
+
+        EXPECT_TRUE(math::isNear(vertex->vertex, expectedVertex.vertex, 0.01)) << "Vertex data mismatch";
+        EXPECT_TRUE(math::isNear(vertex->texcoord, expectedVertex.texcoord, 0.01)) << "Texcoord data mismatch";
+        ++vertex;
+    }
+}
+
+class SurfaceRendererTest :
+    public testing::Test
+{
+protected:
+    TestBufferObjectProvider _bufferObjectProvider;
+    TestSyncObjectProvider _syncObjectProvider;
+    TestObjectRenderer _objectRenderer;
+    render::GeometryStore _store;
+    render::SurfaceRenderer _renderer;
+    render::NopVolumeTest _view;
+
+    SurfaceRendererTest() :
+        _store(_syncObjectProvider, _bufferObjectProvider),
+        _renderer(_store, _objectRenderer)
+    {}
+};
+
+}
+
+TEST_F(SurfaceRendererTest, IdenticalSurfacesShareStorage)
+{
+    TestSurface first({ 0, 0, 0 }, 64);
+    TestSurface second({ 128, 0, 0 }, 64);
+    TestSurface other({ 256, 0, 0 }, 32);
+
+    auto firstSlot = _renderer.addSurface(first);
+    auto secondSlot = _renderer.addSurface(second);
+    auto otherSlot = _renderer.addSurface(other);
+
+    EXPECT_NE(firstSlot, secondSlot) << "Each surface needs its own renderer slot";
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(firstSlot), _renderer.getSurfaceStorageLocation(secondSlot))
+        << "Identical surfaces should share their storage";
+    EXPECT_NE(_renderer.getSurfaceStorageLocation(firstSlot), _renderer.getSurfaceStorageLocation(otherSlot))
+        << "Different surfaces must not share their storage";
+
+    verifySurfaceStorage(_store, _renderer.getSurfaceStorageLocation(secondSlot), second);
+    verifySurfaceStorage(_store, _renderer.getSurfaceStorageLocation(otherSlot), other);
+
+    // The shared geometry is drawn in a single call
+    _renderer.prepareForRendering();
+    _renderer.render(_view, true, false);
+
+    EXPECT_EQ(_objectRenderer.getStatistics().drawCalls, 2);
+    EXPECT_EQ(_objectRenderer.getStatistics().instancedDrawCalls, 1);
+    EXPECT_EQ(_objectRenderer.getStatistics().instances, 2);
+
+    // Without instancing, every surface is drawn on its own
+    _objectRenderer.resetStatistics();
+    _renderer.render(_view, false, false);
+
+    EXPECT_EQ(_objectRenderer.getStatistics().drawCalls, 3);
+    EXPECT_EQ(_objectRenderer.getStatistics().instancedDrawCalls, 0);
+}
+
+TEST_F(SurfaceRendererTest, RemovingSharedSurfaceKeepsStorage)
+{
+    TestSurface first({ 0, 0, 0 }, 64);
+    TestSurface second({ 128, 0, 0 }, 64);
+    TestSurface third({ 256, 0, 0 }, 64);
+
+    auto firstSlot = _renderer.addSurface(first);
+    auto secondSlot = _renderer.addSurface(second);
+    auto storage = _renderer.getSurfaceStorageLocation(firstSlot);
+
+    // Removing the surface the storage has been allocated for
+    _renderer.removeSurface(firstSlot);
+
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(secondSlot), storage) << "Remaining user should keep the storage";
+    verifySurfaceStorage(_store, storage, second);
+
+    // Surfaces added afterwards get valid storage
+    auto thirdSlot = _renderer.addSurface(third);
+    verifySurfaceStorage(_store, _renderer.getSurfaceStorageLocation(thirdSlot), third);
+
+    _renderer.prepareForRendering();
+    _renderer.render(_view, true, false);
+
+    const auto& statistics = _objectRenderer.getStatistics();
+    auto singleDrawCalls = statistics.drawCalls - statistics.instancedDrawCalls;
+
+    EXPECT_EQ(singleDrawCalls + statistics.instances, 2) << "Both remaining surfaces should be drawn exactly once";
+}
+
+TEST_F(SurfaceRendererTest, RemovingNonRepresentativeSurfaceKeepsSharing)
+{
+    TestSurface first({ 0, 0, 0 }, 64);
+    TestSurface second({ 128, 0, 0 }, 64);
+    TestSurface third({ 256, 0, 0 }, 64);
+
+    auto firstSlot = _renderer.addSurface(first);
+    auto secondSlot = _renderer.addSurface(second);
+    auto storage = _renderer.getSurfaceStorageLocation(firstSlot);
+
+    _renderer.removeSurface(secondSlot);
+
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(firstSlot), storage);
+    verifySurfaceStorage(_store, storage, first);
+
+    // The first surface is still around to compare against, new users join its storage
+    auto thirdSlot = _renderer.addSurface(third);
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(thirdSlot), storage);
+}
+
+TEST_F(SurfaceRendererTest, DivergingSurfaceGetsOwnStorage)
+{
+    TestSurface first({ 0, 0, 0 }, 64);
+    TestSurface second({ 128, 0, 0 }, 64);
+
+    auto firstSlot = _renderer.addSurface(first);
+    auto secondSlot = _renderer.addSurface(second);
+    auto sharedStorage = _renderer.getSurfaceStorageLocation(firstSlot);
+
+    ASSERT_EQ(_renderer.getSurfaceStorageLocation(secondSlot), sharedStorage);
+
+    // Change the geometry of the second surface
+    second.setSize(16);
+    _renderer.updateSurface(secondSlot);
+    _renderer.prepareForRendering();
+
+    EXPECT_NE(_renderer.getSurfaceStorageLocation(secondSlot), sharedStorage) << "Changed surface needs its own storage";
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(firstSlot), sharedStorage) << "Unchanged surface should keep its storage";
+
+    verifySurfaceStorage(_store, sharedStorage, first);
+    verifySurfaceStorage(_store, _renderer.getSurfaceStorageLocation(secondSlot), second);
+
+    _renderer.render(_view, true, false);
+    EXPECT_EQ(_objectRenderer.getStatistics().drawCalls, 2);
+    EXPECT_EQ(_objectRenderer.getStatistics().instancedDrawCalls, 0);
+}
+
+TEST_F(SurfaceRendererTest, UnsharedSurfaceIsUpdatedInPlace)
+{
+    TestSurface first({ 0, 0, 0 }, 64);
+    TestSurface second({ 128, 0, 0 }, 32);
+
+    auto firstSlot = _renderer.addSurface(first);
+    auto secondSlot = _renderer.addSurface(second);
+    auto storage = _renderer.getSurfaceStorageLocation(firstSlot);
+
+    first.setSize(16);
+    _renderer.updateSurface(firstSlot);
+    _renderer.prepareForRendering();
+
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(firstSlot), storage) << "Storage should be reused";
+    verifySurfaceStorage(_store, storage, first);
+
+    // New surfaces are compared against the updated geometry
+    TestSurface third({ 256, 0, 0 }, 16);
+    auto thirdSlot = _renderer.addSurface(third);
+
+    EXPECT_EQ(_renderer.getSurfaceStorageLocation(thirdSlot), storage);
+    EXPECT_NE(_renderer.getSurfaceStorageLocation(secondSlot), storage);
+}
+
+}
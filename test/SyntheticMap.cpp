@@ -0,0 +1,198 @@
+#include "RadiantTest.h"
+
+#include <set>
+
+#include "imap.h"
+#include "ishaders.h"
+#include "ientity.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "icommandsystem.h"
+#include "algorithm/SyntheticMap.h"
+#include "algorithm/FileUtils.h"
+#include "algorithm/Primitives.h"
+#include "testutil/TemporaryFile.h"
+#include "testutil/CommandFailureHelper.h"
+
+namespace test
+{
+
+using SyntheticMapTest = RadiantTest;
+
+namespace
+{
+
+struct MapContents
+{
+    std::size_t worldspawnPrimitives = 0;
+    std::size_t brushes = 0;
+    std::size_t patches = 0;
+    std::size_t entities = 0;
+    std::size_t lights = 0;
+    std::size_t models = 0;
+    std::set<std::string> materials;
+};
+
+MapContents getMapContents()
+{
+    MapContents contents;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        auto entity = Node_getEntity(node);
+
+        if (!entity) return true;
+
+        if (entity->getKeyValue("classname") == "light")
+        {
+            ++contents.lights;
+        }
+        else if (!entity->getKeyValue("model").empty() && entity->getKeyValue("model") != entity->getKeyValue("name"))
+        {
+            ++contents.models;
+        }
+        else if (!entity->isWorldspawn())
+        {
+            ++contents.entities;
+        }
+
+        node->foreachNode([&](const scene::INodePtr& child)
+        {
+            if (Node_isBrush(child))
+            {
+                ++contents.brushes;
+                algorithm::foreachFace(*Node_getIBrush(child), [&](IFace& face) { contents.materials.insert(face.getShader()); });
+            }
+            else if (Node_isPatch(child))
+            {
+                ++contents.patches;
+                contents.materials.insert(Node_getIPatch(child)->getShader());
+            }
+            else
+            {
+                return true;
+            }
+
+            if (entity->isWorldspawn())
+            {
+                ++contents.worldspawnPrimitives;
+            }
+
+            return true;
+        });
+
+        return true;
+    });
+
+    return contents;
+}
+
+std::string saveMapToString(const std::string& path)
+{
+    GlobalCommandSystem().executeCommand("SaveAutomaticBackup", path);
+    return algorithm::loadFileToString(path);
+}
+
+}
+
+TEST_F(SyntheticMapTest, GeneratedObjectCounts)
+{
+    algorithm::SyntheticMapSize size;
+    size.brushes = 60;
+    size.patches = 15;
+    size.entities = 4;
+    size.lights = 7;
+    size.models = 9;
+
+    CommandFailureHelper helper;
+    algorithm::generateSyntheticMap(size);
+    EXPECT_FALSE(helper.messageReceived()) << helper.getLastReceivedMessage();
+
+    auto contents = getMapContents();
+
+    EXPECT_EQ(contents.brushes, size.brushes);
+    EXPECT_EQ(contents.patches, size.patches);
+    EXPECT_EQ(contents.entities, size.entities);
+    EXPECT_EQ(contents.lights, size.lights);
+    EXPECT_EQ(contents.models, size.models);
+
+    // Primitives are distributed evenly across worldspawn and the func_statics
+    EXPECT_EQ(contents.worldspawnPrimitives, (size.brushes + size.patches) / (size.entities + 1));
+
+    EXPECT_TRUE(GlobalMapModule().isModified());
+}
+
+TEST_F(SyntheticMapTest, UsesMaterialsOfTheVfs)
+{
+    algorithm::generateSyntheticMap(200);
+
+    auto contents = getMapContents();
+
+    // There should be a good mix of materials
+    EXPECT_GT(contents.materials.size(), 10);
+
+    for (const auto& material : contents.materials)
+    {
+        EXPECT_TRUE(GlobalMaterialManager().materialExists(material)) << material << " is not declared";
+    }
+}
+
+TEST_F(SyntheticMapTest, SameSeedProducesSameMap)
+{
+    auto path = _context.getTemporaryDataPath() + "synthetic.map";
+    TemporaryFile mapFile(path);
+    TemporaryFile infoFile(path.substr(0, path.length() - 3) + "darkradiant");
+
+    auto firstBounds = algorithm::generateSyntheticMap(500, 17);
+    auto first = saveMapToString(path);
+
+    auto secondBounds = algorithm::generateSyntheticMap(500, 17);
+    auto second = saveMapToString(path);
+
+    EXPECT_EQ(first, second) << "Same seed produced different maps";
+    EXPECT_TRUE(math::isNear(firstBounds.getOrigin(), secondBounds.getOrigin(), 0.01));
+    EXPECT_TRUE(math::isNear(firstBounds.getExtents(), secondBounds.getExtents(), 0.01));
+
+    algorithm::generateSyntheticMap(500, 18);
+    auto third = saveMapToString(path);
+
+    EXPECT_NE(first, third) << "Different seeds produced the same map";
+}
+
+TEST_F(SyntheticMapTest, SaveAndLoadRoundTrip)
+{
+    auto path = _context.getTemporaryDataPath() + "synthetic_roundtrip.map";
+    TemporaryFile mapFile(path);
+    TemporaryFile infoFile(path.substr(0, path.length() - 3) + "darkradiant");
+
+    algorithm::generateSyntheticMap(300, 5);
+    auto generated = getMapContents();
+
+    GlobalCommandSystem().executeCommand("SaveAutomaticBackup", path);
+
+    GlobalMapModule().setModified(false);
+    GlobalCommandSystem().executeCommand("OpenMap", path);
+
+    auto loaded = getMapContents();
+
+    EXPECT_EQ(loaded.brushes, generated.brushes);
+    EXPECT_EQ(loaded.patches, generated.patches);
+    EXPECT_EQ(loaded.entities, generated.entities);
+    EXPECT_EQ(loaded.lights, generated.lights);
+    EXPECT_EQ(loaded.models, generated.models);
+    EXPECT_EQ(loaded.materials, generated.materials);
+}
+
+TEST_F(SyntheticMapTest, NegativeCountIsRejected)
+{
+    CommandFailureHelper helper;
+    GlobalMapModule().setModified(false);
+
+    GlobalCommandSystem().executeCommand("GenerateSyntheticMap", {
+        cmd::Argument(-1), cmd::Argument(0), cmd::Argument(0), cmd::Argument(0), cmd::Argument(0)
+    });
+
+    EXPECT_TRUE(helper.messageReceived()) << "Negative counts should have been rejected";
+}
+
+}
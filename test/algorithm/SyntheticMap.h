@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include "imap.h"
+#include "iscenegraph.h"
+#include "icommandsystem.h"
+#include "math/AABB.h"
+
+namespace test::algorithm
+{
+
+// The contents of a map created by generateSyntheticMap()
+struct SyntheticMapSize
+{
+    std::size_t brushes = 0;
+    std::size_t patches = 0;
+    std::size_t entities = 0; // brush-based func_statics, holding a share of the primitives
+    std::size_t lights = 0;
+    std::size_t models = 0; // func_statics with a model spawnarg
+    int seed = 0;
+};
+
+// Replaces the current map with a deterministic synthetic one, using the materials
+// and model files of the test VFS. Returns the bounds of the generated map.
+inline AABB generateSyntheticMap(const SyntheticMapSize& size)
+{
+    // Discard any changes without asking
+    GlobalMapModule().setModified(false);
+
+    GlobalCommandSystem().executeCommand("GenerateSyntheticMap", {
+        cmd::Argument(static_cast<int>(size.brushes)),
+        cmd::Argument(static_cast<int>(size.patches)),
+        cmd::Argument(static_cast<int>(size.entities)),
+        cmd::Argument(static_cast<int>(size.lights)),
+        cmd::Argument(static_cast<int>(size.models)),
+        cmd::Argument(size.seed)
+    });
+
+    return GlobalSceneGraph().root()->worldAABB();
+}
+
+// A map of the given number of primitives, with lights and models in proportion
+// to what's common in actual missions
+inline AABB generateSyntheticMap(std::size_t numPrimitives, int seed = 0)
+{
+    SyntheticMapSize size;
+
+    size.patches = numPrimitives / 8;
+    size.brushes = numPrimitives - size.patches;
+    size.entities = numPrimitives / 50;
+    size.lights = numPrimitives / 40;
+    size.models = numPrimitives / 10;
+    size.seed = seed;
+
+    return generateSyntheticMap(size);
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "RadiantTest.h"
+
+namespace test
+{
+
+/**
+ * Headless application environment shared by all benchmarks in drbench.
+ *
+ * This reuses the RadiantTest fixture to start the core modules against the
+ * test resources, including the headless openGL context. The modules are
+ * started once per process, every benchmark is supposed to begin with a new map.
+ */
+class BenchmarkEnvironment final :
+    public RadiantTest
+{
+private:
+    static inline BenchmarkEnvironment* _instance = nullptr;
+
+public:
+    BenchmarkEnvironment()
+    {
+        _instance = this;
+    }
+
+    ~BenchmarkEnvironment()
+    {
+        _instance = nullptr;
+    }
+
+    void startup()
+    {
+        SetUp();
+    }
+
+    void shutdown()
+    {
+        TearDown();
+    }
+
+    const radiant::TestContext& getContext() const
+    {
+        return _context;
+    }
+
+    static BenchmarkEnvironment& Instance()
+    {
+        return *_instance;
+    }
+
+protected:
+    // Never invoked, the environment is not run as a test
+    void TestBody() override
+    {}
+};
+
+}
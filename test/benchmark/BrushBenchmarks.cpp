@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+#include "SyntheticScene.h"
+
+#include "ibrush.h"
+
+namespace test
+{
+
+// Rebuilds the windings of a prism brush with the given number of sides
+void BrushBRepBuild(benchmark::State& state)
+{
+    auto numSides = static_cast<std::size_t>(state.range(0));
+
+    GlobalMapModule().createNewMap();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushNode = algorithm::createPrismBrush(worldspawn, Vector3(0, 0, 0), numSides, "_default");
+    auto& brush = *Node_getIBrush(brushNode);
+
+    auto outwards = Matrix4::getTranslation(Vector3(16, 0, 0));
+    auto inwards = Matrix4::getTranslation(Vector3(-16, 0, 0));
+    auto moveOutwards = true;
+
+    for (auto _ : state)
+    {
+        // Moving one plane back and forth invalidates the windings of all faces
+        auto& face = brush.getFace(0);
+        face.transform(moveOutwards ? outwards : inwards);
+        face.freezeTransform();
+        moveOutwards = !moveOutwards;
+
+        brush.evaluateBRep();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (numSides + 2));
+
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(BrushBRepBuild)->Arg(4)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+}
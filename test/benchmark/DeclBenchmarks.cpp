@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+
+#include "ideclmanager.h"
+#include "ishaders.h"
+
+namespace test
+{
+
+// Reloads all declarations of the test project and forces every material to be parsed
+void MaterialCorpusParsing(benchmark::State& state)
+{
+    std::size_t numMaterials = 0;
+
+    for (auto _ : state)
+    {
+        GlobalDeclarationManager().reloadDeclarations();
+
+        numMaterials = 0;
+
+        GlobalMaterialManager().foreachMaterial([&](const MaterialPtr& material)
+        {
+            // Accessing the description triggers the parser
+            benchmark::DoNotOptimize(material->getDescription());
+            ++numMaterials;
+        });
+    }
+
+    state.SetItemsProcessed(state.iterations() * numMaterials);
+    state.counters["materials"] = static_cast<double>(numMaterials);
+}
+BENCHMARK(MaterialCorpusParsing)->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,33 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+#include "SyntheticScene.h"
+
+#include "ifilter.h"
+
+namespace test
+{
+
+// Toggling a filter re-evaluates the visibility of every node in the scene
+void FilterUpdate(benchmark::State& state)
+{
+    auto numPrimitives = static_cast<std::size_t>(state.range(0));
+
+    algorithm::generateSyntheticMap(numPrimitives);
+
+    auto filterState = true;
+
+    for (auto _ : state)
+    {
+        GlobalFilterSystem().setFilterState("Caulk", filterState);
+        filterState = !filterState;
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPrimitives);
+
+    GlobalFilterSystem().setFilterState("Caulk", false);
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(FilterUpdate)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+}
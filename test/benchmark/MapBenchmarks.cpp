@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+#include "SyntheticScene.h"
+
+#include "imap.h"
+#include "icommandsystem.h"
+#include "os/file.h"
+
+namespace test
+{
+
+namespace
+{
+    std::string prepareSyntheticMapFile(std::size_t numPrimitives)
+    {
+        algorithm::generateSyntheticMap(numPrimitives);
+
+        auto path = BenchmarkEnvironment::Instance().getContext().getTemporaryDataPath() +
+            "synthetic_" + string::to_string(numPrimitives) + ".map";
+
+        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", path);
+
+        return path;
+    }
+}
+
+void MapSave(benchmark::State& state)
+{
+    auto numPrimitives = static_cast<std::size_t>(state.range(0));
+
+    algorithm::generateSyntheticMap(numPrimitives);
+
+    auto path = BenchmarkEnvironment::Instance().getContext().getTemporaryDataPath() + "synthetic_save.map";
+
+    for (auto _ : state)
+    {
+        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", path);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPrimitives);
+    state.counters["fileSize"] = static_cast<double>(os::getFileSize(path));
+
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(MapSave)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+void MapLoad(benchmark::State& state)
+{
+    auto numPrimitives = static_cast<std::size_t>(state.range(0));
+    auto path = prepareSyntheticMapFile(numPrimitives);
+
+    for (auto _ : state)
+    {
+        // Don't let the map module ask about unsaved changes
+        GlobalMapModule().setModified(false);
+        GlobalCommandSystem().executeCommand("OpenMap", path);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPrimitives);
+
+    GlobalMapModule().setModified(false);
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(MapLoad)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+}
@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+#include "SyntheticScene.h"
+
+#include "igl.h"
+#include "irender.h"
+#include "iparticles.h"
+#include "iparticlestage.h"
+#include "irendersystemfactory.h"
+#include "render/RenderableCollectionWalker.h"
+#include "algorithm/View.h"
+
+namespace test
+{
+
+namespace
+{
+    // Front end collector without any highlighting, like a camera view without selection
+    class BenchmarkRenderableCollector :
+        public render::RenderableCollectorBase
+    {
+    public:
+        bool supportsFullMaterials() const override
+        {
+            return true;
+        }
+
+        void addHighlightRenderable(const OpenGLRenderable& renderable, const Matrix4& localToWorld) override
+        {}
+    };
+}
+
+// Renders a camera frame of the grid into the headless context, front end and back end
+void HeadlessFrame(benchmark::State& state)
+{
+    auto numPrimitives = static_cast<std::size_t>(state.range(0));
+
+    auto bounds = algorithm::generateSyntheticMap(numPrimitives);
+
+    render::View view(true);
+    algorithm::constructCameraView(view, bounds, Vector3(0, 0, -1), Vector3(-90, 0, 0));
+
+    auto flags = RENDER_DEPTHTEST | RENDER_MASKCOLOUR | RENDER_DEPTHWRITE | RENDER_ALPHATEST |
+        RENDER_BLEND | RENDER_CULLFACE | RENDER_OFFSETLINE | RENDER_VERTEX_COLOUR |
+        RENDER_FILL | RENDER_LIGHTING | RENDER_TEXTURE_2D | RENDER_SMOOTH | RENDER_SCALED;
+
+    BenchmarkRenderableCollector collector;
+    std::size_t drawCalls = 0;
+
+    GlobalRenderSystem().setPassTimingsEnabled(true);
+
+    for (auto _ : state)
+    {
+        GlobalRenderSystem().startFrame();
+
+        render::RenderableCollectionWalker::CollectRenderablesInScene(collector, view);
+        auto result = GlobalRenderSystem().renderFullBrightScene(RenderViewType::Camera, flags, view);
+        drawCalls = result->getDrawCalls();
+
+        GlobalRenderSystem().endFrame();
+
+        // Include the GPU work in the measurement
+        glFinish();
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPrimitives);
+    state.counters["drawCalls"] = static_cast<double>(drawCalls);
+
+    // Report the pass breakdown of the last frame
+    auto timings = GlobalRenderSystem().getPassTimings(RenderViewType::Camera);
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(RenderPass::NumPasses); ++i)
+    {
+        auto pass = static_cast<RenderPass>(i);
+
+        if (timings.getCpuTime(pass) >= 0)
+        {
+            state.counters[std::string("cpu_ms ") + getRenderPassName(pass)] = timings.getCpuTime(pass);
+        }
+
+        if (timings.getGpuTime(pass) >= 0)
+        {
+            state.counters[std::string("gpu_ms ") + getRenderPassName(pass)] = timings.getGpuTime(pass);
+        }
+    }
+
+    GlobalRenderSystem().setPassTimingsEnabled(false);
+
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(HeadlessFrame)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+// Generates the quads of a particle system with the given number of particles,
+// using either the batched view-oriented path or the per-quad aimed path
+void ParticleUpdate(benchmark::State& state)
+{
+    auto numParticles = static_cast<int>(state.range(0));
+    auto aimed = state.range(1) != 0;
+
+    auto def = GlobalParticlesManager().findOrInsertParticleDef("benchmark_particle");
+
+    while (def->getNumStages() > 0)
+    {
+        def->removeParticleStage(0);
+    }
+
+    auto stage = def->getStage(def->addParticleStage());
+
+    stage->setMaterialName("_white");
+    stage->setCount(numParticles);
+    stage->setDuration(2.0f);
+    stage->setBunching(1.0f);
+    stage->getSpeed().setFrom(40);
+    stage->getSpeed().setTo(80);
+    stage->getRotationSpeed().setFrom(10);
+    stage->getRotationSpeed().setTo(30);
+    stage->setGravity(10);
+    stage->getSize().setFrom(4);
+    stage->getSize().setTo(8);
+    stage->setOrientationType(aimed ? particles::IStageDef::ORIENTATION_AIMED : particles::IStageDef::ORIENTATION_VIEW);
+
+    auto particle = GlobalParticlesManager().getRenderableParticle("benchmark_particle");
+
+    auto backend = GlobalRenderSystemFactory().createRenderSystem();
+    particle->setRenderSystem(backend);
+
+    std::size_t time = 0;
+
+    for (auto _ : state)
+    {
+        // Advance by one 60 fps frame, such that every update generates new geometry
+        time += 16;
+        backend->setTime(time);
+
+        particle->update(Matrix4::getIdentity(), Matrix4::getIdentity(), nullptr);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numParticles);
+
+    particle->setRenderSystem(RenderSystemPtr());
+}
+BENCHMARK(ParticleUpdate)
+    ->ArgNames({ "particles", "aimed" })
+    ->Args({ 500, 0 })->Args({ 5000, 0 })
+    ->Args({ 500, 1 })->Args({ 5000, 1 })
+    ->Unit(benchmark::kMicrosecond);
+
+}
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+#include "SyntheticScene.h"
+
+#include "iselection.h"
+#include "Rectangle.h"
+#include "algorithm/View.h"
+
+namespace test
+{
+
+// Toggles the primitive below the center of an orthoview looking at the grid
+void SelectPoint(benchmark::State& state)
+{
+    auto numPrimitives = static_cast<std::size_t>(state.range(0));
+
+    auto bounds = algorithm::generateSyntheticMap(numPrimitives);
+
+    render::View orthoView(false);
+    algorithm::constructCenteredOrthoview(orthoView, bounds.getOrigin());
+    auto selectionTest = algorithm::constructOrthoviewSelectionTest(orthoView);
+
+    for (auto _ : state)
+    {
+        GlobalSelectionSystem().selectPoint(selectionTest, selection::SelectionSystem::eToggle, false);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPrimitives);
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(SelectPoint)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Selects everything within the area of an orthoview looking at the grid
+void SelectArea(benchmark::State& state)
+{
+    auto numPrimitives = static_cast<std::size_t>(state.range(0));
+
+    auto bounds = algorithm::generateSyntheticMap(numPrimitives);
+
+    render::View orthoView(false);
+    algorithm::constructCenteredOrthoview(orthoView, bounds.getOrigin());
+
+    render::View scissored(orthoView);
+    ConstructSelectionTest(scissored, selection::Rectangle::ConstructFromArea(Vector2(-1, -1), Vector2(2, 2)));
+    SelectionVolume selectionTest(scissored);
+
+    for (auto _ : state)
+    {
+        GlobalSelectionSystem().setSelectedAll(false);
+        GlobalSelectionSystem().selectArea(selectionTest, selection::SelectionSystem::eToggle, false);
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPrimitives);
+    state.counters["selected"] = static_cast<double>(GlobalSelectionSystem().countSelected());
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    GlobalMapModule().createNewMap();
+}
+BENCHMARK(SelectArea)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+}
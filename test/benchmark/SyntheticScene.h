@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cmath>
+#include "ibrush.h"
+#include "math/pi.h"
+#include "string/convert.h"
+#include "algorithm/Primitives.h"
+#include "algorithm/SyntheticMap.h"
+
+namespace test
+{
+
+namespace algorithm
+{
+
+// Creates a brush with the given number of sides (a prism along the z axis)
+// at the given origin, without recording any undo information
+inline scene::INodePtr createPrismBrush(const scene::INodePtr& parent, const Vector3& origin,
+    std::size_t numSides, const std::string& material)
+{
+    auto brushNode = GlobalBrushCreator().createBrush();
+    parent->addChildNode(brushNode);
+
+    auto& brush = *Node_getIBrush(brushNode);
+    auto translation = Matrix4::getTranslation(origin);
+
+    for (std::size_t i = 0; i < numSides; ++i)
+    {
+        auto angle = 2 * math::PI * i / numSides;
+        brush.addFace(Plane3(cos(angle), sin(angle), 0, 64).transform(translation));
+    }
+
+    brush.addFace(Plane3(0, 0, +1, 64).transform(translation));
+    brush.addFace(Plane3(0, 0, -1, 64).transform(translation));
+
+    brush.setShader(material);
+    brush.evaluateBRep();
+
+    return brushNode;
+}
+
+}
+
+}
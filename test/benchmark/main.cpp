@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkEnvironment.h"
+
+// Starts the core modules once, then runs the benchmarks selected on the command line.
+// Use --benchmark_out=<file> --benchmark_out_format=json to get machine-readable results.
+int main(int argc, char** argv)
+{
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    test::BenchmarkEnvironment environment;
+    environment.startup();
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    environment.shutdown();
+    benchmark::Shutdown();
+
+    return 0;
+}
@@ -5,16 +5,28 @@
 namespace test
 {
 
-// Dummy Object Renderer implementation
+// Dummy Object Renderer implementation, only counting the submitted objects
 class TestObjectRenderer :
     public render::IObjectRenderer
 {
+private:
+    Statistics _statistics;
+
 public:
     void initAttributePointers() override
     {}
 
     void submitObject(render::IRenderableObject& object) override
-    {}
+    {
+        ++_statistics.drawCalls;
+    }
+
+    void submitInstancedObjects(render::IGeometryStore::Slot slot, const std::vector<const Matrix4*>& transforms, bool textured) override
+    {
+        ++_statistics.drawCalls;
+        ++_statistics.instancedDrawCalls;
+        _statistics.instances += transforms.size();
+    }
 
     void submitGeometry(render::IGeometryStore::Slot slot, GLenum primitiveMode) override
     {}
@@ -34,6 +46,16 @@ public:
     void submitGeometryWithCustomIndices(render::IGeometryStore::Slot slot, GLenum primitiveMode,
         const std::vector<unsigned int>& indices) override
     {}
+
+    const Statistics& getStatistics() const override
+    {
+        return _statistics;
+    }
+
+    void resetStatistics() override
+    {
+        _statistics = Statistics();
+    }
 };
 
 }